@@ -150,6 +150,12 @@ namespace TinaXlsx
          */
         [[nodiscard]] const TXFormula* getFormulaObject() const;
 
+        /**
+         * @brief 获取单元格的TXFormula对象，用于就地计算已编译的公式
+         * @return 如果存在公式对象，则返回其指针；否则返回nullptr。
+         */
+        [[nodiscard]] TXFormula* getFormulaObject();
+
         /**
          * @brief 设置单元格的TXFormula对象
          * @param formula_ptr 指向TXFormula对象的unique_ptr。所有权将转移。
@@ -1,42 +1,186 @@
 #pragma once
 
+#include <algorithm>
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <functional>
+#include <iterator>
+#include <string_view>
 #include "TXCoordinate.hpp"
 #include "TXCell.hpp"
 #include "TXRange.hpp"
 #include "TXTypes.hpp"
+#include "TXSharedStringsPool.hpp"
 
 namespace TinaXlsx {
 
 /**
  * @brief 单元格管理器
- * 
+ *
  * 专门负责单元格的存储、访问和基本操作
  * 职责：
  * - 单元格的创建和销毁
  * - 单元格值的读写
  * - 单元格的查找和访问
  * - 批量单元格操作
+ *
+ * 存储结构：每列按 CHUNK_ROWS 行切成数据块，块内按类型分数组保存值
+ * （double / int64 / bool / 字符串编号，按需分配），样式索引单独一个数组。
+ * 只有值和样式的普通单元格不创建 TXCell 对象；带公式、数字格式、合并或锁定
+ * 信息，以及通过 getCell()/getOrCreateCell() 取出过指针的单元格转存到稀疏的
+ * TXCell 侧表中，指针在单元格被删除或移动前保持有效。只读访问（const getCell()、
+ * getCellView()、迭代器）不修改存储，可以在多个线程中并发进行；const getCell()
+ * 为普通单元格生成的只读副本放在加锁的缓存中，下一次修改时转入侧表，指针保持有效。
+ * 字符串值去重后存放在只增不减的字符串池中，覆盖或删除字符串单元格不会释放它占用的
+ * 字节；反复写入大量不同字符串的长期存活的表应在合适的时候调用 compactStrings()。
+ * 遍历按行优先顺序进行，不需要哈希查找。
  */
 class TXCellManager {
+private:
+    /**
+     * @brief 数据块中槽位的状态
+     */
+    enum class SlotType : u8 {
+        None = 0,   ///< 没有单元格
+        Empty,      ///< 存在但没有值（可能有样式）
+        String,
+        Number,
+        Integer,
+        Boolean,
+        Rich        ///< 存放在 TXCell 侧表中
+    };
+
 public:
     using CellValue = cell_value_t;
     using Coordinate = TXCoordinate;
 
     /**
-     * @brief 坐标哈希函数
+     * @brief 坐标哈希函数（行列拼成 64 位后做乘法散列，稠密网格也不会聚集）
      */
     struct CoordinateHash {
         std::size_t operator()(const TXCoordinate& coord) const {
-            return std::hash<u32>()(coord.getRow().index()) ^
-                (std::hash<u32>()(coord.getCol().index()) << 1);
+            const u64 key = (static_cast<u64>(coord.getRow().index()) << 32) | coord.getCol().index();
+            return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 16);
         }
     };
 
-    using CellContainer = std::unordered_map<Coordinate, TXCell, CoordinateHash>;
+    /// 每个数据块覆盖的行数
+    static constexpr u32 CHUNK_ROWS = 256;
+
+    /**
+     * @brief 单元格的只读视图，读取时不创建 TXCell 对象
+     *
+     * 侧表中的单元格转发给对应的 TXCell。视图在单元格被修改或删除前有效。
+     */
+    class CellView {
+    public:
+        CellView() = default;
+
+        /**
+         * @brief 单元格是否存在
+         */
+        [[nodiscard]] bool exists() const { return type_ != SlotType::None; }
+
+        [[nodiscard]] TXCell::CellType getType() const;
+
+        /**
+         * @brief 与 TXCell::isEmpty() 一致：无值或空字符串，且没有公式
+         */
+        [[nodiscard]] bool isEmpty() const;
+
+        [[nodiscard]] u32 getStyleIndex() const;
+
+        [[nodiscard]] bool hasFormula() const;
+
+        [[nodiscard]] std::string getFormula() const;
+
+        [[nodiscard]] const TXFormula* getFormulaObject() const;
+
+        [[nodiscard]] CellValue getValue() const;
+
+        /**
+         * @brief 字符串值（包括公式的字符串结果），其他类型返回空视图
+         */
+        [[nodiscard]] std::string_view getText() const;
+
+        /**
+         * @brief 值是否为字符串（包括公式的字符串结果）
+         */
+        [[nodiscard]] bool holdsText() const;
+
+        [[nodiscard]] std::string getFormattedValue() const;
+
+        [[nodiscard]] bool isLocked() const;
+
+        /**
+         * @brief 侧表中的 TXCell，普通单元格返回 nullptr
+         */
+        [[nodiscard]] const TXCell* getCell() const { return rich_; }
+
+    private:
+        friend class TXCellManager;
+
+        SlotType type_ = SlotType::None;
+        u32 style_ = 0;
+        union {
+            double number_ = 0.0;
+            i64 integer_;
+            bool boolean_;
+        };
+        std::string_view text_;
+        const TXCell* rich_ = nullptr;
+    };
+
+    /**
+     * @brief 行优先的只读迭代器，元素为 (坐标, 视图)
+     */
+    class ConstIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<Coordinate, CellView>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        reference operator*() const { return current_; }
+        pointer operator->() const { return &current_; }
+
+        ConstIterator& operator++() {
+            ++colPos_;
+            settle();
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            ConstIterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const ConstIterator& other) const {
+            return block_ == other.block_ && row_ == other.row_ && colPos_ == other.colPos_;
+        }
+        bool operator!=(const ConstIterator& other) const { return !(*this == other); }
+
+    private:
+        friend class TXCellManager;
+
+        ConstIterator(const TXCellManager* manager, std::size_t block);
+
+        /// 从当前位置起找到第一个已占用的槽位
+        void settle();
+
+        const TXCellManager* manager_;
+        std::size_t block_;
+        u32 row_ = 0;
+        std::size_t colPos_ = 0;
+        value_type current_;
+    };
+
+    using iterator = ConstIterator;
+    using const_iterator = ConstIterator;
 
     TXCellManager() = default;
     ~TXCellManager() = default;
@@ -58,6 +202,9 @@ public:
 
     /**
      * @brief 获取单元格（只读）
+     *
+     * 普通单元格第一次访问时生成一个 TXCell 副本，之后返回同一个对象；
+     * 大量读取时 getCellView() 和迭代器不需要生成副本，开销更小。
      * @param coord 坐标
      * @return 单元格指针，不存在返回nullptr
      */
@@ -70,6 +217,13 @@ public:
      */
     TXCell* getOrCreateCell(const Coordinate& coord);
 
+    /**
+     * @brief 获取单元格的只读视图，不创建 TXCell 对象
+     * @param coord 坐标
+     * @return 视图，单元格不存在时 exists() 为 false
+     */
+    CellView getCellView(const Coordinate& coord) const;
+
     /**
      * @brief 检查单元格是否存在
      * @param coord 坐标
@@ -101,6 +255,14 @@ public:
      */
     CellValue getCellValue(const Coordinate& coord) const;
 
+    /**
+     * @brief 设置已存在单元格的样式索引
+     * @param coord 坐标
+     * @param styleIndex 样式索引（0 为默认样式）
+     * @return 单元格不存在时返回false
+     */
+    bool setCellStyleIndex(const Coordinate& coord, u32 styleIndex);
+
     /**
      * @brief 批量设置单元格值
      * @param values 坐标-值对列表
@@ -140,11 +302,19 @@ public:
      */
     void clear();
 
+    /**
+     * @brief 重建字符串池，丢弃不再被任何单元格引用的字符串
+     *
+     * 会使所有 CellView 中的字符串视图失效，不能在遍历过程中调用。
+     * @return 释放的字符串个数
+     */
+    std::size_t compactStrings();
+
     /**
      * @brief 获取单元格数量
      * @return 单元格总数
      */
-    std::size_t getCellCount() const { return cells_.size(); }
+    std::size_t getCellCount() const { return cellCount_; }
 
     /**
      * @brief 获取非空单元格数量
@@ -152,17 +322,140 @@ public:
      */
     std::size_t getNonEmptyCellCount() const;
 
+    /**
+     * @brief 侧表中的单元格数量
+     */
+    std::size_t getRichCellCount() const { return richCells_.size(); }
+
+    /**
+     * @brief 估算单元格存储占用的堆内存（字节）
+     */
+    std::size_t getMemoryUsage() const;
+
+    // ==================== 修改跟踪 ====================
+
+    /**
+     * @brief 获取修订号，通过管理器接口写入、创建、删除或移动单元格时递增
+     *
+     * 经由 getCell()/getOrCreateCell() 返回的指针直接修改单元格不会改变修订号，
+     * 这类修改由 trackCellHandles() 和 hasHandleChanges() 检测。
+     */
+    std::size_t getRevision() const { return revision_; }
+
+    /**
+     * @brief 开启或关闭单元格指针的修改跟踪
+     *
+     * 开启后 getCell()/getOrCreateCell() 第一次交出某个单元格时记录它的内容，
+     * hasHandleChanges() 据此判断是否有人通过指针修改过单元格。每次调用都会丢弃已有记录。
+     */
+    void trackCellHandles(bool enabled);
+
+    /**
+     * @brief 开启跟踪后交出的单元格是否被修改过（值、公式、格式、样式、合并或锁定状态）
+     */
+    bool hasHandleChanges() const;
+
     // ==================== 迭代器支持 ====================
 
     /**
-     * @brief 获取所有单元格的迭代器
+     * @brief 按行优先顺序遍历所有单元格
+     */
+    ConstIterator begin() const { return ConstIterator(this, 0); }
+    ConstIterator end() const { return ConstIterator(this, blockColumns_.size()); }
+    ConstIterator cbegin() const { return begin(); }
+    ConstIterator cend() const { return end(); }
+
+    /**
+     * @brief 按行优先顺序遍历范围内存在的单元格
+     *
+     * 只访问有数据块的行块和列，整列范围（如 A1:A1048576）的代价与实际数据量成正比。
+     * @param top 起始行，left 起始列，bottom 结束行，right 结束列（都包含在内）
+     * @param fn 以 (const Coordinate&, const CellView&) 调用
+     */
+    template <typename Fn>
+    void forEachCellInRange(row_t top, column_t left, row_t bottom, column_t right, Fn&& fn) const {
+        if (top.index() == 0 || left.index() == 0 || top > bottom || left > right) {
+            return;
+        }
+        const std::size_t firstBlock = (top.index() - 1) / CHUNK_ROWS;
+        const std::size_t lastBlock = std::min<std::size_t>((bottom.index() - 1) / CHUNK_ROWS,
+                                                            blockColumns_.empty() ? 0 : blockColumns_.size() - 1);
+        for (std::size_t block = firstBlock; block < blockColumns_.size() && block <= lastBlock; ++block) {
+            const auto& cols = blockColumns_[block];
+            const auto colBegin = std::lower_bound(cols.begin(), cols.end(), left.index() - 1);
+            const auto colEnd = std::upper_bound(colBegin, cols.end(), right.index() - 1);
+            if (colBegin == colEnd) {
+                continue;
+            }
+            const u32 blockTop = static_cast<u32>(block * CHUNK_ROWS) + 1;
+            const u32 rowBegin = std::max(top.index(), blockTop);
+            const u32 rowEnd = std::min(bottom.index(), blockTop + CHUNK_ROWS - 1);
+            for (u32 row = rowBegin; row <= rowEnd; ++row) {
+                const u32 slot = row - blockTop;
+                for (auto it = colBegin; it != colEnd; ++it) {
+                    const ColumnChunk& chunk = *columns_[*it].chunks[block];
+                    if (chunk.types[slot] != SlotType::None) {
+                        const Coordinate coord(row_t(row), column_t(static_cast<u32>(*it) + 1));
+                        fn(coord, makeView(chunk, slot, coord));
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 按数据块遍历范围内的单元格，数值单元格以连续数组交给调用方
+     *
+     * 对范围与每个数据块相交的列段调用 numbers(values, tags, tag, count)：values 和 tags
+     * 是该列段的 double 数组和类型标记，只有 tags[i] == tag 的位置是数值单元格。
+     * 其余存在的单元格（整数、字符串、布尔、侧表中的单元格等）以 others(coord, view)
+     * 逐个调用。用于聚合计算，遍历顺序为块内按列，与 forEachCellInRange() 不同。
+     */
+    template <typename NumberFn, typename CellFn>
+    void forEachNumericBlock(row_t top, column_t left, row_t bottom, column_t right,
+                             NumberFn&& numbers, CellFn&& others) const {
+        if (top.index() == 0 || left.index() == 0 || top > bottom || left > right) {
+            return;
+        }
+        const std::size_t firstBlock = (top.index() - 1) / CHUNK_ROWS;
+        const std::size_t lastBlock = std::min<std::size_t>((bottom.index() - 1) / CHUNK_ROWS,
+                                                            blockColumns_.empty() ? 0 : blockColumns_.size() - 1);
+        for (std::size_t block = firstBlock; block < blockColumns_.size() && block <= lastBlock; ++block) {
+            const auto& cols = blockColumns_[block];
+            const auto colBegin = std::lower_bound(cols.begin(), cols.end(), left.index() - 1);
+            const auto colEnd = std::upper_bound(colBegin, cols.end(), right.index() - 1);
+            const u32 blockTop = static_cast<u32>(block * CHUNK_ROWS) + 1;
+            const u32 slotBegin = std::max(top.index(), blockTop) - blockTop;
+            const u32 slotEnd = std::min(bottom.index(), blockTop + CHUNK_ROWS - 1) - blockTop + 1;
+            for (auto it = colBegin; it != colEnd; ++it) {
+                const ColumnChunk& chunk = *columns_[*it].chunks[block];
+                if (chunk.numbers) {
+                    numbers(chunk.numbers.get() + slotBegin, reinterpret_cast<const u8*>(chunk.types) + slotBegin,
+                            static_cast<u8>(SlotType::Number), static_cast<std::size_t>(slotEnd - slotBegin));
+                }
+                for (u32 slot = slotBegin; slot < slotEnd; ++slot) {
+                    const SlotType type = chunk.types[slot];
+                    if (type != SlotType::None && type != SlotType::Number) {
+                        const Coordinate coord(row_t(blockTop + slot), column_t(static_cast<u32>(*it) + 1));
+                        others(coord, makeView(chunk, slot, coord));
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 遍历所有带公式的单元格（只访问侧表，不扫描数据块，顺序不确定）
+     * @param fn 以 (const Coordinate&, const TXCell&) 调用
      */
-    CellContainer::iterator begin() { return cells_.begin(); }
-    CellContainer::iterator end() { return cells_.end(); }
-    CellContainer::const_iterator begin() const { return cells_.begin(); }
-    CellContainer::const_iterator end() const { return cells_.end(); }
-    CellContainer::const_iterator cbegin() const { return cells_.cbegin(); }
-    CellContainer::const_iterator cend() const { return cells_.cend(); }
+    template <typename Fn>
+    void forEachFormulaCell(Fn&& fn) const {
+        for (const auto& [coord, cell] : richCells_) {
+            if (cell.hasFormula()) {
+                fn(coord, cell);
+            }
+        }
+    }
 
     // ==================== 行列移动支持 ====================
 
@@ -180,7 +473,54 @@ public:
     std::size_t removeCellsInRange(const TXRange& range);
 
 private:
-    CellContainer cells_;
+    /**
+     * @brief 一列中 CHUNK_ROWS 行的数据，值数组在第一次存入对应类型时分配
+     */
+    struct ColumnChunk {
+        SlotType types[CHUNK_ROWS] = {};
+        u32 count = 0;                          ///< 已占用槽位数
+        std::unique_ptr<double[]> numbers;
+        std::unique_ptr<i64[]> integers;
+        std::unique_ptr<bool[]> booleans;
+        std::unique_ptr<u32[]> strings;         ///< strings_ 中的编号
+        std::unique_ptr<u32[]> styles;          ///< 样式索引，全为 0 时不分配
+    };
+
+    struct Column {
+        std::vector<std::unique_ptr<ColumnChunk>> chunks;   ///< 按行块编号索引
+    };
+
+    std::vector<Column> columns_;                          ///< 按列号 - 1 索引
+    std::vector<std::vector<u16>> blockColumns_;           ///< 每个行块中有数据块的列（列号 - 1，升序）
+    /**
+     * @brief const getCell() 为普通单元格生成的 TXCell，只读访问可能并发，因此加锁
+     */
+    struct ReadCells {
+        std::mutex mutex;
+        std::unordered_map<Coordinate, TXCell, CoordinateHash> cells;
+    };
+
+    std::unordered_map<Coordinate, TXCell, CoordinateHash> richCells_;  ///< TXCell 侧表
+    mutable std::unique_ptr<ReadCells> readCells_ = std::make_unique<ReadCells>();
+    TXSharedStringsPool strings_;                          ///< 字符串值（去重，只存一份）
+    std::size_t cellCount_ = 0;
+    std::size_t revision_ = 0;
+    bool trackHandles_ = false;
+    std::unordered_map<Coordinate, TXCell, CoordinateHash> handleSnapshots_;  ///< 交出指针时的单元格内容
+
+    ColumnChunk* findChunk(const Coordinate& coord) const;
+    ColumnChunk& ensureChunk(const Coordinate& coord);
+    void releaseChunkIfEmpty(const Coordinate& coord);
+    void storeValue(ColumnChunk& chunk, u32 slot, const CellValue& value);
+    CellView makeView(const ColumnChunk& chunk, u32 slot, const Coordinate& coord) const;
+    TXCell* promote(const Coordinate& coord);
+    void adoptReadCells();
+    TXCell* handOut(const Coordinate& coord, TXCell* cell);
+    static TXCell makeCell(const CellView& view);
+    void insertRichCell(const Coordinate& coord, TXCell&& cell);
+
+    static u32 slotOf(const Coordinate& coord) { return (coord.getRow().index() - 1) % CHUNK_ROWS; }
+    static std::size_t blockOf(const Coordinate& coord) { return (coord.getRow().index() - 1) / CHUNK_ROWS; }
 
     /**
      * @brief 验证坐标有效性
@@ -4,15 +4,39 @@
 
 #pragma once
 
+#include <algorithm>
+#include <utility>
+#include <vector>
 #include "TXXmlHandler.hpp"
 #include "TXXmlReader.hpp"
-#include "TXXmlWriter.hpp"
 
 namespace TinaXlsx
 {
     class TXContentTypesXmlHandler : public TXXmlHandler
     {
         public:
+        /**
+         * @brief 登记按扩展名匹配的内容类型（用于从源文件复制的图片等部件），已有的扩展名忽略
+         */
+        void addDefault(const std::string& extension, const std::string& contentType)
+        {
+            if (extension == "rels" || extension == "xml" ||
+                std::any_of(m_defaults.begin(), m_defaults.end(),
+                            [&](const auto& entry) { return entry.first == extension; })) {
+                return;
+            }
+            m_defaults.emplace_back(extension, contentType);
+        }
+
+        /**
+         * @brief 登记单个部件的内容类型（用于从源文件复制的绘图等部件）
+         * @param partName 以 / 开头的部件名
+         */
+        void addOverride(const std::string& partName, const std::string& contentType)
+        {
+            m_overrides.emplace_back(partName, contentType);
+        }
+
         TXResult<void> load(TXZipArchiveReader& zipReader, TXWorkbookContext& context) override
         {
             return Ok();
@@ -20,52 +44,39 @@ namespace TinaXlsx
 
         TXResult<void> save(TXZipArchiveWriter& zipWriter, const TXWorkbookContext& context) override
         {
-            XmlNodeBuilder types("Types");
-
-            types.addAttribute("xmlns", "http://schemas.openxmlformats.org/package/2006/content-types");
-
-            types.addChild(XmlNodeBuilder("Default")
-                .addAttribute("Extension","rels")
-                .addAttribute("ContentType","application/vnd.openxmlformats-package.relationships+xml"));
-
-            types.addChild(XmlNodeBuilder("Default")
-                .addAttribute("Extension","xml")
-                .addAttribute("ContentType","application/xml"));
-
-            types.addChild(XmlNodeBuilder("Override")
-                .addAttribute("PartName","/xl/workbook.xml")
-                .addAttribute("ContentType","application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml"));
+            TXXmlStreamWriter xml;
+            xml.declaration();
+            xml.startElement("Types")
+               .attribute("xmlns", "http://schemas.openxmlformats.org/package/2006/content-types");
+
+            writeDefault(xml, "rels", "application/vnd.openxmlformats-package.relationships+xml");
+            writeDefault(xml, "xml", "application/xml");
+            for (const auto& [extension, contentType] : m_defaults) {
+                writeDefault(xml, extension, contentType);
+            }
+            writeOverride(xml, "/xl/workbook.xml", "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml");
 
             // 工作表
             for (u64 i = 0; i < context.sheets.size(); ++i)
             {
-                types.addChild(XmlNodeBuilder("Override")
-                    .addAttribute("PartName", "/xl/worksheets/sheet" + std::to_string(i + 1) + ".xml")
-                    .addAttribute("ContentType", "application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml"));
+                writeOverride(xml, "/xl/worksheets/sheet" + std::to_string(i + 1) + ".xml",
+                              "application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml");
             }
 
             // 样式（如果启用）
             if (context.componentManager.hasComponent(ExcelComponent::Styles)) {
-                types.addChild(XmlNodeBuilder("Override")
-                               .addAttribute("PartName", "/xl/styles.xml")
-                               .addAttribute("ContentType", "application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml"));
+                writeOverride(xml, "/xl/styles.xml", "application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml");
             }
 
             // 共享字符串（如果启用）
             if (context.componentManager.hasComponent(ExcelComponent::SharedStrings)) {
-                types.addChild(XmlNodeBuilder("Override")
-                               .addAttribute("PartName", "/xl/sharedStrings.xml")
-                               .addAttribute("ContentType", "application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml"));
+                writeOverride(xml, "/xl/sharedStrings.xml", "application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml");
             }
 
             // 文档属性（如果启用）
             if (context.componentManager.hasComponent(ExcelComponent::DocumentProperties)) {
-                types.addChild(XmlNodeBuilder("Override")
-                               .addAttribute("PartName", "/docProps/core.xml")
-                               .addAttribute("ContentType", "application/vnd.openxmlformats-package.core-properties+xml"));
-                types.addChild(XmlNodeBuilder("Override")
-                               .addAttribute("PartName", "/docProps/app.xml")
-                               .addAttribute("ContentType", "application/vnd.openxmlformats-officedocument.extended-properties+xml"));
+                writeOverride(xml, "/docProps/core.xml", "application/vnd.openxmlformats-package.core-properties+xml");
+                writeOverride(xml, "/docProps/app.xml", "application/vnd.openxmlformats-officedocument.extended-properties+xml");
             }
 
             // 图表和绘图内容类型
@@ -74,44 +85,49 @@ namespace TinaXlsx
                 const TXSheet* sheet = context.sheets[i].get();
                 if (sheet->getChartCount() > 0) {
                     // 绘图内容类型
-                    types.addChild(XmlNodeBuilder("Override")
-                                   .addAttribute("PartName", "/xl/drawings/drawing" + std::to_string(i + 1) + ".xml")
-                                   .addAttribute("ContentType", "application/vnd.openxmlformats-officedocument.drawing+xml"));
+                    writeOverride(xml, "/xl/drawings/drawing" + std::to_string(i + 1) + ".xml",
+                                  "application/vnd.openxmlformats-officedocument.drawing+xml");
 
                     // 图表内容类型
                     for (size_t j = 0; j < sheet->getChartCount(); ++j) {
-                        types.addChild(XmlNodeBuilder("Override")
-                                       .addAttribute("PartName", "/xl/charts/chart" + std::to_string(chartCount + 1) + ".xml")
-                                       .addAttribute("ContentType", "application/vnd.openxmlformats-officedocument.drawingml.chart+xml"));
+                        writeOverride(xml, "/xl/charts/chart" + std::to_string(chartCount + 1) + ".xml",
+                                      "application/vnd.openxmlformats-officedocument.drawingml.chart+xml");
                         ++chartCount;
                     }
                 }
             }
 
-            TXXmlWriter writer;
-            auto setRootResult = writer.setRootNode(types);
-            if (setRootResult.isError()) {
-                return Err<void>(setRootResult.error().getCode(), "Failed to set root node: " + setRootResult.error().getMessage());
-            }
-            
-            auto xmlContentResult = writer.generateXmlString();
-            if (xmlContentResult.isError()) {
-                return Err<void>(xmlContentResult.error().getCode(), "Failed to generate XML: " + xmlContentResult.error().getMessage());
-            }
-            
-            std::vector<uint8_t> xmlData(xmlContentResult.value().begin(), xmlContentResult.value().end());
-            auto writeResult = zipWriter.write(std::string(partName()), xmlData);
-            if (writeResult.isError()) {
-                return Err<void>(writeResult.error().getCode(), "Failed to write " + std::string(partName()) + ": " + writeResult.error().getMessage());
+            for (const auto& [part, contentType] : m_overrides) {
+                writeOverride(xml, part, contentType);
             }
 
-            return Ok();
+            xml.endElement("Types");
+            return writeXmlPart(zipWriter, xml);
         }
 
         std::string partName() const override
         {
             return "[Content_Types].xml";
         }
-        
+
+    private:
+        std::vector<std::pair<std::string, std::string>> m_defaults;   ///< 额外的 (扩展名, 内容类型)
+        std::vector<std::pair<std::string, std::string>> m_overrides;  ///< 额外的 (部件名, 内容类型)
+
+        static void writeDefault(TXXmlStreamWriter& xml, std::string_view extension, std::string_view contentType)
+        {
+            xml.startElement("Default")
+               .attribute("Extension", extension)
+               .attribute("ContentType", contentType)
+               .endElement("Default");
+        }
+
+        static void writeOverride(TXXmlStreamWriter& xml, std::string_view partName, std::string_view contentType)
+        {
+            xml.startElement("Override")
+               .attribute("PartName", partName)
+               .attribute("ContentType", contentType)
+               .endElement("Override");
+        }
     };
 }
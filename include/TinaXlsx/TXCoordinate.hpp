@@ -1,7 +1,11 @@
 #pragma once
 
 #include "TXTypes.hpp"
+#include <charconv>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace TinaXlsx {
 
@@ -103,6 +107,16 @@ public:
      * @return A1格式地址 (如 "A1", "B5", "AA10")
      */
     std::string toAddress() const;
+
+    /// toChars() 要求的缓冲区大小（最长的地址 "XFD1048576" 为 10 个字符）
+    static constexpr std::size_t MAX_ADDRESS_LENGTH = 16;
+
+    /**
+     * @brief 把A1格式地址写入调用方的缓冲区，不分配内存
+     * @param buffer 至少 MAX_ADDRESS_LENGTH 字节的缓冲区，不写结尾的 '\0'
+     * @return 写入的字符数
+     */
+    std::size_t toChars(char* buffer) const;
     
     /**
      * @brief 获取列名
@@ -235,4 +249,57 @@ private:
     column_t col_;
 };
 
+/**
+ * @brief 按行生成单元格引用（如 "AB12"），供工作表写出器逐个单元格使用
+ *
+ * 行号在 setRow() 时用 to_chars 生成一次，列字母在第一次用到时按列缓存，
+ * 引用在内部的定长缓冲区中拼接。除列缓存首次扩容外，生成引用不分配堆内存。
+ */
+class TXCellRefFormatter {
+public:
+    /**
+     * @brief 切换到新的一行
+     * @param row 行号 (1-based)
+     */
+    void setRow(u32 row) {
+        rowLength_ = static_cast<std::size_t>(std::to_chars(rowDigits_, rowDigits_ + sizeof(rowDigits_), row).ptr - rowDigits_);
+    }
+
+    /**
+     * @brief 当前行号的文本，用于 <row r="...">
+     */
+    std::string_view rowText() const {
+        return std::string_view(rowDigits_, rowLength_);
+    }
+
+    /**
+     * @brief 当前行中指定列的单元格引用
+     * @param col 列号 (1-based)
+     * @return 引用文本，在下一次调用 cell() 或 setRow() 前有效
+     */
+    std::string_view cell(u32 col) {
+        if (col >= columns_.size()) {
+            columns_.resize(static_cast<std::size_t>(col) + 1);
+        }
+        ColumnLetters& letters = columns_[col];
+        if (letters.length == 0) {
+            letters.length = static_cast<u8>(column_t::column_chars_from_index(col, letters.text));
+        }
+        std::memcpy(ref_, letters.text, letters.length);
+        std::memcpy(ref_ + letters.length, rowDigits_, rowLength_);
+        return std::string_view(ref_, letters.length + rowLength_);
+    }
+
+private:
+    struct ColumnLetters {
+        char text[column_t::MAX_COLUMN_LETTERS];
+        u8 length = 0;    ///< 0 表示尚未生成
+    };
+
+    std::vector<ColumnLetters> columns_;   ///< 按列号索引的列字母缓存
+    char rowDigits_[12] = {};
+    std::size_t rowLength_ = 0;
+    char ref_[TXCoordinate::MAX_ADDRESS_LENGTH] = {};
+};
+
 } // namespace TinaXlsx 
\ No newline at end of file
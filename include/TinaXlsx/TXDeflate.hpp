@@ -0,0 +1,64 @@
+//
+// @file TXDeflate.hpp
+// @brief 内存中的 DEFLATE 压缩，用于在工作线程上预先压缩 ZIP 条目
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "TXResult.hpp"
+#include "TXTypes.hpp"
+
+namespace TinaXlsx
+{
+    /**
+     * @brief 已压缩的 ZIP 条目数据
+     */
+    struct TXDeflatedData
+    {
+        std::vector<uint8_t> bytes;      ///< 原始 DEFLATE 流（无 zlib 头）
+        uint32_t crc32 = 0;              ///< 未压缩数据的 CRC-32
+        uint64_t uncompressedSize = 0;   ///< 未压缩数据长度
+    };
+
+    /**
+     * @brief DEFLATE 压缩器
+     *
+     * 参数与 minizip-ng 写条目时一致（原始流、窗口 15 位、内存级别 8、默认策略），
+     * 同一输入和级别得到的压缩数据与 TXZipArchiveWriter 流式写入的相同。
+     */
+    class TXDeflate
+    {
+    public:
+        /**
+         * @brief 压缩一段内存数据
+         * @param data 数据指针
+         * @param size 数据长度
+         * @param level 压缩级别（0-9）
+         * @return 压缩结果或错误
+         */
+        static TXResult<TXDeflatedData> compress(const void* data, std::size_t size, int level = 6);
+
+        /// compressParallel() 默认的分块大小
+        static constexpr std::size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+        /**
+         * @brief 分块并行压缩一段内存数据（pigz 方式）
+         *
+         * 数据按 blockSize 切块，各块以上一块末尾 32KB 为预设字典独立压缩，
+         * 非最后一块以同步冲刷结束，拼接后即为一个合法的 DEFLATE 流；
+         * CRC 按块计算后用 crc32_combine 合并。压缩数据与 compress() 的结果不同，
+         * 但解压内容相同，压缩率略低。结果与线程数无关，只有一块时等同于 compress()。
+         * @param data 数据指针
+         * @param size 数据长度
+         * @param level 压缩级别（0-9）
+         * @param threadCount 线程数（含调用线程），0 表示硬件并发数
+         * @param blockSize 分块大小（至少 32KB）
+         * @return 压缩结果或错误
+         */
+        static TXResult<TXDeflatedData> compressParallel(const void* data, std::size_t size, int level,
+                                                         u32 threadCount, std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+    };
+} // namespace TinaXlsx
@@ -16,64 +16,43 @@ namespace TinaXlsx
         TXResult<void> save(TXZipArchiveWriter& zipWriter, const TXWorkbookContext& context) override
         {
             // 生成 core.xml
-            XmlNodeBuilder coreProps("cp:coreProperties");
-            coreProps.addAttribute(
-                         "xmlns:cp", "http://schemas.openxmlformats.org/package/2006/metadata/core-properties")
-                     .addAttribute("xmlns:dc", "http://purl.org/dc/elements/1.1/")
-                     .addAttribute("xmlns:dcterms", "http://purl.org/dc/terms/")
-                     .addAttribute("xmlns:dcmitype", "http://purl.org/dc/dcmitype/")
-                     .addAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-            coreProps.addChild(XmlNodeBuilder("dc:creator").setText("TinaXlsx"));
-            coreProps.addChild(XmlNodeBuilder("cp:lastModifiedBy").setText("TinaXlsx"));
-            coreProps.addChild(XmlNodeBuilder("dcterms:created")
-                               .addAttribute("xsi:type", "dcterms:W3CDTF")
-                               .setText("2025-05-29T00:00:00Z"));
-            coreProps.addChild(XmlNodeBuilder("dcterms:modified")
-                               .addAttribute("xsi:type", "dcterms:W3CDTF")
-                               .setText("2025-05-29T00:00:00Z"));
+            TXXmlStreamWriter core;
+            core.declaration();
+            core.startElement("cp:coreProperties")
+                .attribute("xmlns:cp", "http://schemas.openxmlformats.org/package/2006/metadata/core-properties")
+                .attribute("xmlns:dc", "http://purl.org/dc/elements/1.1/")
+                .attribute("xmlns:dcterms", "http://purl.org/dc/terms/")
+                .attribute("xmlns:dcmitype", "http://purl.org/dc/dcmitype/")
+                .attribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
+            core.element("dc:creator", "TinaXlsx");
+            core.element("cp:lastModifiedBy", "TinaXlsx");
+            core.startElement("dcterms:created").attribute("xsi:type", "dcterms:W3CDTF")
+                .text("2025-05-29T00:00:00Z").endElement("dcterms:created");
+            core.startElement("dcterms:modified").attribute("xsi:type", "dcterms:W3CDTF")
+                .text("2025-05-29T00:00:00Z").endElement("dcterms:modified");
+            core.endElement("cp:coreProperties");
 
-            TXXmlWriter coreWriter;
-            auto setCoreRootResult = coreWriter.setRootNode(coreProps);
-            if (setCoreRootResult.isError()) {
-                return Err<void>(setCoreRootResult.error().getCode(), "Failed to set core root node: " + setCoreRootResult.error().getMessage());
-            }
-            
-            auto coreContentResult = coreWriter.generateXmlString();
-            if (coreContentResult.isError()) {
-                return Err<void>(coreContentResult.error().getCode(), "Failed to generate core XML string: " + coreContentResult.error().getMessage());
-            }
-            
-            std::vector<uint8_t> coreData(coreContentResult.value().begin(), coreContentResult.value().end());
-            auto writeCoreResult = zipWriter.write("docProps/core.xml", coreData);
+            auto writeCoreResult = zipWriter.write("docProps/core.xml", core.buffer().data(), core.buffer().size());
             if (writeCoreResult.isError())
             {
                 return Err<void>(writeCoreResult.error().getCode(), "Failed to write docProps/core.xml: " + writeCoreResult.error().getMessage());
             }
 
             // 生成 app.xml
-            XmlNodeBuilder appProps("Properties");
-            appProps.addAttribute("xmlns", "http://schemas.openxmlformats.org/officeDocument/2006/extended-properties")
-                    .addAttribute("xmlns:vt", "http://schemas.openxmlformats.org/officeDocument/2006/docPropsVTypes");
-            appProps.addChild(XmlNodeBuilder("Application").setText("TinaXlsx"));
-            appProps.addChild(XmlNodeBuilder("DocSecurity").setText("0"));
-            appProps.addChild(XmlNodeBuilder("ScaleCrop").setText("false"));
-            appProps.addChild(XmlNodeBuilder("SharedDoc").setText("false"));
-            appProps.addChild(XmlNodeBuilder("HyperlinksChanged").setText("false"));
-            appProps.addChild(XmlNodeBuilder("AppVersion").setText("16.0300"));
+            TXXmlStreamWriter app;
+            app.declaration();
+            app.startElement("Properties")
+               .attribute("xmlns", "http://schemas.openxmlformats.org/officeDocument/2006/extended-properties")
+               .attribute("xmlns:vt", "http://schemas.openxmlformats.org/officeDocument/2006/docPropsVTypes");
+            app.element("Application", "TinaXlsx");
+            app.element("DocSecurity", "0");
+            app.element("ScaleCrop", "false");
+            app.element("SharedDoc", "false");
+            app.element("HyperlinksChanged", "false");
+            app.element("AppVersion", "16.0300");
+            app.endElement("Properties");
 
-            TXXmlWriter appWriter;
-            auto setAppRootResult = appWriter.setRootNode(appProps);
-            if (setAppRootResult.isError()) {
-                return Err<void>(setAppRootResult.error().getCode(), "Failed to set app root node: " + setAppRootResult.error().getMessage());
-            }
-            
-            auto appContentResult = appWriter.generateXmlString();
-            if (appContentResult.isError()) {
-                return Err<void>(appContentResult.error().getCode(), "Failed to generate app XML string: " + appContentResult.error().getMessage());
-            }
-            
-            std::vector<uint8_t> appData(appContentResult.value().begin(), appContentResult.value().end());
-            auto writeAppResult = zipWriter.write("docProps/app.xml", appData);
+            auto writeAppResult = zipWriter.write("docProps/app.xml", app.buffer().data(), app.buffer().size());
             if (writeAppResult.isError())
             {
                 return Err<void>(writeAppResult.error().getCode(), "Failed to write docProps/app.xml: " + writeAppResult.error().getMessage());
@@ -6,17 +6,22 @@
 #include <unordered_map>
 #include <memory>
 #include <functional>
+#include <string_view>
 #include <variant>
 
 namespace TinaXlsx {
 
 // Forward declarations
 class TXSheet;
+class TXCellManager;
 
 /**
  * @brief Excel公式处理类
  * 
- * 提供公式解析、计算和生成功能，支持常用的Excel函数
+ * 提供公式解析、计算和生成功能，支持常用的Excel函数。
+ * 设置公式时只编译一次：词法分析和按优先级的递归下降解析把公式转换为
+ * 逆波兰形式的指令序列，单元格引用预先解析为行列号，函数名解析为内置函数表下标。
+ * evaluate() 只是在值栈上依次执行指令，不再处理公式文本。
  */
 class TXFormula {
 public:
@@ -92,9 +97,12 @@ public:
     TXFormula& operator=(TXFormula&& other) noexcept;
 
     /**
-     * @brief 解析公式
-     * @param formula 公式字符串（不含等号）
-     * @return 成功返回true，失败返回false
+     * @brief 解析并编译公式
+     *
+     * 支持数字、字符串和逻辑常量，单元格和范围引用（可带 $，包括整列 A:C 和整行 1:3），
+     * 运算符 + - * / ^ & % 和比较运算（优先级与 Excel 相同），以及可嵌套的函数调用。
+     * @param formula 公式字符串（可以带前导等号）
+     * @return 成功返回true，语法错误或未知名称返回false（getLastError() 给出原因）
      */
     bool parseFormula(const std::string& formula);
 
@@ -103,10 +111,21 @@ public:
      * @param sheet 当前工作表
      * @param currentRow 当前单元格行号
      * @param currentCol 当前单元格列号
-     * @return 计算结果
+     * @return 计算结果，出错时返回空值并设置 getLastError()
      */
     FormulaValue evaluate(const TXSheet* sheet, row_t currentRow, column_t currentCol);
 
+    /**
+     * @brief 在单元格管理器上计算公式结果
+     *
+     * 纯数值公式的计算不分配内存（求值栈和参数列表在多次计算间复用）。
+     * @param cells 引用所在的单元格管理器
+     * @param currentRow 当前单元格行号
+     * @param currentCol 当前单元格列号
+     * @return 计算结果，出错时返回空值并设置 getLastError()
+     */
+    FormulaValue evaluate(const TXCellManager& cells, row_t currentRow, column_t currentCol);
+
     /**
      * @brief 获取公式字符串
      * @return 公式字符串
@@ -132,11 +151,22 @@ public:
     std::string getErrorDescription() const;
 
     /**
-     * @brief 获取公式依赖的单元格
+     * @brief 获取最后的错误对应的 Excel 错误值（如 "#DIV/0!"），无错误时返回空串
+     */
+    std::string_view getErrorValue() const;
+
+    /**
+     * @brief 获取公式直接引用的单元格（不含范围）
      * @return 依赖的单元格引用列表
      */
     std::vector<CellReference> getDependencies() const;
 
+    /**
+     * @brief 获取公式引用的范围
+     * @return 范围引用列表（起点不大于终点）
+     */
+    const std::vector<RangeReference>& getRangeDependencies() const;
+
     /**
      * @brief 检查是否为有效的公式
      * @param formula 公式字符串
@@ -145,14 +175,14 @@ public:
     static bool isValidFormula(const std::string& formula);
 
     /**
-     * @brief 注册自定义函数
+     * @brief 注册自定义函数，同名时覆盖内置函数
      * @param name 函数名称
      * @param func 函数实现
      */
     void registerFunction(const std::string& name, const FormulaFunction& func);
 
     /**
-     * @brief 清除自定义函数
+     * @brief 清除自定义函数（内置函数不受影响）
      */
     void clearCustomFunctions();
 
@@ -241,19 +271,69 @@ public:
     static bool valuesEqual(const FormulaValue& a, const FormulaValue& b);
 
 private:
+    /**
+     * @brief 指令操作码
+     */
+    enum class OpCode : u8 {
+        PushNumber,     ///< 压入数字常量 numbers[a]
+        PushString,     ///< 压入字符串常量 strings[a]
+        PushBool,       ///< 压入逻辑常量 a
+        PushEmpty,      ///< 压入空值（省略的参数）
+        PushCell,       ///< 压入单元格 (行 a, 列 b) 的值
+        PushRange,      ///< 压入范围 ranges[a]，只能作为函数参数展开
+        RefError,       ///< 无法计算的引用（跨工作表）
+        Add, Subtract, Multiply, Divide, Power, Concat,
+        Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual,
+        Negate,         ///< 一元负号
+        Percent,        ///< 后缀 %
+        JumpIfFalse,    ///< 弹出条件，为假时跳到 a
+        Jump,           ///< 跳到 a
+        CallBuiltin,    ///< 调用内置函数 a，参数 b 个
+        CallCustom      ///< 调用名为 strings[a] 的自定义函数，参数 b 个
+    };
+
+    struct Instruction {
+        OpCode op;
+        u32 a = 0;
+        u32 b = 0;
+    };
+
+    /**
+     * @brief 编译后的公式
+     */
+    struct Program {
+        std::vector<Instruction> code;
+        std::vector<double> numbers;
+        std::vector<std::string> strings;        ///< 字符串常量和自定义函数名
+        std::vector<RangeReference> ranges;
+    };
+
+    /**
+     * @brief 求值栈元素；range 不是 NO_RANGE 时表示未展开的范围
+     */
+    struct StackEntry {
+        FormulaValue value;
+        u32 range;
+    };
+
+    static constexpr u32 NO_RANGE = 0xFFFFFFFFu;
+
+    class Compiler;
+
     std::string formulaString_;
     FormulaError lastError_;
+    FormulaError compileError_ = FormulaError::None;     ///< 编译错误，每次计算都返回它
+    Program program_;
     std::vector<CellReference> dependencies_;
+    std::vector<RangeReference> rangeDependencies_;
     std::unordered_map<std::string, FormulaFunction> customFunctions_;
-    
+    std::vector<StackEntry> stack_;                      ///< 求值栈（跨计算复用）
+    std::vector<FormulaValue> args_;                     ///< 函数参数（跨计算复用）
+
     // Helper methods
-    void registerBuiltinFunctions();
-    FormulaValue evaluateExpression(const std::string& expr, const TXSheet* sheet, row_t currentRow, column_t currentCol);
-    std::vector<FormulaValue> parseArguments(const std::string& args, const TXSheet* sheet, row_t currentRow, column_t currentCol);
-    FormulaValue callFunction(const std::string& funcName, const std::vector<FormulaValue>& args);
-    void updateDependencies();
-    std::string replaceReferences(const std::string& expression, const TXSheet* sheet, row_t currentRow, column_t currentCol);
-    FormulaValue evaluateSimpleExpression(const std::string& expr);
+    void compile();
+    FormulaValue run(const TXCellManager& cells);
+    FormulaValue fail(FormulaError error);
 };
 
 } // namespace TinaXlsx 
@@ -5,14 +5,19 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include "TXCoordinate.hpp"
+#include "TXParallel.hpp"
 #include "TXRange.hpp"
+#include "TXRangeIndex.hpp"
 #include "TXTypes.hpp"
 
 namespace TinaXlsx {
 
 // 前向声明
 class TXCellManager;
+class TXCell;
 
 /**
  * @brief 公式管理器
@@ -24,6 +29,18 @@ class TXCellManager;
  * - 公式计算和更新
  * - 循环引用检测
  * - 命名范围管理
+ *
+ * 依赖关系保存为持久的正向（公式 -> 引用的单元格）和反向（单元格 -> 引用它的公式）
+ * 索引。范围引用不展开成单元格：相同的范围只保存一份，记录引用它的公式，并放入
+ * TXRangeIndex 空间索引，“哪些公式依赖单元格 X”按对数时间查询，整列引用也不占额外内存。
+ * 索引第一次使用时从已编译的公式建立，之后随 setCellFormula() 和 onCellChanged()
+ * 增量维护，并把受影响的公式标记为脏。recalculate() 只按拓扑顺序计算脏公式，
+ * 每个计算一次，修改一个输入的代价与受它影响的公式数量成正比。
+ * FormulaCalculationOptions::threadCount 大于 1 时按拓扑层并行计算：同一层的公式互不
+ * 依赖，在本对象持有的常驻线程池上对同一份只读的单元格数据求值，结果在整层算完后
+ * 按顺序写回。线程池在第一次并行计算时创建，逐层分发不再创建线程。
+ * 绕过本类修改公式或移动单元格后需要调用 invalidateDependencyIndex()，calculateAllFormulas()
+ * 总是重建索引。const 查询在索引无效时加锁重建，多个线程可以同时调用 const 查询。
  */
 class TXFormulaManager {
 public:
@@ -32,8 +49,9 @@ public:
      */
     struct CoordinateHash {
         std::size_t operator()(const TXCoordinate& coord) const {
-            return std::hash<u32>()(coord.getRow().index()) ^
-                (std::hash<u32>()(coord.getCol().index()) << 1);
+            // 与 TXCellManager::CoordinateHash 相同，稠密的公式区域不会聚集到少数桶中
+            const u64 key = (static_cast<u64>(coord.getRow().index()) << 32) | coord.getCol().index();
+            return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 16);
         }
     };
 
@@ -47,6 +65,7 @@ public:
         double maxChange = 0.001;                    ///< 最大变化值
         bool precisionAsDisplayed = false;           ///< 以显示精度计算
         bool use1904DateSystem = false;              ///< 使用1904日期系统
+        u32 threadCount = 1;                         ///< 重算线程数，1 为串行（确定的单线程路径），0 为硬件并发数
 
         /**
          * @brief 创建默认计算选项
@@ -135,6 +154,8 @@ public:
 
     /**
      * @brief 计算所有公式
+     *
+     * 先从单元格重建依赖索引，绕过本类设置的公式（如 TXSheet::getCell()->setFormula()）也会计算。
      * @param cellManager 单元格管理器
      * @return 成功计算的公式数量
      */
@@ -158,18 +179,48 @@ public:
 
     /**
      * @brief 重新计算依赖于指定单元格的所有公式
+     *
+     * 把直接和间接依赖它的公式标记为脏后执行 recalculate()。
      * @param coord 被依赖的单元格坐标
      * @param cellManager 单元格管理器
      * @return 重新计算的公式数量
      */
     std::size_t recalculateDependents(const TXCoordinate& coord, TXCellManager& cellManager);
 
+    /**
+     * @brief 按拓扑顺序计算所有脏公式，每个公式只计算一次
+     *
+     * 循环引用中的公式在其余公式之后各计算一次。threadCount 大于 1 时，公式较多的
+     * 拓扑层并行求值，结果与串行计算相同；循环引用中的公式始终串行计算。
+     * @param cellManager 单元格管理器
+     * @return 成功计算的公式数量
+     */
+    std::size_t recalculate(TXCellManager& cellManager);
+
+    /**
+     * @brief 通知单元格的值已改变，把直接和间接依赖它的公式标记为脏
+     * @param coord 改变的单元格坐标
+     */
+    void onCellChanged(const TXCoordinate& coord);
+
+    /**
+     * @brief 丢弃依赖索引（行列插入删除等批量移动单元格之后调用）
+     *
+     * 下次使用时重新建立索引，所有公式都视为脏。
+     */
+    void invalidateDependencyIndex();
+
+    /**
+     * @brief 获取已标记为脏、等待重新计算的公式数量（索引尚未建立时为 0）
+     */
+    std::size_t getDirtyFormulaCount() const { return dirty_.size(); }
+
     // ==================== 依赖关系分析 ====================
 
     /**
      * @brief 获取公式依赖关系图
      * @param cellManager 单元格管理器
-     * @return 依赖关系图
+     * @return 依赖关系图（只含单元格引用，范围引用见 getDirectRangeDependencies()）
      */
     DependencyGraph getFormulaDependencies(const TXCellManager& cellManager) const;
 
@@ -177,13 +228,22 @@ public:
      * @brief 获取单元格的直接依赖
      * @param coord 坐标
      * @param cellManager 单元格管理器
-     * @return 依赖的单元格列表
+     * @return 依赖的单元格列表（不含范围引用）
      */
     std::vector<TXCoordinate> getDirectDependencies(const TXCoordinate& coord, 
                                                    const TXCellManager& cellManager) const;
 
     /**
-     * @brief 获取依赖于指定单元格的所有单元格
+     * @brief 获取公式直接引用的范围
+     * @param coord 公式单元格坐标
+     * @param cellManager 单元格管理器
+     * @return 范围列表（不展开）
+     */
+    std::vector<TXRange> getDirectRangeDependencies(const TXCoordinate& coord,
+                                                    const TXCellManager& cellManager) const;
+
+    /**
+     * @brief 获取直接依赖于指定单元格的公式（包括通过范围引用依赖的）
      * @param coord 坐标
      * @param cellManager 单元格管理器
      * @return 依赖单元格列表
@@ -307,21 +367,64 @@ public:
     FormulaStats getFormulaStats(const TXCellManager& cellManager) const;
 
 private:
+    using CoordinateSet = std::unordered_set<TXCoordinate, CoordinateHash>;
+
     FormulaCalculationOptions options_;
     std::unordered_map<std::string, TXRange> namedRanges_;
 
     /**
-     * @brief 循环引用检测辅助方法
-     * @param coord 当前检查的坐标
-     * @param visiting 正在访问的坐标集合
-     * @param visited 已访问的坐标集合
-     * @param cellManager 单元格管理器
-     * @return 发现循环引用返回true
+     * @brief 被公式引用的一个范围（相同范围共用一个节点）
      */
-    bool detectCircularReferencesHelper(const TXCoordinate& coord,
-                                       std::unordered_set<TXCoordinate, CoordinateHash>& visiting,
-                                       std::unordered_set<TXCoordinate, CoordinateHash>& visited,
-                                       const TXCellManager& cellManager) const;
+    struct RangeNode {
+        TXRange range;
+        std::vector<TXCoordinate> formulas;     ///< 引用该范围的公式，为空表示节点空闲
+    };
+
+    struct RangeHash {
+        std::size_t operator()(const TXRange& range) const {
+            const CoordinateHash hash;
+            return hash(range.getStart()) ^ (hash(range.getEnd()) * 31);
+        }
+    };
+
+    // 依赖索引在 const 查询中按需建立，因此为 mutable；建立过程由 indexMutex_ 保护
+    mutable DependencyGraph precedents_;    ///< 公式单元格 -> 引用的单元格（去重，不含范围）
+    mutable DependencyGraph dependents_;    ///< 单元格 -> 直接引用它的公式单元格
+    mutable std::unordered_map<TXCoordinate, std::vector<u32>, CoordinateHash> formulaRanges_;  ///< 公式 -> 范围节点编号
+    mutable std::vector<RangeNode> rangeNodes_;
+    mutable std::vector<u32> freeRangeNodes_;
+    mutable std::unordered_map<TXRange, u32, RangeHash> rangeNodeIds_;
+    mutable TXRangeIndex rangeIndex_;       ///< 范围节点编号的空间索引
+    mutable CoordinateSet dirty_;           ///< 等待重新计算的公式，对“依赖”关系封闭
+    mutable bool indexValid_ = false;
+    std::unique_ptr<std::mutex> indexMutex_ = std::make_unique<std::mutex>();  ///< 放在堆上以保持可移动
+    std::unique_ptr<TXThreadPool> pool_;    ///< 并行重算的工作线程，第一次需要时创建，线程数改变时重建
+
+    /**
+     * @brief 索引无效时从单元格管理器中的公式重新建立，所有公式标记为脏
+     */
+    void ensureDependencyIndex(const TXCellManager& cellManager) const;
+
+    /**
+     * @brief 用公式单元格当前编译结果替换它在索引中的边
+     */
+    void indexFormula(const TXCoordinate& coord, const TXCell& cell) const;
+
+    /**
+     * @brief 从索引中删除公式单元格的边
+     */
+    void unindexFormula(const TXCoordinate& coord) const;
+
+    /**
+     * @brief 把依赖指定单元格的公式（传递闭包）标记为脏
+     */
+    void markDependentsDirty(const TXCoordinate& coord) const;
+
+    /**
+     * @brief 对每个直接依赖该单元格的公式调用 fn（同时通过多个引用依赖时会调用多次）
+     */
+    template <typename Fn>
+    void forEachDependent(const TXCoordinate& coord, Fn&& fn) const;
 
     /**
      * @brief 验证命名范围名称
@@ -334,32 +437,39 @@ private:
      * @brief 查找循环引用路径
      */
     bool findCircularReferencePath(const TXCoordinate& coord,
-                                  std::unordered_set<TXCoordinate, CoordinateHash>& visiting,
-                                  std::unordered_set<TXCoordinate, CoordinateHash>& visited,
-                                  std::vector<TXCoordinate>& path,
-                                  const TXCellManager& cellManager) const;
+                                  CoordinateSet& visiting,
+                                  CoordinateSet& visited,
+                                  std::vector<TXCoordinate>& path) const;
 
     /**
-     * @brief 获取计算顺序
+     * @brief 获取一组公式的计算顺序（Kahn 拓扑排序，只考虑组内的边）
+     * @param cells 要计算的公式单元格
+     * @param order 输出：逐层排列，每层只依赖前面的层，循环引用中的公式排在最后
+     * @param levels 可选输出：每层在 order 中的起始下标（不含循环引用部分）
+     * @return 不在循环引用中的公式数量
      */
-    std::vector<TXCoordinate> getCalculationOrder(const DependencyGraph& dependencies) const;
+    std::size_t getCalculationOrder(const CoordinateSet& cells, std::vector<TXCoordinate>& order,
+                                    std::vector<std::size_t>* levels = nullptr) const;
 
     /**
-     * @brief 拓扑排序
+     * @brief 按层并行计算 order 的前 acyclic 个公式，每层算完后统一写回
+     * @return 成功计算的公式数量
      */
-    void topologicalSort(const TXCoordinate& coord,
-                        const DependencyGraph& dependencies,
-                        std::unordered_set<TXCoordinate, CoordinateHash>& visited,
-                        std::unordered_set<TXCoordinate, CoordinateHash>& visiting,
-                        std::vector<TXCoordinate>& order) const;
+    std::size_t calculateLevels(const std::vector<TXCoordinate>& order, const std::vector<std::size_t>& levels,
+                                std::size_t acyclic, u32 threadCount, TXCellManager& cellManager);
 
     /**
-     * @brief 计算公式的实际实现
-     * @param formula 公式字符串
-     * @param cellManager 单元格管理器
-     * @return 计算结果
+     * @brief 取得线程数为 threadCount 的工作线程池，多次重算之间复用
+     */
+    TXThreadPool& workerPool(u32 threadCount);
+
+    /**
+     * @brief 计算公式单元格的结果但不写回
+     * @param result 输出：计算结果，出错时为错误值
+     * @return 计算过程中没有抛出异常返回 true
      */
-    cell_value_t evaluateFormula(const std::string& formula, const TXCellManager& cellManager) const;
+    static bool evaluateFormulaCell(TXCell& cell, const TXCoordinate& coord, const TXCellManager& cellManager,
+                                    cell_value_t& result);
 };
 
 } // namespace TinaXlsx
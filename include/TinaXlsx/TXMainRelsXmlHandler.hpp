@@ -6,7 +6,6 @@
 
 #include "TXXmlHandler.hpp"
 #include "TXXmlReader.hpp"
-#include "TXXmlWriter.hpp"
 
 namespace TinaXlsx
 {
@@ -21,52 +20,29 @@ namespace TinaXlsx
 
         TXResult<void> save(TXZipArchiveWriter& zipWriter, const TXWorkbookContext& context) override
         {
-            XmlNodeBuilder relationships("Relationships");
-            relationships.addAttribute("xmlns", "http://schemas.openxmlformats.org/package/2006/relationships");
+            TXXmlStreamWriter xml;
+            xml.declaration();
+            xml.startElement("Relationships")
+               .attribute("xmlns", "http://schemas.openxmlformats.org/package/2006/relationships");
 
             // 工作簿关系
-            relationships.addChild(XmlNodeBuilder("Relationship")
-                                   .addAttribute("Id", "rId1")
-                                   .addAttribute(
-                                       "Type",
-                                       "http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument")
-                                   .addAttribute("Target", "xl/workbook.xml"));
+            writeRelationship(xml, "rId1",
+                              "http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument",
+                              "xl/workbook.xml");
 
             // 文档属性（如果启用）
             if (context.componentManager.hasComponent(ExcelComponent::DocumentProperties))
             {
-                relationships.addChild(XmlNodeBuilder("Relationship")
-                                       .addAttribute("Id", "rId2")
-                                       .addAttribute(
-                                           "Type",
-                                           "http://schemas.openxmlformats.org/package/2006/relationships/metadata/core-properties")
-                                       .addAttribute("Target", "docProps/core.xml"));
-                relationships.addChild(XmlNodeBuilder("Relationship")
-                                       .addAttribute("Id", "rId3")
-                                       .addAttribute(
-                                           "Type",
-                                           "http://schemas.openxmlformats.org/officeDocument/2006/relationships/extended-properties")
-                                       .addAttribute("Target", "docProps/app.xml"));
+                writeRelationship(xml, "rId2",
+                                  "http://schemas.openxmlformats.org/package/2006/relationships/metadata/core-properties",
+                                  "docProps/core.xml");
+                writeRelationship(xml, "rId3",
+                                  "http://schemas.openxmlformats.org/officeDocument/2006/relationships/extended-properties",
+                                  "docProps/app.xml");
             }
 
-            TXXmlWriter writer;
-            auto setRootResult = writer.setRootNode(relationships);
-            if (setRootResult.isError()) {
-                return Err<void>(setRootResult.error().getCode(), "Failed to set root node: " + setRootResult.error().getMessage());
-            }
-            
-            auto xmlContentResult = writer.generateXmlString();
-            if (xmlContentResult.isError()) {
-                return Err<void>(xmlContentResult.error().getCode(), "Failed to generate XML: " + xmlContentResult.error().getMessage());
-            }
-            
-            std::vector<uint8_t> xmlData(xmlContentResult.value().begin(), xmlContentResult.value().end());
-            auto writeResult = zipWriter.write(std::string(partName()), xmlData);
-            if (writeResult.isError())
-            {
-                return Err<void>(writeResult.error().getCode(), "Failed to write " + std::string(partName()) + ": " + writeResult.error().getMessage());
-            }
-            return Ok();
+            xml.endElement("Relationships");
+            return writeXmlPart(zipWriter, xml);
         }
 
         std::string partName() const override
@@ -0,0 +1,56 @@
+//
+// @file TXMappedFile.hpp
+// @brief 只读内存映射文件
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "TXResult.hpp"
+
+namespace TinaXlsx
+{
+    /**
+     * @brief 只读内存映射文件
+     *
+     * 整个文件映射进地址空间，读取直接命中页缓存，不再额外复制到堆上。
+     * 映射地址在对象移动后保持不变，持有者可以安全地保存指向映射内存的指针。
+     */
+    class TXMappedFile
+    {
+    public:
+        TXMappedFile() = default;
+        ~TXMappedFile();
+
+        TXMappedFile(const TXMappedFile&) = delete;
+        TXMappedFile& operator=(const TXMappedFile&) = delete;
+
+        TXMappedFile(TXMappedFile&& other) noexcept;
+        TXMappedFile& operator=(TXMappedFile&& other) noexcept;
+
+        /**
+         * @brief 以只读方式映射文件，已有映射会先解除
+         * @param filename 文件路径
+         * @return 成功返回Ok，失败返回错误
+         */
+        TXResult<void> open(const std::string& filename);
+
+        /**
+         * @brief 解除映射
+         */
+        void close();
+
+        [[nodiscard]] bool isOpen() const { return data_ != nullptr; }
+        [[nodiscard]] const uint8_t* data() const { return data_; }
+        [[nodiscard]] std::size_t size() const { return size_; }
+
+    private:
+        const uint8_t* data_ = nullptr;
+        std::size_t size_ = 0;
+#ifdef _WIN32
+        void* mapping_ = nullptr; ///< 文件映射对象句柄
+#endif
+    };
+} // namespace TinaXlsx
@@ -248,6 +248,12 @@ public:
      */
     const std::string& getLastError() const;
 
+    /**
+     * @brief 获取修订号，合并区域每次变更时递增
+     * @return 修订号
+     */
+    std::size_t getRevision() const;
+
     // ==================== 行列调整操作 ====================
 
     /**
@@ -311,6 +317,8 @@ private:
     
     std::string lastError_;
 
+    std::size_t revision_ = 0;
+
     // ==================== 私有辅助方法 ====================
 
     /**
@@ -118,18 +118,29 @@ public:
      */
     static std::string formatInt64(int64_t value, const FormatOptions& options = {});
 
+    /// formatForExcelXml(double, char*) 要求的缓冲区大小
+    static constexpr std::size_t EXCEL_XML_NUMBER_BUFFER_SIZE = 32;
+
     /**
      * @brief 格式化数值为Excel XML兼容格式
      * 
      * 这个方法确保生成的数值格式与Excel筛选条件兼容：
      * - 整数：不带小数点（如 "3000"）
-     * - 小数：最小精度，移除尾随零（如 "123.45"）
+     * - 小数：能精确还原该 double 的最短表示，最多 17 位有效数字（如 "123.45"、"3.14159"）
      * 
      * @param value 要格式化的数值
      * @return Excel XML兼容的字符串
      */
     static std::string formatForExcelXml(double value);
 
+    /**
+     * @brief 按 formatForExcelXml(double) 的格式写入调用方的缓冲区，不分配内存
+     * @param value 要格式化的数值
+     * @param buffer 至少 EXCEL_XML_NUMBER_BUFFER_SIZE 字节的缓冲区，不写结尾的 '\0'
+     * @return 写入的字符数
+     */
+    static std::size_t formatForExcelXml(double value, char* buffer);
+
     // ==================== 工具方法 ====================
 
     /**
@@ -0,0 +1,84 @@
+//
+// @file TXNumericKernels.hpp
+// @brief 连续 double 数组上的聚合计算（SIMD，运行时选择指令集）
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include "TXTypes.hpp"
+
+namespace TinaXlsx {
+
+/**
+ * @brief 聚合的中间结果：总和、数量、最小值、最大值
+ *
+ * 一次遍历同时得到 SUM / AVERAGE / COUNT / MIN / MAX 需要的全部信息，
+ * 多段数据的结果可以依次累加。与总和一样，任何一个值为 NaN 时最小值和最大值也是 NaN。
+ */
+struct TXNumericAccumulator {
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    std::size_t count = 0;
+
+    void add(double value) {
+        sum += value;
+        addBounds(value, value);
+        ++count;
+    }
+
+    /**
+     * @brief 合并一段数据的最小值和最大值（NaN 传播，与合并顺序无关）
+     */
+    void addBounds(double low, double high) {
+        min = (std::isnan(min) || min <= low) ? min : low;
+        max = (std::isnan(max) || max >= high) ? max : high;
+    }
+};
+
+/**
+ * @brief 聚合内核
+ *
+ * 输入是单元格存储中的原始数据块：一段连续的 double 和等长的类型标记，只有标记等于
+ * 指定值的元素参与计算（其余位置的 double 是未使用的旧值）。x86 上按 CPUID 选择 AVX2、
+ * SSE2 或标量实现，其他平台使用标量实现。向量实现分多路累加，总和的舍入可能与逐个
+ * 相加略有不同。
+ */
+class TXNumericKernels {
+public:
+    enum class Level : u8 {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    /**
+     * @brief 当前 CPU 支持的最高实现（第一次调用时检测）
+     */
+    static Level detectLevel();
+
+    /**
+     * @brief 把 tags[i] == tag 的 values[i] 累加到 acc
+     * @param values 数值数组
+     * @param tags 类型标记数组
+     * @param tag 参与计算的标记值
+     * @param count 元素数量
+     * @param acc 累加结果
+     */
+    static void accumulate(const double* values, const u8* tags, u8 tag, std::size_t count,
+                           TXNumericAccumulator& acc) {
+        accumulate(detectLevel(), values, tags, tag, count, acc);
+    }
+
+    /**
+     * @brief 使用指定实现累加（level 高于 CPU 支持时降级），用于测试和对比
+     */
+    static void accumulate(Level level, const double* values, const u8* tags, u8 tag, std::size_t count,
+                           TXNumericAccumulator& acc);
+};
+
+} // namespace TinaXlsx
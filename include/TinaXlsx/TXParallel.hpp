@@ -0,0 +1,209 @@
+//
+// @file TXParallel.hpp
+// @brief 简单的并行执行工具
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TXTypes.hpp"
+
+namespace TinaXlsx
+{
+    /**
+     * @brief 并行执行工具
+     *
+     * 任务按编号动态分配给工作线程，调用线程本身也参与执行，
+     * 所有任务结束后才返回。任务抛出的第一个异常在返回前重新抛出。
+     */
+    class TXParallel
+    {
+    public:
+        /**
+         * @brief 解析线程数：0 表示使用硬件并发数
+         */
+        static u32 resolveThreadCount(u32 threadCount) {
+            if (threadCount == 0) {
+                threadCount = std::max(1u, std::thread::hardware_concurrency());
+            }
+            return threadCount;
+        }
+
+        /**
+         * @brief 对 [0, count) 中的每个编号调用 fn(index)
+         * @param count 任务数量
+         * @param threadCount 最大线程数（含调用线程），0 表示硬件并发数
+         * @param fn 任务函数，不同编号可能在不同线程上并发执行
+         */
+        template <typename Fn>
+        static void forEach(std::size_t count, u32 threadCount, Fn&& fn) {
+            const std::size_t workers = std::min<std::size_t>(resolveThreadCount(threadCount), count);
+            if (workers <= 1) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    fn(i);
+                }
+                return;
+            }
+
+            std::atomic<std::size_t> next{0};
+            std::exception_ptr firstError;
+            std::mutex errorMutex;
+            auto run = [&]() {
+                for (std::size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                    try {
+                        fn(i);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(errorMutex);
+                        if (!firstError) {
+                            firstError = std::current_exception();
+                        }
+                    }
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(workers - 1);
+            for (std::size_t t = 1; t < workers; ++t) {
+                threads.emplace_back(run);
+            }
+            run();
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            if (firstError) {
+                std::rethrow_exception(firstError);
+            }
+        }
+    };
+
+    /**
+     * @brief 常驻工作线程的线程池
+     *
+     * 与 TXParallel::forEach() 的语义相同，但工作线程在构造时创建、析构时回收，
+     * 适合短时间内多次分发小批任务的场景（例如公式按拓扑层逐层计算），
+     * 避免每次分发都创建和回收线程。同一时间只能有一个线程调用 forEach()。
+     */
+    class TXThreadPool
+    {
+    public:
+        /**
+         * @param threadCount 线程数（含调用线程），0 表示硬件并发数
+         */
+        explicit TXThreadPool(u32 threadCount) {
+            const u32 total = TXParallel::resolveThreadCount(threadCount);
+            workers_.reserve(total - 1);
+            for (u32 t = 1; t < total; ++t) {
+                workers_.emplace_back([this]() { workerLoop(); });
+            }
+        }
+
+        ~TXThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (auto& worker : workers_) {
+                worker.join();
+            }
+        }
+
+        TXThreadPool(const TXThreadPool&) = delete;
+        TXThreadPool& operator=(const TXThreadPool&) = delete;
+
+        /**
+         * @brief 线程数（含调用线程）
+         */
+        u32 threadCount() const { return static_cast<u32>(workers_.size()) + 1; }
+
+        /**
+         * @brief 对 [0, count) 中的每个编号调用 fn(index)，调用线程也参与执行，全部结束后返回
+         * @param count 任务数量
+         * @param fn 任务函数，不同编号可能在不同线程上并发执行
+         */
+        template <typename Fn>
+        void forEach(std::size_t count, Fn&& fn) {
+            if (workers_.empty() || count <= 1) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    fn(i);
+                }
+                return;
+            }
+
+            std::atomic<std::size_t> next{0};
+            std::exception_ptr firstError;
+            std::mutex errorMutex;
+            const std::function<void()> run = [&]() {
+                for (std::size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                    try {
+                        fn(i);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(errorMutex);
+                        if (!firstError) {
+                            firstError = std::current_exception();
+                        }
+                    }
+                }
+            };
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                job_ = &run;
+                busy_ = workers_.size();
+                ++generation_;
+            }
+            wake_.notify_all();
+            run();
+            {
+                // 每个工作线程都执行过本轮任务后 run 才能销毁
+                std::unique_lock<std::mutex> lock(mutex_);
+                done_.wait(lock, [this]() { return busy_ == 0; });
+                job_ = nullptr;
+            }
+            if (firstError) {
+                std::rethrow_exception(firstError);
+            }
+        }
+
+    private:
+        void workerLoop() {
+            u64 seen = 0;
+            for (;;) {
+                const std::function<void()>* job = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    wake_.wait(lock, [&]() { return stopping_ || generation_ != seen; });
+                    if (stopping_) {
+                        return;
+                    }
+                    seen = generation_;
+                    job = job_;
+                }
+                (*job)();
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (--busy_ == 0) {
+                        done_.notify_one();
+                    }
+                }
+            }
+        }
+
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable wake_;          ///< 有新任务或正在析构
+        std::condition_variable done_;          ///< 本轮所有工作线程都已完成
+        const std::function<void()>* job_ = nullptr;
+        std::size_t busy_ = 0;                  ///< 本轮尚未完成的工作线程数
+        u64 generation_ = 0;                    ///< 每次分发加一，工作线程据此识别新任务
+        bool stopping_ = false;
+    };
+} // namespace TinaXlsx
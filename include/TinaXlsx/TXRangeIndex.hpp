@@ -0,0 +1,134 @@
+//
+// @file TXRangeIndex.hpp
+// @brief 范围的空间索引：查询包含某个单元格的所有范围
+//
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "TXTypes.hpp"
+#include "TXCoordinate.hpp"
+#include "TXRange.hpp"
+
+namespace TinaXlsx {
+
+/**
+ * @brief 按编号保存范围，回答“哪些范围包含单元格 X”
+ *
+ * 主体是按 STR（Sort-Tile-Recursive）方法打包的静态 R 树：范围按中心点分成列条带，
+ * 条带内按行排序，每 NODE_SIZE 个组成一个节点，逐层计算包围盒。查询只下降到包围盒
+ * 包含该单元格的节点，代价与树高（对数）和命中数成正比，不需要展开范围内的单元格。
+ *
+ * 新插入的范围先放在未索引的尾部线性扫描，删除只在树中留下墓碑；尾部超过已索引
+ * 数量的平方根或墓碑超过一半时，在下一次查询前重新打包。因此批量插入不会反复重建。
+ * 查询可能触发重建，不能与修改或其他查询并发。
+ */
+class TXRangeIndex {
+public:
+    static constexpr u32 NODE_SIZE = 16;
+
+    /**
+     * @brief 添加范围，编号已存在时替换原来的范围
+     * @param id 调用方分配的编号（应尽量紧凑，内部按编号建立位置表）
+     * @param range 范围
+     */
+    void insert(u32 id, const TXRange& range);
+
+    /**
+     * @brief 删除编号对应的范围，不存在时什么也不做
+     */
+    void erase(u32 id);
+
+    /**
+     * @brief 删除所有范围
+     */
+    void clear();
+
+    /**
+     * @brief 范围数量
+     */
+    [[nodiscard]] std::size_t size() const { return live_; }
+
+    [[nodiscard]] bool empty() const { return live_ == 0; }
+
+    /**
+     * @brief 对每个包含该单元格的范围调用 fn(id)，顺序不确定
+     */
+    template <typename Fn>
+    void forEachContaining(const TXCoordinate& cell, Fn&& fn) const {
+        if (live_ == 0) {
+            return;
+        }
+        if (needsRebuild()) {
+            rebuild();
+        }
+        const u32 row = cell.getRow().index();
+        const u32 col = cell.getCol().index();
+        if (!levels_.empty()) {
+            visit(levels_.size() - 1, 0, row, col, fn);
+        }
+        for (std::size_t i = indexed_; i < entries_.size(); ++i) {
+            if (entries_[i].box.contains(row, col)) {
+                fn(entries_[i].id);
+            }
+        }
+    }
+
+private:
+    static constexpr u32 NONE = 0xFFFFFFFFu;
+
+    struct Box {
+        u32 top = 0;
+        u32 left = 0;
+        u32 bottom = 0;
+        u32 right = 0;
+
+        [[nodiscard]] bool contains(u32 row, u32 col) const {
+            return row >= top && row <= bottom && col >= left && col <= right;
+        }
+    };
+
+    struct Entry {
+        Box box;
+        u32 id;     ///< 墓碑为 NONE
+    };
+
+    // 查询时按需重新打包，因此为 mutable
+    mutable std::vector<Entry> entries_;              ///< [0, indexed_) 按树的叶子顺序排列，其后为尾部
+    mutable std::vector<std::vector<Box>> levels_;    ///< levels_[0] 为叶子节点的包围盒，最后一层只有根
+    mutable std::vector<u32> positions_;              ///< 编号 -> entries_ 下标
+    mutable std::size_t indexed_ = 0;
+    mutable std::size_t tombstones_ = 0;
+    std::size_t live_ = 0;
+
+    [[nodiscard]] bool needsRebuild() const {
+        const std::size_t tail = entries_.size() - indexed_;
+        return (tail > 32 && tail * tail > indexed_) || tombstones_ * 2 > indexed_ + 64;
+    }
+
+    void rebuild() const;
+
+    template <typename Fn>
+    void visit(std::size_t level, std::size_t node, u32 row, u32 col, Fn& fn) const {
+        if (!levels_[level][node].contains(row, col)) {
+            return;
+        }
+        const std::size_t first = node * NODE_SIZE;
+        if (level == 0) {
+            const std::size_t last = std::min(first + NODE_SIZE, indexed_);
+            for (std::size_t i = first; i < last; ++i) {
+                if (entries_[i].id != NONE && entries_[i].box.contains(row, col)) {
+                    fn(entries_[i].id);
+                }
+            }
+            return;
+        }
+        const std::size_t last = std::min(first + NODE_SIZE, levels_[level - 1].size());
+        for (std::size_t child = first; child < last; ++child) {
+            visit(level - 1, child, row, col, fn);
+        }
+    }
+};
+
+} // namespace TinaXlsx
@@ -220,6 +220,11 @@ public:
      */
     void clear();
 
+    /**
+     * @brief 修订号，行高、列宽、隐藏状态改变或插入删除行列时增大
+     */
+    std::size_t getRevision() const { return revision_; }
+
 private:
     // 存储自定义的行高和列宽
     std::unordered_map<row_t::index_t, double> rowHeights_;
@@ -228,6 +233,7 @@ private:
     // 存储隐藏状态
     std::unordered_map<row_t::index_t, bool> hiddenRows_;
     std::unordered_map<column_t::index_t, bool> hiddenColumns_;
+    std::size_t revision_ = 0;
 
     // 默认值
     static constexpr double DEFAULT_ROW_HEIGHT = 15.0;
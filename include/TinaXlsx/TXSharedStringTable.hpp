@@ -0,0 +1,150 @@
+//
+// @file TXSharedStringTable.hpp
+// @brief 紧凑共享字符串表 - 单块字符区 + 偏移数组，按索引 O(1) 取值
+//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "TXTypes.hpp"
+#include "TXResult.hpp"
+#include "TXXmlSaxParser.hpp"
+
+namespace TinaXlsx {
+
+/**
+ * @brief 只追加的共享字符串表
+ *
+ * 所有字符串首尾相接存放在一块连续字符区中，第 i 个字符串为
+ * [offsets[i], offsets[i+1])。与 vector<string> 相比，每个字符串只多占 4 字节，
+ * 没有独立的堆分配。字符区总大小上限为 4 GiB。
+ * 加载完成后只读，多个线程可以不加锁地同时按索引取值。
+ */
+class TXSharedStringTable {
+public:
+    TXSharedStringTable() : offsets_{0} {}
+
+    /**
+     * @brief 预留容量
+     * @param count 字符串个数（通常来自 sst 的 uniqueCount）
+     * @param bytes 字符总字节数（未知时为 0）
+     */
+    void reserve(std::size_t count, std::size_t bytes = 0) {
+        offsets_.reserve(count + 1);
+        if (bytes > 0) {
+            data_.reserve(bytes);
+        }
+    }
+
+    /**
+     * @brief 追加一个完整字符串
+     * @return 新字符串的索引
+     */
+    u32 append(std::string_view text) {
+        appendPart(text);
+        return commit();
+    }
+
+    /**
+     * @brief 向尚未结束的字符串追加一段（富文本分段时使用）
+     */
+    void appendPart(std::string_view text) {
+        data_.append(text.data(), text.size());
+    }
+
+    /**
+     * @brief 结束当前字符串
+     * @return 该字符串的索引
+     */
+    u32 commit() {
+        offsets_.push_back(static_cast<u32>(data_.size()));
+        return static_cast<u32>(offsets_.size() - 2);
+    }
+
+    /**
+     * @brief 按索引取字符串，索引必须小于 size()
+     */
+    std::string_view get(u32 index) const {
+        return std::string_view(data_.data() + offsets_[index], offsets_[index + 1] - offsets_[index]);
+    }
+
+    std::string_view operator[](u32 index) const { return get(index); }
+
+    /**
+     * @brief 索引有效时取出字符串
+     * @param index 索引
+     * @param out 输出字符串视图
+     * @return 索引是否有效
+     */
+    bool tryGet(u32 index, std::string_view& out) const {
+        if (index >= size()) {
+            return false;
+        }
+        out = get(index);
+        return true;
+    }
+
+    std::size_t size() const { return offsets_.size() - 1; }
+    bool empty() const { return offsets_.size() == 1; }
+
+    /**
+     * @brief 清空（保留已分配的容量）
+     */
+    void clear() {
+        data_.clear();
+        offsets_.resize(1);
+    }
+
+    /**
+     * @brief 占用的堆内存（字节）
+     */
+    std::size_t memoryUsage() const {
+        return data_.capacity() + offsets_.capacity() * sizeof(u32);
+    }
+
+    /**
+     * @brief 流式解析 sharedStrings.xml 并追加到本表
+     * @param xml 完整的 XML 内容
+     * @return TXResult<void> 操作结果
+     */
+    TXResult<void> load(std::string_view xml);
+
+private:
+    std::string data_;
+    std::vector<u32> offsets_;
+};
+
+/**
+ * @brief sharedStrings.xml 的 SAX 处理器，按块喂给 TXXmlSaxParser 即可填充字符串表
+ *
+ * 富文本 <r> 各段的 <t> 依次拼接，注音 <rPh> 被忽略；
+ * 根元素的 uniqueCount 用于预留偏移数组。
+ */
+class TXSharedStringsSaxHandler : public TXXmlSaxHandler {
+public:
+    /**
+     * @param table 目标字符串表
+     * @param inputSize 文档字节数（未知时为 0），用于限制按 uniqueCount 预留的容量
+     */
+    explicit TXSharedStringsSaxHandler(TXSharedStringTable& table, std::size_t inputSize = 0)
+        : table_(table), inputSize_(inputSize) {}
+
+    void onStartElement(std::string_view name, const TXXmlSaxAttributes& attributes) override;
+    void onEndElement(std::string_view name) override;
+    void onText(std::string_view text) override;
+
+private:
+    // uniqueCount 来自文件，不可信：最短的条目 <si/> 占 5 字节，文档大小未知时最多预留 MAX_RESERVE 个
+    static constexpr std::size_t MIN_ITEM_BYTES = 5;
+    static constexpr std::size_t MAX_RESERVE = 1u << 16;
+
+    TXSharedStringTable& table_;
+    std::size_t inputSize_;
+    bool inItem_ = false;
+    bool inPhonetic_ = false;
+    bool capture_ = false;
+};
+
+} // namespace TinaXlsx
@@ -4,54 +4,124 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <memory>
+#include <string_view>
 #include <vector>
 #include "TXTypes.hpp"
+#include "TXSharedStringTable.hpp"
 
 namespace TinaXlsx
 {
+    /**
+     * @brief 保存时使用的共享字符串池
+     *
+     * 字符串字节只在分块内存区中存一份，按添加顺序以 string_view 索引；
+     * 去重使用开放寻址（线性探测）哈希表，槽位只保存哈希值和索引，
+     * 命中时只需一次探测序列即可返回。分块不会移动，因此 getStrings()
+     * 返回的视图在 reset() 之前一直有效（移动整个池也不会失效）。
+     */
     class TXSharedStringsPool {
     public:
+        TXSharedStringsPool() = default;
+        TXSharedStringsPool(TXSharedStringsPool&& other) noexcept;
+        TXSharedStringsPool& operator=(TXSharedStringsPool&& other) noexcept;
+        TXSharedStringsPool(const TXSharedStringsPool&) = delete;
+        TXSharedStringsPool& operator=(const TXSharedStringsPool&) = delete;
+
         // 添加字符串并返回索引
-        u32 add(const std::string& str) {
-            // 尝试在唯一字符串表中查找
-            if (auto it = m_uniqueIndexMap.find(str); it != m_uniqueIndexMap.end()) {
-                m_frequencyMap[str]++;
-                return it->second;
-            }
-        
-            // 新字符串 - 添加到池
-            const u32 newIndex = static_cast<u32>(m_strings.size());
-            m_strings.push_back(str);
-            m_uniqueIndexMap[str] = newIndex;
-            m_frequencyMap[str] = 1;
-            m_dirty = true;
-        
-            return newIndex;
-        }
-    
+        u32 add(std::string_view str) {
+            return add(str, hash(str));
+        }
+
+        // 使用调用方预先计算的哈希（必须来自 hash()）添加字符串并返回索引
+        u32 add(std::string_view str, std::size_t hashValue);
+
+        // 按顺序追加字符串，不去重，返回值总是追加前的 size()。
+        // 用于按原有 sst 的顺序预置字符串，保证已有索引不变；重复的字符串 add() 命中第一个
+        u32 append(std::string_view str);
+
+        // 计算 add()/find() 使用的哈希值
+        [[nodiscard]] static std::size_t hash(std::string_view str) noexcept {
+            return std::hash<std::string_view>{}(str);
+        }
+
+        // 查找字符串，存在时写出索引
+        [[nodiscard]] bool find(std::string_view str, u32& index) const;
+
         // 获取所有字符串（按添加顺序）
-        [[nodiscard]] const std::vector<std::string>& getStrings() const { 
-            return m_strings; 
+        [[nodiscard]] const std::vector<std::string_view>& getStrings() const {
+            return m_strings;
         }
-    
-        // 检查是否需要写入XML
-        [[nodiscard]] bool isDirty() const { 
-            return m_dirty; 
+
+        // 按索引获取字符串
+        [[nodiscard]] std::string_view get(u32 index) const {
+            return m_strings[index];
+        }
+
+        // 唯一字符串数量
+        [[nodiscard]] std::size_t size() const {
+            return m_strings.size();
         }
-    
-        // 重置状态
-        void reset() {
-            m_strings.clear();
-            m_uniqueIndexMap.clear();
-            m_frequencyMap.clear();
-            m_dirty = false;
+
+        // 预留唯一字符串数量，避免保存大表时反复扩容
+        void reserve(std::size_t count);
+
+        // 开启或关闭出现次数统计（默认关闭）。开启前已加入的字符串按出现 1 次计
+        void setFrequencyTracking(bool enabled);
+
+        [[nodiscard]] bool isFrequencyTrackingEnabled() const {
+            return m_trackFrequency;
         }
 
+        // 获取字符串的出现次数，未开启统计时返回 0
+        [[nodiscard]] u32 getFrequency(u32 index) const {
+            return m_trackFrequency && index < m_frequencies.size() ? m_frequencies[index] : 0;
+        }
+
+        // 设置从文件加载的共享字符串表（工作表加载时按索引解析 t="s" 单元格）
+        void setLoadedStrings(TXSharedStringTable&& table) {
+            m_loadedStrings = std::move(table);
+        }
+
+        // 获取从文件加载的共享字符串表
+        [[nodiscard]] const TXSharedStringTable& getLoadedStrings() const {
+            return m_loadedStrings;
+        }
+
+        // 检查是否需要写入XML
+        [[nodiscard]] bool isDirty() const {
+            return m_dirty;
+        }
+
+        // 占用的堆内存（字节，不含加载的字符串表）
+        [[nodiscard]] std::size_t memoryUsage() const;
+
+        // 重置状态（频率统计开关和加载的字符串表保持不变）
+        void reset();
+
     private:
-        std::vector<std::string> m_strings;              // 按顺序存储的字符串
-        std::unordered_map<std::string, u32> m_uniqueIndexMap; // 字符串到索引的映射
-        std::unordered_map<std::string, int> m_frequencyMap;   // 字符串频率统计
+        static constexpr std::size_t ARENA_CHUNK_SIZE = 64 * 1024;   // 分块大小
+        static constexpr u32 EMPTY_SLOT = 0xFFFFFFFFu;
+
+        struct Slot {
+            u32 hash = 0;             // 哈希值低 32 位，探测时先比较它再比较内容
+            u32 index = EMPTY_SLOT;   // 字符串索引
+        };
+
+        std::string_view storeBytes(std::string_view str);
+        void rehash(std::size_t slotCount);
+
+        std::vector<std::unique_ptr<char[]>> m_chunks;   // 字符串字节所在的分块
+        char* m_chunkCursor = nullptr;                   // 当前分块的空闲位置
+        std::size_t m_chunkRemaining = 0;                // 当前分块剩余字节
+        std::size_t m_arenaBytes = 0;                    // 已分配的分块总字节
+
+        std::vector<std::string_view> m_strings;         // 按顺序存储的字符串
+        std::vector<Slot> m_slots;                       // 开放寻址表，大小为 2 的幂
+        std::vector<u32> m_frequencies;                  // 出现次数（仅在开启统计时维护）
+        bool m_trackFrequency = false;
+
+        TXSharedStringTable m_loadedStrings;             // 从文件加载的字符串（只读）
         bool m_dirty = false;                            // 是否有未保存更改
     };
 }
@@ -5,9 +5,9 @@
 #pragma once
 
 #include "TXSharedStringsPool.hpp"
+#include "TXSharedStringTable.hpp"
+#include "TXXmlSaxParser.hpp"
 #include "TXXmlHandler.hpp"
-#include "TXXmlReader.hpp"
-#include "TXXmlWriter.hpp"
 #include "TXComponentManager.hpp"
 
 namespace TinaXlsx
@@ -15,80 +15,78 @@ namespace TinaXlsx
     class TXSharedStringsXmlHandler : public TXXmlHandler
     {
     public:
+        /**
+         * @brief 流式解析共享字符串表并存入 sharedStringsPool，供工作表加载时按索引解析
+         */
         TXResult<void> load(TXZipArchiveReader& zipReader, TXWorkbookContext& context) override
         {
-            auto xmlData = zipReader.read(partName());
-            if (xmlData.isError())
-            {
-                return Err<void>(xmlData.error().getCode(), "Failed to read " + partName());
-            }
-            
-            std::string xmlContent(xmlData.value().begin(), xmlData.value().end());
-            TXXmlReader reader;
-            auto parseResult = reader.parseFromString(xmlContent);
-            if (parseResult.isError())
-            {
-                return Err<void>(parseResult.error().getCode(), "Failed to parse sharedStrings.xml: " + parseResult.error().getMessage());
-            }
+            TXSharedStringTable table;
+            TXSharedStringsSaxHandler handler(table);
+            TXXmlSaxParser parser(handler);
 
-            // 解析共享字符串
-            auto siNodesResult = reader.findNodes("//si/t");
-            if (siNodesResult.isError())
+            // 边解压边解析，不保留整个文档
+            bool parseFailed = false;
+            auto streamResult = zipReader.readStream(partName(), [&](const uint8_t* data, std::size_t size) {
+                auto feedResult = parser.feed(reinterpret_cast<const char*>(data), size);
+                parseFailed = feedResult.isError();
+                return feedResult;
+            });
+            if (streamResult.isOk())
             {
-                return Err<void>(siNodesResult.error().getCode(), "Failed to find shared string nodes: " + siNodesResult.error().getMessage());
+                streamResult = parser.finish();
+                parseFailed = streamResult.isError();
             }
-            
-            std::vector<std::string> sharedStrings;
-            sharedStrings.reserve(siNodesResult.value().size());
-            for (const auto& siNode : siNodesResult.value())
+            if (streamResult.isError())
             {
-                sharedStrings.push_back(siNode.value);
+                if (parseFailed)
+                {
+                    return Err<void>(streamResult.error().getCode(), "Failed to parse sharedStrings.xml: " + streamResult.error().getMessage());
+                }
+                return Err<void>(streamResult.error().getCode(), "Failed to read " + partName());
             }
-            // 假设 TXStyleManager 或其他组件需要存储共享字符串
+
+            context.sharedStringsPool.setLoadedStrings(std::move(table));
             return Ok();
         }
 
         TXResult<void> save(TXZipArchiveWriter& zipWriter, const TXWorkbookContext& context) override
         {
-            // 获取共享字符串池中的字符串
+            // 获取共享字符串池中的字符串。组件已注册时 workbook.xml.rels 和
+            // [Content_Types].xml 都会引用本部件，因此没有字符串也要写出空的 sst
             const auto& strings = context.sharedStringsPool.getStrings();
-            
-            // 如果没有字符串或共享字符串池不是dirty状态，则不生成文件
-            if (strings.empty() || !context.sharedStringsPool.isDirty()) {
-                return Ok();  // 跳过空池或未修改的池
+
+            // 字符串数量可能很大，边生成边压缩写入条目
+            auto openResult = zipWriter.openEntry(partName());
+            if (openResult.isError()) {
+                return Err<void>(openResult.error().getCode(), "Failed to write " + partName() + ": " + openResult.error().getMessage());
             }
-            
-            // 生成 XML
-            XmlNodeBuilder sst("sst");
-            sst.addAttribute("xmlns", "http://schemas.openxmlformats.org/spreadsheetml/2006/main")
-               .addAttribute("count", std::to_string(strings.size()))
-               .addAttribute("uniqueCount", std::to_string(strings.size()));
+
+            TXZipEntrySink sink(zipWriter);
+            TXXmlStreamWriter xml(&sink);
+            xml.declaration();
+            // count 是单元格对字符串的引用总数，直接复制的工作表中的引用无法统计，
+            // 该属性可选，因此不写出，只写去重后的 uniqueCount
+            xml.startElement("sst")
+               .attribute("xmlns", "http://schemas.openxmlformats.org/spreadsheetml/2006/main")
+               .attribute("uniqueCount", strings.size());
 
             for (const auto& str : strings)
             {
-                XmlNodeBuilder si("si");
-                si.addChild(XmlNodeBuilder("t").setText(str));
-                sst.addChild(si);
+                xml.startElement("si").startElement("t");
+                if (TXXmlStreamWriter::needsSpacePreserve(str)) {
+                    xml.attributeRaw("xml:space", "preserve");
+                }
+                xml.text(str).endElement("t").endElement("si");
             }
+            xml.endElement("sst");
 
-            TXXmlWriter writer;
-            auto setRootResult = writer.setRootNode(sst);
-            if (setRootResult.isError())
-            {
-                return Err<void>(setRootResult.error().getCode(), "Failed to set root node: " + setRootResult.error().getMessage());
+            auto flushResult = xml.flush();
+            auto closeResult = zipWriter.closeEntry();
+            if (flushResult.isError()) {
+                return Err<void>(flushResult.error().getCode(), "Failed to write " + partName() + ": " + flushResult.error().getMessage());
             }
-            
-            auto xmlContentResult = writer.generateXmlString();
-            if (xmlContentResult.isError())
-            {
-                return Err<void>(xmlContentResult.error().getCode(), "Failed to generate XML: " + xmlContentResult.error().getMessage());
-            }
-            
-            std::vector<uint8_t> xmlData(xmlContentResult.value().begin(), xmlContentResult.value().end());
-            auto writeResult = zipWriter.write(std::string(partName()), xmlData);
-            if (writeResult.isError())
-            {
-                return Err<void>(writeResult.error().getCode(), "Failed to write " + std::string(partName()) + ": " + writeResult.error().getMessage());
+            if (closeResult.isError()) {
+                return Err<void>(closeResult.error().getCode(), "Failed to write " + partName() + ": " + closeResult.error().getMessage());
             }
             return Ok();
         }
@@ -328,6 +328,15 @@ public:
      */
     std::size_t calculateAllFormulas();
 
+    /**
+     * @brief 只重新计算受修改影响的公式
+     *
+     * 通过 setCellValue() 和 setCellFormula() 的修改会把依赖它们的公式标记为脏，
+     * 这里按依赖顺序计算这些公式，每个只计算一次。
+     * @return 成功计算的公式数量
+     */
+    std::size_t recalculateFormulas();
+
     /**
      * @brief 计算指定范围内的公式
      * @param range 范围
@@ -850,6 +859,28 @@ public:
     */
     TXWorkbook* getWorkbook() const { return workbook_; }
 
+    // ==================== 修改跟踪 ====================
+
+    /**
+     * @brief 工作表自加载后是否被修改过
+     *
+     * 修改单元格、格式、合并区域、行列等都会置位，包括直接调用管理器的修改方法，以及
+     * 通过 getCell() 等返回的指针修改单元格；只读取不算修改。增量保存时未修改的工作表
+     * 直接复制源文件中的压缩数据。
+     * @return 修改过返回true，否则返回false
+     */
+    bool isModified() const;
+
+    /**
+     * @brief 标记工作表已修改
+     */
+    void markModified();
+
+    /**
+     * @brief 清除修改标记（工作簿加载或保存完成后调用），之后的修改重新开始跟踪
+     */
+    void clearModified();
+
     // ==================== 管理器访问接口（高级用法）====================
 
     /**
@@ -893,6 +924,8 @@ private:
     std::string name_;                              ///< 工作表名称
     TXWorkbook* workbook_ = nullptr;                ///< 父工作簿指针
     mutable std::string lastError_;                 ///< 最后的错误信息
+    mutable bool modified_ = true;                  ///< 自加载后是否修改过，新建的工作表视为已修改
+    std::size_t cleanRevision_ = 0;                 ///< clearModified() 时各管理器修订号之和
 
     // ==================== 管理器组件 ====================
     TXCellManager cellManager_;                     ///< 单元格管理器
@@ -1004,7 +1037,7 @@ private:
     void clearError() const { lastError_.clear(); }
 
     /**
-     * @brief 通知组件变化
+     * @brief 通知组件变化，同时标记工作表已修改
      * @param component 变化的组件
      */
     void notifyComponentChange(ExcelComponent component) const;
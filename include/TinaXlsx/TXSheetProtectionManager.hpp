@@ -261,8 +261,14 @@ public:
      */
     void reset();
 
+    /**
+     * @brief 获取修订号，保护设置每次变更时递增
+     */
+    std::size_t getRevision() const { return revision_; }
+
 private:
     SheetProtection protection_;
+    std::size_t revision_ = 0;
 
     /**
      * @brief 生成密码哈希
@@ -0,0 +1,149 @@
+//
+// @file TXSheetReader.hpp
+// @brief 只进的逐行读取器 - 不经过 TXCellManager，内存占用与行数无关
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "TXResult.hpp"
+#include "TXTypes.hpp"
+
+namespace TinaXlsx {
+
+/**
+ * @brief 单元格视图
+ *
+ * text 指向读取器内部的共享字符串表或行缓冲区，
+ * 只在下一次调用 TXSheetReader::nextRow() 之前有效。
+ */
+struct TXCellView {
+    enum class Type : u8 {
+        Empty,    ///< 无值（例如只有样式）
+        Number,   ///< 数值
+        Boolean,  ///< 布尔值
+        String,   ///< 字符串（共享字符串、内联字符串或公式字符串结果）
+        Error     ///< 错误值，如 #DIV/0!
+    };
+
+    column_t::index_t column = 0; ///< 列号（从1开始）
+    Type type = Type::Empty;
+    double number = 0.0;          ///< Number 类型的值
+    bool boolean = false;         ///< Boolean 类型的值
+    std::string_view text;        ///< String / Error 类型的值
+    u32 styleIndex = 0;           ///< 样式索引
+    bool hasFormula = false;      ///< 是否由公式计算得到（值为缓存结果）
+
+    bool isEmpty() const { return type == Type::Empty; }
+    bool isNumber() const { return type == Type::Number; }
+    bool isBoolean() const { return type == Type::Boolean; }
+    bool isString() const { return type == Type::String; }
+};
+
+/**
+ * @brief 行视图（读取器复用同一个对象，不会随行数增长）
+ */
+struct TXRowView {
+    row_t::index_t index = 0;       ///< 行号（从1开始）
+    std::vector<TXCellView> cells;  ///< 本行出现的单元格，按列递增
+
+    /**
+     * @brief 按列号查找单元格
+     * @return 未找到返回 nullptr
+     */
+    const TXCellView* find(column_t::index_t column) const {
+        for (const auto& cell : cells) {
+            if (cell.column == column) {
+                return &cell;
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @brief 只进的工作表读取器
+ *
+ * 适用于只需扫描一次数据的 ETL 场景：打开文件、选择工作表后反复调用
+ * nextRow()。工作表条目按块解压并以 SAX 方式解析，每次只保留当前行，
+ * 内存占用只取决于共享字符串表和单行大小。
+ *
+ * @code
+ * TXSheetReader reader;
+ * if (reader.open("data.xlsx", "Sheet1")) {
+ *     while (true) {
+ *         auto hasRow = reader.nextRow();
+ *         if (!hasRow || !hasRow.value()) break;
+ *         for (const auto& cell : reader.row().cells) { ... }
+ *     }
+ * }
+ * @endcode
+ */
+class TXSheetReader {
+public:
+    TXSheetReader();
+    ~TXSheetReader();
+
+    TXSheetReader(const TXSheetReader&) = delete;
+    TXSheetReader& operator=(const TXSheetReader&) = delete;
+    TXSheetReader(TXSheetReader&&) noexcept;
+    TXSheetReader& operator=(TXSheetReader&&) noexcept;
+
+    /**
+     * @brief 打开文件并定位到指定名称的工作表
+     * @param filename xlsx 文件路径
+     * @param sheetName 工作表名称
+     * @return TXResult<void> 操作结果
+     */
+    TXResult<void> open(const std::string& filename, const std::string& sheetName);
+
+    /**
+     * @brief 打开文件并定位到指定索引的工作表
+     * @param filename xlsx 文件路径
+     * @param sheetIndex 工作表索引（从0开始）
+     * @return TXResult<void> 操作结果
+     */
+    TXResult<void> open(const std::string& filename, u32 sheetIndex);
+
+    /**
+     * @brief 读取下一行
+     * @return TXResult<bool> true 表示读到一行，false 表示已到末尾
+     */
+    TXResult<bool> nextRow();
+
+    /**
+     * @brief 当前行（nextRow() 返回 true 之后有效）
+     */
+    const TXRowView& row() const;
+
+    /**
+     * @brief 工作簿中所有工作表名称（open 之后有效）
+     */
+    const std::vector<std::string>& getSheetNames() const;
+
+    /**
+     * @brief 共享字符串数量
+     */
+    std::size_t getSharedStringCount() const;
+
+    /**
+     * @brief 关闭文件并释放资源
+     */
+    void close();
+
+    /**
+     * @brief 是否已打开
+     */
+    bool isOpen() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+
+    TXResult<void> openSheet(const std::string& filename, const std::string* sheetName, u32 sheetIndex);
+};
+
+} // namespace TinaXlsx
@@ -0,0 +1,184 @@
+//
+// @file TXStreamingWorkbook.hpp
+// @brief 只写流式工作簿 - 行按顺序追加并直接压缩进 ZIP，内存占用与行数无关
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "TXTypes.hpp"
+#include "TXCoordinate.hpp"
+#include "TXResult.hpp"
+#include "TXXmlStreamWriter.hpp"
+#include "TXZipArchive.hpp"
+
+namespace TinaXlsx {
+
+// 前向声明
+class TXSheet;
+class TXCellStyle;
+class TXStyleManager;
+class ComponentManager;
+class TXSharedStringsPool;
+class TXWorkbookProtectionManager;
+struct TXWorkbookContext;
+class TXStreamingWorkbook;
+
+/**
+ * @brief 只写流式工作表
+ *
+ * 行必须按行号递增的顺序追加，每行在追加时即被序列化并送入压缩流，
+ * 之后不可再访问或修改。字符串一律写为内联字符串，不占用共享字符串池。
+ * 由 TXStreamingWorkbook::addSheet() 创建，同一时间只有最后添加的工作表可写。
+ */
+class TXStreamingSheet {
+public:
+    ~TXStreamingSheet();
+
+    TXStreamingSheet(const TXStreamingSheet&) = delete;
+    TXStreamingSheet& operator=(const TXStreamingSheet&) = delete;
+
+    /**
+     * @brief 获取工作表名称
+     */
+    const std::string& getName() const { return name_; }
+
+    /**
+     * @brief 设置列宽，必须在追加第一行之前调用
+     * @param col 列
+     * @param width 宽度（字符单位）
+     * @return TXResult<void> 操作结果
+     */
+    TXResult<void> setColumnWidth(column_t col, double width);
+
+    /**
+     * @brief 追加一行，行号为上一行加一，从 A 列开始依次写入
+     * @param values 单元格值，std::monostate 表示空单元格
+     * @param styleIndex 应用于本行所有单元格的样式索引（0 为默认样式）
+     * @return TXResult<void> 操作结果
+     */
+    TXResult<void> appendRow(const std::vector<cell_value_t>& values, u32 styleIndex = 0);
+
+    /**
+     * @brief 在指定行号追加一行，行号必须大于已写入的最后一行
+     * @param row 行号
+     * @param values 单元格值
+     * @param styleIndex 样式索引
+     * @return TXResult<void> 操作结果
+     */
+    TXResult<void> appendRow(row_t row, const std::vector<cell_value_t>& values, u32 styleIndex = 0);
+
+    /**
+     * @brief 已写入的最后一行行号（0 表示尚未写入）
+     */
+    row_t::index_t getLastRow() const { return lastRow_; }
+
+    /**
+     * @brief 已写入的行数
+     */
+    std::size_t getRowCount() const { return rowCount_; }
+
+    /**
+     * @brief 是否已结束写入（添加了新工作表或工作簿已关闭）
+     */
+    bool isClosed() const { return closed_; }
+
+private:
+    friend class TXStreamingWorkbook;
+
+    TXStreamingSheet(TXZipArchiveWriter& zipWriter, std::string name, u32 index);
+
+    TXResult<void> begin();
+    TXResult<void> finish();
+    TXResult<void> beginSheetData();
+
+    TXZipArchiveWriter& zipWriter_;
+    TXZipEntrySink sink_;
+    TXXmlStreamWriter writer_;
+    std::string name_;
+    u32 index_;
+    row_t::index_t lastRow_ = 0;
+    std::size_t rowCount_ = 0;
+    bool sheetDataStarted_ = false;
+    bool closed_ = false;
+    std::vector<std::pair<u32, double>> columnWidths_;
+    TXCellRefFormatter cellRefs_;             ///< 单元格引用生成器，列字母跨行缓存
+};
+
+/**
+ * @brief 只写流式工作簿
+ *
+ * 适合导出百万行级别的报表：工作表数据边生成边压缩写入文件，
+ * 其余部件（workbook.xml、样式、关系等）在 close() 时写出。
+ *
+ * @code
+ * TXStreamingWorkbook book;
+ * book.open("report.xlsx");
+ * auto sheet = book.addSheet("Data");
+ * for (...) sheet.value()->appendRow({std::string("name"), 1.5, true});
+ * book.close();
+ * @endcode
+ */
+class TXStreamingWorkbook {
+public:
+    TXStreamingWorkbook();
+    ~TXStreamingWorkbook();
+
+    TXStreamingWorkbook(const TXStreamingWorkbook&) = delete;
+    TXStreamingWorkbook& operator=(const TXStreamingWorkbook&) = delete;
+
+    /**
+     * @brief 创建输出文件
+     * @param filename 文件路径（已存在时覆盖）
+     * @return TXResult<void> 操作结果
+     */
+    TXResult<void> open(const std::string& filename);
+
+    /**
+     * @brief 添加工作表，之前添加的工作表随即结束写入
+     * @param name 工作表名称
+     * @return TXResult<TXStreamingSheet*> 新工作表
+     */
+    TXResult<TXStreamingSheet*> addSheet(const std::string& name);
+
+    /**
+     * @brief 注册单元格样式，返回可用于 appendRow 的样式索引
+     * @param style 样式
+     * @return 样式索引
+     */
+    u32 registerStyle(const TXCellStyle& style);
+
+    /**
+     * @brief 结束当前工作表并写出其余部件，完成文件
+     * @return TXResult<void> 操作结果
+     */
+    TXResult<void> close();
+
+    /**
+     * @brief 是否已打开
+     */
+    bool isOpen() const { return zipWriter_.isOpen(); }
+
+    /**
+     * @brief 工作表数量
+     */
+    std::size_t getSheetCount() const { return streamingSheets_.size(); }
+
+private:
+    TXZipArchiveWriter zipWriter_;
+    std::vector<std::unique_ptr<TXStreamingSheet>> streamingSheets_;
+
+    // 以下成员只保存工作簿级元数据，用于复用现有部件处理器写出 workbook.xml 等
+    std::vector<std::unique_ptr<TXSheet>> sheets_;
+    std::unique_ptr<TXStyleManager> styleManager_;
+    std::unique_ptr<ComponentManager> componentManager_;
+    std::unique_ptr<TXSharedStringsPool> sharedStringsPool_;
+    std::unique_ptr<TXWorkbookProtectionManager> protectionManager_;
+    std::unique_ptr<TXWorkbookContext> context_;
+
+    TXResult<void> finishCurrentSheet();
+};
+
+} // namespace TinaXlsx
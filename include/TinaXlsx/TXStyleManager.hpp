@@ -76,6 +76,18 @@ namespace TinaXlsx
          */
         TXCellStyle getStyleObjectFromXfIndex(u32 xfIndex) const;
 
+        /**
+         * @brief 样式表的修订号，注册新的字体、填充、边框、数字格式或 XF 时增大
+         *
+         * 各存储池只增不减，命中已有条目的注册不改变修订号；
+         * 比较前后两次的值即可判断 styles.xml 是否需要重新生成。
+         */
+        std::size_t getRevision() const
+        {
+            return fonts_pool_.size() + fills_pool_.size() + borders_pool_.size() +
+                cell_xfs_pool_.size() + num_fmts_pool_new_.size();
+        }
+
     private:
         // 辅助函数，用于将枚举转换为XML字符串
         std::string horizontalAlignmentToString(HorizontalAlignment alignment) const;
@@ -41,26 +41,13 @@ namespace TinaXlsx {
         }
 
         TXResult<void> save(TXZipArchiveWriter& zipWriter, const TXWorkbookContext& context) override {
-            // 使用styleManager的createStylesXmlNode方法生成样式XML
+            // 样式表结构较深且体量小，仍由 styleManager 构建节点树，再直接序列化
             XmlNodeBuilder styleSheet = context.styleManager.createStylesXmlNode();
 
-            TXXmlWriter writer;
-            auto setRootResult = writer.setRootNode(styleSheet);
-            if (setRootResult.isError()) {
-                return Err<void>(setRootResult.error().getCode(), "Failed to set root node: " + setRootResult.error().getMessage());
-            }
-            
-            auto xmlContentResult = writer.generateXmlString();
-            if (xmlContentResult.isError()) {
-                return Err<void>(xmlContentResult.error().getCode(), "Failed to generate XML string: " + xmlContentResult.error().getMessage());
-            }
-            
-            std::vector<uint8_t> xmlData(xmlContentResult.value().begin(), xmlContentResult.value().end());
-            auto writeResult = zipWriter.write(std::string(partName()), xmlData);
-            if (writeResult.isError()) {
-                return Err<void>(writeResult.error().getCode(), "Failed to write " + std::string(partName()) + ": " + writeResult.error().getMessage());
-            }
-            return Ok();
+            TXXmlStreamWriter xml;
+            xml.declaration();
+            TXXmlWriter::writeNode(xml, styleSheet);
+            return writeXmlPart(zipWriter, xml);
         }
 
         std::string partName() const override {
@@ -157,6 +157,17 @@ public:
      * @return 列名 (如 "A", "B", "AA")
      */
     static std::string column_string_from_index(index_t column_index);
+
+    /// 列名的最大长度（"XFD"）
+    static constexpr std::size_t MAX_COLUMN_LETTERS = 3;
+
+    /**
+     * @brief 将列索引转换为列名并写入调用方的缓冲区，不分配内存
+     * @param column_index 列索引 (1-based)
+     * @param buffer 至少 MAX_COLUMN_LETTERS 字节的缓冲区，不写结尾的 '\0'
+     * @return 写入的字符数，列索引无效时为 0
+     */
+    static std::size_t column_chars_from_index(index_t column_index, char* buffer);
     
     /**
      * @brief 默认构造函数，指向 A 列
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <ctime>
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include "TXTypes.hpp"
 #include "TXComponentManager.hpp"
 #include "TXStyleManager.hpp"
@@ -16,6 +22,102 @@ namespace TinaXlsx
     class TXCellStyle;
     class TXSheet;
     class TXXmlHandler;
+    class TXContentTypesXmlHandler;
+    class TXZipArchiveReader;
+    class TXZipArchiveWriter;
+
+    /**
+     * @brief 接收保存输出的回调，返回 false 表示写出失败。
+     * 一次保存中可能被调用多次，数据只在回调期间有效。
+     */
+    using TXOutputSink = std::function<bool(const uint8_t* data, std::size_t size)>;
+
+    /**
+     * @brief 保存选项
+     */
+    struct TXSaveOptions
+    {
+        /**
+         * @brief DEFLATE 压缩级别（0-9），1 最快，9 压缩率最高
+         */
+        int compressionLevel = 6;
+
+        /**
+         * @brief 小于该大小（字节）的部件以 STORE 方式写入不压缩，0 表示全部压缩。
+         * 关系文件、内容类型等小部件压缩几乎不省空间，却要为每个条目初始化压缩流。
+         */
+        std::size_t storeThreshold = 0;
+
+        /**
+         * @brief 生成和压缩工作表的线程数（含调用线程），0 表示硬件并发数。
+         * 大于 1 时各工作表在线程池上序列化并压缩，再按顺序追加到归档中。
+         * 单线程保存的工作表同样先整体压缩再写入，所以固定 modifiedTime 时，
+         * 任意线程数保存的归档都与单线程保存逐字节相同。
+         */
+        u32 threadCount = 1;
+
+        /**
+         * @brief 未压缩大小达到该值的工作表按块压缩，多线程保存时各块并行压缩（0 表示不分块）。
+         * 分块压缩的数据与整体压缩不同、压缩率略低，但与线程数无关。
+         */
+        std::size_t parallelDeflateThreshold = 32 * 1024 * 1024;
+
+        /**
+         * @brief 各条目的修改时间（UNIX 时间戳，秒），0 表示保存时的当前时间。
+         * 固定该值可以得到可重复的输出，便于比较两次保存的结果。
+         */
+        std::time_t modifiedTime = 0;
+
+        /**
+         * @brief 复用源文件中未修改的部件（仅对 loadFromFile() 加载的工作簿有效）。
+         * 未修改的工作表、样式表和共享字符串表直接复制源文件中的压缩数据，
+         * 不再重新生成和压缩；填写模板等只改动少数工作表的场景保存更快。
+         * 未修改工作表的关系部件及其引用的绘图、图表、图片等部件一并原样复制；
+         * 这些部件与本次生成的图表部件重名时该工作表改为重新生成。重新生成的工作表
+         * 不保留源文件中的绘图和图片。
+         */
+        bool reuseUnchangedParts = true;
+
+        /**
+         * @brief 快速模式：级别 1，小于 4KB 的部件不压缩，用于对延迟敏感的场景
+         */
+        static TXSaveOptions fast() {
+            TXSaveOptions options;
+            options.compressionLevel = 1;
+            options.storeThreshold = 4 * 1024;
+            return options;
+        }
+
+        /**
+         * @brief 最大压缩率模式：级别 9，所有部件都压缩
+         */
+        static TXSaveOptions maxRatio() {
+            TXSaveOptions options;
+            options.compressionLevel = 9;
+            return options;
+        }
+    };
+
+    /**
+     * @brief 加载选项
+     */
+    struct TXLoadOptions
+    {
+        /**
+         * @brief 按需加载工作表：加载时只解析 workbook.xml、样式和共享字符串，
+         * 每个工作表在第一次通过 getSheet()、getActiveSheet() 或 getSheets() 访问时才解析。
+         * 只读取少数工作表时延迟接近这些工作表本身的解析耗时。仅对 loadFromFile() 有效。
+         */
+        bool lazySheets = false;
+
+        /**
+         * @brief 解析工作表的线程数（含调用线程），0 表示硬件并发数。
+         * 共享字符串和样式先在调用线程上加载，之后各工作表互不依赖：
+         * 每个工作表的条目在线程池上独立解压并解析到自己的单元格管理器中，
+         * 共享字符串表此时只读，各线程无锁并发访问。按需加载时不使用。
+         */
+        u32 threadCount = 1;
+    };
 
     /**
      * @brief Excel工作簿类
@@ -38,11 +140,43 @@ namespace TinaXlsx
 
         /**
          * @brief 从文件加载工作簿
+         *
+         * 源文件保持映射直到下一次加载或 clear()，再次保存时未修改的部件直接从中复制
+         * （见 TXSaveOptions::reuseUnchangedParts）。
+         *
+         * 数值单元格的类型由文本决定（loadFromMemory() 相同）：不含小数点和指数的值加载为 int64_t，
+         * 其余加载为 double。保存时整数值的 double 写成整数形式（42.0 写为 <v>42</v>），
+         * 所以保存再加载后得到 int64_t(42) 而不是 42.0。
          * @param filename XLSX文件路径
          * @return 成功返回true，失败返回false
          */
         bool loadFromFile(const std::string& filename);
 
+        /**
+         * @brief 按指定选项从文件加载工作簿
+         * @param filename XLSX文件路径
+         * @param options 加载选项
+         * @return 成功返回true，失败返回false
+         */
+        bool loadFromFile(const std::string& filename, const TXLoadOptions& options);
+
+        /**
+         * @brief 从内存中的 XLSX 数据加载工作簿，不经过文件系统
+         *
+         * 与 loadFromFile() 不同，加载后不保留源数据，再次保存时全部部件都重新生成。
+         * @param data XLSX 数据，加载期间直接读取不复制，返回后不再引用
+         * @param size 数据长度
+         * @return 成功返回true，失败返回false
+         */
+        bool loadFromMemory(const void* data, std::size_t size);
+
+        /**
+         * @brief 从内存中的 XLSX 数据加载工作簿
+         * @param data XLSX 数据
+         * @return 成功返回true，失败返回false
+         */
+        bool loadFromMemory(const std::vector<uint8_t>& data);
+
         /**
          * @brief 保存工作簿到文件
          * @param filename 输出文件路径
@@ -50,6 +184,44 @@ namespace TinaXlsx
          */
         bool saveToFile(const std::string& filename);
 
+        /**
+         * @brief 按指定选项保存工作簿到文件
+         * @param filename 输出文件路径
+         * @param options 保存选项
+         * @return 成功返回true，失败返回false
+         */
+        bool saveToFile(const std::string& filename, const TXSaveOptions& options);
+
+        /**
+         * @brief 保存工作簿到内存，不经过文件系统
+         * @param buffer 输出缓冲区，原有内容被替换
+         * @return 成功返回true，失败返回false
+         */
+        bool saveToMemory(std::vector<uint8_t>& buffer);
+
+        /**
+         * @brief 按指定选项保存工作簿到内存
+         * @param buffer 输出缓冲区，原有内容被替换
+         * @param options 保存选项
+         * @return 成功返回true，失败返回false
+         */
+        bool saveToMemory(std::vector<uint8_t>& buffer, const TXSaveOptions& options);
+
+        /**
+         * @brief 保存工作簿并把归档数据交给回调（例如直接写入网络响应）
+         * @param sink 输出回调，数据直接来自内存归档，不再额外复制
+         * @return 成功返回true，失败返回false
+         */
+        bool saveToStream(const TXOutputSink& sink);
+
+        /**
+         * @brief 按指定选项保存工作簿并把归档数据交给回调
+         * @param sink 输出回调
+         * @param options 保存选项
+         * @return 成功返回true，失败返回false
+         */
+        bool saveToStream(const TXOutputSink& sink, const TXSaveOptions& options);
+
         /**
          * @brief 创建新的工作表
          * @param name 工作表名称
@@ -65,19 +237,41 @@ namespace TinaXlsx
         TXSheet* addSheet(std::unique_ptr<TXSheet> sheet);
 
         /**
-         * @brief 获取工作表
+         * @brief 获取工作表，按需加载的工作表在此时解析
          * @param name 工作表名称
-         * @return 工作表指针，如果不存在返回nullptr
+         * @return 工作表指针，如果不存在或解析失败返回nullptr
          */
         TXSheet* getSheet(const std::string& name);
 
         /**
-         * @brief 获取工作表
+         * @brief 获取工作表，按需加载的工作表在此时解析
+         *
+         * 多个线程可以同时调用：按需加载的解析在锁内进行，每个工作表只解析一次，
+         * 同时访问未解析工作表的其他线程等待解析完成。
          * @param index 工作表索引
-         * @return 工作表指针，如果索引无效返回nullptr
+         * @return 工作表指针，如果索引无效或解析失败返回nullptr
          */
         TXSheet* getSheet(u64 index) const;
 
+        /**
+         * @brief 工作表的单元格是否已经解析
+         * @param name 工作表名称
+         * @return 已解析（或不是从文件加载的）返回true，尚未解析或不存在返回false
+         */
+        bool isSheetLoaded(const std::string& name) const;
+
+        /**
+         * @brief 释放工作表的单元格数据，下次访问时重新从源文件解析
+         *
+         * 只有 loadFromFile() 加载且自加载后未修改的工作表可以卸载，否则修改会丢失。
+         * 卸载会使该工作表中取得的单元格指针、迭代器和管理器引用全部失效；TXSheet 指针本身
+         * 仍然有效，但其中没有单元格，直到再次通过 getSheet() 等访问时重新解析。
+         * 不能与该工作表上的任何访问并发调用。
+         * @param name 工作表名称
+         * @return 成功返回true，失败返回false
+         */
+        bool unloadSheet(const std::string& name);
+
         /**
          * @brief 删除工作表
          * @param name 工作表名称
@@ -194,13 +388,13 @@ namespace TinaXlsx
         void registerComponent(ExcelComponent component);
 
         /**
-         * @brief 获取工作表列表
+         * @brief 获取工作表列表，尚未解析的工作表全部在此时解析
          * @return 工作表列表引用
          */
         std::vector<std::unique_ptr<TXSheet>>& getSheets();
 
         /**
-         * @brief 获取工作表列表（常量版本）
+         * @brief 获取工作表列表（常量版本），尚未解析的工作表全部在此时解析
          * @return 工作表列表常量引用
          */
         const std::vector<std::unique_ptr<TXSheet>>& getSheets() const;
@@ -280,14 +474,117 @@ namespace TinaXlsx
         bool protectWindows(const std::string& password);
 
     private:
+        /**
+         * @brief 从已打开的归档加载全部部件
+         */
+        bool loadFromArchive(TXZipArchiveReader& zipReader, const TXLoadOptions& options);
+
+        /**
+         * @brief 解析全部工作表，threadCount 大于 1 时在线程池上并行解析
+         */
+        bool loadWorksheets(TXZipArchiveReader& zipReader, u32 threadCount);
+
+        /**
+         * @brief 按名称查找工作表，不触发解析
+         */
+        TXSheet* findSheet(const std::string& name) const;
+
+        /**
+         * @brief 解析尚未加载的工作表，已加载时直接返回true
+         */
+        bool ensureSheetLoaded(TXSheet* sheet) const;
+
+        /**
+         * @brief 解析全部尚未加载的工作表
+         */
+        bool ensureAllSheetsLoaded() const;
+
+        /**
+         * @brief 把全部部件写入已打开的归档
+         */
+        bool saveToArchive(TXZipArchiveWriter& zipWriter, const TXSaveOptions& options);
+
+        /// 需要从源归档原样复制的部件，元素为 (目标部件名, 源部件名)
+        using SourceCopies = std::vector<std::pair<std::string, std::string>>;
+
+        /**
+         * @brief 生成并压缩工作表，再按顺序写出工作表及其关联部件
+         *
+         * threadCount 大于 1 时在线程池上生成和压缩，否则逐个处理；两者写出的条目相同。
+         * @param sourceParts 每个工作表可直接复制的源部件名，空字符串表示重新生成
+         * @param sourceCopies 每个复制的工作表需要一并复制的关系部件及其引用的部件
+         */
+        bool saveWorksheets(TXZipArchiveWriter& zipWriter, u32 threadCount, const TXSaveOptions& options,
+                            const std::vector<std::string>& sourceParts,
+                            const std::vector<SourceCopies>& sourceCopies);
+
+        /**
+         * @brief 记录加载来源，之后保存时复用其中未修改的部件
+         */
+        void attachSource(std::unique_ptr<TXZipArchiveReader> archive, const std::string& filename);
+
+        /**
+         * @brief 释放源归档，之后的保存全部重新生成
+         */
+        void releaseSource();
+
+        /**
+         * @brief 源归档中是否存在指定部件
+         */
+        bool sourceHas(const std::string& partName) const;
+
+        /**
+         * @brief 工作表可以原样复制时返回其在源归档中的部件名，否则返回空字符串
+         */
+        std::string reusableSourcePart(std::size_t index) const;
+
+        /**
+         * @brief 确定可以原样复制的工作表及其关系部件引用的全部部件
+         *
+         * 源关系无法解析，或引用的部件与本次生成的部件重名时，对应工作表改为重新生成。
+         * 多个工作表引用的同一部件只复制一次。
+         */
+        void planSourceReuse(std::vector<std::string>& sourceParts, std::vector<SourceCopies>& sourceCopies);
+
+        /**
+         * @brief 收集源关系部件引用的所有内部部件（递归包括它们的关系部件），
+         * 解析失败时返回 false
+         */
+        bool collectSourceRelationships(const std::string& relsPart, const std::string& ownerPart,
+                                        std::vector<std::string>& parts) const;
+
+        /**
+         * @brief 按源文件的 [Content_Types].xml 为复制的部件登记内容类型
+         */
+        bool addSourceContentTypes(TXContentTypesXmlHandler& handler, const std::vector<SourceCopies>& sourceCopies);
+
+        /**
+         * @brief 把源归档中的部件不经解压地复制到目标归档
+         */
+        bool copySourcePart(TXZipArchiveWriter& zipWriter, const std::string& partName,
+                            const std::string& sourcePart);
+
+        /**
+         * @brief 写出工作表的关系、绘图和图表部件（如果有图表）
+         */
+        bool saveSheetAttachments(TXZipArchiveWriter& zipWriter, std::size_t index);
+
         std::vector<std::unique_ptr<TXSheet>> sheets_;
         std::size_t active_sheet_index_;
-        std::string last_error_;
+        mutable std::string last_error_;  ///< const 访问触发按需解析时也要能记录错误
         ComponentManager component_manager_;
         bool auto_component_detection_;
         TXStyleManager style_manager_;
         TXSharedStringsPool shared_strings_pool_;
         std::unique_ptr<TXWorkbookContext> context_;
         TXWorkbookProtectionManager workbook_protection_manager_;  ///< 工作簿保护管理器
+
+        // ==================== 增量保存 ====================
+        std::unique_ptr<TXZipArchiveReader> source_archive_;  ///< loadFromFile() 打开的源归档
+        std::string source_filename_;                         ///< 源归档路径
+        std::unordered_map<const TXSheet*, std::size_t> source_sheets_;  ///< 加载的工作表 → 源归档中的序号
+        std::size_t source_style_revision_ = 0;               ///< 加载完成时样式表的修订号
+        mutable std::unordered_set<TXSheet*> pending_sheets_;  ///< 按需加载时尚未解析的工作表
+        mutable std::mutex sheet_load_mutex_;                  ///< 保护 pending_sheets_ 和按需解析过程
     };
 } // namespace TinaXlsx 
@@ -6,7 +6,6 @@
 
 #include "TXXmlHandler.hpp"
 #include "TXXmlReader.hpp"
-#include "TXXmlWriter.hpp"
 
 namespace TinaXlsx {
     class TXWorkbookRelsXmlHandler : public TXXmlHandler {
@@ -17,54 +16,38 @@ namespace TinaXlsx {
         }
 
         TXResult<void> save(TXZipArchiveWriter& zipWriter, const TXWorkbookContext& context) override {
-            XmlNodeBuilder relationships("Relationships");
-            relationships.addAttribute("xmlns", "http://schemas.openxmlformats.org/package/2006/relationships");
+            TXXmlStreamWriter xml;
+            xml.declaration();
+            xml.startElement("Relationships")
+               .attribute("xmlns", "http://schemas.openxmlformats.org/package/2006/relationships");
 
             size_t rid = 1;
 
             // 工作表关系
             for (size_t i = 0; i < context.sheets.size(); ++i) {
-                relationships.addChild(XmlNodeBuilder("Relationship")
-                                       .addAttribute("Id", "rId" + std::to_string(rid))
-                                       .addAttribute("Type", "http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet")
-                                       .addAttribute("Target", "worksheets/sheet" + std::to_string(i + 1) + ".xml"));
+                writeRelationship(xml, "rId" + std::to_string(rid),
+                                  "http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet",
+                                  "worksheets/sheet" + std::to_string(i + 1) + ".xml");
                 ++rid;
             }
 
             // 样式关系（如果启用）
             if (context.componentManager.hasComponent(ExcelComponent::Styles)) {
-                relationships.addChild(XmlNodeBuilder("Relationship")
-                                       .addAttribute("Id", "rId" + std::to_string(rid))
-                                       .addAttribute("Type", "http://schemas.openxmlformats.org/officeDocument/2006/relationships/styles")
-                                       .addAttribute("Target", "styles.xml"));
+                writeRelationship(xml, "rId" + std::to_string(rid),
+                                  "http://schemas.openxmlformats.org/officeDocument/2006/relationships/styles",
+                                  "styles.xml");
                 ++rid;
             }
 
             // 共享字符串关系（如果启用）
             if (context.componentManager.hasComponent(ExcelComponent::SharedStrings)) {
-                relationships.addChild(XmlNodeBuilder("Relationship")
-                                       .addAttribute("Id", "rId" + std::to_string(rid))
-                                       .addAttribute("Type", "http://schemas.openxmlformats.org/officeDocument/2006/relationships/sharedStrings")
-                                       .addAttribute("Target", "sharedStrings.xml"));
+                writeRelationship(xml, "rId" + std::to_string(rid),
+                                  "http://schemas.openxmlformats.org/officeDocument/2006/relationships/sharedStrings",
+                                  "sharedStrings.xml");
             }
 
-            TXXmlWriter writer;
-            auto setRootResult = writer.setRootNode(relationships);
-            if (setRootResult.isError()) {
-                return Err<void>(setRootResult.error().getCode(), "Failed to set root node: " + setRootResult.error().getMessage());
-            }
-            
-            auto xmlContentResult = writer.generateXmlString();
-            if (xmlContentResult.isError()) {
-                return Err<void>(xmlContentResult.error().getCode(), "Failed to generate XML: " + xmlContentResult.error().getMessage());
-            }
-            
-            std::vector<uint8_t> xmlData(xmlContentResult.value().begin(), xmlContentResult.value().end());
-            auto writeResult = zipWriter.write(std::string(partName()), xmlData);
-            if (writeResult.isError()) {
-                return Err<void>(writeResult.error().getCode(), "Failed to write " + std::string(partName()) + ": " + writeResult.error().getMessage());
-            }
-            return Ok();
+            xml.endElement("Relationships");
+            return writeXmlPart(zipWriter, xml);
         }
 
         std::string partName() const override {
@@ -6,7 +6,6 @@
 
 #include "TXXmlHandler.hpp"
 #include "TXXmlReader.hpp"
-#include "TXXmlWriter.hpp"
 
 namespace TinaXlsx
 {
@@ -55,73 +54,56 @@ namespace TinaXlsx
 
         TXResult<void> save(TXZipArchiveWriter& zipWriter, const TXWorkbookContext& context) override
         {
-            XmlNodeBuilder workbook("workbook");
-            workbook.addAttribute("xmlns", "http://schemas.openxmlformats.org/spreadsheetml/2006/main")
-                    .addAttribute("xmlns:r", "http://schemas.openxmlformats.org/officeDocument/2006/relationships");
+            TXXmlStreamWriter xml;
+            xml.declaration();
+            xml.startElement("workbook")
+               .attribute("xmlns", "http://schemas.openxmlformats.org/spreadsheetml/2006/main")
+               .attribute("xmlns:r", "http://schemas.openxmlformats.org/officeDocument/2006/relationships");
 
             // 添加工作簿保护信息
             auto& workbookProtectionManager = context.workbookProtectionManager;
             if (workbookProtectionManager.isWorkbookProtected()) {
                 const auto& protection = workbookProtectionManager.getWorkbookProtection();
-                XmlNodeBuilder workbookProtection("workbookProtection");
+                xml.startElement("workbookProtection");
 
                 // 添加现代Excel的SHA-512密码保护属性
                 if (!protection.passwordHash.empty()) {
-                    workbookProtection.addAttribute("workbookAlgorithmName", protection.algorithmName);
-                    workbookProtection.addAttribute("workbookHashValue", protection.passwordHash);
-                    workbookProtection.addAttribute("workbookSaltValue", protection.saltValue);
-                    workbookProtection.addAttribute("workbookSpinCount", std::to_string(protection.spinCount));
+                    xml.attribute("workbookAlgorithmName", protection.algorithmName)
+                       .attribute("workbookHashValue", protection.passwordHash)
+                       .attribute("workbookSaltValue", protection.saltValue)
+                       .attribute("workbookSpinCount", protection.spinCount);
                 }
 
                 // 添加保护选项属性
                 if (protection.lockStructure) {
-                    workbookProtection.addAttribute("lockStructure", "1");
+                    xml.attribute("lockStructure", "1");
                 }
                 if (protection.lockWindows) {
-                    workbookProtection.addAttribute("lockWindows", "1");
+                    xml.attribute("lockWindows", "1");
                 }
                 if (protection.lockRevision) {
-                    workbookProtection.addAttribute("lockRevision", "1");
+                    xml.attribute("lockRevision", "1");
                 }
 
-                workbook.addChild(workbookProtection);
+                xml.endElement("workbookProtection");
             }
 
             // 创建sheets节点
-            XmlNodeBuilder sheetNode("sheets");
+            xml.startElement("sheets");
             for (std::size_t i = 0; i < context.sheets.size(); ++i)
             {
-                XmlNodeBuilder sheet("sheet");
-                sheet.addAttribute("name", context.sheets[i]->getName())
-                     .addAttribute("sheetId", std::to_string(i + 1))
-                     .addAttribute("r:id", "rId" + std::to_string(i + 1));
-                sheetNode.addChild(sheet);
+                xml.startElement("sheet")
+                   .attribute("name", context.sheets[i]->getName())
+                   .attribute("sheetId", i + 1)
+                   .attribute("r:id", "rId" + std::to_string(i + 1))
+                   .endElement("sheet");
             }
-            workbook.addChild(sheetNode);
+            xml.endElement("sheets");
 
-            TXXmlWriter xmlWriter;
-            auto setRootResult = xmlWriter.setRootNode(workbook);
-            if (setRootResult.isError())
-            {
-                return Err<void>(setRootResult.error().getCode(), "Failed to set root node: " + setRootResult.error().getMessage());
-            }
-            
-            auto xmlContentResult = xmlWriter.generateXmlString();
-            if (xmlContentResult.isError())
-            {
-                return Err<void>(xmlContentResult.error().getCode(), "Failed to generate XML: " + xmlContentResult.error().getMessage());
-            }
-            
-            std::vector<uint8_t> xmlData(xmlContentResult.value().begin(), xmlContentResult.value().end());
-            auto writeResult = zipWriter.write(std::string(partName()), xmlData);
-            if (writeResult.isError())
-            {
-                return Err<void>(writeResult.error().getCode(), "Failed to write " + std::string(partName()) + ": " + writeResult.error().getMessage());
-            }
-            return Ok();
+            xml.endElement("workbook");
+            return writeXmlPart(zipWriter, xml);
         }
 
-
         std::string partName() const override
         {
             return "xl/workbook.xml";
@@ -5,7 +5,6 @@
 #pragma once
 
 #include "TXXmlHandler.hpp"
-#include "TXXmlWriter.hpp"
 
 namespace TinaXlsx
 {
@@ -0,0 +1,97 @@
+//
+// @file TXWorksheetSaxHandler.hpp
+// @brief 工作表 sheetData 的 SAX 事件处理基类
+//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include "TXXmlSaxParser.hpp"
+#include "TXTypes.hpp"
+
+namespace TinaXlsx {
+
+/**
+ * @brief 工作表 SAX 处理基类
+ *
+ * 只关心 sheetData/row/c 及其 v、f、is 子元素，把每个单元格整理为
+ * CellData 后交给派生类，不保留任何中间节点。单元格加载和逐行读取
+ * 共用这一套状态机。
+ */
+class TXWorksheetSaxHandler : public TXXmlSaxHandler {
+public:
+    /**
+     * @brief 单元格原始数据（视图仅在 onCell 回调期间有效）
+     */
+    struct CellData {
+        u32 row = 0;                  ///< 行号（从1开始）
+        u32 column = 0;               ///< 列号（从1开始）
+        std::string_view type;        ///< t 属性，缺省为 "n"
+        u32 styleIndex = 0;           ///< s 属性
+        std::string_view value;       ///< <v> 文本
+        std::string_view formula;     ///< <f> 文本（不含等号）
+        std::string_view inlineText;  ///< <is> 中所有 <t> 拼接后的文本
+        bool hasInlineString = false; ///< 是否出现了 <is>
+
+        /**
+         * @brief 是否带有值（内联字符串即使为空也算有值）
+         */
+        bool hasValue() const { return !value.empty() || hasInlineString; }
+    };
+
+    void onStartElement(std::string_view qname, const TXXmlSaxAttributes& attributes) override;
+    void onEndElement(std::string_view qname) override;
+    void onText(std::string_view text) override;
+
+    /**
+     * @brief 解析 "AB12" 形式的单元格引用，不分配内存
+     * @return 成功返回 true
+     */
+    static bool parseCellReference(std::string_view ref, u32& row, u32& column);
+
+    /**
+     * @brief 解析无符号十进制整数，遇到非数字字符即停止
+     *
+     * 超出 u32 范围时返回 u32 最大值而不是回绕，过大的行号、样式或共享字符串索引
+     * 不会落到某个有效值上。
+     */
+    static u32 parseUnsigned(std::string_view text);
+
+protected:
+    /**
+     * @brief 行开始
+     */
+    virtual void onRowStart(u32 /*row*/) {}
+
+    /**
+     * @brief 单元格结束，所有数据已收集完毕
+     */
+    virtual void onCell(const CellData& cell) = 0;
+
+    /**
+     * @brief 行结束
+     */
+    virtual void onRowEnd(u32 /*row*/) {}
+
+private:
+    enum class Capture { None, Value, Formula, InlineText };
+
+    void beginCell(const TXXmlSaxAttributes& attributes);
+    void endCell();
+
+    bool m_inSheetData = false;
+    bool m_inCell = false;
+    bool m_inInlineString = false;
+    bool m_hasInlineString = false;
+    Capture m_capture = Capture::None;
+    u32 m_row = 0;
+    u32 m_col = 0;
+    u32 m_style = 0;
+    std::string m_type;
+    std::string m_value;
+    std::string m_formula;
+    std::string m_inlineText;
+};
+
+} // namespace TinaXlsx
@@ -8,6 +8,7 @@
 #include <memory>
 #include "TXZipArchive.hpp"
 #include "TXWorkbookContext.hpp"
+#include "TXXmlStreamWriter.hpp"
 #include "TXResult.hpp"
 
 namespace TinaXlsx
@@ -26,6 +27,35 @@ namespace TinaXlsx
         [[nodiscard]] std::string lastError() const { return m_lastError; }
 
     protected:
+        /**
+         * @brief 把已序列化的 XML 作为本部件写入 ZIP
+         * @param zipWriter ZIP 写入器
+         * @param xml 已完成的 XML 输出器（无输出端）
+         * @return TXResult<void> 操作结果
+         */
+        TXResult<void> writeXmlPart(TXZipArchiveWriter& zipWriter, const TXXmlStreamWriter& xml) const
+        {
+            const std::string& data = xml.buffer();
+            auto writeResult = zipWriter.write(partName(), data.data(), data.size());
+            if (writeResult.isError()) {
+                return Err<void>(writeResult.error().getCode(), "Failed to write " + partName() + ": " + writeResult.error().getMessage());
+            }
+            return Ok();
+        }
+
+        /**
+         * @brief 写入一个 <Relationship Id Type Target/> 元素
+         */
+        static void writeRelationship(TXXmlStreamWriter& xml, std::string_view id,
+                                      std::string_view type, std::string_view target)
+        {
+            xml.startElement("Relationship")
+               .attribute("Id", id)
+               .attribute("Type", type)
+               .attribute("Target", target)
+               .endElement("Relationship");
+        }
+
         std::string m_lastError;
     };
 }
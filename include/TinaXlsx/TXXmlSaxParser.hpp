@@ -0,0 +1,198 @@
+//
+// @file TXXmlSaxParser.hpp
+// @brief 流式 SAX XML 解析器 - 按块输入，不构建 DOM
+//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "TXResult.hpp"
+
+namespace TinaXlsx {
+
+/**
+ * @brief SAX 属性
+ *
+ * name/value 均指向解析器内部缓冲区，仅在回调期间有效
+ */
+struct TXXmlSaxAttribute {
+    std::string_view name;   ///< 属性名（含命名空间前缀）
+    std::string_view value;  ///< 已解码实体的属性值
+};
+
+/**
+ * @brief 单个元素的属性列表（回调期间有效，解析器内部复用）
+ */
+class TXXmlSaxAttributes {
+public:
+    /**
+     * @brief 查找属性值
+     * @param name 属性名
+     * @param defaultValue 未找到时返回的值
+     * @return 属性值视图
+     */
+    std::string_view get(std::string_view name, std::string_view defaultValue = {}) const {
+        for (const auto& attr : attrs_) {
+            if (attr.name == name) {
+                return attr.value;
+            }
+        }
+        return defaultValue;
+    }
+
+    /**
+     * @brief 检查属性是否存在
+     */
+    bool has(std::string_view name) const {
+        for (const auto& attr : attrs_) {
+            if (attr.name == name) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t size() const { return attrs_.size(); }
+    bool empty() const { return attrs_.empty(); }
+    const TXXmlSaxAttribute& operator[](std::size_t index) const { return attrs_[index]; }
+    std::vector<TXXmlSaxAttribute>::const_iterator begin() const { return attrs_.begin(); }
+    std::vector<TXXmlSaxAttribute>::const_iterator end() const { return attrs_.end(); }
+
+private:
+    friend class TXXmlSaxParser;
+    std::vector<TXXmlSaxAttribute> attrs_;
+};
+
+/**
+ * @brief SAX 事件处理器
+ *
+ * 所有 string_view 参数只在回调期间有效；同一元素的文本可能分多次回调
+ * （例如遇到 CDATA 时），需要完整文本的处理器应自行拼接。
+ */
+class TXXmlSaxHandler {
+public:
+    virtual ~TXXmlSaxHandler() = default;
+
+    /**
+     * @brief 元素开始（自闭合元素会紧接着收到 onEndElement）
+     * @param name 元素名（含命名空间前缀）
+     * @param attributes 属性列表
+     */
+    virtual void onStartElement(std::string_view /*name*/, const TXXmlSaxAttributes& /*attributes*/) {}
+
+    /**
+     * @brief 元素结束
+     * @param name 元素名（含命名空间前缀）
+     */
+    virtual void onEndElement(std::string_view /*name*/) {}
+
+    /**
+     * @brief 文本内容（已解码实体）
+     * @param text 文本
+     */
+    virtual void onText(std::string_view /*text*/) {}
+};
+
+/**
+ * @brief 流式 SAX XML 解析器
+ *
+ * 调用方按任意大小的块调用 feed() 输入数据，解析器只保留尚未构成完整
+ * 标记的尾部字节，因此内存占用与文档大小无关。支持元素、属性、文本、
+ * CDATA、注释、处理指令以及预定义/数字字符实体；不处理 DTD 内部子集。
+ * 结束标签必须与最近一个未关闭的开始标签同名，否则返回错误。
+ */
+class TXXmlSaxParser {
+public:
+    explicit TXXmlSaxParser(TXXmlSaxHandler& handler);
+
+    /**
+     * @brief 输入一块数据并分发其中完整的事件
+     * @param data 数据指针
+     * @param size 数据长度
+     * @return TXResult<void> 操作结果
+     */
+    TXResult<void> feed(const char* data, std::size_t size);
+
+    /**
+     * @brief 输入一块数据
+     */
+    TXResult<void> feed(std::string_view data) { return feed(data.data(), data.size()); }
+
+    /**
+     * @brief 结束输入，处理剩余数据并检查文档完整性
+     *
+     * 若回调在此期间调用了 pause()，返回后 isPaused() 为 true，需再次调用 finish()
+     * @return TXResult<void> 操作结果
+     */
+    TXResult<void> finish();
+
+    /**
+     * @brief 一次性解析完整文档
+     * @param data 文档内容
+     * @return TXResult<void> 操作结果
+     */
+    TXResult<void> parse(std::string_view data);
+
+    /**
+     * @brief 暂停事件分发（通常在回调中调用），剩余数据保留到 resume()
+     *
+     * 用于把推模式的 SAX 事件转换为拉模式接口，例如逐行读取。
+     */
+    void pause() { paused_ = true; }
+
+    /**
+     * @brief 继续分发暂停前已输入的数据
+     * @return TXResult<void> 操作结果
+     */
+    TXResult<void> resume();
+
+    /**
+     * @brief 是否处于暂停状态
+     */
+    bool isPaused() const { return paused_; }
+
+    /**
+     * @brief 重置解析器状态以便复用
+     */
+    void reset();
+
+    /**
+     * @brief 当前元素嵌套深度
+     */
+    std::size_t depth() const { return openNameStarts_.size(); }
+
+    /**
+     * @brief 去掉命名空间前缀，返回本地名
+     */
+    static std::string_view localName(std::string_view name) {
+        auto colon = name.find(':');
+        return colon == std::string_view::npos ? name : name.substr(colon + 1);
+    }
+
+    /**
+     * @brief 原地解码 XML 实体（解码结果不会比原文长）
+     * @param text 文本起始指针
+     * @param length 文本长度
+     * @return 解码后的长度
+     */
+    static std::size_t decodeEntities(char* text, std::size_t length);
+
+private:
+    TXXmlSaxHandler& handler_;
+    std::string buffer_;            ///< 输入缓冲区
+    std::size_t head_ = 0;          ///< buffer_ 中第一个未消费字节的位置
+    TXXmlSaxAttributes attributes_; ///< 复用的属性列表
+    std::string openNames_;                     ///< 未关闭元素的名称，依次拼接
+    std::vector<std::size_t> openNameStarts_;   ///< 每个未关闭元素的名称在 openNames_ 中的起始位置
+    std::size_t consumed_ = 0;      ///< 已丢弃的字节数（用于错误定位）
+    bool finished_ = false;
+    bool paused_ = false;
+
+    TXResult<void> process(bool final);
+    TXResult<void> parseStartTag(char* begin, char* end);
+    TXResult<void> makeError(const std::string& message, std::size_t offset) const;
+};
+
+} // namespace TinaXlsx
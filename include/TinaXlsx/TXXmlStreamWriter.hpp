@@ -0,0 +1,229 @@
+//
+// @file TXXmlStreamWriter.hpp
+// @brief 直接写缓冲区的 XML 输出器 - 无中间节点树，可按阈值冲刷到输出端
+//
+
+#pragma once
+
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "TXResult.hpp"
+
+namespace TinaXlsx {
+
+// 前向声明
+class TXZipArchiveWriter;
+
+/**
+ * @brief XML 输出端
+ */
+class TXXmlSink {
+public:
+    virtual ~TXXmlSink() = default;
+
+    /**
+     * @brief 写出一段已序列化的数据
+     * @param data 数据指针
+     * @param size 数据长度
+     * @return TXResult<void> 操作结果
+     */
+    virtual TXResult<void> write(const char* data, std::size_t size) = 0;
+};
+
+/**
+ * @brief 把数据写入 ZIP 中当前打开的流式条目
+ */
+class TXZipEntrySink : public TXXmlSink {
+public:
+    explicit TXZipEntrySink(TXZipArchiveWriter& zipWriter) : zipWriter_(zipWriter) {}
+
+    TXResult<void> write(const char* data, std::size_t size) override;
+
+private:
+    TXZipArchiveWriter& zipWriter_;
+};
+
+/**
+ * @brief 流式 XML 输出器
+ *
+ * 元素、属性和文本直接序列化进内部缓冲区，属性按调用顺序输出，不做缩进。
+ * 设置了输出端时，缓冲区超过阈值即冲刷，因此内存占用与文档大小无关；
+ * 未设置输出端时，整个文档累积在 buffer() 中。
+ *
+ * 输出端出错后后续写入都会被忽略，错误由 flush()/status() 返回。
+ *
+ * @code
+ * TXXmlStreamWriter xml;
+ * xml.declaration();
+ * xml.startElement("row").attribute("r", 1);
+ * xml.startElement("c").attribute("r", "A1").endElement("c");
+ * xml.endElement("row");
+ * @endcode
+ */
+class TXXmlStreamWriter {
+public:
+    static constexpr std::size_t DEFAULT_FLUSH_THRESHOLD = 64 * 1024;
+
+    /**
+     * @brief 构造输出器
+     * @param sink 输出端，为 nullptr 时累积在内部缓冲区
+     * @param flushThreshold 缓冲区冲刷阈值（字节）
+     */
+    explicit TXXmlStreamWriter(TXXmlSink* sink = nullptr, std::size_t flushThreshold = DEFAULT_FLUSH_THRESHOLD);
+
+    /**
+     * @brief 写入 XML 声明
+     */
+    TXXmlStreamWriter& declaration();
+
+    /**
+     * @brief 开始元素，之后可以继续添加属性
+     */
+    TXXmlStreamWriter& startElement(std::string_view name);
+
+    /**
+     * @brief 添加字符串属性（自动转义）
+     */
+    TXXmlStreamWriter& attribute(std::string_view name, std::string_view value);
+
+    /**
+     * @brief 添加整数属性
+     */
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+    TXXmlStreamWriter& attribute(std::string_view name, T value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        return attributeRaw(name, std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)));
+    }
+
+    /**
+     * @brief 添加浮点数属性
+     */
+    TXXmlStreamWriter& attribute(std::string_view name, double value);
+
+    /**
+     * @brief 添加无需转义的属性（调用方保证内容安全，例如数字或单元格引用）
+     */
+    TXXmlStreamWriter& attributeRaw(std::string_view name, std::string_view value);
+
+    /**
+     * @brief 写入文本内容（自动转义）
+     */
+    TXXmlStreamWriter& text(std::string_view value);
+
+    /**
+     * @brief 写入整数文本
+     */
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+    TXXmlStreamWriter& text(T value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        return raw(std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)));
+    }
+
+    /**
+     * @brief 写入浮点数文本
+     */
+    TXXmlStreamWriter& text(double value);
+
+    /**
+     * @brief 结束元素；没有内容的元素输出为自闭合形式
+     * @param name 元素名，必须与对应的 startElement 一致
+     */
+    TXXmlStreamWriter& endElement(std::string_view name);
+
+    /**
+     * @brief 写入 <name>value</name>
+     */
+    TXXmlStreamWriter& element(std::string_view name, std::string_view value);
+
+    /**
+     * @brief 原样写入已序列化的片段
+     */
+    TXXmlStreamWriter& raw(std::string_view data);
+
+    /**
+     * @brief 把缓冲区内容写到输出端（无输出端时不做任何事）
+     * @return TXResult<void> 第一次出现的错误或 Ok
+     */
+    TXResult<void> flush();
+
+    /**
+     * @brief 当前状态（第一次出现的错误或 Ok）
+     */
+    TXResult<void> status() const;
+
+    /**
+     * @brief 内部缓冲区（无输出端时即完整文档）
+     */
+    const std::string& buffer() const { return buffer_; }
+
+    /**
+     * @brief 取走内部缓冲区内容
+     */
+    std::string takeBuffer();
+
+    /**
+     * @brief 清空缓冲区和状态以便复用
+     */
+    void reset();
+
+    /**
+     * @brief 预留缓冲区容量
+     */
+    void reserve(std::size_t size) { buffer_.reserve(size); }
+
+    /**
+     * @brief 已写出的总字节数（含已冲刷部分）
+     */
+    std::size_t bytesWritten() const { return flushedBytes_ + buffer_.size(); }
+
+    /**
+     * @brief 文本首尾有空白时需要 xml:space="preserve"，否则读取方可能裁剪
+     */
+    static bool needsSpacePreserve(std::string_view value) {
+        if (value.empty()) {
+            return false;
+        }
+        auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; };
+        return isSpace(value.front()) || isSpace(value.back());
+    }
+
+    /**
+     * @brief 按文本规则转义并追加到 out
+     */
+    static void appendEscapedText(std::string& out, std::string_view value);
+
+    /**
+     * @brief 按属性规则转义并追加到 out
+     */
+    static void appendEscapedAttribute(std::string& out, std::string_view value);
+
+private:
+    TXXmlSink* sink_;
+    std::size_t flushThreshold_;
+    std::string buffer_;
+    std::size_t flushedBytes_ = 0;
+    bool tagOpen_ = false;      ///< 开始标签尚未闭合（可继续添加属性）
+    bool failed_ = false;
+    TXError error_;
+
+    void closeStartTag() {
+        if (tagOpen_) {
+            buffer_.push_back('>');
+            tagOpen_ = false;
+        }
+    }
+
+    void maybeFlush() {
+        if (sink_ && buffer_.size() >= flushThreshold_) {
+            flushBuffer();
+        }
+    }
+
+    void flushBuffer();
+};
+
+} // namespace TinaXlsx
@@ -8,25 +8,20 @@
 #include <string>
 #include <vector>
 #include <memory>
-#include <unordered_map>
+#include <utility>
 #include "TXResult.hpp"
 
-// 前向声明
-namespace pugi {
-class xml_document;
-class xml_node;
-}
-
 namespace TinaXlsx {
 
 // 前向声明
 class TXZipArchiveWriter;
+class TXXmlStreamWriter;
 
 /**
  * @brief XML 写入选项
  */
 struct XmlWriteOptions {
-    bool format_output = true;          ///< 是否格式化输出
+    bool format_output = false;         ///< 是否格式化输出（XLSX 部件默认不缩进）
     std::string indent = "  ";          ///< 缩进字符串
     bool include_declaration = true;    ///< 是否包含 XML 声明
     std::string encoding = "UTF-8";     ///< 编码格式
@@ -34,9 +29,14 @@ struct XmlWriteOptions {
 
 /**
  * @brief XML 节点构建器
+ *
+ * 用于图表、样式等结构较深的部件；属性按添加顺序输出。
+ * 大数据量的部件（工作表、共享字符串）应直接使用 TXXmlStreamWriter。
  */
 class XmlNodeBuilder {
 public:
+    using Attribute = std::pair<std::string, std::string>;
+
     XmlNodeBuilder(const std::string& name);
     
     /**
@@ -45,7 +45,7 @@ public:
     XmlNodeBuilder& setText(const std::string& text);
     
     /**
-     * @brief 添加属性
+     * @brief 添加属性，同名属性覆盖原值并保持原位置
      */
     XmlNodeBuilder& addAttribute(const std::string& name, const std::string& value);
     
@@ -53,6 +53,11 @@ public:
      * @brief 添加子节点
      */
     XmlNodeBuilder& addChild(const XmlNodeBuilder& child);
+
+    /**
+     * @brief 添加子节点（移入，避免复制整棵子树）
+     */
+    XmlNodeBuilder& addChild(XmlNodeBuilder&& child);
     
     /**
      * @brief 获取节点名称
@@ -65,9 +70,9 @@ public:
     const std::string& getText() const;
     
     /**
-     * @brief 获取属性映射
+     * @brief 获取属性列表（按添加顺序）
      */
-    const std::unordered_map<std::string, std::string>& getAttributes() const;
+    const std::vector<Attribute>& getAttributes() const;
     
     /**
      * @brief 获取子节点列表
@@ -77,14 +82,15 @@ public:
 private:
     std::string name_;
     std::string text_;
-    std::unordered_map<std::string, std::string> attributes_;
+    std::vector<Attribute> attributes_;
     std::vector<XmlNodeBuilder> children_;
 };
 
 /**
  * @brief XML 写入器
  * 
- * 专门用于生成 XLSX 文件中的 XML 内容，封装了 ZIP 写入操作
+ * 把 XmlNodeBuilder 树序列化为 XML 并写入 ZIP，底层使用 TXXmlStreamWriter，
+ * 不再经过中间 DOM。
  */
 class TXXmlWriter {
 public:
@@ -166,19 +172,23 @@ public:
     
     TXResult<DocumentStats> getStats() const;
 
+    /**
+     * @brief 把节点树写入流式输出器（不缩进）
+     * @param out 输出器
+     * @param node 节点树
+     */
+    static void writeNode(TXXmlStreamWriter& out, const XmlNodeBuilder& node);
+
 private:
-    std::unique_ptr<pugi::xml_document> doc_;
+    std::unique_ptr<XmlNodeBuilder> root_;
     XmlWriteOptions options_;
     bool isValid_ = false;
 
-    // 递归构建 XML 节点
-    void buildNode(pugi::xml_node& parent, const XmlNodeBuilder& builder);
-    
-    // 生成格式化的 XML 字符串
+    // 生成 XML 字符串
     std::string generateString() const;
 
     // 统计文档信息
-    DocumentStats calculateStats(const pugi::xml_node& node) const;
+    static DocumentStats calculateStats(const XmlNodeBuilder& node);
 };
 
 } // namespace TinaXlsx
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <mz_strm_os.h>
 #include <mz_strm_mem.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -15,8 +16,13 @@
 #include <ctime>
 #include <functional>
 #include <cstring>
+#include <memory>
+#include <optional>
+#include <string_view>
 
 #include "TXResult.hpp"
+#include "TXDeflate.hpp"
+#include "TXMappedFile.hpp"
 
 namespace TinaXlsx
 {
@@ -32,6 +38,17 @@ namespace TinaXlsx
         bool is_directory = false;
     };
 
+    /// 条目未解压的原始数据，用于在归档之间原样复制
+    struct ZipRawEntry
+    {
+        const uint8_t* data = nullptr; // 指向源归档中的压缩数据
+        std::size_t compressed_size = 0;
+        std::size_t uncompressed_size = 0;
+        uint32_t crc32 = 0;
+        uint16_t method = 0; // MZ_COMPRESS_METHOD_STORE 或 MZ_COMPRESS_METHOD_DEFLATE
+        std::time_t modified_date = 0;
+    };
+
     // ────────────────────────────────────────────────────────────────────────────
     //  RAII handle wrapper (minizip uses C pointers)
     // ────────────────────────────────────────────────────────────────────────────
@@ -104,215 +121,149 @@ namespace TinaXlsx
     // ────────────────────────────────────────────────────────────────────────────
     //  Reader implementation
     // ────────────────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief 基于内存映射的 ZIP 归档读取器
+     *
+     * 打开时把整个归档映射进内存（或直接使用调用者提供的内存），解析中央目录；STORED 条目可以零拷贝
+     * 地以 view() 取得，DEFLATE 条目按调用者提供的缓冲区逐段解压。并发打开多个
+     * 大工作簿时数据只存在于页缓存中，不会在堆上再保留一份压缩数据。
+     */
     class TXZipArchiveReader
     {
     public:
-        TXZipArchiveReader() = default;
-        ~TXZipArchiveReader() { close(); }
+        TXZipArchiveReader();
+        ~TXZipArchiveReader();
 
         TXZipArchiveReader(const TXZipArchiveReader&) = delete;
         TXZipArchiveReader& operator=(const TXZipArchiveReader&) = delete;
 
-        TXZipArchiveReader(TXZipArchiveReader&& o) noexcept { *this = std::move(o); }
+        TXZipArchiveReader(TXZipArchiveReader&& o) noexcept;
+        TXZipArchiveReader& operator=(TXZipArchiveReader&& o) noexcept;
 
-        TXZipArchiveReader& operator=(TXZipArchiveReader&& o) noexcept
-        {
-            if (this != &o)
-            {
-                close();
-                reader_ = std::move(o.reader_);
-                is_open_ = o.is_open_;
-                filename_ = std::move(o.filename_);
-                o.is_open_ = false;
-            }
-            return *this;
-        }
+        /**
+         * @brief 映射归档文件并解析中央目录
+         * @param file 文件路径
+         * @return TXResult<void> 成功则Ok()
+         */
+        [[nodiscard]] TXResult<void> open(const std::string& file);
 
-        [[nodiscard]] TXResult<void> open(const std::string& file)
-        {
-            close();
-            reader_ = ReaderHandle();
-            if (!reader_)
-            {
-                return Err(TX_ERROR_CREATE(TXErrorCode::ZipOpenFailed,
-                                           "mz_zip_reader_create failed (internal minizip-ng error)"));
-            }
-            int32_t err = mz_zip_reader_open_file(reader_.get(), file.c_str());
-            if (err != MZ_OK)
-            {
-                std::string error_message = "Cannot open ZIP archive: " + file +
-                    " (minizip-ng error code: " + std::to_string(err) + ")";
-                return Err<void>(TX_ERROR_CREATE(TXErrorCode::ZipOpenFailed, error_message));
-            }
-            filename_ = file;
-            is_open_ = true;
-            return Ok();
-        }
+        /**
+         * @brief 直接从内存中的归档数据打开，不复制也不经过文件系统
+         * @param data 归档数据，在 close() 或归档对象销毁前必须保持有效
+         * @param size 数据长度
+         * @return TXResult<void> 成功则Ok()
+         */
+        [[nodiscard]] TXResult<void> openMemory(const void* data, std::size_t size);
 
-        void close()
-        {
-            if (reader_ && is_open_)
-            {
-                mz_zip_reader_close(reader_.get());
-            }
-            is_open_ = false;
-            filename_.clear();
-        }
+        void close();
 
         [[nodiscard]] bool isOpen() const { return is_open_; }
 
-        // Enumerate entries – O(n) with no allocations apart from vector growth.
-        [[nodiscard]] TXResult<std::vector<ZipEntry>> entries()
-        {
-            auto open_check = ensureOpen();
-            if (open_check.isError()) return Err<std::vector<ZipEntry>>(open_check.error());
+        // 列出全部条目，直接来自已解析的中央目录
+        [[nodiscard]] TXResult<std::vector<ZipEntry>> entries();
 
-            std::vector<ZipEntry> out_entries;
-            int32_t err = mz_zip_reader_goto_first_entry(reader_.get());
+        [[nodiscard]] TXResult<bool> has(const std::string& entry_name);
 
-            if (err == MZ_END_OF_LIST)
-            {
-                return Ok(std::move(out_entries));
-            }
+        [[nodiscard]] TXResult<std::vector<uint8_t>> read(const std::string& entry_name);
 
-            if (err != MZ_OK)
-            {
-                // 其他错误
-                std::string error_message = "Failed to go to first entry in ZIP (minizip-ng error code: " +
-                    std::to_string(err) + ")";
-                return Err<std::vector<ZipEntry>>(TX_ERROR_CREATE(TXErrorCode::OperationFailed, error_message));
-            }
-
-            do
-            {
-                mz_zip_file* info = nullptr;
-                err = mz_zip_reader_entry_get_info(reader_.get(), &info);
-                if (err == MZ_OK && info)
-                {
-                    ZipEntry e;
-                    e.filename = info->filename ? info->filename : "";
-                    e.uncompressed_size = static_cast<std::size_t>(info->uncompressed_size);
-                    e.compressed_size = static_cast<std::size_t>(info->compressed_size);
-                    e.modified_date = info->modified_date;
-                    e.is_directory = (info->filename && info->filename[strlen(info->filename) - 1] == '/');
-                    out_entries.emplace_back(std::move(e));
-                }
-                else
-                {
-                    std::string error_message = "Failed to get entry info during ZIP iteration (minizip-ng error code: "
-                        + std::to_string(err) + ")";
-                    return Err<std::vector<ZipEntry>>(TX_ERROR_CREATE(TXErrorCode::OperationFailed, error_message));
-                }
-                err = mz_zip_reader_goto_next_entry(reader_.get());
-            }
-            while (err == MZ_OK);
+        [[nodiscard]] TXResult<std::string> readString(const std::string& entry_name);
 
-            if (err != MZ_END_OF_LIST)
-            {
-                // 如果循环不是因为到达列表末尾而正常结束
-                std::string error_message = "Error iterating ZIP entries (minizip-ng error code: " + std::to_string(err)
-                    + ")";
-                return Err<std::vector<ZipEntry>>(TX_ERROR_CREATE(TXErrorCode::OperationFailed, error_message));
-            }
-
-            return Ok(std::move(out_entries));
-        }
-
-        [[nodiscard]] TXResult<bool> has(const std::string& entry_name)
-        {
-            auto open_check = ensureOpen();
-            if (open_check.isError())
-            {
-                return Err<bool>(open_check.error());
-            }
-            int32_t err = mz_zip_reader_locate_entry(reader_.get(), entry_name.c_str(), 1);
-            if (err == MZ_OK)
-            {
-                return Ok(true);
-            }
-            // 其他错误码表示定位操作本身失败
-            std::string error_message = "Failed to locate entry '" + entry_name + "' (minizip-ng error code: " +
-                std::to_string(err) + ")";
-            return Err<bool>(TX_ERROR_CREATE(TXErrorCode::OperationFailed, error_message));
-        }
+        /**
+         * @brief 取得 STORED 条目数据的零拷贝视图
+         *
+         * 视图指向归档数据，在 close() 或归档对象销毁前有效；压缩条目返回错误，
+         * 应改用 readInto() 或 openEntry()/readEntry()。
+         * @param entry_name 条目名称
+         * @return TXResult<std::string_view> 条目数据
+         */
+        [[nodiscard]] TXResult<std::string_view> view(const std::string& entry_name);
 
-        [[nodiscard]] TXResult<std::vector<uint8_t>> read(const std::string& entry_name)
-        {
-            auto open_check = ensureOpen();
-            if (open_check.isError())
-            {
-                return Err<std::vector<uint8_t>>(open_check.error());
-            }
-            int32_t err = mz_zip_reader_locate_entry(reader_.get(), entry_name.c_str(), 1);
+        /**
+         * @brief 把整个条目解压到调用者提供的缓冲区
+         * @param entry_name 条目名称
+         * @param buffer 目标缓冲区
+         * @param capacity 缓冲区大小，不能小于条目的解压大小
+         * @return TXResult<std::size_t> 写入的字节数
+         */
+        [[nodiscard]] TXResult<std::size_t> readInto(const std::string& entry_name, void* buffer,
+                                                     std::size_t capacity);
 
-            if (err != MZ_OK)
-            {
-                std::string error_message = "Failed to locate entry '" + entry_name +
-                    "' for reading (minizip-ng error code: " + std::to_string(err) + ")";
-                return Err<std::vector<uint8_t>>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed, error_message));
-            }
-            err = mz_zip_reader_entry_open(reader_.get());
+        /**
+         * @brief 取得条目未解压的原始数据，配合 TXZipArchiveWriter::copyRaw() 不经解压地复制条目
+         *
+         * 数据指向归档，在 close() 或归档对象销毁前有效。
+         * @param entry_name 条目名称
+         * @return TXResult<ZipRawEntry> 原始数据及 CRC、大小等信息
+         */
+        [[nodiscard]] TXResult<ZipRawEntry> rawEntry(const std::string& entry_name);
 
-            if (err != MZ_OK)
-            {
-                std::string error_message = "Cannot open ZIP entry '" + entry_name +
-                    "' for reading (minizip-ng error code: " + std::to_string(err) + ")";
-                return Err<std::vector<uint8_t>>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed, error_message));
-            }
+        /// readStream() 默认的分块大小
+        static constexpr std::size_t DEFAULT_STREAM_CHUNK = 64 * 1024;
 
-            mz_zip_file* info = nullptr;
-            err = mz_zip_reader_entry_get_info(reader_.get(), &info);
-            if (err != MZ_OK || !info)
-            {
-                mz_zip_reader_entry_close(reader_.get());
-                std::string error_message = "Failed to get ZIP entry info for '" + entry_name +
-                    "' (minizip-ng error code: " + std::to_string(err) + ")";
-                return Err<std::vector<uint8_t>>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed, error_message));
-            }
-            std::vector<uint8_t> data_buffer(static_cast<std::size_t>(info->uncompressed_size));
-            int32_t bytes_read = mz_zip_reader_entry_read(reader_.get(), data_buffer.data(),
-                                                          static_cast<int32_t>(data_buffer.size()));
+        /// 接收一块解压数据，返回错误时 readStream() 立即停止
+        using ChunkSink = std::function<TXResult<void>(const uint8_t* data, std::size_t size)>;
 
-            int32_t close_err = mz_zip_reader_entry_close(reader_.get());
-            if (close_err != MZ_OK && bytes_read >= 0)
-            {
-                // 如果读取成功但关闭失败，也报告问题
-                std::string error_message = "Failed to close ZIP entry '" + entry_name +
-                    "' after reading (minizip-ng error code: " + std::to_string(close_err) + ")";
-                return Err<std::vector<uint8_t>>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed, error_message));
-            }
+        /**
+         * @brief 按固定大小分块解压条目，依次交给 sink 处理
+         *
+         * 峰值内存只有一个分块，与条目大小无关；STORED 条目直接交付映射中的数据，
+         * 不经过中间缓冲。与 openEntry() 打开的条目互不影响；只读取映射中的数据，
+         * 多个线程可以同时对同一归档调用（不能与 open()/close() 并发）。
+         * @param entry_name 条目名称
+         * @param sink 数据块回调，数据只在回调期间有效
+         * @param chunkSize 分块大小
+         * @return TXResult<void> 成功则Ok()，sink 返回的错误原样返回
+         */
+        [[nodiscard]] TXResult<void> readStream(const std::string& entry_name, const ChunkSink& sink,
+                                                std::size_t chunkSize = DEFAULT_STREAM_CHUNK);
 
-            if (bytes_read < 0)
-            {
-                std::string error_message = "Failed to read data from ZIP entry '" + entry_name +
-                    "' (minizip-ng error code: " + std::to_string(bytes_read) + ")";
-                return Err<std::vector<uint8_t>>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed, error_message));
-            }
+        /**
+         * @brief 打开条目以便分块读取（同一时间只能打开一个条目）
+         * @param entry_name 条目名称
+         * @return TXResult<void> 成功则Ok()
+         */
+        [[nodiscard]] TXResult<void> openEntry(const std::string& entry_name);
 
-            if (static_cast<std::size_t>(bytes_read) != data_buffer.size())
-            {
-                return Err<std::vector<uint8_t>>(TX_ERROR_CREATE(TXErrorCode::ZipOpenFailed,
-                                                                 "Incomplete read from ZIP entry '" + entry_name +
-                                                                 "'. Expected " + std::to_string(data_buffer.size()) +
-                                                                 ", got " + std::to_string(bytes_read)));
-            }
-            return Ok(std::move(data_buffer));
-        }
+        /**
+         * @brief 从已打开的条目读取下一块解压数据
+         * @param buffer 目标缓冲区
+         * @param size 缓冲区大小
+         * @return TXResult<std::size_t> 实际读取的字节数，0 表示条目结束
+         */
+        [[nodiscard]] TXResult<std::size_t> readEntry(void* buffer, std::size_t size);
 
-        [[nodiscard]] TXResult<std::string> readString(const std::string& entry_name)
-        {
-            TXResult<std::vector<uint8_t>> read_result = read(entry_name);
-            if (read_result.isError())
-            {
-                return Err<std::string>(read_result.error());
-            }
-            const auto& bytes = read_result.value();
-            return Ok(std::string(bytes.begin(), bytes.end()));
-        }
+        /**
+         * @brief 关闭当前打开的条目
+         */
+        void closeEntry();
 
     private:
-        using ReaderHandle = unique_mz_handle<mz_zip_reader_create, mz_zip_reader_delete>;
-        ReaderHandle reader_;
+        /// 中央目录中的一条记录
+        struct CentralEntry
+        {
+            std::string name;
+            uint16_t method = 0;
+            uint16_t flags = 0;
+            uint32_t crc32 = 0;
+            uint32_t dos_datetime = 0;
+            uint64_t compressed_size = 0;
+            uint64_t uncompressed_size = 0;
+            uint64_t local_header_offset = 0;
+        };
+
+        /// 已打开条目的解压状态，定义在实现文件中以免头文件依赖 zlib
+        struct EntryCursor;
+
+        TXMappedFile mapping_;
+        const uint8_t* data_ = nullptr; ///< 归档数据：文件映射或调用者提供的内存
+        std::size_t size_ = 0;
+        std::vector<CentralEntry> central_;
+        /// 条目名 → central_ 下标，打开时建立一次，查找为 O(1)
+        std::unordered_map<std::string, std::size_t> name_index_;
+        /// 小写条目名 → central_ 下标，用于忽略大小写的查找
+        std::unordered_map<std::string, std::size_t> folded_index_;
+        std::unique_ptr<EntryCursor> cursor_;
         bool is_open_ = false;
         std::string filename_;
 
@@ -324,6 +275,14 @@ namespace TinaXlsx
             }
             return Ok();
         }
+
+        [[nodiscard]] TXResult<void> parseCentralDirectory();
+        [[nodiscard]] const CentralEntry* findEntry(const std::string& entry_name) const;
+
+        /**
+         * @brief 定位条目数据在映射中的位置（跳过本地文件头）
+         */
+        [[nodiscard]] TXResult<const uint8_t*> entryData(const CentralEntry& entry) const;
     };
 
     // ────────────────────────────────────────────────────────────────────────────
@@ -348,10 +307,20 @@ namespace TinaXlsx
             {
                 close(); // 关闭当前实例（如果已打开）
                 writer_ = std::move(o.writer_);
+                mem_stream_ = std::move(o.mem_stream_);
                 is_open_ = o.is_open_;
+                entry_open_ = o.entry_open_;
                 filename_ = std::move(o.filename_);
+                store_threshold_ = o.store_threshold_;
+                modified_time_ = o.modified_time_;
+                pending_ = o.pending_;
+                pending_name_ = std::move(o.pending_name_);
+                pending_mtime_ = o.pending_mtime_;
+                pending_data_ = std::move(o.pending_data_);
+                o.pending_ = false;
                 // last_error_ 成员是内部实现细节，用于构建 TXError，不参与移动赋值
                 o.is_open_ = false; // 源对象置于有效但关闭的状态
+                o.entry_open_ = false;
                 o.filename_.clear();
             }
             return *this;
@@ -368,6 +337,7 @@ namespace TinaXlsx
                                           int16_t level = 6 /* MZ_DEFAULT_COMPRESSION */)
         {
             close(); // 关闭任何先前打开的归档
+            mem_stream_.reset();
             
             // 如果不是追加模式且文件存在，先删除它以确保完全重写
             if (!append && mz_os_file_exists(file.c_str()) == MZ_OK) {
@@ -411,12 +381,85 @@ namespace TinaXlsx
             return Ok(); // 成功打开
         }
 
+        /**
+         * @brief 在内存中创建ZIP归档，不经过文件系统。
+         * 写完后先 close()，再用 memoryBuffer() 取得归档数据。
+         * @param level Deflate 压缩级别 (0‑9)。
+         * @return TXResult<void> 成功则Ok()，失败则Err(TXError)。
+         */
+        [[nodiscard]] TXResult<void> openMemory(int16_t level = 6)
+        {
+            close();
+            mem_stream_.reset();
+
+            MemStreamHandle stream;
+            if (!stream)
+            {
+                return Err(TX_ERROR_CREATE(TXErrorCode::ZipCreateFailed,
+                                           "mz_stream_mem_create failed (internal minizip-ng error)"));
+            }
+            mz_stream_mem_set_grow_size(stream.get(), MEMORY_GROW_SIZE);
+            int32_t err = mz_stream_open(stream.get(), nullptr, MZ_OPEN_MODE_CREATE);
+            if (err != MZ_OK)
+            {
+                return Err(TX_ERROR_CREATE(TXErrorCode::ZipCreateFailed,
+                                           "Cannot open memory stream (minizip-ng error code: " +
+                                           std::to_string(err) + ")"));
+            }
+
+            writer_ = WriterHandle();
+            if (!writer_)
+            {
+                return Err(TX_ERROR_CREATE(TXErrorCode::ZipCreateFailed,
+                                           "mz_zip_writer_create failed (internal minizip-ng error)"));
+            }
+            mz_zip_writer_set_compress_level(writer_.get(), level);
+            err = mz_zip_writer_open(writer_.get(), stream.get(), 0 /* append */);
+            if (err != MZ_OK)
+            {
+                return Err(TX_ERROR_CREATE(TXErrorCode::ZipCreateFailed,
+                                           "Cannot open in-memory ZIP archive for writing (minizip-ng error code: " +
+                                           std::to_string(err) + ")"));
+            }
+            mem_stream_.emplace(std::move(stream));
+            is_open_ = true;
+            return Ok();
+        }
+
+        /**
+         * @brief 取得内存归档的数据。
+         * 只能在 openMemory() 打开并 close() 之后调用；数据在下次打开或对象销毁前有效。
+         * @return TXResult<std::string_view> 归档数据，失败则Err(TXError)。
+         */
+        [[nodiscard]] TXResult<std::string_view> memoryBuffer() const
+        {
+            if (!mem_stream_)
+            {
+                return Err<std::string_view>(TXErrorCode::ZipInvalidState,
+                                             "Archive was not opened in memory. Call openMemory() first.");
+            }
+            if (is_open_)
+            {
+                return Err<std::string_view>(TXErrorCode::ZipInvalidState,
+                                             "Archive is still open. Call close() first.");
+            }
+            const void* buffer = nullptr;
+            int32_t length = 0;
+            mz_stream_mem_get_buffer(mem_stream_->get(), &buffer);
+            mz_stream_mem_get_buffer_length(mem_stream_->get(), &length);
+            return Ok(std::string_view(static_cast<const char*>(buffer), static_cast<std::size_t>(length)));
+        }
+
         /**
          * @brief 关闭当前打开的ZIP归档，完成所有写入操作。
          * 如果未打开，则此操作无效果。
          */
         void close()
         {
+            if (entry_open_ && writer_)
+            {
+                (void)closeEntry();
+            }
             if (writer_ && is_open_)
             {
                 // 确保句柄有效且归档已打开
@@ -436,7 +479,7 @@ namespace TinaXlsx
          * @brief 将内存中的字节向量作为条目写入ZIP归档。
          * @param entry_name 要在归档中创建的条目名称 (UTF‑8 编码)。
          * @param data 包含要写入数据的字节向量。
-         * @param mtimeSec 条目的UNIX时间戳（秒）；如果为0，则使用当前系统时间。
+         * @param mtimeSec 条目的UNIX时间戳（秒）；如果为0，则使用 setModifiedTime() 设置的时间，未设置时为当前系统时间。
          * @return TXResult<void> 成功则Ok()，失败则Err(TXError)。
          */
         [[nodiscard]] TXResult<void> write(const std::string& entry_name,
@@ -451,7 +494,7 @@ namespace TinaXlsx
          * @param entry_name 要在归档中创建的条目名称 (UTF‑8 编码)。
          * @param buf 指向要写入数据的缓冲区的指针。
          * @param size 要写入数据的大小（字节）。
-         * @param mtimeSec 条目的UNIX时间戳（秒）；如果为0，则使用当前系统时间。
+         * @param mtimeSec 条目的UNIX时间戳（秒）；如果为0，则使用 setModifiedTime() 设置的时间，未设置时为当前系统时间。
          * @return TXResult<void> 成功则Ok()，失败则Err(TXError)。
          */
         [[nodiscard]] TXResult<void> write(const std::string& entry_name,
@@ -469,9 +512,11 @@ namespace TinaXlsx
             file_info.filename = entry_name.c_str();
             file_info.version_madeby = MZ_VERSION_MADEBY; // 使用 minizip-ng 定义的版本
 
-            file_info.compression_method = static_cast<uint8_t>(MZ_COMPRESS_METHOD_DEFLATE); // Deflate 压缩
+            // 小于存储阈值的条目不压缩：压缩小文件几乎不省空间，却要付出初始化压缩流的开销
+            file_info.compression_method = static_cast<uint8_t>(
+                size < store_threshold_ ? MZ_COMPRESS_METHOD_STORE : MZ_COMPRESS_METHOD_DEFLATE);
 
-            file_info.modified_date = to_dos_datetime(mtimeSec != 0 ? mtimeSec : std::time(nullptr));
+            file_info.modified_date = to_dos_datetime(entryTime_(mtimeSec));
             file_info.flag = MZ_ZIP_FLAG_UTF8; // 推荐使用 UTF-8 编码文件名
             file_info.uncompressed_size = static_cast<int64_t>(size);
 
@@ -488,6 +533,169 @@ namespace TinaXlsx
             return Ok(); // 成功写入
         }
 
+        /**
+         * @brief 把已压缩好的数据原样写入为一个 DEFLATE 条目，不再经过压缩流。
+         * 用于在工作线程上预先压缩条目，再由调用线程按顺序追加。
+         * @param entry_name 要在归档中创建的条目名称 (UTF‑8 编码)。
+         * @param deflated TXDeflate::compress() 的结果。
+         * @param mtimeSec 条目的UNIX时间戳（秒）；如果为0，则使用 setModifiedTime() 设置的时间，未设置时为当前系统时间。
+         * @return TXResult<void> 成功则Ok()，失败则Err(TXError)。
+         */
+        [[nodiscard]] TXResult<void> writeDeflated(const std::string& entry_name,
+                                                   const TXDeflatedData& deflated,
+                                                   std::time_t mtimeSec = 0)
+        {
+            return writeRaw_(entry_name, MZ_COMPRESS_METHOD_DEFLATE, deflated.bytes.data(), deflated.bytes.size(),
+                             deflated.crc32, deflated.uncompressedSize, mtimeSec);
+        }
+
+        /**
+         * @brief 把另一个归档中条目的原始数据原样写入，不解压也不重新压缩。
+         * 用于增量保存时复制未修改的部件。
+         * @param entry_name 要在归档中创建的条目名称 (UTF‑8 编码)。
+         * @param raw TXZipArchiveReader::rawEntry() 的结果，写入期间源归档必须保持打开。
+         * @return TXResult<void> 成功则Ok()，失败则Err(TXError)。
+         */
+        [[nodiscard]] TXResult<void> copyRaw(const std::string& entry_name, const ZipRawEntry& raw)
+        {
+            return writeRaw_(entry_name, raw.method, raw.data, raw.compressed_size, raw.crc32,
+                             raw.uncompressed_size, raw.modified_date);
+        }
+
+        /**
+         * @brief 开始一个流式写入的条目，之后通过 writeEntry() 追加数据，closeEntry() 结束。
+         * 数据边写边压缩，不需要预先知道条目大小；同一时间只能有一个条目处于打开状态。
+         * @param entry_name 要在归档中创建的条目名称 (UTF‑8 编码)。
+         * @param mtimeSec 条目的UNIX时间戳（秒）；如果为0，则使用 setModifiedTime() 设置的时间，未设置时为当前系统时间。
+         * @return TXResult<void> 成功则Ok()，失败则Err(TXError)。
+         */
+        [[nodiscard]] TXResult<void> openEntry(const std::string& entry_name, std::time_t mtimeSec = 0)
+        {
+            auto open_check = ensureOpen_();
+            if (open_check.isError())
+            {
+                return open_check;
+            }
+            if (entry_open_)
+            {
+                return Err(TXErrorCode::ZipInvalidState, "Another entry is still open. Call closeEntry() first.");
+            }
+
+            if (store_threshold_ > 0)
+            {
+                // 先缓存数据，超过存储阈值时才真正打开压缩条目，关闭时仍未超过则按存储方式写出
+                pending_ = true;
+                pending_name_ = entry_name;
+                pending_mtime_ = mtimeSec;
+                pending_data_.clear();
+                entry_open_ = true;
+                return Ok();
+            }
+            return openStreamingEntry_(entry_name, mtimeSec);
+        }
+
+        /**
+         * @brief 向当前打开的条目追加数据（数据会立即送入压缩流）。
+         * @param buf 数据指针。
+         * @param size 数据大小（字节）。
+         * @return TXResult<void> 成功则Ok()，失败则Err(TXError)。
+         */
+        [[nodiscard]] TXResult<void> writeEntry(const void* buf, std::size_t size)
+        {
+            if (!entry_open_)
+            {
+                return Err(TXErrorCode::ZipInvalidState, "No entry is open. Call openEntry() first.");
+            }
+            const auto* bytes = static_cast<const uint8_t*>(buf);
+            if (pending_)
+            {
+                if (pending_data_.size() + size < store_threshold_)
+                {
+                    pending_data_.insert(pending_data_.end(), bytes, bytes + size);
+                    return Ok();
+                }
+                // 超过阈值：打开压缩条目并补写已缓存的数据
+                pending_ = false;
+                entry_open_ = false;
+                auto openResult = openStreamingEntry_(pending_name_, pending_mtime_);
+                if (openResult.isError())
+                {
+                    return openResult;
+                }
+                std::vector<uint8_t> buffered;
+                buffered.swap(pending_data_);
+                auto bufferedResult = writeEntry(buffered.data(), buffered.size());
+                if (bufferedResult.isError())
+                {
+                    return bufferedResult;
+                }
+            }
+            while (size > 0)
+            {
+                // minizip-ng 单次写入长度为 int32_t
+                const int32_t chunk = static_cast<int32_t>(std::min<std::size_t>(size, 1u << 30));
+                int32_t written = mz_zip_writer_entry_write(writer_.get(), bytes, chunk);
+                if (written != chunk)
+                {
+                    std::string error_message = "Failed to write ZIP entry data (minizip-ng error code: " +
+                        std::to_string(written) + ")";
+                    return Err(TX_ERROR_CREATE(TXErrorCode::ZipWriteEntryFailed, error_message));
+                }
+                bytes += chunk;
+                size -= static_cast<std::size_t>(chunk);
+            }
+            return Ok();
+        }
+
+        /**
+         * @brief 结束当前流式条目，写入数据描述符。
+         * @return TXResult<void> 成功则Ok()，失败则Err(TXError)。
+         */
+        [[nodiscard]] TXResult<void> closeEntry()
+        {
+            if (!entry_open_)
+            {
+                return Ok();
+            }
+            entry_open_ = false;
+            if (pending_)
+            {
+                pending_ = false;
+                std::vector<uint8_t> buffered;
+                buffered.swap(pending_data_);
+                return write(pending_name_, buffered, pending_mtime_);
+            }
+            int32_t err = mz_zip_writer_entry_close(writer_.get());
+            if (err != MZ_OK)
+            {
+                return Err(TX_ERROR_CREATE(TXErrorCode::ZipWriteEntryFailed,
+                                           "Failed to close ZIP entry (minizip-ng error code: " + std::to_string(err) + ")"));
+            }
+            return Ok();
+        }
+
+        /**
+         * @brief 是否有流式条目处于打开状态。
+         */
+        [[nodiscard]] bool isEntryOpen() const { return entry_open_; }
+
+        /**
+         * @brief 设置存储阈值：小于该大小（字节）的条目以 STORE 方式写入，不压缩。
+         * 对 write() 和流式条目都生效；0 表示所有条目都压缩（默认）。
+         * writeDeflated() 写入的是已压缩数据，不受影响。
+         */
+        void setStoreThreshold(std::size_t bytes) { store_threshold_ = bytes; }
+
+        [[nodiscard]] std::size_t storeThreshold() const { return store_threshold_; }
+
+        /**
+         * @brief 设置未指定时间戳的条目使用的修改时间（UNIX 时间戳，秒）；0 表示当前系统时间（默认）。
+         * 固定该值后，相同内容的两次保存得到逐字节相同的归档。
+         */
+        void setModifiedTime(std::time_t mtimeSec) { modified_time_ = mtimeSec; }
+
+        [[nodiscard]] std::time_t modifiedTime() const { return modified_time_; }
+
         /**
          * @brief 将磁盘上的文件直接添加为ZIP归档中的一个条目（可能使用流式处理，效率较高）。
          * @param entry_name 要在归档中创建的条目名称。
@@ -516,9 +724,105 @@ namespace TinaXlsx
 
     private:
         using WriterHandle = unique_mz_handle<mz_zip_writer_create, mz_zip_writer_delete>; ///< minizip 写入器句柄的 RAII 包装。
+        using MemStreamHandle = unique_mz_handle<mz_stream_mem_create, mz_stream_mem_delete>;
+        /// 内存归档每次扩容的大小
+        static constexpr int32_t MEMORY_GROW_SIZE = 1024 * 1024;
+
         WriterHandle writer_; ///< 底层 minizip-ng 写入器句柄。
+        std::optional<MemStreamHandle> mem_stream_; ///< openMemory() 时归档写入的内存流。
         bool is_open_ = false; ///< 标记归档是否已打开以供写入。
+        bool entry_open_ = false; ///< 标记是否有流式条目处于打开状态。
         std::string filename_; ///< 当前打开的归档文件名。
+        std::size_t store_threshold_ = 0; ///< 小于该大小的条目不压缩。
+        std::time_t modified_time_ = 0; ///< 未指定时间戳的条目使用的时间，0 表示当前时间。
+        bool pending_ = false; ///< 流式条目的数据仍在缓存中，尚未打开压缩条目。
+        std::string pending_name_; ///< 缓存中条目的名称。
+        std::time_t pending_mtime_ = 0; ///< 缓存中条目的时间戳。
+        std::vector<uint8_t> pending_data_; ///< 缓存中条目的数据。
+
+        /**
+         * @brief 条目实际使用的时间戳：显式指定的时间、setModifiedTime() 的时间或当前时间。
+         */
+        [[nodiscard]] std::time_t entryTime_(std::time_t mtimeSec) const
+        {
+            if (mtimeSec != 0)
+            {
+                return mtimeSec;
+            }
+            return modified_time_ != 0 ? modified_time_ : std::time(nullptr);
+        }
+
+        /**
+         * @brief 立即打开一个 DEFLATE 流式条目。
+         */
+        [[nodiscard]] TXResult<void> openStreamingEntry_(const std::string& entry_name, std::time_t mtimeSec)
+        {
+            mz_zip_file file_info{};
+            file_info.filename = entry_name.c_str();
+            file_info.version_madeby = MZ_VERSION_MADEBY;
+            file_info.compression_method = static_cast<uint8_t>(MZ_COMPRESS_METHOD_DEFLATE);
+            file_info.modified_date = to_dos_datetime(entryTime_(mtimeSec));
+            file_info.flag = MZ_ZIP_FLAG_UTF8;
+
+            int32_t err = mz_zip_writer_entry_open(writer_.get(), &file_info);
+            if (err != MZ_OK)
+            {
+                std::string error_message = "Failed to open ZIP entry '" + entry_name +
+                    "' for writing (minizip-ng error code: " + std::to_string(err) + ")";
+                return Err(TX_ERROR_CREATE(TXErrorCode::ZipWriteEntryFailed, error_message));
+            }
+            entry_open_ = true;
+            return Ok();
+        }
+
+        /**
+         * @brief 以原始模式写入已按 method 编码好的数据，writeDeflated() 与 copyRaw() 共用。
+         */
+        [[nodiscard]] TXResult<void> writeRaw_(const std::string& entry_name, uint16_t method, const void* data,
+                                               std::size_t size, uint32_t crc32, std::size_t uncompressedSize,
+                                               std::time_t mtimeSec)
+        {
+            auto open_check = ensureOpen_();
+            if (open_check.isError())
+            {
+                return open_check;
+            }
+            if (entry_open_)
+            {
+                return Err(TXErrorCode::ZipInvalidState, "Another entry is still open. Call closeEntry() first.");
+            }
+
+            // 与 openEntry() 相同的条目信息，另外给出 CRC 和大小（关闭时由 minizip-ng 写入）
+            mz_zip_file file_info{};
+            file_info.filename = entry_name.c_str();
+            file_info.version_madeby = MZ_VERSION_MADEBY;
+            file_info.compression_method = static_cast<uint8_t>(method);
+            file_info.modified_date = to_dos_datetime(entryTime_(mtimeSec));
+            file_info.flag = MZ_ZIP_FLAG_UTF8;
+            file_info.crc = crc32;
+            file_info.uncompressed_size = static_cast<int64_t>(uncompressedSize);
+            file_info.compressed_size = static_cast<int64_t>(size);
+
+            mz_zip_writer_set_raw(writer_.get(), 1);
+            int32_t err = mz_zip_writer_entry_open(writer_.get(), &file_info);
+            if (err == MZ_OK)
+            {
+                entry_open_ = true;
+                auto writeResult = writeEntry(data, size);
+                auto closeResult = closeEntry();
+                mz_zip_writer_set_raw(writer_.get(), 0);
+                if (writeResult.isError())
+                {
+                    return writeResult;
+                }
+                return closeResult;
+            }
+            mz_zip_writer_set_raw(writer_.get(), 0);
+
+            std::string error_message = "Failed to open ZIP entry '" + entry_name +
+                "' for raw writing (minizip-ng error code: " + std::to_string(err) + ")";
+            return Err(TX_ERROR_CREATE(TXErrorCode::ZipWriteEntryFailed, error_message));
+        }
 
         /**
          * @brief 内部辅助函数，确保归档当前已打开以供写入。
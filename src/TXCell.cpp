@@ -327,6 +327,10 @@ namespace TinaXlsx
         return formula_object_.get();
     }
 
+    TXFormula* TXCell::getFormulaObject() {
+        return formula_object_.get();
+    }
+
     void TXCell::setFormulaObject(std::unique_ptr<TXFormula> formula_ptr) {
         formula_object_ = std::move(formula_ptr);
         if (formula_object_) {
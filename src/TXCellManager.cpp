@@ -5,35 +5,147 @@
 
 namespace TinaXlsx {
 
+// ==================== CellView ====================
+
+TXCell::CellType TXCellManager::CellView::getType() const {
+    switch (type_) {
+        case SlotType::String: return TXCell::CellType::String;
+        case SlotType::Number: return TXCell::CellType::Number;
+        case SlotType::Integer: return TXCell::CellType::Integer;
+        case SlotType::Boolean: return TXCell::CellType::Boolean;
+        case SlotType::Rich: return rich_->getType();
+        default: return TXCell::CellType::Empty;
+    }
+}
+
+bool TXCellManager::CellView::isEmpty() const {
+    switch (type_) {
+        case SlotType::None:
+        case SlotType::Empty: return true;
+        case SlotType::String: return text_.empty();
+        case SlotType::Rich: return rich_->isEmpty();
+        default: return false;
+    }
+}
+
+u32 TXCellManager::CellView::getStyleIndex() const {
+    return rich_ ? rich_->getStyleIndex() : style_;
+}
+
+bool TXCellManager::CellView::hasFormula() const {
+    return rich_ && rich_->hasFormula();
+}
+
+std::string TXCellManager::CellView::getFormula() const {
+    return rich_ ? rich_->getFormula() : std::string();
+}
+
+const TXFormula* TXCellManager::CellView::getFormulaObject() const {
+    return rich_ ? rich_->getFormulaObject() : nullptr;
+}
+
+TXCellManager::CellValue TXCellManager::CellView::getValue() const {
+    switch (type_) {
+        case SlotType::String: return std::string(text_);
+        case SlotType::Number: return number_;
+        case SlotType::Integer: return integer_;
+        case SlotType::Boolean: return boolean_;
+        case SlotType::Rich: return rich_->getValue();
+        default: return std::monostate{};
+    }
+}
+
+std::string_view TXCellManager::CellView::getText() const {
+    if (rich_) {
+        const auto* str = std::get_if<std::string>(&rich_->getValue());
+        return str ? std::string_view(*str) : std::string_view();
+    }
+    return text_;
+}
+
+bool TXCellManager::CellView::holdsText() const {
+    if (rich_) {
+        return std::holds_alternative<std::string>(rich_->getValue());
+    }
+    return type_ == SlotType::String;
+}
+
+std::string TXCellManager::CellView::getFormattedValue() const {
+    if (rich_) {
+        return rich_->getFormattedValue();
+    }
+    // 普通单元格没有数字格式对象，等同于常规格式
+    return TXNumberFormat(TXNumberFormat::FormatType::General).format(getValue());
+}
+
+bool TXCellManager::CellView::isLocked() const {
+    return rich_ ? rich_->isLocked() : true;
+}
+
+// ==================== ConstIterator ====================
+
+TXCellManager::ConstIterator::ConstIterator(const TXCellManager* manager, std::size_t block)
+    : manager_(manager), block_(block) {
+    settle();
+}
+
+void TXCellManager::ConstIterator::settle() {
+    const auto& blocks = manager_->blockColumns_;
+    while (block_ < blocks.size()) {
+        const auto& cols = blocks[block_];
+        if (cols.empty()) {
+            ++block_;
+            continue;
+        }
+        while (row_ < CHUNK_ROWS) {
+            while (colPos_ < cols.size()) {
+                const u32 col = cols[colPos_];
+                const ColumnChunk& chunk = *manager_->columns_[col].chunks[block_];
+                if (chunk.types[row_] != SlotType::None) {
+                    const Coordinate coord(row_t(static_cast<u32>(block_ * CHUNK_ROWS + row_ + 1)), column_t(col + 1));
+                    current_.first = coord;
+                    current_.second = manager_->makeView(chunk, row_, coord);
+                    return;
+                }
+                ++colPos_;
+            }
+            colPos_ = 0;
+            ++row_;
+        }
+        row_ = 0;
+        ++block_;
+    }
+    // 结束位置
+    row_ = 0;
+    colPos_ = 0;
+}
+
 // ==================== 单元格访问 ====================
 
 TXCell* TXCellManager::getCell(const Coordinate& coord) {
     if (!isValidCoordinate(coord)) {
         return nullptr;
     }
+    adoptReadCells();
 
-    auto it = cells_.find(coord);
-    if (it != cells_.end()) {
-        return &it->second;
-    }
-
-    // 不自动创建单元格，返回nullptr
-    return nullptr;
+    // 不自动创建单元格，不存在时返回nullptr
+    return handOut(coord, promote(coord));
 }
 
 TXCell* TXCellManager::getOrCreateCell(const Coordinate& coord) {
     if (!isValidCoordinate(coord)) {
         return nullptr;
     }
+    adoptReadCells();
 
-    auto it = cells_.find(coord);
-    if (it != cells_.end()) {
-        return &it->second;
+    if (TXCell* cell = promote(coord)) {
+        return handOut(coord, cell);
     }
 
     // 创建新单元格
-    cells_[coord] = TXCell();
-    return &cells_[coord];
+    insertRichCell(coord, TXCell());
+    ++revision_;
+    return &richCells_.find(coord)->second;
 }
 
 const TXCell* TXCellManager::getCell(const Coordinate& coord) const {
@@ -41,21 +153,61 @@ const TXCell* TXCellManager::getCell(const Coordinate& coord) const {
         return nullptr;
     }
 
-    auto it = cells_.find(coord);
-    return (it != cells_.end()) ? &it->second : nullptr;
+    const CellView view = getCellView(coord);
+    if (!view.exists() || view.getCell()) {
+        return view.getCell();
+    }
+
+    // 只读访问不转存，普通单元格的副本放在缓存中
+    if (!readCells_) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(readCells_->mutex);
+    auto it = readCells_->cells.find(coord);
+    if (it == readCells_->cells.end()) {
+        it = readCells_->cells.emplace(coord, makeCell(view)).first;
+    }
+    return &it->second;
+}
+
+TXCellManager::CellView TXCellManager::getCellView(const Coordinate& coord) const {
+    if (!isValidCoordinate(coord)) {
+        return CellView();
+    }
+    const ColumnChunk* chunk = findChunk(coord);
+    if (!chunk) {
+        return CellView();
+    }
+    return makeView(*chunk, slotOf(coord), coord);
 }
 
 bool TXCellManager::hasCell(const Coordinate& coord) const {
-    return cells_.find(coord) != cells_.end();
+    const ColumnChunk* chunk = isValidCoordinate(coord) ? findChunk(coord) : nullptr;
+    return chunk && chunk->types[slotOf(coord)] != SlotType::None;
 }
 
 bool TXCellManager::removeCell(const Coordinate& coord) {
-    auto it = cells_.find(coord);
-    if (it != cells_.end()) {
-        cells_.erase(it);
-        return true;
+    adoptReadCells();
+    ColumnChunk* chunk = isValidCoordinate(coord) ? findChunk(coord) : nullptr;
+    if (!chunk) {
+        return false;
     }
-    return false;
+    const u32 slot = slotOf(coord);
+    if (chunk->types[slot] == SlotType::None) {
+        return false;
+    }
+    if (chunk->types[slot] == SlotType::Rich) {
+        richCells_.erase(coord);
+    }
+    chunk->types[slot] = SlotType::None;
+    if (chunk->styles) {
+        chunk->styles[slot] = 0;
+    }
+    --chunk->count;
+    --cellCount_;
+    releaseChunkIfEmpty(coord);
+    ++revision_;
+    return true;
 }
 
 // ==================== 值操作 ====================
@@ -64,23 +216,57 @@ bool TXCellManager::setCellValue(const Coordinate& coord, const CellValue& value
     if (!isValidCoordinate(coord)) {
         return false;
     }
-
-    auto* cell = getOrCreateCell(coord);
-    if (cell) {
-        cell->setValue(value);
-        return true;
+    adoptReadCells();
+
+    ColumnChunk& chunk = ensureChunk(coord);
+    const u32 slot = slotOf(coord);
+    ++revision_;
+    switch (chunk.types[slot]) {
+        case SlotType::Rich:
+            // 公式单元格设置的是缓存结果，保留公式
+            richCells_.find(coord)->second.setValue(value);
+            return true;
+        case SlotType::None:
+            ++chunk.count;
+            ++cellCount_;
+            break;
+        default:
+            break;
     }
-    return false;
+    storeValue(chunk, slot, value);
+    return true;
 }
 
 TXCellManager::CellValue TXCellManager::getCellValue(const Coordinate& coord) const {
-    const auto* cell = getCell(coord);
-    if (cell) {
-        return cell->getValue();
+    const CellView view = getCellView(coord);
+    if (view.exists()) {
+        return view.getValue();
     }
     return std::string(""); // 默认返回空字符串
 }
 
+bool TXCellManager::setCellStyleIndex(const Coordinate& coord, u32 styleIndex) {
+    adoptReadCells();
+    ColumnChunk* chunk = isValidCoordinate(coord) ? findChunk(coord) : nullptr;
+    const u32 slot = slotOf(coord);
+    if (!chunk || chunk->types[slot] == SlotType::None) {
+        return false;
+    }
+    ++revision_;
+    if (chunk->types[slot] == SlotType::Rich) {
+        richCells_.find(coord)->second.setStyleIndex(styleIndex);
+        return true;
+    }
+    if (!chunk->styles) {
+        if (styleIndex == 0) {
+            return true;
+        }
+        chunk->styles = std::make_unique<u32[]>(CHUNK_ROWS);
+    }
+    chunk->styles[slot] = styleIndex;
+    return true;
+}
+
 std::size_t TXCellManager::setCellValues(const std::vector<std::pair<Coordinate, CellValue>>& values) {
     std::size_t count = 0;
     for (const auto& pair : values) {
@@ -106,34 +292,22 @@ TXCellManager::getCellValues(const std::vector<Coordinate>& coords) const {
 // ==================== 范围操作 ====================
 
 TXRange TXCellManager::getUsedRange() const {
-    if (cells_.empty()) {
-        // 返回无效范围：使用无效坐标
-        return TXRange(TXCoordinate(row_t(static_cast<row_t::index_t>(0)), column_t(static_cast<column_t::index_t>(0))),
-                      TXCoordinate(row_t(static_cast<row_t::index_t>(0)), column_t(static_cast<column_t::index_t>(0))));
-    }
-
     row_t min_row = row_t::last(), max_row = row_t(1);
     column_t min_col = column_t::last(), max_col = column_t(1);
 
     bool found_data = false;
-    for (const auto& pair : cells_) {
-        if (!pair.second.isEmpty()) {
-            const auto& coord = pair.first;
-            if (!found_data) {
-                // 第一个有效单元格，初始化范围
-                min_row = coord.getRow();
-                max_row = coord.getRow();
-                min_col = coord.getCol();
-                max_col = coord.getCol();
-                found_data = true;
-            } else {
-                // 扩展范围
-                min_row = std::min(min_row, coord.getRow());
-                max_row = std::max(max_row, coord.getRow());
-                min_col = std::min(min_col, coord.getCol());
-                max_col = std::max(max_col, coord.getCol());
-            }
+    for (const auto& [coord, view] : *this) {
+        if (view.isEmpty()) {
+            continue;
         }
+        if (!found_data) {
+            // 行优先遍历，第一个非空单元格所在行即最小行
+            min_row = coord.getRow();
+            found_data = true;
+        }
+        max_row = coord.getRow();
+        min_col = std::min(min_col, coord.getCol());
+        max_col = std::max(max_col, coord.getCol());
     }
 
     if (!found_data) {
@@ -147,9 +321,9 @@ TXRange TXCellManager::getUsedRange() const {
 
 row_t TXCellManager::getMaxUsedRow() const {
     row_t max_row = row_t(0);
-    for (const auto& pair : cells_) {
-        if (!pair.second.isEmpty()) {
-            max_row = std::max(max_row, pair.first.getRow());
+    for (const auto& [coord, view] : *this) {
+        if (!view.isEmpty()) {
+            max_row = coord.getRow();
         }
     }
     return max_row;
@@ -157,44 +331,141 @@ row_t TXCellManager::getMaxUsedRow() const {
 
 column_t TXCellManager::getMaxUsedColumn() const {
     column_t max_col = column_t(1);
-    for (const auto& pair : cells_) {
-        if (!pair.second.isEmpty()) {
-            max_col = std::max(max_col, pair.first.getCol());
+    for (const auto& [coord, view] : *this) {
+        if (!view.isEmpty()) {
+            max_col = std::max(max_col, coord.getCol());
         }
     }
     return max_col;
 }
 
 void TXCellManager::clear() {
-    cells_.clear();
+    columns_.clear();
+    blockColumns_.clear();
+    richCells_.clear();
+    if (readCells_) {
+        readCells_->cells.clear();
+    }
+    strings_.reset();
+    cellCount_ = 0;
+    handleSnapshots_.clear();
+    ++revision_;
+}
+
+std::size_t TXCellManager::compactStrings() {
+    TXSharedStringsPool live;
+    for (auto& column : columns_) {
+        for (auto& chunk : column.chunks) {
+            if (!chunk || !chunk->strings) {
+                continue;
+            }
+            for (u32 slot = 0; slot < CHUNK_ROWS; ++slot) {
+                if (chunk->types[slot] == SlotType::String) {
+                    chunk->strings[slot] = live.add(strings_.get(chunk->strings[slot]));
+                }
+            }
+        }
+    }
+    const std::size_t removed = strings_.size() - live.size();
+    strings_ = std::move(live);
+    return removed;
 }
 
 std::size_t TXCellManager::getNonEmptyCellCount() const {
     std::size_t count = 0;
-    for (const auto& pair : cells_) {
-        if (!pair.second.isEmpty()) {
+    for (const auto& [coord, view] : *this) {
+        if (!view.isEmpty()) {
             ++count;
         }
     }
     return count;
 }
 
+std::size_t TXCellManager::getMemoryUsage() const {
+    std::size_t bytes = columns_.capacity() * sizeof(Column)
+                      + blockColumns_.capacity() * sizeof(std::vector<u16>)
+                      + strings_.memoryUsage();
+    for (const auto& column : columns_) {
+        bytes += column.chunks.capacity() * sizeof(std::unique_ptr<ColumnChunk>);
+        for (const auto& chunk : column.chunks) {
+            if (!chunk) {
+                continue;
+            }
+            bytes += sizeof(ColumnChunk);
+            if (chunk->numbers) bytes += CHUNK_ROWS * sizeof(double);
+            if (chunk->integers) bytes += CHUNK_ROWS * sizeof(i64);
+            if (chunk->booleans) bytes += CHUNK_ROWS * sizeof(bool);
+            if (chunk->strings) bytes += CHUNK_ROWS * sizeof(u32);
+            if (chunk->styles) bytes += CHUNK_ROWS * sizeof(u32);
+        }
+    }
+    for (const auto& cols : blockColumns_) {
+        bytes += cols.capacity() * sizeof(u16);
+    }
+    // 侧表节点：键、TXCell、链表指针和缓存的哈希值，外加默认的数字格式对象
+    bytes += richCells_.size() * (sizeof(Coordinate) + sizeof(TXCell) + 2 * sizeof(void*) + sizeof(TXNumberFormat))
+           + richCells_.bucket_count() * sizeof(void*);
+    return bytes;
+}
+
+// ==================== 修改跟踪 ====================
+
+void TXCellManager::trackCellHandles(bool enabled) {
+    trackHandles_ = enabled;
+    handleSnapshots_.clear();
+}
+
+bool TXCellManager::hasHandleChanges() const {
+    for (const auto& [coord, snapshot] : handleSnapshots_) {
+        auto it = richCells_.find(coord);
+        if (it == richCells_.end()) {
+            return true;
+        }
+        const TXCell& cell = it->second;
+        const TXNumberFormat* format = cell.getNumberFormatObject();
+        const TXNumberFormat* oldFormat = snapshot.getNumberFormatObject();
+        if (!(cell == snapshot) || cell.getStyleIndex() != snapshot.getStyleIndex() ||
+            cell.hasStyle() != snapshot.hasStyle() || cell.isLocked() != snapshot.isLocked() ||
+            cell.isMerged() != snapshot.isMerged() || cell.isMasterCell() != snapshot.isMasterCell() ||
+            cell.getMasterCellPosition() != snapshot.getMasterCellPosition() ||
+            (format == nullptr) != (oldFormat == nullptr) ||
+            (format && (format->getFormatType() != oldFormat->getFormatType() ||
+                        format->getFormatString() != oldFormat->getFormatString()))) {
+            return true;
+        }
+    }
+    return false;
+}
+
 // ==================== 行列移动支持 ====================
 
 void TXCellManager::transformCells(std::function<Coordinate(const Coordinate&)> transform) {
-    CellContainer new_cells;
+    adoptReadCells();
+    TXCellManager result;
 
-    for (auto& pair : cells_) {
-        const auto& old_coord = pair.first;
-        auto new_coord = transform(old_coord);
-        
-        if (new_coord.isValid()) {
-            new_cells[new_coord] = std::move(pair.second);
-        }
+    for (const auto& [old_coord, view] : *this) {
+        const Coordinate new_coord = transform(old_coord);
         // 如果新坐标无效，单元格被丢弃（用于删除操作）
+        if (!new_coord.isValid()) {
+            continue;
+        }
+
+        // 多个单元格映射到同一坐标时后者覆盖前者
+        result.removeCell(new_coord);
+        if (view.getCell()) {
+            result.insertRichCell(new_coord, std::move(richCells_.find(old_coord)->second));
+        } else {
+            result.setCellValue(new_coord, view.getValue());
+            result.setCellStyleIndex(new_coord, view.getStyleIndex());
+        }
     }
 
-    cells_ = std::move(new_cells);
+    // 移动后的单元格坐标已变，旧的指针记录不再适用
+    const std::size_t revision = revision_ + 1;
+    const bool trackHandles = trackHandles_;
+    *this = std::move(result);
+    revision_ = revision;
+    trackHandles_ = trackHandles;
 }
 
 std::size_t TXCellManager::removeCellsInRange(const TXRange& range) {
@@ -202,15 +473,24 @@ std::size_t TXCellManager::removeCellsInRange(const TXRange& range) {
         return 0;
     }
 
+    const u32 firstCol = range.getStart().getCol().index();
+    const u32 lastCol = std::min<u32>(range.getEnd().getCol().index(), static_cast<u32>(columns_.size()));
+    const u32 firstRow = range.getStart().getRow().index();
+    const u32 lastRow = range.getEnd().getRow().index();
+
     std::size_t removed_count = 0;
-    auto it = cells_.begin();
-    
-    while (it != cells_.end()) {
-        if (range.contains(it->first)) {
-            it = cells_.erase(it);
-            ++removed_count;
-        } else {
-            ++it;
+    for (u32 col = firstCol; col <= lastCol; ++col) {
+        for (u32 row = firstRow; row <= lastRow; ++row) {
+            const Coordinate coord{row_t(row), column_t(col)};
+            const ColumnChunk* chunk = findChunk(coord);
+            if (!chunk) {
+                // 跳到下一个数据块
+                row = static_cast<u32>((blockOf(coord) + 1) * CHUNK_ROWS);
+                continue;
+            }
+            if (removeCell(coord)) {
+                ++removed_count;
+            }
         }
     }
 
@@ -219,6 +499,168 @@ std::size_t TXCellManager::removeCellsInRange(const TXRange& range) {
 
 // ==================== 私有辅助方法 ====================
 
+TXCellManager::ColumnChunk* TXCellManager::findChunk(const Coordinate& coord) const {
+    const u32 col = coord.getCol().index();
+    if (col > columns_.size()) {
+        return nullptr;
+    }
+    const auto& chunks = columns_[col - 1].chunks;
+    const std::size_t block = blockOf(coord);
+    return block < chunks.size() ? chunks[block].get() : nullptr;
+}
+
+TXCellManager::ColumnChunk& TXCellManager::ensureChunk(const Coordinate& coord) {
+    const u32 col = coord.getCol().index();
+    if (col > columns_.size()) {
+        columns_.resize(col);
+    }
+    auto& chunks = columns_[col - 1].chunks;
+    const std::size_t block = blockOf(coord);
+    if (block >= chunks.size()) {
+        chunks.resize(block + 1);
+    }
+    if (!chunks[block]) {
+        chunks[block] = std::make_unique<ColumnChunk>();
+        if (block >= blockColumns_.size()) {
+            blockColumns_.resize(block + 1);
+        }
+        auto& cols = blockColumns_[block];
+        const u16 colIndex = static_cast<u16>(col - 1);
+        cols.insert(std::lower_bound(cols.begin(), cols.end(), colIndex), colIndex);
+    }
+    return *chunks[block];
+}
+
+void TXCellManager::releaseChunkIfEmpty(const Coordinate& coord) {
+    auto& chunks = columns_[coord.getCol().index() - 1].chunks;
+    const std::size_t block = blockOf(coord);
+    if (chunks[block]->count != 0) {
+        return;
+    }
+    chunks[block].reset();
+    auto& cols = blockColumns_[block];
+    const u16 colIndex = static_cast<u16>(coord.getCol().index() - 1);
+    auto it = std::lower_bound(cols.begin(), cols.end(), colIndex);
+    if (it != cols.end() && *it == colIndex) {
+        cols.erase(it);
+    }
+}
+
+void TXCellManager::storeValue(ColumnChunk& chunk, u32 slot, const CellValue& value) {
+    std::visit([&](auto&& arg) {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (std::is_same_v<T, std::monostate>) {
+            chunk.types[slot] = SlotType::Empty;
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            if (!chunk.strings) {
+                chunk.strings = std::make_unique<u32[]>(CHUNK_ROWS);
+            }
+            chunk.strings[slot] = strings_.add(arg);
+            chunk.types[slot] = SlotType::String;
+        } else if constexpr (std::is_same_v<T, double>) {
+            if (!chunk.numbers) {
+                chunk.numbers = std::make_unique<double[]>(CHUNK_ROWS);
+            }
+            chunk.numbers[slot] = arg;
+            chunk.types[slot] = SlotType::Number;
+        } else if constexpr (std::is_same_v<T, i64>) {
+            if (!chunk.integers) {
+                chunk.integers = std::make_unique<i64[]>(CHUNK_ROWS);
+            }
+            chunk.integers[slot] = arg;
+            chunk.types[slot] = SlotType::Integer;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            if (!chunk.booleans) {
+                chunk.booleans = std::make_unique<bool[]>(CHUNK_ROWS);
+            }
+            chunk.booleans[slot] = arg;
+            chunk.types[slot] = SlotType::Boolean;
+        }
+    }, value);
+}
+
+TXCellManager::CellView TXCellManager::makeView(const ColumnChunk& chunk, u32 slot, const Coordinate& coord) const {
+    CellView view;
+    view.type_ = chunk.types[slot];
+    view.style_ = chunk.styles ? chunk.styles[slot] : 0;
+    switch (view.type_) {
+        case SlotType::String: view.text_ = strings_.get(chunk.strings[slot]); break;
+        case SlotType::Number: view.number_ = chunk.numbers[slot]; break;
+        case SlotType::Integer: view.integer_ = chunk.integers[slot]; break;
+        case SlotType::Boolean: view.boolean_ = chunk.booleans[slot]; break;
+        case SlotType::Rich: view.rich_ = &richCells_.find(coord)->second; break;
+        default: break;
+    }
+    return view;
+}
+
+TXCell* TXCellManager::promote(const Coordinate& coord) {
+    ColumnChunk* chunk = findChunk(coord);
+    if (!chunk) {
+        return nullptr;
+    }
+    const u32 slot = slotOf(coord);
+    switch (chunk->types[slot]) {
+        case SlotType::None:
+            return nullptr;
+        case SlotType::Rich:
+            return &richCells_.find(coord)->second;
+        default:
+            break;
+    }
+
+    TXCell cell = makeCell(makeView(*chunk, slot, coord));
+    chunk->types[slot] = SlotType::Rich;
+    return &richCells_.emplace(coord, std::move(cell)).first->second;
+}
+
+void TXCellManager::adoptReadCells() {
+    if (!readCells_ || readCells_->cells.empty()) {
+        return;
+    }
+    // 修改前把只读副本转入侧表，已经交出的指针继续有效并能看到之后的修改
+    auto& cells = readCells_->cells;
+    while (!cells.empty()) {
+        auto node = cells.extract(cells.begin());
+        ColumnChunk& chunk = *findChunk(node.key());
+        const u32 slot = slotOf(node.key());
+        chunk.types[slot] = SlotType::Rich;
+        if (chunk.styles) {
+            chunk.styles[slot] = 0;
+        }
+        richCells_.insert(std::move(node));
+    }
+}
+
+TXCell* TXCellManager::handOut(const Coordinate& coord, TXCell* cell) {
+    if (cell && trackHandles_) {
+        handleSnapshots_.try_emplace(coord, *cell);
+    }
+    return cell;
+}
+
+TXCell TXCellManager::makeCell(const CellView& view) {
+    TXCell cell(view.getValue());
+    if (view.style_ != 0) {
+        cell.setStyleIndex(view.style_);
+    }
+    return cell;
+}
+
+void TXCellManager::insertRichCell(const Coordinate& coord, TXCell&& cell) {
+    ColumnChunk& chunk = ensureChunk(coord);
+    const u32 slot = slotOf(coord);
+    if (chunk.types[slot] == SlotType::None) {
+        ++chunk.count;
+        ++cellCount_;
+    }
+    if (chunk.styles) {
+        chunk.styles[slot] = 0;
+    }
+    chunk.types[slot] = SlotType::Rich;
+    richCells_.insert_or_assign(coord, std::move(cell));
+}
+
 bool TXCellManager::isValidCoordinate(const Coordinate& coord) const {
     return coord.isValid();
 }
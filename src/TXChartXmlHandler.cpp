@@ -33,27 +33,10 @@ namespace TinaXlsx
 
         XmlNodeBuilder chartSpace = generateChartXml();
 
-        TXXmlWriter writer;
-        auto setRootResult = writer.setRootNode(chartSpace);
-        if (setRootResult.isError()) {
-            return Err<void>(setRootResult.error().getCode(), 
-                           "Failed to set root node: " + setRootResult.error().getMessage());
-        }
-
-        auto xmlContentResult = writer.generateXmlString();
-        if (xmlContentResult.isError()) {
-            return Err<void>(xmlContentResult.error().getCode(), 
-                           "Failed to generate XML: " + xmlContentResult.error().getMessage());
-        }
-
-        std::vector<uint8_t> xmlData(xmlContentResult.value().begin(), xmlContentResult.value().end());
-        auto writeResult = zipWriter.write(partName(), xmlData);
-        if (writeResult.isError()) {
-            return Err<void>(writeResult.error().getCode(), 
-                           "Failed to write " + partName() + ": " + writeResult.error().getMessage());
-        }
-
-        return Ok();
+        TXXmlStreamWriter xml;
+        xml.declaration();
+        TXXmlWriter::writeNode(xml, chartSpace);
+        return writeXmlPart(zipWriter, xml);
     }
 
     std::string TXChartXmlHandler::partName() const
@@ -314,33 +297,16 @@ namespace TinaXlsx
 
     TXResult<void> TXChartRelsXmlHandler::save(TXZipArchiveWriter& zipWriter, const TXWorkbookContext& context)
     {
-        XmlNodeBuilder relationships("Relationships");
-        relationships.addAttribute("xmlns", "http://schemas.openxmlformats.org/package/2006/relationships");
+        TXXmlStreamWriter xml;
+        xml.declaration();
+        xml.startElement("Relationships")
+           .attribute("xmlns", "http://schemas.openxmlformats.org/package/2006/relationships");
 
         // 添加样式关系（如果需要）
         // 这里可以添加图表特定的关系
 
-        TXXmlWriter writer;
-        auto setRootResult = writer.setRootNode(relationships);
-        if (setRootResult.isError()) {
-            return Err<void>(setRootResult.error().getCode(),
-                           "Failed to set root node: " + setRootResult.error().getMessage());
-        }
-
-        auto xmlContentResult = writer.generateXmlString();
-        if (xmlContentResult.isError()) {
-            return Err<void>(xmlContentResult.error().getCode(),
-                           "Failed to generate XML: " + xmlContentResult.error().getMessage());
-        }
-
-        std::vector<uint8_t> xmlData(xmlContentResult.value().begin(), xmlContentResult.value().end());
-        auto writeResult = zipWriter.write(partName(), xmlData);
-        if (writeResult.isError()) {
-            return Err<void>(writeResult.error().getCode(),
-                           "Failed to write " + partName() + ": " + writeResult.error().getMessage());
-        }
-
-        return Ok();
+        xml.endElement("Relationships");
+        return writeXmlPart(zipWriter, xml);
     }
 
     std::string TXChartRelsXmlHandler::partName() const
@@ -450,27 +416,10 @@ namespace TinaXlsx
             drawing.addChild(twoCellAnchor);
         }
 
-        TXXmlWriter writer;
-        auto setRootResult = writer.setRootNode(drawing);
-        if (setRootResult.isError()) {
-            return Err<void>(setRootResult.error().getCode(),
-                           "Failed to set root node: " + setRootResult.error().getMessage());
-        }
-
-        auto xmlContentResult = writer.generateXmlString();
-        if (xmlContentResult.isError()) {
-            return Err<void>(xmlContentResult.error().getCode(),
-                           "Failed to generate XML: " + xmlContentResult.error().getMessage());
-        }
-
-        std::vector<uint8_t> xmlData(xmlContentResult.value().begin(), xmlContentResult.value().end());
-        auto writeResult = zipWriter.write(partName(), xmlData);
-        if (writeResult.isError()) {
-            return Err<void>(writeResult.error().getCode(),
-                           "Failed to write " + partName() + ": " + writeResult.error().getMessage());
-        }
-
-        return Ok();
+        TXXmlStreamWriter xml;
+        xml.declaration();
+        TXXmlWriter::writeNode(xml, drawing);
+        return writeXmlPart(zipWriter, xml);
     }
 
     std::string TXDrawingXmlHandler::partName() const
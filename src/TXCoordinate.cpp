@@ -68,7 +68,13 @@ bool TXCoordinate::isValidCol() const {
 // ==================== TXCoordinate 转换方法实现 ====================
 
 std::string TXCoordinate::toAddress() const {
-    return col_.column_string() + std::to_string(row_.index());
+    char buffer[MAX_ADDRESS_LENGTH];
+    return std::string(buffer, toChars(buffer));
+}
+
+std::size_t TXCoordinate::toChars(char* buffer) const {
+    const std::size_t letters = column_t::column_chars_from_index(col_.index(), buffer);
+    return static_cast<std::size_t>(std::to_chars(buffer + letters, buffer + MAX_ADDRESS_LENGTH, row_.index()).ptr - buffer);
 }
 
 std::string TXCoordinate::getColName() const {
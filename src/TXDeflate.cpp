@@ -0,0 +1,156 @@
+//
+// @file TXDeflate.cpp
+// @brief DEFLATE 压缩实现
+//
+
+#include "TinaXlsx/TXDeflate.hpp"
+#include "TinaXlsx/TXParallel.hpp"
+
+#include <algorithm>
+#include <zlib.h>
+
+namespace TinaXlsx
+{
+    namespace
+    {
+        // zlib 单次处理长度为 uInt
+        constexpr std::size_t MAX_ZLIB_CHUNK = 1u << 30;
+        // DEFLATE 回溯窗口
+        constexpr std::size_t WINDOW_SIZE = 32 * 1024;
+
+        uLong crc32Of(const Bytef* data, std::size_t size)
+        {
+            uLong crc = crc32(0L, Z_NULL, 0);
+            for (std::size_t offset = 0; offset < size; offset += MAX_ZLIB_CHUNK) {
+                crc = crc32(crc, data + offset, static_cast<uInt>(std::min(MAX_ZLIB_CHUNK, size - offset)));
+            }
+            return crc;
+        }
+
+        /**
+         * @brief 把 [data, data + size) 送入压缩流并追加输出
+         * @param flush Z_FINISH 结束整个流；Z_SYNC_FLUSH 在字节边界处结束当前块
+         */
+        bool deflateInto(z_stream& stream, const Bytef* data, std::size_t size, int flush, std::vector<uint8_t>& out)
+        {
+            std::size_t produced = out.size();
+            if (out.capacity() == produced) {
+                out.reserve(produced + std::max<std::size_t>(WINDOW_SIZE,
+                    static_cast<std::size_t>(deflateBound(&stream, static_cast<uLong>(std::min(size, MAX_ZLIB_CHUNK)))) + 64));
+            }
+            out.resize(out.capacity());
+
+            std::size_t consumed = 0;
+            while (true) {
+                if (stream.avail_in == 0 && consumed < size) {
+                    const std::size_t chunk = std::min(MAX_ZLIB_CHUNK, size - consumed);
+                    stream.next_in = const_cast<Bytef*>(data + consumed);
+                    stream.avail_in = static_cast<uInt>(chunk);
+                    consumed += chunk;
+                }
+                if (produced == out.size()) {
+                    out.resize(out.size() * 2);
+                }
+                const std::size_t space = std::min(MAX_ZLIB_CHUNK, out.size() - produced);
+                stream.next_out = out.data() + produced;
+                stream.avail_out = static_cast<uInt>(space);
+
+                const int status = deflate(&stream, consumed == size ? flush : Z_NO_FLUSH);
+                produced += space - stream.avail_out;
+                if (status == Z_STREAM_END) {
+                    break;
+                }
+                if (status != Z_OK && status != Z_BUF_ERROR) {
+                    return false;
+                }
+                // 同步冲刷：输入已全部送入且输出缓冲区没有被写满，说明冲刷已完成
+                if (flush != Z_FINISH && consumed == size && stream.avail_in == 0 && stream.avail_out != 0) {
+                    break;
+                }
+            }
+            out.resize(produced);
+            return true;
+        }
+    }
+
+    TXResult<TXDeflatedData> TXDeflate::compress(const void* data, std::size_t size, int level)
+    {
+        TXDeflatedData result;
+        result.uncompressedSize = size;
+
+        const auto* input = static_cast<const Bytef*>(data);
+        result.crc32 = static_cast<uint32_t>(crc32Of(input, size));
+
+        z_stream stream{};
+        if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return Err<TXDeflatedData>(TXErrorCode::ZipCompressionFailed, "deflateInit2 failed");
+        }
+        const bool ok = deflateInto(stream, input, size, Z_FINISH, result.bytes);
+        deflateEnd(&stream);
+        if (!ok) {
+            return Err<TXDeflatedData>(TXErrorCode::ZipCompressionFailed, "deflate failed");
+        }
+        return Ok(std::move(result));
+    }
+
+    TXResult<TXDeflatedData> TXDeflate::compressParallel(const void* data, std::size_t size, int level,
+                                                         u32 threadCount, std::size_t blockSize)
+    {
+        blockSize = std::max(blockSize, WINDOW_SIZE);
+        const std::size_t blockCount = size == 0 ? 1 : (size + blockSize - 1) / blockSize;
+        if (blockCount == 1) {
+            return compress(data, size, level);
+        }
+
+        const auto* input = static_cast<const Bytef*>(data);
+        std::vector<std::vector<uint8_t>> blocks(blockCount);
+        std::vector<uLong> crcs(blockCount);
+        std::vector<char> failed(blockCount, 0);
+
+        TXParallel::forEach(blockCount, threadCount, [&](std::size_t i) {
+            const std::size_t offset = i * blockSize;
+            const std::size_t length = std::min(blockSize, size - offset);
+            crcs[i] = crc32Of(input + offset, length);
+
+            z_stream stream{};
+            if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                failed[i] = 1;
+                return;
+            }
+            // 以上一块末尾 32KB 作为预设字典，跨块的重复内容仍能被引用
+            if (i > 0) {
+                const std::size_t dictLength = std::min(WINDOW_SIZE, offset);
+                deflateSetDictionary(&stream, input + offset - dictLength, static_cast<uInt>(dictLength));
+            }
+            // 除最后一块外以同步冲刷结束：输出在字节边界处结束且不带结束标志，可直接拼接
+            const int flush = (i + 1 == blockCount) ? Z_FINISH : Z_SYNC_FLUSH;
+            if (!deflateInto(stream, input + offset, length, flush, blocks[i])) {
+                failed[i] = 1;
+            }
+            deflateEnd(&stream);
+        });
+
+        TXDeflatedData result;
+        result.uncompressedSize = size;
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < blockCount; ++i) {
+            if (failed[i]) {
+                return Err<TXDeflatedData>(TXErrorCode::ZipCompressionFailed, "deflate failed");
+            }
+            total += blocks[i].size();
+        }
+
+        result.bytes.reserve(total);
+        uLong crc = crcs[0];
+        for (std::size_t i = 0; i < blockCount; ++i) {
+            result.bytes.insert(result.bytes.end(), blocks[i].begin(), blocks[i].end());
+            std::vector<uint8_t>().swap(blocks[i]);
+            if (i > 0) {
+                const std::size_t length = std::min(blockSize, size - i * blockSize);
+                crc = crc32_combine(crc, crcs[i], static_cast<z_off_t>(length));
+            }
+        }
+        result.crc32 = static_cast<uint32_t>(crc);
+        return Ok(std::move(result));
+    }
+} // namespace TinaXlsx
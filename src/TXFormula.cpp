@@ -2,11 +2,13 @@
 #include "TinaXlsx/TXSheet.hpp"
 #include "TinaXlsx/TXCell.hpp"
 #include "TinaXlsx/TXCoordinate.hpp"
+#include "TinaXlsx/TXCellManager.hpp"
+#include "TinaXlsx/TXNumberUtils.hpp"
+#include "TinaXlsx/TXNumericKernels.hpp"
 #include <algorithm>
 #include <cmath>
 #include <chrono>
-#include <sstream>
-#include <regex>
+#include <iterator>
 #include <cctype>
 
 namespace TinaXlsx {
@@ -132,16 +134,662 @@ bool TXFormula::RangeReference::isValid() const {
            start.row.index() <= end.row.index() && start.col.index() <= end.col.index();
 }
 
+// ==================== 编译器 ====================
+
+namespace {
+
+using FormulaValue = TXFormula::FormulaValue;
+
+/**
+ * @brief 可以直接在数值数组上归约的聚合函数
+ */
+enum class Aggregate : u8 { None, Sum, Average, Count, Max, Min };
+
+struct BuiltinFunction {
+    std::string_view name;
+    FormulaValue (*function)(const std::vector<FormulaValue>&);
+    Aggregate aggregate;
+};
+
+// 内置函数表，编译时函数名解析为表中的下标（IF 编译为跳转指令，不在表中）
+const BuiltinFunction BUILTIN_FUNCTIONS[] = {
+    {"SUM", &TXFormula::sumFunction, Aggregate::Sum},
+    {"AVERAGE", &TXFormula::averageFunction, Aggregate::Average},
+    {"COUNT", &TXFormula::countFunction, Aggregate::Count},
+    {"MAX", &TXFormula::maxFunction, Aggregate::Max},
+    {"MIN", &TXFormula::minFunction, Aggregate::Min},
+    {"CONCATENATE", &TXFormula::concatenateFunction, Aggregate::None},
+    {"LEN", &TXFormula::lenFunction, Aggregate::None},
+    {"ROUND", &TXFormula::roundFunction, Aggregate::None},
+    {"NOW", &TXFormula::nowFunction, Aggregate::None},
+    {"TODAY", &TXFormula::todayFunction, Aggregate::None},
+};
+
+/**
+ * @brief 由累加结果得到聚合函数的值，与 sumFunction() 等对同样参数的结果一致
+ * @param blanks 参数中空值的个数（COUNT 不计）
+ */
+FormulaValue finishAggregate(Aggregate aggregate, const TXNumericAccumulator& acc, std::size_t blanks) {
+    switch (aggregate) {
+    case Aggregate::Sum: return acc.sum;
+    case Aggregate::Average: return acc.count ? acc.sum / static_cast<double>(acc.count) : 0.0;
+    case Aggregate::Count: return static_cast<double>(acc.count - blanks);
+    case Aggregate::Max: return acc.count ? acc.max : 0.0;
+    case Aggregate::Min: return acc.count ? acc.min : 0.0;
+    default: return std::monostate{};
+    }
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::toupper(static_cast<unsigned char>(x)) == std::toupper(static_cast<unsigned char>(y));
+           });
+}
+
+bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '$';
+}
+
+enum class RefKind { Invalid, Cell, Column, Row };
+
+/**
+ * @brief 解析引用的一端（可带 $），整个文本都必须是引用
+ *
+ * 单元格（A1）、整列（A，用于 A:C）或整行（1，用于 1:3）。
+ */
+RefKind parseReferencePart(std::string_view text, TXFormula::CellReference& ref) {
+    std::size_t pos = 0;
+    const bool firstDollar = pos < text.size() && text[pos] == '$';
+    if (firstDollar) {
+        ++pos;
+    }
+    column_t::index_t col = 0;
+    std::size_t letters = 0;
+    while (pos < text.size() && std::isalpha(static_cast<unsigned char>(text[pos]))) {
+        col = col * 26 + static_cast<column_t::index_t>(std::toupper(static_cast<unsigned char>(text[pos])) - 'A' + 1);
+        ++pos;
+        if (++letters > column_t::MAX_COLUMN_LETTERS) {
+            return RefKind::Invalid;
+        }
+    }
+    const bool secondDollar = letters > 0 && pos < text.size() && text[pos] == '$';
+    if (secondDollar) {
+        ++pos;
+    }
+    row_t::index_t row = 0;
+    std::size_t digits = 0;
+    while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+        row = row * 10 + static_cast<row_t::index_t>(text[pos] - '0');
+        ++pos;
+        if (++digits > 7) {
+            return RefKind::Invalid;
+        }
+    }
+    if (pos != text.size() || col > column_t::MAX_COLUMNS || row > row_t::MAX_ROWS ||
+        (digits > 0 && row == 0)) {
+        return RefKind::Invalid;
+    }
+    if (letters > 0 && digits > 0) {
+        ref.col = column_t(col);
+        ref.row = row_t(row);
+        ref.absoluteCol = firstDollar;
+        ref.absoluteRow = secondDollar;
+        return RefKind::Cell;
+    }
+    if (letters > 0 && !secondDollar) {
+        ref.col = column_t(col);
+        ref.absoluteCol = firstDollar;
+        return RefKind::Column;
+    }
+    if (digits > 0) {
+        ref.row = row_t(row);
+        ref.absoluteRow = firstDollar;
+        return RefKind::Row;
+    }
+    return RefKind::Invalid;
+}
+
+/**
+ * @brief 运算用的数值转换：空值为 0，逻辑值为 0/1，文本必须是数字
+ */
+bool toNumber(const FormulaValue& value, double& out) {
+    if (const auto* number = std::get_if<double>(&value)) {
+        out = *number;
+    } else if (const auto* integer = std::get_if<int64_t>(&value)) {
+        out = static_cast<double>(*integer);
+    } else if (const auto* boolean = std::get_if<bool>(&value)) {
+        out = *boolean ? 1.0 : 0.0;
+    } else if (const auto* text = std::get_if<std::string>(&value)) {
+        auto parsed = TXNumberUtils::parseDouble(*text);
+        if (!parsed) {
+            return false;
+        }
+        out = *parsed;
+    } else {
+        out = 0.0;
+    }
+    return true;
+}
+
+/**
+ * @brief 条件判断用的逻辑值转换，文本只接受 TRUE/FALSE
+ */
+bool toCondition(const FormulaValue& value, bool& out) {
+    if (const auto* text = std::get_if<std::string>(&value)) {
+        if (equalsIgnoreCase(*text, "TRUE") || equalsIgnoreCase(*text, "FALSE")) {
+            out = equalsIgnoreCase(*text, "TRUE");
+            return true;
+        }
+        return false;
+    }
+    double number = 0.0;
+    toNumber(value, number);
+    out = number != 0.0;
+    return true;
+}
+
+/**
+ * @brief 按 Excel 规则比较：数字 < 文本 < 逻辑值，文本不区分大小写，空值按另一侧的类型取 0 或空串
+ */
+int compareValues(const FormulaValue& a, const FormulaValue& b) {
+    auto rank = [](const FormulaValue& v, const FormulaValue& other) {
+        if (std::holds_alternative<std::monostate>(v)) {
+            return std::holds_alternative<std::string>(other) ? 1 : (std::holds_alternative<bool>(other) ? 2 : 0);
+        }
+        if (std::holds_alternative<std::string>(v)) {
+            return 1;
+        }
+        return std::holds_alternative<bool>(v) ? 2 : 0;
+    };
+    const int rankA = rank(a, b);
+    const int rankB = rank(b, a);
+    if (rankA != rankB) {
+        return rankA < rankB ? -1 : 1;
+    }
+    if (rankA == 1) {
+        const std::string_view x = std::holds_alternative<std::string>(a) ? std::string_view(std::get<std::string>(a)) : std::string_view();
+        const std::string_view y = std::holds_alternative<std::string>(b) ? std::string_view(std::get<std::string>(b)) : std::string_view();
+        for (std::size_t i = 0; i < x.size() && i < y.size(); ++i) {
+            const int cx = std::toupper(static_cast<unsigned char>(x[i]));
+            const int cy = std::toupper(static_cast<unsigned char>(y[i]));
+            if (cx != cy) {
+                return cx < cy ? -1 : 1;
+            }
+        }
+        return x.size() == y.size() ? 0 : (x.size() < y.size() ? -1 : 1);
+    }
+    double x = 0.0;
+    double y = 0.0;
+    toNumber(a, x);
+    toNumber(b, y);
+    return x == y ? 0 : (x < y ? -1 : 1);
+}
+
+} // namespace
+
+/**
+ * @brief 公式编译器：按优先级递归下降解析，直接生成逆波兰指令
+ *
+ * 优先级从低到高：比较、&、+ -、* /、^、一元负号、后缀 %。
+ */
+class TXFormula::Compiler {
+public:
+    Compiler(std::string_view source, TXFormula& formula)
+        : src_(source), formula_(formula), program_(formula.program_) {}
+
+    FormulaError compile() {
+        if (!parseComparison()) {
+            return error_;
+        }
+        skipSpaces();
+        if (pos_ != src_.size()) {
+            return FormulaError::Syntax;
+        }
+        return FormulaError::None;
+    }
+
+private:
+    void skipSpaces() {
+        while (pos_ < src_.size() && std::isspace(static_cast<unsigned char>(src_[pos_]))) {
+            ++pos_;
+        }
+    }
+
+    char peek() {
+        skipSpaces();
+        return pos_ < src_.size() ? src_[pos_] : '\0';
+    }
+
+    bool fail(FormulaError error) {
+        if (error_ == FormulaError::None) {
+            error_ = error;
+        }
+        return false;
+    }
+
+    u32 emit(OpCode op, u32 a = 0, u32 b = 0) {
+        program_.code.push_back({op, a, b});
+        return static_cast<u32>(program_.code.size() - 1);
+    }
+
+    bool parseComparison() {
+        if (!parseConcat()) {
+            return false;
+        }
+        for (;;) {
+            const char c = peek();
+            OpCode op;
+            if (c == '=') {
+                op = OpCode::Equal;
+                ++pos_;
+            } else if (c == '<' || c == '>') {
+                const char next = pos_ + 1 < src_.size() ? src_[pos_ + 1] : '\0';
+                if (c == '<' && next == '>') {
+                    op = OpCode::NotEqual;
+                    pos_ += 2;
+                } else if (next == '=') {
+                    op = c == '<' ? OpCode::LessEqual : OpCode::GreaterEqual;
+                    pos_ += 2;
+                } else {
+                    op = c == '<' ? OpCode::Less : OpCode::Greater;
+                    ++pos_;
+                }
+            } else {
+                return true;
+            }
+            if (!parseConcat()) {
+                return false;
+            }
+            emit(op);
+        }
+    }
+
+    bool parseConcat() {
+        if (!parseAdditive()) {
+            return false;
+        }
+        while (peek() == '&') {
+            ++pos_;
+            if (!parseAdditive()) {
+                return false;
+            }
+            emit(OpCode::Concat);
+        }
+        return true;
+    }
+
+    bool parseAdditive() {
+        if (!parseTerm()) {
+            return false;
+        }
+        for (char c = peek(); c == '+' || c == '-'; c = peek()) {
+            ++pos_;
+            if (!parseTerm()) {
+                return false;
+            }
+            emit(c == '+' ? OpCode::Add : OpCode::Subtract);
+        }
+        return true;
+    }
+
+    bool parseTerm() {
+        if (!parsePower()) {
+            return false;
+        }
+        for (char c = peek(); c == '*' || c == '/'; c = peek()) {
+            ++pos_;
+            if (!parsePower()) {
+                return false;
+            }
+            emit(c == '*' ? OpCode::Multiply : OpCode::Divide);
+        }
+        return true;
+    }
+
+    bool parsePower() {
+        // 与 Excel 相同，^ 左结合且优先级低于一元负号：-2^2 = 4
+        if (!parseUnary()) {
+            return false;
+        }
+        while (peek() == '^') {
+            ++pos_;
+            if (!parseUnary()) {
+                return false;
+            }
+            emit(OpCode::Power);
+        }
+        return true;
+    }
+
+    bool parseUnary() {
+        const char c = peek();
+        if (c == '-' || c == '+') {
+            ++pos_;
+            if (!parseUnary()) {
+                return false;
+            }
+            if (c == '-') {
+                emit(OpCode::Negate);
+            }
+            return true;
+        }
+        if (!parsePrimary()) {
+            return false;
+        }
+        while (peek() == '%') {
+            ++pos_;
+            emit(OpCode::Percent);
+        }
+        return true;
+    }
+
+    bool parsePrimary() {
+        const char c = peek();
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            std::size_t end = pos_;
+            while (end < src_.size() && std::isdigit(static_cast<unsigned char>(src_[end]))) {
+                ++end;
+            }
+            // 整行范围（1:3）
+            return end < src_.size() && src_[end] == ':' ? parseReference(std::string()) : parseNumber();
+        }
+        if (c == '.' && pos_ + 1 < src_.size() && std::isdigit(static_cast<unsigned char>(src_[pos_ + 1]))) {
+            return parseNumber();
+        }
+        if (c == '"') {
+            return parseString();
+        }
+        if (c == '(') {
+            ++pos_;
+            if (!parseComparison()) {
+                return false;
+            }
+            if (peek() != ')') {
+                return fail(FormulaError::Syntax);
+            }
+            ++pos_;
+            return true;
+        }
+        if (c == '\'') {
+            std::string sheetName;
+            if (!parseQuotedSheetName(sheetName)) {
+                return false;
+            }
+            return parseReference(sheetName);
+        }
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_' || c == '$') {
+            const std::size_t start = pos_;
+            while (pos_ < src_.size() && isIdentifierChar(src_[pos_])) {
+                ++pos_;
+            }
+            const std::string_view name = src_.substr(start, pos_ - start);
+            if (pos_ < src_.size() && src_[pos_] == '(') {
+                ++pos_;
+                return parseCall(name);
+            }
+            if (pos_ < src_.size() && src_[pos_] == '!') {
+                ++pos_;
+                return parseReference(std::string(name));
+            }
+            CellReference ref;
+            const RefKind kind = parseReferencePart(name, ref);
+            if (kind == RefKind::Cell || (kind != RefKind::Invalid && pos_ < src_.size() && src_[pos_] == ':')) {
+                pos_ = start;
+                return parseReference(std::string());
+            }
+            if (equalsIgnoreCase(name, "TRUE") || equalsIgnoreCase(name, "FALSE")) {
+                emit(OpCode::PushBool, equalsIgnoreCase(name, "TRUE") ? 1u : 0u);
+                return true;
+            }
+            // 命名范围等其他名称暂不支持
+            return fail(FormulaError::Name);
+        }
+        return fail(FormulaError::Syntax);
+    }
+
+    bool parseNumber() {
+        const std::size_t start = pos_;
+        while (pos_ < src_.size() && (std::isdigit(static_cast<unsigned char>(src_[pos_])) || src_[pos_] == '.')) {
+            ++pos_;
+        }
+        if (pos_ < src_.size() && (src_[pos_] == 'e' || src_[pos_] == 'E')) {
+            std::size_t exp = pos_ + 1;
+            if (exp < src_.size() && (src_[exp] == '+' || src_[exp] == '-')) {
+                ++exp;
+            }
+            if (exp < src_.size() && std::isdigit(static_cast<unsigned char>(src_[exp]))) {
+                pos_ = exp;
+                while (pos_ < src_.size() && std::isdigit(static_cast<unsigned char>(src_[pos_]))) {
+                    ++pos_;
+                }
+            }
+        }
+        auto number = TXNumberUtils::parseDouble(src_.substr(start, pos_ - start));
+        if (!number) {
+            return fail(FormulaError::Syntax);
+        }
+        program_.numbers.push_back(*number);
+        emit(OpCode::PushNumber, static_cast<u32>(program_.numbers.size() - 1));
+        return true;
+    }
+
+    bool parseString() {
+        std::string text;
+        ++pos_;
+        for (;;) {
+            if (pos_ >= src_.size()) {
+                return fail(FormulaError::Syntax);
+            }
+            const char c = src_[pos_++];
+            if (c == '"') {
+                if (pos_ < src_.size() && src_[pos_] == '"') {
+                    text.push_back('"');
+                    ++pos_;
+                    continue;
+                }
+                break;
+            }
+            text.push_back(c);
+        }
+        program_.strings.push_back(std::move(text));
+        emit(OpCode::PushString, static_cast<u32>(program_.strings.size() - 1));
+        return true;
+    }
+
+    bool parseQuotedSheetName(std::string& sheetName) {
+        ++pos_;
+        for (;;) {
+            if (pos_ >= src_.size()) {
+                return fail(FormulaError::Syntax);
+            }
+            const char c = src_[pos_++];
+            if (c == '\'') {
+                if (pos_ < src_.size() && src_[pos_] == '\'') {
+                    sheetName.push_back('\'');
+                    ++pos_;
+                    continue;
+                }
+                break;
+            }
+            sheetName.push_back(c);
+        }
+        if (pos_ >= src_.size() || src_[pos_] != '!') {
+            return fail(FormulaError::Syntax);
+        }
+        ++pos_;
+        return true;
+    }
+
+    /**
+     * @brief 读取引用的一端
+     */
+    bool readReferencePart(CellReference& ref, RefKind& kind) {
+        const std::size_t start = pos_;
+        while (pos_ < src_.size() && isIdentifierChar(src_[pos_])) {
+            ++pos_;
+        }
+        kind = parseReferencePart(src_.substr(start, pos_ - start), ref);
+        if (kind == RefKind::Invalid) {
+            return fail(FormulaError::Reference);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 读取单元格引用，或由冒号连接的范围（A1:B2、A:C、1:3）
+     */
+    bool parseReference(const std::string& sheetName) {
+        CellReference first;
+        RefKind kind = RefKind::Invalid;
+        if (!readReferencePart(first, kind)) {
+            return false;
+        }
+        first.sheetName = sheetName;
+        if (pos_ < src_.size() && src_[pos_] == ':') {
+            ++pos_;
+            CellReference last;
+            RefKind lastKind = RefKind::Invalid;
+            if (!readReferencePart(last, lastKind)) {
+                return false;
+            }
+            if (lastKind != kind) {
+                return fail(FormulaError::Reference);
+            }
+            last.sheetName = sheetName;
+            if (kind == RefKind::Column) {
+                first.row = row_t(1u);
+                last.row = row_t(row_t::MAX_ROWS);
+            } else if (kind == RefKind::Row) {
+                first.col = column_t(1u);
+                last.col = column_t(column_t::MAX_COLUMNS);
+            }
+            RangeReference range(first, last);
+            // 规范化为左上到右下
+            if (range.start.row.index() > range.end.row.index()) {
+                std::swap(range.start.row, range.end.row);
+            }
+            if (range.start.col.index() > range.end.col.index()) {
+                std::swap(range.start.col, range.end.col);
+            }
+            formula_.rangeDependencies_.push_back(range);
+            if (!sheetName.empty()) {
+                emit(OpCode::RefError);
+                return true;
+            }
+            program_.ranges.push_back(range);
+            emit(OpCode::PushRange, static_cast<u32>(program_.ranges.size() - 1));
+            return true;
+        }
+        if (kind != RefKind::Cell) {
+            return fail(FormulaError::Reference);
+        }
+        formula_.dependencies_.push_back(first);
+        if (!sheetName.empty()) {
+            // 计算时只能访问当前工作表
+            emit(OpCode::RefError);
+            return true;
+        }
+        emit(OpCode::PushCell, first.row.index(), first.col.index());
+        return true;
+    }
+
+    bool parseCall(std::string_view name) {
+        std::string upper(name);
+        std::transform(upper.begin(), upper.end(), upper.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        const auto& custom = formula_.customFunctions_;
+        const bool isCustom = custom.count(std::string(name)) > 0 || custom.count(upper) > 0;
+
+        if (!isCustom && upper == "IF") {
+            return parseIf();
+        }
+
+        u32 argc = 0;
+        if (peek() == ')') {
+            ++pos_;
+        } else {
+            for (;;) {
+                const char c = peek();
+                if (c == ',' || c == ')') {
+                    emit(OpCode::PushEmpty);   // 省略的参数
+                } else if (!parseComparison()) {
+                    return false;
+                }
+                ++argc;
+                const char next = peek();
+                ++pos_;
+                if (next == ')') {
+                    break;
+                }
+                if (next != ',') {
+                    return fail(FormulaError::Syntax);
+                }
+            }
+        }
+
+        if (isCustom) {
+            program_.strings.push_back(custom.count(std::string(name)) > 0 ? std::string(name) : upper);
+            emit(OpCode::CallCustom, static_cast<u32>(program_.strings.size() - 1), argc);
+            return true;
+        }
+        for (std::size_t i = 0; i < std::size(BUILTIN_FUNCTIONS); ++i) {
+            if (BUILTIN_FUNCTIONS[i].name == upper) {
+                emit(OpCode::CallBuiltin, static_cast<u32>(i), argc);
+                return true;
+            }
+        }
+        return fail(FormulaError::Name);
+    }
+
+    /**
+     * @brief IF 编译为条件跳转，只计算选中的分支
+     */
+    bool parseIf() {
+        if (!parseComparison()) {
+            return false;
+        }
+        if (peek() != ',') {
+            return fail(FormulaError::Syntax);
+        }
+        ++pos_;
+        const u32 jumpToElse = emit(OpCode::JumpIfFalse);
+        if (!parseComparison()) {
+            return false;
+        }
+        const u32 jumpToEnd = emit(OpCode::Jump);
+        program_.code[jumpToElse].a = static_cast<u32>(program_.code.size());
+        if (peek() == ',') {
+            ++pos_;
+            if (!parseComparison()) {
+                return false;
+            }
+        } else {
+            emit(OpCode::PushBool, 0);   // 省略 else 分支时与 Excel 一样返回 FALSE
+        }
+        program_.code[jumpToEnd].a = static_cast<u32>(program_.code.size());
+        if (peek() != ')') {
+            return fail(FormulaError::Syntax);
+        }
+        ++pos_;
+        return true;
+    }
+
+    std::string_view src_;
+    std::size_t pos_ = 0;
+    TXFormula& formula_;
+    Program& program_;
+    FormulaError error_ = FormulaError::None;
+};
+
 // ==================== TXFormula 实现 ====================
 
 TXFormula::TXFormula() : lastError_(FormulaError::None) {
-    registerBuiltinFunctions();
 }
 
 TXFormula::TXFormula(const std::string& formula) 
     : formulaString_(formula), lastError_(FormulaError::None) {
-    registerBuiltinFunctions();
-    updateDependencies();
+    compile();
 }
 
 TXFormula::~TXFormula() = default;
@@ -149,7 +797,10 @@ TXFormula::~TXFormula() = default;
 TXFormula::TXFormula(const TXFormula& other)
     : formulaString_(other.formulaString_)
     , lastError_(other.lastError_)
+    , compileError_(other.compileError_)
+    , program_(other.program_)
     , dependencies_(other.dependencies_)
+    , rangeDependencies_(other.rangeDependencies_)
     , customFunctions_(other.customFunctions_) {
 }
 
@@ -157,7 +808,10 @@ TXFormula& TXFormula::operator=(const TXFormula& other) {
     if (this != &other) {
         formulaString_ = other.formulaString_;
         lastError_ = other.lastError_;
+        compileError_ = other.compileError_;
+        program_ = other.program_;
         dependencies_ = other.dependencies_;
+        rangeDependencies_ = other.rangeDependencies_;
         customFunctions_ = other.customFunctions_;
     }
     return *this;
@@ -166,7 +820,10 @@ TXFormula& TXFormula::operator=(const TXFormula& other) {
 TXFormula::TXFormula(TXFormula&& other) noexcept
     : formulaString_(std::move(other.formulaString_))
     , lastError_(other.lastError_)
+    , compileError_(other.compileError_)
+    , program_(std::move(other.program_))
     , dependencies_(std::move(other.dependencies_))
+    , rangeDependencies_(std::move(other.rangeDependencies_))
     , customFunctions_(std::move(other.customFunctions_)) {
 }
 
@@ -174,7 +831,10 @@ TXFormula& TXFormula::operator=(TXFormula&& other) noexcept {
     if (this != &other) {
         formulaString_ = std::move(other.formulaString_);
         lastError_ = other.lastError_;
+        compileError_ = other.compileError_;
+        program_ = std::move(other.program_);
         dependencies_ = std::move(other.dependencies_);
+        rangeDependencies_ = std::move(other.rangeDependencies_);
         customFunctions_ = std::move(other.customFunctions_);
     }
     return *this;
@@ -182,23 +842,26 @@ TXFormula& TXFormula::operator=(TXFormula&& other) noexcept {
 
 bool TXFormula::parseFormula(const std::string& formula) {
     formulaString_ = formula;
-    lastError_ = FormulaError::None;
-    updateDependencies();
-    return true; // 简化实现，总是返回true
+    compile();
+    return compileError_ == FormulaError::None;
 }
 
 TXFormula::FormulaValue TXFormula::evaluate(const TXSheet* sheet, row_t currentRow, column_t currentCol) {
     if (!sheet) {
-        lastError_ = FormulaError::Reference;
-        return std::monostate{};
+        return fail(FormulaError::Reference);
     }
-    
-    try {
-        return evaluateExpression(formulaString_, sheet, currentRow, currentCol);
-    } catch (...) {
-        lastError_ = FormulaError::Syntax;
-        return std::monostate{};
+    return evaluate(sheet->getCellManager(), currentRow, currentCol);
+}
+
+TXFormula::FormulaValue TXFormula::evaluate(const TXCellManager& cells, row_t currentRow, column_t currentCol) {
+    // 引用已在编译时解析为绝对坐标，当前位置暂不参与计算
+    (void)currentRow;
+    (void)currentCol;
+    if (compileError_ != FormulaError::None) {
+        return fail(compileError_);
     }
+    lastError_ = FormulaError::None;
+    return run(cells);
 }
 
 const std::string& TXFormula::getFormulaString() const {
@@ -207,8 +870,7 @@ const std::string& TXFormula::getFormulaString() const {
 
 void TXFormula::setFormulaString(const std::string& formula) {
     formulaString_ = formula;
-    lastError_ = FormulaError::None;
-    updateDependencies();
+    compile();
 }
 
 TXFormula::FormulaError TXFormula::getLastError() const {
@@ -228,29 +890,39 @@ std::string TXFormula::getErrorDescription() const {
     }
 }
 
+std::string_view TXFormula::getErrorValue() const {
+    switch (lastError_) {
+        case FormulaError::None: return {};
+        case FormulaError::Reference: return "#REF!";
+        case FormulaError::Name: return "#NAME?";
+        case FormulaError::Value: return "#VALUE!";
+        case FormulaError::Division: return "#DIV/0!";
+        default: return "#ERROR!";
+    }
+}
+
 std::vector<TXFormula::CellReference> TXFormula::getDependencies() const {
     return dependencies_;
 }
 
+const std::vector<TXFormula::RangeReference>& TXFormula::getRangeDependencies() const {
+    return rangeDependencies_;
+}
+
 bool TXFormula::isValidFormula(const std::string& formula) {
-    // 简化实现，检查基本格式
     if (formula.empty()) return false;
-    
-    // 检查是否包含函数调用或引用
-    std::regex functionRegex(R"([A-Z]+\s*\()");
-    std::regex cellRefRegex(R"([A-Z]+[0-9]+)");
-    
-    return std::regex_search(formula, functionRegex) || 
-           std::regex_search(formula, cellRefRegex) ||
-           formula.find_first_of("+-*/()") != std::string::npos;
+    return TXFormula().parseFormula(formula);
 }
 
 void TXFormula::registerFunction(const std::string& name, const FormulaFunction& func) {
     customFunctions_[name] = func;
+    // 函数名在编译时解析，注册后重新编译以便覆盖同名内置函数
+    compile();
 }
 
 void TXFormula::clearCustomFunctions() {
     customFunctions_.clear();
+    compile();
 }
 
 // ==================== 内置函数实现 ====================
@@ -377,7 +1049,7 @@ std::string TXFormula::valueToString(const FormulaValue& value) {
     if (std::holds_alternative<std::string>(value)) {
         return std::get<std::string>(value);
     } else if (std::holds_alternative<double>(value)) {
-        return std::to_string(std::get<double>(value));
+        return TXNumberUtils::formatForExcelXml(std::get<double>(value));
     } else if (std::holds_alternative<int64_t>(value)) {
         return std::to_string(std::get<int64_t>(value));
     } else if (std::holds_alternative<bool>(value)) {
@@ -431,191 +1103,231 @@ bool TXFormula::valuesEqual(const FormulaValue& a, const FormulaValue& b) {
 
 // ==================== 私有辅助方法 ====================
 
-void TXFormula::registerBuiltinFunctions() {
-    customFunctions_["SUM"] = sumFunction;
-    customFunctions_["AVERAGE"] = averageFunction;
-    customFunctions_["COUNT"] = countFunction;
-    customFunctions_["MAX"] = maxFunction;
-    customFunctions_["MIN"] = minFunction;
-    customFunctions_["IF"] = ifFunction;
-    customFunctions_["CONCATENATE"] = concatenateFunction;
-    customFunctions_["LEN"] = lenFunction;
-    customFunctions_["ROUND"] = roundFunction;
-    customFunctions_["NOW"] = nowFunction;
-    customFunctions_["TODAY"] = todayFunction;
-}
-
-TXFormula::FormulaValue TXFormula::evaluateExpression(const std::string& expr, const TXSheet* sheet, row_t currentRow, column_t currentCol) {
-    std::string workingExpr = expr;
-    
-    // 移除前导的 '=' 符号
-    if (!workingExpr.empty() && workingExpr[0] == '=') {
-        workingExpr = workingExpr.substr(1);
-    }
-    
-    // 替换单元格引用
-    workingExpr = replaceReferences(workingExpr, sheet, currentRow, currentCol);
-    
-    // 检查函数调用
-    size_t parenPos = workingExpr.find('(');
-    if (parenPos != std::string::npos) {
-        std::string funcName = workingExpr.substr(0, parenPos);
-        std::string argsStr = workingExpr.substr(parenPos + 1);
-        
-        // 移除最后的 ')'
-        if (!argsStr.empty() && argsStr.back() == ')') {
-            argsStr.pop_back();
-        }
-        
-        auto args = parseArguments(argsStr, sheet, currentRow, currentCol);
-        return callFunction(funcName, args);
-    }
-    
-    // 否则作为简单表达式计算
-    return evaluateSimpleExpression(workingExpr);
-}
+void TXFormula::compile() {
+    program_ = Program{};
+    dependencies_.clear();
+    rangeDependencies_.clear();
+    lastError_ = FormulaError::None;
 
-std::vector<TXFormula::FormulaValue> TXFormula::parseArguments(const std::string& args, const TXSheet* sheet, row_t currentRow, column_t currentCol) {
-    std::vector<FormulaValue> result;
-    
-    if (args.empty()) return result;
-    
-    std::stringstream ss(args);
-    std::string item;
-    
-    while (std::getline(ss, item, ',')) {
-        // 去除前后空格
-        item.erase(0, item.find_first_not_of(" \t"));
-        item.erase(item.find_last_not_of(" \t") + 1);
-        
-        if (!item.empty()) {
-            auto value = evaluateExpression(item, sheet, currentRow, currentCol);
-            result.push_back(value);
-        }
+    std::string_view source = formulaString_;
+    if (!source.empty() && source.front() == '=') {
+        source.remove_prefix(1);
+    }
+    compileError_ = source.empty() ? FormulaError::Syntax : Compiler(source, *this).compile();
+    if (compileError_ != FormulaError::None) {
+        program_ = Program{};
+        lastError_ = compileError_;
     }
-    
-    return result;
 }
 
-TXFormula::FormulaValue TXFormula::callFunction(const std::string& funcName, const std::vector<FormulaValue>& args) {
-    auto it = customFunctions_.find(funcName);
-    if (it != customFunctions_.end()) {
-        return it->second(args);
-    }
-    
-    lastError_ = FormulaError::Name;
+TXFormula::FormulaValue TXFormula::fail(FormulaError error) {
+    lastError_ = error;
+    stack_.clear();
     return std::monostate{};
 }
 
-void TXFormula::updateDependencies() {
-    dependencies_.clear();
-    
-    // 使用正则表达式查找单元格引用
-    std::regex cellRefRegex(R"([A-Z]+[0-9]+)");
-    std::sregex_iterator iter(formulaString_.begin(), formulaString_.end(), cellRefRegex);
-    std::sregex_iterator end;
-    
-    for (; iter != end; ++iter) {
-        std::string ref = iter->str();
-        CellReference cellRef = CellReference::fromString(ref);
-        if (cellRef.isValid()) {
-            dependencies_.push_back(cellRef);
-        }
-    }
-}
+TXFormula::FormulaValue TXFormula::run(const TXCellManager& cells) {
+    stack_.clear();
+    const std::vector<Instruction>& code = program_.code;
+    for (std::size_t pc = 0; pc < code.size(); ++pc) {
+        const Instruction& ins = code[pc];
+        switch (ins.op) {
+        case OpCode::PushNumber:
+            stack_.push_back({program_.numbers[ins.a], NO_RANGE});
+            break;
+        case OpCode::PushString:
+            stack_.push_back({program_.strings[ins.a], NO_RANGE});
+            break;
+        case OpCode::PushBool:
+            stack_.push_back({ins.a != 0, NO_RANGE});
+            break;
+        case OpCode::PushEmpty:
+            stack_.push_back({std::monostate{}, NO_RANGE});
+            break;
+        case OpCode::PushCell:
+            stack_.push_back({cells.getCellView(TXCoordinate(row_t(ins.a), column_t(ins.b))).getValue(), NO_RANGE});
+            break;
+        case OpCode::PushRange:
+            stack_.push_back({std::monostate{}, ins.a});
+            break;
+        case OpCode::RefError:
+            return fail(FormulaError::Reference);
 
-std::string TXFormula::replaceReferences(const std::string& expression, const TXSheet* sheet, row_t currentRow, column_t currentCol) {
-    std::string result = expression;
-    
-    // 查找并替换单元格引用
-    std::regex cellRefRegex(R"([A-Z]+[0-9]+)");
-    std::sregex_iterator iter(result.begin(), result.end(), cellRefRegex);
-    std::sregex_iterator end;
-    
-    std::vector<std::pair<std::string, std::string>> replacements;
-    
-    for (; iter != end; ++iter) {
-        std::string ref = iter->str();
-        CellReference cellRef = CellReference::fromString(ref);
-        
-        if (cellRef.isValid()) {
-            TXCoordinate coord(cellRef.row, cellRef.col);
-            auto cellValue = sheet->getCellValue(coord);
-            
-            std::string value = "0";
-            if (std::holds_alternative<double>(cellValue)) {
-                value = std::to_string(std::get<double>(cellValue));
-            } else if (std::holds_alternative<int64_t>(cellValue)) {
-                value = std::to_string(std::get<int64_t>(cellValue));
-            } else if (std::holds_alternative<std::string>(cellValue)) {
-                value = "\"" + std::get<std::string>(cellValue) + "\"";
-            } else if (std::holds_alternative<bool>(cellValue)) {
-                value = std::get<bool>(cellValue) ? "1" : "0";
-            }
-            
-            replacements.push_back({ref, value});
+        case OpCode::Add:
+        case OpCode::Subtract:
+        case OpCode::Multiply:
+        case OpCode::Divide:
+        case OpCode::Power: {
+            StackEntry& lhs = stack_[stack_.size() - 2];
+            const StackEntry& rhs = stack_.back();
+            double a = 0.0;
+            double b = 0.0;
+            if (lhs.range != NO_RANGE || rhs.range != NO_RANGE || !toNumber(lhs.value, a) || !toNumber(rhs.value, b)) {
+                return fail(FormulaError::Value);
+            }
+            double result = 0.0;
+            switch (ins.op) {
+            case OpCode::Add: result = a + b; break;
+            case OpCode::Subtract: result = a - b; break;
+            case OpCode::Multiply: result = a * b; break;
+            case OpCode::Divide:
+                if (b == 0.0) {
+                    return fail(FormulaError::Division);
+                }
+                result = a / b;
+                break;
+            default:
+                if (a == 0.0 && b < 0.0) {
+                    return fail(FormulaError::Division);
+                }
+                result = std::pow(a, b);
+                break;
+            }
+            if (!std::isfinite(result)) {
+                return fail(FormulaError::Value);
+            }
+            lhs.value = result;
+            stack_.pop_back();
+            break;
         }
-    }
-    
-    // 执行替换
-    for (const auto& replacement : replacements) {
-        size_t pos = 0;
-        while ((pos = result.find(replacement.first, pos)) != std::string::npos) {
-            result.replace(pos, replacement.first.length(), replacement.second);
-            pos += replacement.second.length();
+        case OpCode::Concat: {
+            StackEntry& lhs = stack_[stack_.size() - 2];
+            const StackEntry& rhs = stack_.back();
+            if (lhs.range != NO_RANGE || rhs.range != NO_RANGE) {
+                return fail(FormulaError::Value);
+            }
+            lhs.value = valueToString(lhs.value) + valueToString(rhs.value);
+            stack_.pop_back();
+            break;
+        }
+        case OpCode::Equal:
+        case OpCode::NotEqual:
+        case OpCode::Less:
+        case OpCode::LessEqual:
+        case OpCode::Greater:
+        case OpCode::GreaterEqual: {
+            StackEntry& lhs = stack_[stack_.size() - 2];
+            const StackEntry& rhs = stack_.back();
+            if (lhs.range != NO_RANGE || rhs.range != NO_RANGE) {
+                return fail(FormulaError::Value);
+            }
+            const int order = compareValues(lhs.value, rhs.value);
+            bool result = false;
+            switch (ins.op) {
+            case OpCode::Equal: result = order == 0; break;
+            case OpCode::NotEqual: result = order != 0; break;
+            case OpCode::Less: result = order < 0; break;
+            case OpCode::LessEqual: result = order <= 0; break;
+            case OpCode::Greater: result = order > 0; break;
+            default: result = order >= 0; break;
+            }
+            lhs.value = result;
+            stack_.pop_back();
+            break;
+        }
+        case OpCode::Negate:
+        case OpCode::Percent: {
+            StackEntry& operand = stack_.back();
+            double value = 0.0;
+            if (operand.range != NO_RANGE || !toNumber(operand.value, value)) {
+                return fail(FormulaError::Value);
+            }
+            operand.value = ins.op == OpCode::Negate ? -value : value / 100.0;
+            break;
         }
-    }
-    
-    return result;
-}
 
-TXFormula::FormulaValue TXFormula::evaluateSimpleExpression(const std::string& expr) {
-    std::string cleanExpr = expr;
-    
-    // 移除空格
-    cleanExpr.erase(std::remove(cleanExpr.begin(), cleanExpr.end(), ' '), cleanExpr.end());
-    
-    // 检查是否是字符串（被引号包围）
-    if (cleanExpr.length() >= 2 && cleanExpr[0] == '"' && cleanExpr.back() == '"') {
-        return cleanExpr.substr(1, cleanExpr.length() - 2);
-    }
-    
-    try {
-        // 简单的算术运算
-        if (cleanExpr.find('+') != std::string::npos) {
-            size_t pos = cleanExpr.find_last_of('+');
-            double left = std::stod(cleanExpr.substr(0, pos));
-            double right = std::stod(cleanExpr.substr(pos + 1));
-            return left + right;
-        } else if (cleanExpr.find('-') != std::string::npos && cleanExpr[0] != '-') {
-            size_t pos = cleanExpr.find_last_of('-');
-            double left = std::stod(cleanExpr.substr(0, pos));
-            double right = std::stod(cleanExpr.substr(pos + 1));
-            return left - right;
-        } else if (cleanExpr.find('*') != std::string::npos) {
-            size_t pos = cleanExpr.find_last_of('*');
-            double left = std::stod(cleanExpr.substr(0, pos));
-            double right = std::stod(cleanExpr.substr(pos + 1));
-            return left * right;
-        } else if (cleanExpr.find('/') != std::string::npos) {
-            size_t pos = cleanExpr.find_last_of('/');
-            double left = std::stod(cleanExpr.substr(0, pos));
-            double right = std::stod(cleanExpr.substr(pos + 1));
-            if (right != 0.0) {
-                return left / right;
+        case OpCode::JumpIfFalse: {
+            bool condition = false;
+            if (stack_.back().range != NO_RANGE || !toCondition(stack_.back().value, condition)) {
+                return fail(FormulaError::Value);
+            }
+            stack_.pop_back();
+            if (!condition) {
+                pc = ins.a - 1;   // 循环末尾会加一
+            }
+            break;
+        }
+        case OpCode::Jump:
+            pc = ins.a - 1;
+            break;
+
+        case OpCode::CallBuiltin:
+        case OpCode::CallCustom: {
+            const std::size_t first = stack_.size() - ins.b;
+            const Aggregate aggregate = ins.op == OpCode::CallBuiltin ? BUILTIN_FUNCTIONS[ins.a].aggregate : Aggregate::None;
+            if (aggregate != Aggregate::None) {
+                // 聚合函数不生成参数列表：范围中的数值单元格以数据块为单位交给 SIMD 内核，
+                // 其他值逐个按 valueToNumber() 累加
+                TXNumericAccumulator acc;
+                std::size_t blanks = 0;
+                auto fold = [&acc, &blanks](const FormulaValue& value) {
+                    acc.add(valueToNumber(value));
+                    blanks += std::holds_alternative<std::monostate>(value) ? 1 : 0;
+                };
+                for (std::size_t i = first; i < stack_.size(); ++i) {
+                    const StackEntry& entry = stack_[i];
+                    if (entry.range == NO_RANGE) {
+                        fold(entry.value);
+                        continue;
+                    }
+                    const RangeReference& range = program_.ranges[entry.range];
+                    cells.forEachNumericBlock(range.start.row, range.start.col, range.end.row, range.end.col,
+                                              [&acc](const double* values, const u8* tags, u8 tag, std::size_t count) {
+                                                  TXNumericKernels::accumulate(values, tags, tag, count, acc);
+                                              },
+                                              [&fold](const TXCoordinate&, const TXCellManager::CellView& view) {
+                                                  if (!view.isEmpty()) {
+                                                      fold(view.getValue());
+                                                  }
+                                              });
+                }
+                stack_.resize(first);
+                stack_.push_back({finishAggregate(aggregate, acc, blanks), NO_RANGE});
+                break;
+            }
+
+            // 参数按顺序收集，范围展开为其中非空单元格的值（与 Excel 的聚合函数一样忽略空单元格）
+            args_.clear();
+            for (std::size_t i = first; i < stack_.size(); ++i) {
+                StackEntry& entry = stack_[i];
+                if (entry.range == NO_RANGE) {
+                    args_.push_back(std::move(entry.value));
+                    continue;
+                }
+                // 只访问存在的单元格，整列范围的代价与实际数据量成正比
+                const RangeReference& range = program_.ranges[entry.range];
+                cells.forEachCellInRange(range.start.row, range.start.col, range.end.row, range.end.col,
+                                         [this](const TXCoordinate&, const TXCellManager::CellView& view) {
+                                             if (!view.isEmpty()) {
+                                                 args_.push_back(view.getValue());
+                                             }
+                                         });
+            }
+            stack_.resize(first);
+
+            FormulaValue result;
+            if (ins.op == OpCode::CallBuiltin) {
+                result = BUILTIN_FUNCTIONS[ins.a].function(args_);
             } else {
-                lastError_ = FormulaError::Division;
-                return std::monostate{};
+                auto it = customFunctions_.find(program_.strings[ins.a]);
+                if (it == customFunctions_.end()) {
+                    return fail(FormulaError::Name);
+                }
+                result = it->second(args_);
             }
+            stack_.push_back({std::move(result), NO_RANGE});
+            break;
+        }
         }
-        
-        // 尝试解析为数字
-        return valueFromString(cleanExpr);
-        
-    } catch (...) {
-        lastError_ = FormulaError::Syntax;
-        return std::monostate{};
     }
+
+    if (stack_.size() != 1 || stack_.back().range != NO_RANGE) {
+        // 单独的范围引用（如 =A1:B2）无法作为一个值返回
+        return fail(FormulaError::Value);
+    }
+    FormulaValue result = std::move(stack_.back().value);
+    stack_.clear();
+    return result;
 }
 
 } // namespace TinaXlsx
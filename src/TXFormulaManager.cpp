@@ -1,6 +1,8 @@
 #include "TinaXlsx/TXFormulaManager.hpp"
 #include "TinaXlsx/TXCellManager.hpp"
 #include "TinaXlsx/TXCell.hpp"
+#include "TinaXlsx/TXFormula.hpp"
+#include "TinaXlsx/TXParallel.hpp"
 #include <regex>
 #include <algorithm>
 #include <queue>
@@ -10,6 +12,15 @@
 
 namespace TinaXlsx {
 
+namespace {
+
+// 公式少于这个数量的层串行计算，避免为很窄的层启动线程
+constexpr std::size_t PARALLEL_LEVEL_MIN = 256;
+// 并行计算时每个任务包含的公式数
+constexpr std::size_t PARALLEL_BATCH = 64;
+
+} // namespace
+
 // ==================== 公式操作 ====================
 
 bool TXFormulaManager::setCellFormula(const TXCoordinate& coord, const std::string& formula, TXCellManager& cellManager) {
@@ -23,16 +34,16 @@ bool TXFormulaManager::setCellFormula(const TXCoordinate& coord, const std::stri
     }
 
     cell->setFormula(formula);
+    if (indexValid_) {
+        indexFormula(coord, *cell);
+        dirty_.insert(coord);
+        markDependentsDirty(coord);
+    }
     return true;
 }
 
 std::string TXFormulaManager::getCellFormula(const TXCoordinate& coord, const TXCellManager& cellManager) const {
-    const auto* cell = cellManager.getCell(coord);
-    if (!cell) {
-        return "";
-    }
-    
-    return cell->getFormula();
+    return cellManager.getCellView(coord).getFormula();
 }
 
 std::size_t TXFormulaManager::setCellFormulas(const std::vector<std::pair<TXCoordinate, std::string>>& formulas, 
@@ -47,33 +58,20 @@ std::size_t TXFormulaManager::setCellFormulas(const std::vector<std::pair<TXCoor
 }
 
 bool TXFormulaManager::hasFormula(const TXCoordinate& coord, const TXCellManager& cellManager) const {
-    const auto* cell = cellManager.getCell(coord);
-    return cell ? cell->hasFormula() : false;
+    return cellManager.getCellView(coord).hasFormula();
 }
 
 // ==================== 公式计算 ====================
 
 std::size_t TXFormulaManager::calculateAllFormulas(TXCellManager& cellManager) {
-    std::size_t count = 0;
-    
     if (!options_.autoCalculate) {
-        return count;
-    }
-    
-    // 获取依赖关系图
-    auto dependencies = getFormulaDependencies(cellManager);
-    
-    // 拓扑排序计算顺序
-    std::vector<TXCoordinate> calculationOrder = getCalculationOrder(dependencies);
-    
-    // 按顺序计算公式
-    for (const auto& coord : calculationOrder) {
-        if (calculateFormula(coord, cellManager)) {
-            ++count;
-        }
+        return 0;
     }
-    
-    return count;
+
+    // 公式可能经 TXCell::setFormula() 绕过本类设置或修改，重建索引后全部视为脏
+    invalidateDependencyIndex();
+    ensureDependencyIndex(cellManager);
+    return recalculate(cellManager);
 }
 
 std::size_t TXFormulaManager::calculateFormulasInRange(const TXRange& range, TXCellManager& cellManager) {
@@ -105,121 +103,215 @@ bool TXFormulaManager::calculateFormula(const TXCoordinate& coord, TXCellManager
         return false;
     }
 
-    std::string formula = cell->getFormula();
+    cell_value_t result;
+    const bool ok = evaluateFormulaCell(*cell, coord, cellManager, result);
+    cell->setValue(result);
+    return ok;
+}
+
+bool TXFormulaManager::evaluateFormulaCell(TXCell& cell, const TXCoordinate& coord, const TXCellManager& cellManager,
+                                           cell_value_t& result) {
+    // 公式在设置时已编译，这里只执行指令
+    TXFormula* formula = cell.getFormulaObject();
 
     try {
-        // 计算公式结果
-        cell_value_t result = evaluateFormula(formula, cellManager);
-        cell->setValue(result);
+        result = formula->evaluate(cellManager, coord.getRow(), coord.getCol());
+        if (formula->getLastError() != TXFormula::FormulaError::None) {
+            // 与 Excel 一样把错误值作为计算结果写入单元格
+            result = std::string(formula->getErrorValue());
+        }
         return true;
     } catch (...) {
         // 计算失败，设置错误值
-        cell->setValue(std::string("#ERROR!"));
+        result = std::string("#ERROR!");
         return false;
     }
 }
 
 std::size_t TXFormulaManager::recalculateDependents(const TXCoordinate& coord, TXCellManager& cellManager) {
+    ensureDependencyIndex(cellManager);
+    markDependentsDirty(coord);
+    return recalculate(cellManager);
+}
+
+std::size_t TXFormulaManager::recalculate(TXCellManager& cellManager) {
+    ensureDependencyIndex(cellManager);
+    if (dirty_.empty()) {
+        return 0;
+    }
+
+    const u32 threadCount = TXParallel::resolveThreadCount(options_.threadCount);
+    std::vector<TXCoordinate> order;
+    std::vector<std::size_t> levels;
+    const std::size_t acyclic = getCalculationOrder(dirty_, order, threadCount > 1 ? &levels : nullptr);
+    dirty_.clear();
+
     std::size_t count = 0;
-    
-    // 获取依赖关系图
-    auto dependencies = getFormulaDependencies(cellManager);
-    
-    // 找到所有依赖于此单元格的单元格
-    std::vector<TXCoordinate> dependents = getDependents(coord, cellManager);
-    
-    // 递归计算所有依赖单元格
-    for (const auto& dependent : dependents) {
-        if (calculateFormula(dependent, cellManager)) {
+    std::size_t next = 0;
+    if (threadCount > 1) {
+        count = calculateLevels(order, levels, acyclic, threadCount, cellManager);
+        next = acyclic;
+    }
+    for (; next < order.size(); ++next) {
+        if (calculateFormula(order[next], cellManager)) {
             ++count;
         }
-        // 递归计算依赖的依赖
-        count += recalculateDependents(dependent, cellManager);
     }
-    
     return count;
 }
 
-// ==================== 依赖关系分析 ====================
+std::size_t TXFormulaManager::calculateLevels(const std::vector<TXCoordinate>& order,
+                                              const std::vector<std::size_t>& levels,
+                                              std::size_t acyclic, u32 threadCount, TXCellManager& cellManager) {
+    std::size_t count = 0;
+    std::vector<TXCell*> cells;
+    std::vector<cell_value_t> results;
+    std::vector<u8> succeeded;
+
+    for (std::size_t level = 0; level < levels.size(); ++level) {
+        const std::size_t begin = levels[level];
+        const std::size_t end = level + 1 < levels.size() ? levels[level + 1] : acyclic;
+        const std::size_t size = end - begin;
+        if (size < PARALLEL_LEVEL_MIN) {
+            for (std::size_t i = begin; i < end; ++i) {
+                if (calculateFormula(order[i], cellManager)) {
+                    ++count;
+                }
+            }
+            continue;
+        }
 
-TXFormulaManager::DependencyGraph TXFormulaManager::getFormulaDependencies(const TXCellManager& cellManager) const {
-    DependencyGraph dependencies;
-    
-    for (auto it = cellManager.begin(); it != cellManager.end(); ++it) {
-        const auto& coord = it->first;
-        const auto& cell = it->second;
-        
-        if (cell.hasFormula()) {
-            std::vector<TXCoordinate> refs = parseFormulaReferences(cell.getFormula());
-            dependencies[coord] = refs;
+        // 先在当前线程取出单元格指针，求值期间单元格管理器只被读取
+        cells.assign(size, nullptr);
+        for (std::size_t i = 0; i < size; ++i) {
+            TXCell* cell = cellManager.getCell(order[begin + i]);
+            cells[i] = cell && cell->hasFormula() ? cell : nullptr;
+        }
+        results.assign(size, cell_value_t());
+        succeeded.assign(size, 0);
+
+        const TXCellManager& snapshot = cellManager;
+        const std::size_t batches = (size + PARALLEL_BATCH - 1) / PARALLEL_BATCH;
+        workerPool(threadCount).forEach(batches, [&](std::size_t batch) {
+            const std::size_t last = std::min(size, (batch + 1) * PARALLEL_BATCH);
+            for (std::size_t i = batch * PARALLEL_BATCH; i < last; ++i) {
+                if (cells[i]) {
+                    succeeded[i] = evaluateFormulaCell(*cells[i], order[begin + i], snapshot, results[i]);
+                }
+            }
+        });
+
+        // 整层算完后写回，下一层读到的是本层的结果
+        for (std::size_t i = 0; i < size; ++i) {
+            if (cells[i]) {
+                cells[i]->setValue(std::move(results[i]));
+                count += succeeded[i];
+            }
         }
     }
-    
-    return dependencies;
+    return count;
+}
+
+TXThreadPool& TXFormulaManager::workerPool(u32 threadCount) {
+    if (!pool_ || pool_->threadCount() != threadCount) {
+        pool_ = std::make_unique<TXThreadPool>(threadCount);
+    }
+    return *pool_;
+}
+
+void TXFormulaManager::onCellChanged(const TXCoordinate& coord) {
+    // 索引未建立时，建立后所有公式都是脏的，不需要记录
+    if (indexValid_) {
+        markDependentsDirty(coord);
+    }
+}
+
+void TXFormulaManager::invalidateDependencyIndex() {
+    precedents_.clear();
+    dependents_.clear();
+    formulaRanges_.clear();
+    rangeNodes_.clear();
+    freeRangeNodes_.clear();
+    rangeNodeIds_.clear();
+    rangeIndex_.clear();
+    dirty_.clear();
+    indexValid_ = false;
+}
+
+// ==================== 依赖关系分析 ====================
+
+TXFormulaManager::DependencyGraph TXFormulaManager::getFormulaDependencies(const TXCellManager& cellManager) const {
+    ensureDependencyIndex(cellManager);
+    return precedents_;
 }
 
 std::vector<TXCoordinate> TXFormulaManager::getDirectDependencies(const TXCoordinate& coord, 
                                                                  const TXCellManager& cellManager) const {
-    const auto* cell = cellManager.getCell(coord);
-    if (!cell || !cell->hasFormula()) {
-        return {};
+    ensureDependencyIndex(cellManager);
+    auto it = precedents_.find(coord);
+    return it != precedents_.end() ? it->second : std::vector<TXCoordinate>{};
+}
+
+std::vector<TXRange> TXFormulaManager::getDirectRangeDependencies(const TXCoordinate& coord,
+                                                                  const TXCellManager& cellManager) const {
+    ensureDependencyIndex(cellManager);
+    std::vector<TXRange> ranges;
+    auto it = formulaRanges_.find(coord);
+    if (it != formulaRanges_.end()) {
+        for (u32 id : it->second) {
+            ranges.push_back(rangeNodes_[id].range);
+        }
     }
-    
-    return parseFormulaReferences(cell->getFormula());
+    return ranges;
 }
 
 std::vector<TXCoordinate> TXFormulaManager::getDependents(const TXCoordinate& coord, 
                                                          const TXCellManager& cellManager) const {
+    ensureDependencyIndex(cellManager);
     std::vector<TXCoordinate> dependents;
-    
-    // 遍历所有单元格，找到引用了指定单元格的公式
-    for (auto it = cellManager.begin(); it != cellManager.end(); ++it) {
-        const auto& cellCoord = it->first;
-        const auto& cell = it->second;
-        
-        if (cell.hasFormula()) {
-            std::vector<TXCoordinate> refs = parseFormulaReferences(cell.getFormula());
-            if (std::find(refs.begin(), refs.end(), coord) != refs.end()) {
-                dependents.push_back(cellCoord);
-            }
-        }
-    }
-    
+    forEachDependent(coord, [&dependents](const TXCoordinate& dependent) {
+        dependents.push_back(dependent);
+    });
+    std::sort(dependents.begin(), dependents.end());
+    dependents.erase(std::unique(dependents.begin(), dependents.end()), dependents.end());
     return dependents;
 }
 
 bool TXFormulaManager::detectCircularReferences(const TXCellManager& cellManager) const {
-    std::unordered_set<TXCoordinate, CoordinateHash> visiting;
-    std::unordered_set<TXCoordinate, CoordinateHash> visited;
-    
-    for (auto it = cellManager.begin(); it != cellManager.end(); ++it) {
-        const auto& coord = it->first;
-        const auto& cell = it->second;
-        
-        if (cell.hasFormula() && visited.find(coord) == visited.end()) {
-            if (detectCircularReferencesHelper(coord, visiting, visited, cellManager)) {
-                return true;
-            }
-        }
+    ensureDependencyIndex(cellManager);
+
+    CoordinateSet formulas;
+    formulas.reserve(precedents_.size());
+    for (const auto& node : precedents_) {
+        formulas.insert(node.first);
     }
-    
-    return false;
+    std::vector<TXCoordinate> order;
+    return getCalculationOrder(formulas, order) != formulas.size();
 }
 
 std::vector<std::vector<TXCoordinate>> TXFormulaManager::getCircularReferences(const TXCellManager& cellManager) const {
+    ensureDependencyIndex(cellManager);
+
+    // 沿“被依赖”方向查找（范围引用只有这个方向的索引），找到的环再反转为引用顺序
     std::vector<std::vector<TXCoordinate>> circularRefs;
-    std::unordered_set<TXCoordinate, CoordinateHash> globalVisited;
+    CoordinateSet globalVisited;
     
-    for (auto it = cellManager.begin(); it != cellManager.end(); ++it) {
-        const auto& coord = it->first;
-        const auto& cell = it->second;
-        
-        if (cell.hasFormula() && globalVisited.find(coord) == globalVisited.end()) {
-            std::unordered_set<TXCoordinate, CoordinateHash> visiting;
-            std::unordered_set<TXCoordinate, CoordinateHash> visited;
+    for (const auto& node : precedents_) {
+        const auto& coord = node.first;
+        if (globalVisited.find(coord) == globalVisited.end()) {
+            CoordinateSet visiting;
+            CoordinateSet visited;
             std::vector<TXCoordinate> path;
             
-            if (findCircularReferencePath(coord, visiting, visited, path, cellManager)) {
+            if (findCircularReferencePath(coord, visiting, visited, path)) {
+                // 从循环外的公式出发会再次走到已报告的循环，跳过
+                const bool reported = std::any_of(path.begin(), path.end(), [&globalVisited](const TXCoordinate& c) {
+                    return globalVisited.find(c) != globalVisited.end();
+                });
+                if (reported) {
+                    continue;
+                }
+                std::reverse(path.begin(), path.end());
                 circularRefs.push_back(path);
                 // 将路径中的所有坐标标记为已访问
                 for (const auto& pathCoord : path) {
@@ -425,45 +517,147 @@ TXFormulaManager::FormulaStats TXFormulaManager::getFormulaStats(const TXCellMan
 void TXFormulaManager::clear() {
     namedRanges_.clear();
     options_ = FormulaCalculationOptions::createDefault();
+    invalidateDependencyIndex();
 }
 
 // ==================== 私有辅助方法 ====================
 
-bool TXFormulaManager::detectCircularReferencesHelper(const TXCoordinate& coord,
-                                                     std::unordered_set<TXCoordinate, CoordinateHash>& visiting,
-                                                     std::unordered_set<TXCoordinate, CoordinateHash>& visited,
-                                                     const TXCellManager& cellManager) const {
-    if (visiting.find(coord) != visiting.end()) {
-        return true; // 发现循环
+void TXFormulaManager::ensureDependencyIndex(const TXCellManager& cellManager) const {
+    // 并发的 const 查询中只有一个线程重建，其余等待后直接读取建好的索引
+    std::lock_guard<std::mutex> lock(*indexMutex_);
+    if (indexValid_) {
+        return;
+    }
+
+    precedents_.clear();
+    dependents_.clear();
+    dirty_.clear();
+    cellManager.forEachFormulaCell([this](const TXCoordinate& coord, const TXCell& cell) {
+        indexFormula(coord, cell);
+        dirty_.insert(coord);
+    });
+    indexValid_ = true;
+}
+
+void TXFormulaManager::indexFormula(const TXCoordinate& coord, const TXCell& cell) const {
+    unindexFormula(coord);
+
+    std::vector<TXCoordinate> refs;
+    std::vector<u32> ranges;
+    if (const TXFormula* formula = cell.getFormulaObject()) {
+        // 依赖来自编译结果，跨工作表引用不参与本表的计算顺序
+        for (const auto& ref : formula->getDependencies()) {
+            if (ref.sheetName.empty()) {
+                refs.emplace_back(ref.row, ref.col);
+            }
+        }
+        for (const auto& ref : formula->getRangeDependencies()) {
+            if (!ref.start.sheetName.empty()) {
+                continue;
+            }
+            const TXRange range(TXCoordinate(ref.start.row, ref.start.col), TXCoordinate(ref.end.row, ref.end.col));
+            auto found = rangeNodeIds_.find(range);
+            u32 id;
+            if (found != rangeNodeIds_.end()) {
+                id = found->second;
+            } else {
+                if (freeRangeNodes_.empty()) {
+                    id = static_cast<u32>(rangeNodes_.size());
+                    rangeNodes_.emplace_back();
+                } else {
+                    id = freeRangeNodes_.back();
+                    freeRangeNodes_.pop_back();
+                }
+                rangeNodes_[id].range = range;
+                rangeNodeIds_.emplace(range, id);
+                rangeIndex_.insert(id, range);
+            }
+            if (std::find(ranges.begin(), ranges.end(), id) == ranges.end()) {
+                ranges.push_back(id);
+                rangeNodes_[id].formulas.push_back(coord);
+            }
+        }
     }
+    std::sort(refs.begin(), refs.end());
+    refs.erase(std::unique(refs.begin(), refs.end()), refs.end());
 
-    if (visited.find(coord) != visited.end()) {
-        return false; // 已经访问过
+    for (const auto& ref : refs) {
+        dependents_[ref].push_back(coord);
     }
+    precedents_[coord] = std::move(refs);
+    if (!ranges.empty()) {
+        formulaRanges_[coord] = std::move(ranges);
+    }
+}
 
-    visiting.insert(coord);
+void TXFormulaManager::unindexFormula(const TXCoordinate& coord) const {
+    auto it = precedents_.find(coord);
+    if (it == precedents_.end()) {
+        return;
+    }
+    for (const auto& ref : it->second) {
+        auto dep = dependents_.find(ref);
+        if (dep == dependents_.end()) {
+            continue;
+        }
+        auto& list = dep->second;
+        list.erase(std::remove(list.begin(), list.end(), coord), list.end());
+        if (list.empty()) {
+            dependents_.erase(dep);
+        }
+    }
+    precedents_.erase(it);
 
-    const auto* cell = cellManager.getCell(coord);
-    if (cell && cell->hasFormula()) {
-        std::vector<TXCoordinate> refs = parseFormulaReferences(cell->getFormula());
-        for (const TXCoordinate& ref : refs) {
-            if (detectCircularReferencesHelper(ref, visiting, visited, cellManager)) {
-                return true;
-            }
+    auto ranges = formulaRanges_.find(coord);
+    if (ranges == formulaRanges_.end()) {
+        return;
+    }
+    for (u32 id : ranges->second) {
+        RangeNode& node = rangeNodes_[id];
+        node.formulas.erase(std::remove(node.formulas.begin(), node.formulas.end(), coord), node.formulas.end());
+        if (node.formulas.empty()) {
+            // 没有公式再引用这个范围，释放节点
+            rangeIndex_.erase(id);
+            rangeNodeIds_.erase(node.range);
+            freeRangeNodes_.push_back(id);
         }
     }
+    formulaRanges_.erase(ranges);
+}
 
-    visiting.erase(coord);
-    visited.insert(coord);
+template <typename Fn>
+void TXFormulaManager::forEachDependent(const TXCoordinate& coord, Fn&& fn) const {
+    auto it = dependents_.find(coord);
+    if (it != dependents_.end()) {
+        for (const auto& dependent : it->second) {
+            fn(dependent);
+        }
+    }
+    rangeIndex_.forEachContaining(coord, [this, &fn](u32 id) {
+        for (const auto& dependent : rangeNodes_[id].formulas) {
+            fn(dependent);
+        }
+    });
+}
 
-    return false;
+void TXFormulaManager::markDependentsDirty(const TXCoordinate& coord) const {
+    // dirty_ 对依赖关系封闭：已经是脏的公式，其下游也都已是脏的，遍历到此为止
+    std::vector<TXCoordinate> pending{coord};
+    while (!pending.empty()) {
+        const TXCoordinate current = pending.back();
+        pending.pop_back();
+        forEachDependent(current, [this, &pending](const TXCoordinate& dependent) {
+            if (dirty_.insert(dependent).second) {
+                pending.push_back(dependent);
+            }
+        });
+    }
 }
 
 bool TXFormulaManager::findCircularReferencePath(const TXCoordinate& coord,
-                                                std::unordered_set<TXCoordinate, CoordinateHash>& visiting,
-                                                std::unordered_set<TXCoordinate, CoordinateHash>& visited,
-                                                std::vector<TXCoordinate>& path,
-                                                const TXCellManager& cellManager) const {
+                                                CoordinateSet& visiting,
+                                                CoordinateSet& visited,
+                                                std::vector<TXCoordinate>& path) const {
     if (visiting.find(coord) != visiting.end()) {
         // 找到循环，记录路径
         auto it = std::find(path.begin(), path.end(), coord);
@@ -480,14 +674,14 @@ bool TXFormulaManager::findCircularReferencePath(const TXCoordinate& coord,
     visiting.insert(coord);
     path.push_back(coord);
 
-    const auto* cell = cellManager.getCell(coord);
-    if (cell && cell->hasFormula()) {
-        std::vector<TXCoordinate> refs = parseFormulaReferences(cell->getFormula());
-        for (const TXCoordinate& ref : refs) {
-            if (findCircularReferencePath(ref, visiting, visited, path, cellManager)) {
-                return true;
-            }
+    bool found = false;
+    forEachDependent(coord, [&](const TXCoordinate& dependent) {
+        if (!found && findCircularReferencePath(dependent, visiting, visited, path)) {
+            found = true;
         }
+    });
+    if (found) {
+        return true;
     }
 
     visiting.erase(coord);
@@ -497,47 +691,63 @@ bool TXFormulaManager::findCircularReferencePath(const TXCoordinate& coord,
     return false;
 }
 
-std::vector<TXCoordinate> TXFormulaManager::getCalculationOrder(const DependencyGraph& dependencies) const {
-    std::vector<TXCoordinate> order;
-    std::unordered_set<TXCoordinate, CoordinateHash> visited;
-    std::unordered_set<TXCoordinate, CoordinateHash> visiting;
-
-    // 拓扑排序
-    for (const auto& pair : dependencies) {
-        const TXCoordinate& coord = pair.first;
-        if (visited.find(coord) == visited.end()) {
-            topologicalSort(coord, dependencies, visited, visiting, order);
-        }
+std::size_t TXFormulaManager::getCalculationOrder(const CoordinateSet& cells, std::vector<TXCoordinate>& order,
+                                                  std::vector<std::size_t>* levels) const {
+    // 入度 = 组内公式指向它的边数（范围引用没有正向索引，因此从每个公式的下游累加）
+    std::unordered_map<TXCoordinate, u32, CoordinateHash> pending;
+    pending.reserve(cells.size());
+    for (const auto& coord : cells) {
+        pending.emplace(coord, 0);
+    }
+    for (const auto& coord : cells) {
+        forEachDependent(coord, [&pending](const TXCoordinate& dependent) {
+            auto entry = pending.find(dependent);
+            if (entry != pending.end()) {
+                ++entry->second;
+            }
+        });
     }
 
-    return order;
-}
-
-void TXFormulaManager::topologicalSort(const TXCoordinate& coord,
-                                      const DependencyGraph& dependencies,
-                                      std::unordered_set<TXCoordinate, CoordinateHash>& visited,
-                                      std::unordered_set<TXCoordinate, CoordinateHash>& visiting,
-                                      std::vector<TXCoordinate>& order) const {
-    if (visiting.find(coord) != visiting.end()) {
-        return; // 循环引用，跳过
+    order.clear();
+    order.reserve(cells.size());
+    for (const auto& entry : pending) {
+        if (entry.second == 0) {
+            order.push_back(entry.first);
+        }
     }
-
-    if (visited.find(coord) != visited.end()) {
-        return; // 已访问
+    // 按先进先出处理，每个公式在它最深的前驱所在层的下一层变为就绪，order 因此逐层排列
+    if (levels) {
+        levels->clear();
     }
-
-    visiting.insert(coord);
-
-    auto it = dependencies.find(coord);
-    if (it != dependencies.end()) {
-        for (const TXCoordinate& dep : it->second) {
-            topologicalSort(dep, dependencies, visited, visiting, order);
+    std::size_t levelEnd = 0;
+    for (std::size_t next = 0; next < order.size(); ++next) {
+        if (next == levelEnd) {
+            levelEnd = order.size();
+            if (levels) {
+                levels->push_back(next);
+            }
         }
+        forEachDependent(order[next], [&](const TXCoordinate& dependent) {
+            auto entry = pending.find(dependent);
+            if (entry != pending.end() && entry->second > 0 && --entry->second == 0) {
+                order.push_back(dependent);
+            }
+        });
     }
 
-    visiting.erase(coord);
-    visited.insert(coord);
-    order.push_back(coord);
+    const std::size_t acyclic = order.size();
+    if (acyclic != cells.size()) {
+        // 循环引用中的公式（及其下游）入度无法降到 0，按坐标顺序追加
+        std::vector<TXCoordinate> remaining;
+        for (const auto& entry : pending) {
+            if (entry.second > 0) {
+                remaining.push_back(entry.first);
+            }
+        }
+        std::sort(remaining.begin(), remaining.end());
+        order.insert(order.end(), remaining.begin(), remaining.end());
+    }
+    return acyclic;
 }
 
 bool TXFormulaManager::isValidNamedRangeName(const std::string& name) const {
@@ -571,24 +781,4 @@ bool TXFormulaManager::isValidNamedRangeName(const std::string& name) const {
     return true;
 }
 
-cell_value_t TXFormulaManager::evaluateFormula(const std::string& formula, const TXCellManager& cellManager) const {
-    // 简化的公式计算实现
-    // 实际实现需要完整的表达式解析器
-
-    if (formula.length() < 2 || formula[0] != '=') {
-        return std::string("#ERROR!");
-    }
-
-    std::string expr = formula.substr(1); // 去掉等号
-
-    // 简单的数字计算
-    try {
-        double result = std::stod(expr);
-        return result;
-    } catch (...) {
-        // 不是简单数字，返回错误
-        return std::string("#VALUE!");
-    }
-}
-
 } // namespace TinaXlsx
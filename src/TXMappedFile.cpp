@@ -0,0 +1,125 @@
+//
+// @file TXMappedFile.cpp
+// @brief 只读内存映射文件实现
+//
+
+#include "TinaXlsx/TXMappedFile.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace TinaXlsx
+{
+    TXMappedFile::~TXMappedFile() {
+        close();
+    }
+
+    TXMappedFile::TXMappedFile(TXMappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    TXMappedFile& TXMappedFile::operator=(TXMappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+            mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+    TXResult<void> TXMappedFile::open(const std::string& filename) {
+        close();
+
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return Err<void>(TXErrorCode::FileOpenFailed, "Cannot open file: " + filename);
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return Err<void>(TXErrorCode::FileReadFailed, "Cannot map empty or unreadable file: " + filename);
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) {
+            return Err<void>(TXErrorCode::FileReadFailed, "Cannot create file mapping: " + filename);
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            CloseHandle(mapping);
+            return Err<void>(TXErrorCode::FileReadFailed, "Cannot map file: " + filename);
+        }
+
+        mapping_ = mapping;
+        data_ = static_cast<const uint8_t*>(view);
+        size_ = static_cast<std::size_t>(fileSize.QuadPart);
+        return Ok();
+    }
+
+    void TXMappedFile::close() {
+        if (data_) {
+            UnmapViewOfFile(data_);
+        }
+        if (mapping_) {
+            CloseHandle(mapping_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        mapping_ = nullptr;
+    }
+#else
+    TXResult<void> TXMappedFile::open(const std::string& filename) {
+        close();
+
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return Err<void>(TXErrorCode::FileOpenFailed, "Cannot open file: " + filename);
+        }
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return Err<void>(TXErrorCode::FileReadFailed, "Cannot map empty or unreadable file: " + filename);
+        }
+
+        const auto length = static_cast<std::size_t>(st.st_size);
+        void* view = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        // 映射建立后文件描述符不再需要
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            return Err<void>(TXErrorCode::FileReadFailed, "Cannot map file: " + filename);
+        }
+
+        data_ = static_cast<const uint8_t*>(view);
+        size_ = length;
+        return Ok();
+    }
+
+    void TXMappedFile::close() {
+        if (data_) {
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+#endif
+} // namespace TinaXlsx
@@ -138,6 +138,7 @@ bool TXMergedCells::mergeCells(const TXRange& range) {
     if (result.second) {
         // 更新映射
         updateCellMapping(normalizedRegion, &(*result.first));
+        ++revision_;
         return true;
     }
     
@@ -166,6 +167,7 @@ bool TXMergedCells::unmergeCells(row_t row, column_t col) {
         
         // 从集合中移除
         mergeRegions_.erase(region);
+        ++revision_;
         return true;
     }
     
@@ -181,6 +183,7 @@ bool TXMergedCells::unmergeCells(const MergeRegion& region) {
         // 清除映射
         updateCellMapping(*it, nullptr);
         mergeRegions_.erase(it);
+        ++revision_;
         return true;
     }
     
@@ -282,6 +285,9 @@ std::size_t TXMergedCells::batchMergeCells(const std::vector<MergeRegion>& regio
         }
     }
     
+    if (successCount > 0) {
+        ++revision_;
+    }
     return successCount;
 }
 
@@ -297,6 +303,9 @@ std::size_t TXMergedCells::batchUnmergeCells(const std::vector<MergeRegion>& reg
         }
     }
     
+    if (successCount > 0) {
+        ++revision_;
+    }
     return successCount;
 }
 
@@ -306,6 +315,7 @@ void TXMergedCells::clear() {
     mergeRegions_.clear();
     cellToRegionMap_.clear();
     lastError_.clear();
+    ++revision_;
 }
 
 bool TXMergedCells::empty() const {
@@ -316,6 +326,10 @@ const std::string& TXMergedCells::getLastError() const {
     return lastError_;
 }
 
+std::size_t TXMergedCells::getRevision() const {
+    return revision_;
+}
+
 // ==================== 静态工具函数实现 ====================
 
 bool TXMergedCells::isOverlapping(const MergeRegion& region1, const MergeRegion& region2) {
@@ -339,6 +353,7 @@ TXMergedCells::MergeRegion TXMergedCells::normalizeRegion(const MergeRegion& reg
 // ==================== 行列调整操作 ====================
 
 void TXMergedCells::adjustForRowInsertion(row_t insertRow, row_t count) {
+    ++revision_;
     std::vector<MergeRegion> toUpdate;
     std::vector<MergeRegion> toRemove;
 
@@ -365,6 +380,7 @@ void TXMergedCells::adjustForRowInsertion(row_t insertRow, row_t count) {
 }
 
 void TXMergedCells::adjustForRowDeletion(row_t deleteRow, row_t count) {
+    ++revision_;
     std::vector<MergeRegion> toUpdate;
     std::vector<MergeRegion> toRemove;
 
@@ -419,6 +435,7 @@ void TXMergedCells::adjustForRowDeletion(row_t deleteRow, row_t count) {
 }
 
 void TXMergedCells::adjustForColumnInsertion(column_t insertCol, column_t count) {
+    ++revision_;
     std::vector<MergeRegion> toUpdate;
     std::vector<MergeRegion> toRemove;
 
@@ -445,6 +462,7 @@ void TXMergedCells::adjustForColumnInsertion(column_t insertCol, column_t count)
 }
 
 void TXMergedCells::adjustForColumnDeletion(column_t deleteCol, column_t count) {
+    ++revision_;
     std::vector<MergeRegion> toUpdate;
     std::vector<MergeRegion> toRemove;
 
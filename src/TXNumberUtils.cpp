@@ -6,7 +6,10 @@
 
 #include "TinaXlsx/TXNumberUtils.hpp"
 #include <algorithm>
+#include <charconv>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <limits>
 
 namespace TinaXlsx {
@@ -166,18 +169,40 @@ std::string TXNumberUtils::formatInt64(int64_t value, const FormatOptions& optio
 }
 
 std::string TXNumberUtils::formatForExcelXml(double value) {
-    if (isInteger(value)) {
-        // 整数：使用整数格式
-        return std::to_string(static_cast<long long>(value));
-    } else {
-        // 小数：使用最小精度格式
-        FormatOptions options;
-        options.precision = 2;
-        options.removeTrailingZeros = true;
-        options.useThousandSeparator = false;
-        
-        return formatDoubleInternal(value, options);
+    char buffer[EXCEL_XML_NUMBER_BUFFER_SIZE];
+    return std::string(buffer, formatForExcelXml(value, buffer));
+}
+
+std::size_t TXNumberUtils::formatForExcelXml(double value, char* buffer) {
+    char* const last = buffer + EXCEL_XML_NUMBER_BUFFER_SIZE;
+    if (!std::isfinite(value)) {
+        const std::string_view text = std::isnan(value) ? "NaN" : (value > 0 ? "Infinity" : "-Infinity");
+        std::memcpy(buffer, text.data(), text.size());
+        return text.size();
+    }
+
+    // 整数：int64 范围内按整数输出（-0 也输出为 "0"），比浮点转换快
+    if (isInteger(value) && std::fabs(value) < 9.2e18) {
+        return static_cast<std::size_t>(std::to_chars(buffer, last, static_cast<int64_t>(value)).ptr - buffer);
+    }
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    // 小数：最短的可往返表示，与区域设置无关
+    return static_cast<std::size_t>(std::to_chars(buffer, last, value).ptr - buffer);
+#else
+    // 标准库不支持浮点 to_chars 时，从 15 位有效数字开始逐步增加，直到能还原原值
+    int length = 0;
+    for (int digits = 15; digits <= 17; ++digits) {
+        length = std::snprintf(buffer, EXCEL_XML_NUMBER_BUFFER_SIZE, "%.*g", digits, value);
+        // snprintf 受区域设置影响，小数点可能是逗号
+        std::replace(buffer, buffer + length, ',', '.');
+        double parsed = 0.0;
+        if (fast_float::from_chars(buffer, buffer + length, parsed).ec == std::errc{} && parsed == value) {
+            break;
+        }
     }
+    return static_cast<std::size_t>(length);
+#endif
 }
 
 // ==================== 工具方法 ====================
@@ -0,0 +1,199 @@
+//
+// @file TXNumericKernels.cpp
+// @brief 聚合内核的标量、SSE2 和 AVX2 实现
+//
+
+#include "TinaXlsx/TXNumericKernels.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define TX_NUMERIC_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC 不需要为单个函数开启指令集
+#define TX_TARGET(isa)
+#else
+#define TX_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace TinaXlsx {
+
+namespace {
+
+constexpr double POS_INF = std::numeric_limits<double>::infinity();
+constexpr double NEG_INF = -std::numeric_limits<double>::infinity();
+constexpr double NOT_A_NUMBER = std::numeric_limits<double>::quiet_NaN();
+
+// 4 位掩码中 1 的个数
+constexpr u8 MASK_BITS[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+void accumulateScalar(const double* values, const u8* tags, u8 tag, std::size_t count,
+                      TXNumericAccumulator& acc) {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (tags[i] == tag) {
+            acc.add(values[i]);
+        }
+    }
+}
+
+#ifdef TX_NUMERIC_X86
+
+TX_TARGET("sse2")
+void accumulateSse2(const double* values, const u8* tags, u8 tag, std::size_t count,
+                    TXNumericAccumulator& acc) {
+    const __m128d posInf = _mm_set1_pd(POS_INF);
+    const __m128d negInf = _mm_set1_pd(NEG_INF);
+    __m128d sum0 = _mm_setzero_pd();
+    __m128d sum1 = _mm_setzero_pd();
+    __m128d low = posInf;
+    __m128d high = negInf;
+    __m128d nan = _mm_setzero_pd();
+    std::size_t n = 0;
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // SSE2 没有字节到 64 位的扩展，掩码逐个构造
+        const __m128d m0 = _mm_castsi128_pd(_mm_set_epi64x(-static_cast<long long>(tags[i + 1] == tag),
+                                                           -static_cast<long long>(tags[i] == tag)));
+        const __m128d m1 = _mm_castsi128_pd(_mm_set_epi64x(-static_cast<long long>(tags[i + 3] == tag),
+                                                           -static_cast<long long>(tags[i + 2] == tag)));
+        const __m128d v0 = _mm_loadu_pd(values + i);
+        const __m128d v1 = _mm_loadu_pd(values + i + 2);
+        sum0 = _mm_add_pd(sum0, _mm_and_pd(m0, v0));
+        sum1 = _mm_add_pd(sum1, _mm_and_pd(m1, v1));
+        // minpd/maxpd 遇到 NaN 时返回第二个操作数，不会传播 NaN，因此单独记录
+        nan = _mm_or_pd(nan, _mm_and_pd(m0, _mm_cmpunord_pd(v0, v0)));
+        nan = _mm_or_pd(nan, _mm_and_pd(m1, _mm_cmpunord_pd(v1, v1)));
+        low = _mm_min_pd(low, _mm_or_pd(_mm_and_pd(m0, v0), _mm_andnot_pd(m0, posInf)));
+        low = _mm_min_pd(low, _mm_or_pd(_mm_and_pd(m1, v1), _mm_andnot_pd(m1, posInf)));
+        high = _mm_max_pd(high, _mm_or_pd(_mm_and_pd(m0, v0), _mm_andnot_pd(m0, negInf)));
+        high = _mm_max_pd(high, _mm_or_pd(_mm_and_pd(m1, v1), _mm_andnot_pd(m1, negInf)));
+        n += MASK_BITS[_mm_movemask_pd(m0) | (_mm_movemask_pd(m1) << 2)];
+    }
+
+    alignas(16) double lanes[2];
+    alignas(16) double highLanes[2];
+    _mm_store_pd(lanes, _mm_add_pd(sum0, sum1));
+    acc.sum += lanes[0] + lanes[1];
+    _mm_store_pd(lanes, low);
+    _mm_store_pd(highLanes, high);
+    acc.addBounds(lanes[0], highLanes[0]);
+    acc.addBounds(lanes[1], highLanes[1]);
+    if (_mm_movemask_pd(nan) != 0) {
+        acc.addBounds(NOT_A_NUMBER, NOT_A_NUMBER);
+    }
+    acc.count += n;
+
+    accumulateScalar(values + i, tags + i, tag, count - i, acc);
+}
+
+TX_TARGET("avx2")
+void accumulateAvx2(const double* values, const u8* tags, u8 tag, std::size_t count,
+                    TXNumericAccumulator& acc) {
+    const __m256i wanted = _mm256_set1_epi64x(tag);
+    const __m256d posInf = _mm256_set1_pd(POS_INF);
+    const __m256d negInf = _mm256_set1_pd(NEG_INF);
+    __m256d sum0 = _mm256_setzero_pd();
+    __m256d sum1 = _mm256_setzero_pd();
+    __m256d low = posInf;
+    __m256d high = negInf;
+    __m256d nan = _mm256_setzero_pd();
+    std::size_t n = 0;
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // 4 个标记字节零扩展为 4 个 64 位整数后与目标比较，得到每个 double 的掩码
+        int t0;
+        int t1;
+        std::memcpy(&t0, tags + i, sizeof(t0));
+        std::memcpy(&t1, tags + i + 4, sizeof(t1));
+        const __m256d m0 = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_cvtepu8_epi64(_mm_cvtsi32_si128(t0)), wanted));
+        const __m256d m1 = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_cvtepu8_epi64(_mm_cvtsi32_si128(t1)), wanted));
+        const __m256d v0 = _mm256_loadu_pd(values + i);
+        const __m256d v1 = _mm256_loadu_pd(values + i + 4);
+        sum0 = _mm256_add_pd(sum0, _mm256_and_pd(m0, v0));
+        sum1 = _mm256_add_pd(sum1, _mm256_and_pd(m1, v1));
+        nan = _mm256_or_pd(nan, _mm256_and_pd(m0, _mm256_cmp_pd(v0, v0, _CMP_UNORD_Q)));
+        nan = _mm256_or_pd(nan, _mm256_and_pd(m1, _mm256_cmp_pd(v1, v1, _CMP_UNORD_Q)));
+        low = _mm256_min_pd(low, _mm256_blendv_pd(posInf, v0, m0));
+        low = _mm256_min_pd(low, _mm256_blendv_pd(posInf, v1, m1));
+        high = _mm256_max_pd(high, _mm256_blendv_pd(negInf, v0, m0));
+        high = _mm256_max_pd(high, _mm256_blendv_pd(negInf, v1, m1));
+        n += MASK_BITS[_mm256_movemask_pd(m0)] + MASK_BITS[_mm256_movemask_pd(m1)];
+    }
+
+    alignas(32) double lanes[4];
+    alignas(32) double highLanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(sum0, sum1));
+    acc.sum += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    _mm256_store_pd(lanes, low);
+    _mm256_store_pd(highLanes, high);
+    for (int k = 0; k < 4; ++k) {
+        acc.addBounds(lanes[k], highLanes[k]);
+    }
+    if (_mm256_movemask_pd(nan) != 0) {
+        acc.addBounds(NOT_A_NUMBER, NOT_A_NUMBER);
+    }
+    acc.count += n;
+
+    accumulateScalar(values + i, tags + i, tag, count - i, acc);
+}
+
+TXNumericKernels::Level detectCpuLevel() {
+#if defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    // AVX2 还需要操作系统保存 YMM 寄存器（OSXSAVE 且 XCR0 的第 1、2 位）
+    const bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+    bool avx2 = false;
+    if (osAvx && maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    // libgcc 的检测已包含操作系统对 YMM 寄存器的支持
+    __builtin_cpu_init();
+    const bool sse2 = __builtin_cpu_supports("sse2");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2) {
+        return TXNumericKernels::Level::AVX2;
+    }
+    return sse2 ? TXNumericKernels::Level::SSE2 : TXNumericKernels::Level::Scalar;
+}
+
+#endif // TX_NUMERIC_X86
+
+} // namespace
+
+TXNumericKernels::Level TXNumericKernels::detectLevel() {
+#ifdef TX_NUMERIC_X86
+    static const Level level = detectCpuLevel();
+    return level;
+#else
+    return Level::Scalar;
+#endif
+}
+
+void TXNumericKernels::accumulate(Level level, const double* values, const u8* tags, u8 tag, std::size_t count,
+                                  TXNumericAccumulator& acc) {
+    level = std::min(level, detectLevel());
+#ifdef TX_NUMERIC_X86
+    if (level == Level::AVX2) {
+        accumulateAvx2(values, tags, tag, count, acc);
+        return;
+    }
+    if (level == Level::SSE2) {
+        accumulateSse2(values, tags, tag, count, acc);
+        return;
+    }
+#endif
+    accumulateScalar(values, tags, tag, count, acc);
+}
+
+} // namespace TinaXlsx
@@ -0,0 +1,122 @@
+//
+// @file TXRangeIndex.cpp
+// @brief 范围空间索引实现
+//
+
+#include "TinaXlsx/TXRangeIndex.hpp"
+#include <cmath>
+
+namespace TinaXlsx {
+
+void TXRangeIndex::insert(u32 id, const TXRange& range) {
+    erase(id);
+    if (id >= positions_.size()) {
+        positions_.resize(static_cast<std::size_t>(id) + 1, NONE);
+    }
+
+    // 保存规范化后的包围盒，起点和终点的先后不影响查询
+    const u32 r1 = range.getStart().getRow().index();
+    const u32 r2 = range.getEnd().getRow().index();
+    const u32 c1 = range.getStart().getCol().index();
+    const u32 c2 = range.getEnd().getCol().index();
+    Box box{std::min(r1, r2), std::min(c1, c2), std::max(r1, r2), std::max(c1, c2)};
+
+    positions_[id] = static_cast<u32>(entries_.size());
+    entries_.push_back({box, id});
+    ++live_;
+}
+
+void TXRangeIndex::erase(u32 id) {
+    if (id >= positions_.size() || positions_[id] == NONE) {
+        return;
+    }
+    const std::size_t pos = positions_[id];
+    positions_[id] = NONE;
+    --live_;
+
+    if (pos < indexed_) {
+        // 树中的条目只留墓碑，包围盒仍然有效（只是偏大）
+        entries_[pos].id = NONE;
+        ++tombstones_;
+        return;
+    }
+    if (pos + 1 != entries_.size()) {
+        entries_[pos] = entries_.back();
+        positions_[entries_[pos].id] = static_cast<u32>(pos);
+    }
+    entries_.pop_back();
+}
+
+void TXRangeIndex::clear() {
+    entries_.clear();
+    levels_.clear();
+    positions_.clear();
+    indexed_ = 0;
+    tombstones_ = 0;
+    live_ = 0;
+}
+
+void TXRangeIndex::rebuild() const {
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                  [](const Entry& entry) { return entry.id == NONE; }),
+                   entries_.end());
+
+    // STR 打包：先按中心列切成 slices 个条带，条带内按中心行排序
+    const std::size_t count = entries_.size();
+    const std::size_t leaves = (count + NODE_SIZE - 1) / NODE_SIZE;
+    const std::size_t slices = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(leaves))));
+    const std::size_t sliceSize = std::max<std::size_t>(1, slices) * NODE_SIZE;
+
+    auto centerCol = [](const Entry& e) { return static_cast<u64>(e.box.left) + e.box.right; };
+    auto centerRow = [](const Entry& e) { return static_cast<u64>(e.box.top) + e.box.bottom; };
+    std::sort(entries_.begin(), entries_.end(),
+              [&](const Entry& a, const Entry& b) { return centerCol(a) < centerCol(b); });
+    for (std::size_t first = 0; first < count; first += sliceSize) {
+        const auto last = entries_.begin() + static_cast<std::ptrdiff_t>(std::min(first + sliceSize, count));
+        std::sort(entries_.begin() + static_cast<std::ptrdiff_t>(first), last,
+                  [&](const Entry& a, const Entry& b) { return centerRow(a) < centerRow(b); });
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        positions_[entries_[i].id] = static_cast<u32>(i);
+    }
+
+    // 自底向上计算每层节点的包围盒
+    auto merge = [](Box& into, const Box& box) {
+        into.top = std::min(into.top, box.top);
+        into.left = std::min(into.left, box.left);
+        into.bottom = std::max(into.bottom, box.bottom);
+        into.right = std::max(into.right, box.right);
+    };
+    levels_.clear();
+    if (count > 0) {
+        std::vector<Box> level;
+        level.reserve(leaves);
+        for (std::size_t first = 0; first < count; first += NODE_SIZE) {
+            Box box = entries_[first].box;
+            for (std::size_t i = first + 1; i < std::min(first + NODE_SIZE, count); ++i) {
+                merge(box, entries_[i].box);
+            }
+            level.push_back(box);
+        }
+        levels_.push_back(std::move(level));
+        while (levels_.back().size() > 1) {
+            const std::vector<Box>& below = levels_.back();
+            std::vector<Box> above;
+            above.reserve((below.size() + NODE_SIZE - 1) / NODE_SIZE);
+            for (std::size_t first = 0; first < below.size(); first += NODE_SIZE) {
+                Box box = below[first];
+                for (std::size_t i = first + 1; i < std::min(first + NODE_SIZE, below.size()); ++i) {
+                    merge(box, below[i]);
+                }
+                above.push_back(box);
+            }
+            levels_.push_back(std::move(above));
+        }
+    }
+
+    indexed_ = count;
+    tombstones_ = 0;
+}
+
+} // namespace TinaXlsx
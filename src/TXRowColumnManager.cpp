@@ -52,6 +52,7 @@ bool TXRowColumnManager::insertRows(row_t row, row_t count, TXCellManager& cellM
         }
     }
     hiddenRows_ = std::move(newHiddenRows);
+    ++revision_;
 
     return true;
 }
@@ -113,6 +114,7 @@ bool TXRowColumnManager::deleteRows(row_t row, row_t count, TXCellManager& cellM
         // 在删除范围内的隐藏状态被丢弃
     }
     hiddenRows_ = std::move(newHiddenRows);
+    ++revision_;
 
     return true;
 }
@@ -123,6 +125,7 @@ bool TXRowColumnManager::setRowHeight(row_t row, double height) {
     }
     
     rowHeights_[row.index()] = height;
+    ++revision_;
     return true;
 }
 
@@ -141,6 +144,7 @@ bool TXRowColumnManager::setRowHidden(row_t row, bool hidden) {
     } else {
         hiddenRows_.erase(row.index());
     }
+    ++revision_;
     return true;
 }
 
@@ -195,6 +199,7 @@ bool TXRowColumnManager::insertColumns(column_t col, column_t count, TXCellManag
         }
     }
     hiddenColumns_ = std::move(newHiddenColumns);
+    ++revision_;
 
     return true;
 }
@@ -256,6 +261,7 @@ bool TXRowColumnManager::deleteColumns(column_t col, column_t count, TXCellManag
         // 在删除范围内的隐藏状态被丢弃
     }
     hiddenColumns_ = std::move(newHiddenColumns);
+    ++revision_;
 
     return true;
 }
@@ -266,6 +272,7 @@ bool TXRowColumnManager::setColumnWidth(column_t col, double width) {
     }
     
     columnWidths_[col.index()] = width;
+    ++revision_;
     return true;
 }
 
@@ -284,6 +291,7 @@ bool TXRowColumnManager::setColumnHidden(column_t col, bool hidden) {
     } else {
         hiddenColumns_.erase(col.index());
     }
+    ++revision_;
     return true;
 }
 
@@ -420,6 +428,7 @@ void TXRowColumnManager::clear() {
     columnWidths_.clear();
     hiddenRows_.clear();
     hiddenColumns_.clear();
+    ++revision_;
 }
 
 // ==================== 私有辅助方法 ====================
@@ -0,0 +1,61 @@
+//
+// @file TXSharedStringTable.cpp
+// @brief 紧凑共享字符串表实现
+//
+
+#include "TinaXlsx/TXSharedStringTable.hpp"
+#include "TinaXlsx/TXWorksheetSaxHandler.hpp"
+#include <algorithm>
+
+namespace TinaXlsx {
+
+// ==================== TXSharedStringsSaxHandler ====================
+
+void TXSharedStringsSaxHandler::onStartElement(std::string_view qname, const TXXmlSaxAttributes& attributes) {
+    const std::string_view name = TXXmlSaxParser::localName(qname);
+    if (name == "si") {
+        inItem_ = true;
+    } else if (name == "t") {
+        capture_ = inItem_ && !inPhonetic_;
+    } else if (name == "rPh") {
+        inPhonetic_ = true;
+    } else if (name == "sst") {
+        const std::string_view unique = attributes.get("uniqueCount");
+        if (!unique.empty()) {
+            const std::size_t limit = inputSize_ > 0 ? inputSize_ / MIN_ITEM_BYTES : MAX_RESERVE;
+            const std::size_t count = std::min<std::size_t>(TXWorksheetSaxHandler::parseUnsigned(unique), limit);
+            table_.reserve(table_.size() + count);
+        }
+    }
+}
+
+void TXSharedStringsSaxHandler::onEndElement(std::string_view qname) {
+    const std::string_view name = TXXmlSaxParser::localName(qname);
+    if (name == "t") {
+        capture_ = false;
+    } else if (name == "rPh") {
+        inPhonetic_ = false;
+    } else if (name == "si") {
+        inItem_ = false;
+        table_.commit();
+    }
+}
+
+void TXSharedStringsSaxHandler::onText(std::string_view text) {
+    if (capture_) {
+        table_.appendPart(text);
+    }
+}
+
+// ==================== TXSharedStringTable ====================
+
+TXResult<void> TXSharedStringTable::load(std::string_view xml) {
+    // 文本总量不超过文档大小，按一半预留可以避免大部分扩容
+    data_.reserve(data_.size() + xml.size() / 2);
+
+    TXSharedStringsSaxHandler handler(*this, xml.size());
+    TXXmlSaxParser parser(handler);
+    return parser.parse(xml);
+}
+
+} // namespace TinaXlsx
@@ -0,0 +1,203 @@
+//
+// @file TXSharedStringsPool.cpp
+// @brief 共享字符串池实现
+//
+
+#include "TinaXlsx/TXSharedStringsPool.hpp"
+#include <cstring>
+
+namespace TinaXlsx {
+
+namespace {
+
+inline u32 foldHash(std::size_t hashValue) {
+    if constexpr (sizeof(std::size_t) > sizeof(u32)) {
+        return static_cast<u32>(hashValue ^ (static_cast<u64>(hashValue) >> 32));
+    } else {
+        return static_cast<u32>(hashValue);
+    }
+}
+
+} // namespace
+
+TXSharedStringsPool::TXSharedStringsPool(TXSharedStringsPool&& other) noexcept
+    : m_chunks(std::move(other.m_chunks))
+    , m_chunkCursor(other.m_chunkCursor)
+    , m_chunkRemaining(other.m_chunkRemaining)
+    , m_arenaBytes(other.m_arenaBytes)
+    , m_strings(std::move(other.m_strings))
+    , m_slots(std::move(other.m_slots))
+    , m_frequencies(std::move(other.m_frequencies))
+    , m_trackFrequency(other.m_trackFrequency)
+    , m_loadedStrings(std::move(other.m_loadedStrings))
+    , m_dirty(other.m_dirty) {
+    // 分块归新对象所有，原对象不能再往里写
+    other.reset();
+}
+
+TXSharedStringsPool& TXSharedStringsPool::operator=(TXSharedStringsPool&& other) noexcept {
+    if (this != &other) {
+        m_chunks = std::move(other.m_chunks);
+        m_chunkCursor = other.m_chunkCursor;
+        m_chunkRemaining = other.m_chunkRemaining;
+        m_arenaBytes = other.m_arenaBytes;
+        m_strings = std::move(other.m_strings);
+        m_slots = std::move(other.m_slots);
+        m_frequencies = std::move(other.m_frequencies);
+        m_trackFrequency = other.m_trackFrequency;
+        m_loadedStrings = std::move(other.m_loadedStrings);
+        m_dirty = other.m_dirty;
+        other.reset();
+    }
+    return *this;
+}
+
+u32 TXSharedStringsPool::add(std::string_view str, std::size_t hashValue) {
+    // 负载因子保持在 3/4 以下，保证空槽存在、探测序列短
+    if ((m_strings.size() + 1) * 4 > m_slots.size() * 3) {
+        rehash(m_slots.empty() ? 64 : m_slots.size() * 2);
+    }
+
+    const u32 folded = foldHash(hashValue);
+    const std::size_t mask = m_slots.size() - 1;
+    for (std::size_t pos = folded & mask;; pos = (pos + 1) & mask) {
+        Slot& slot = m_slots[pos];
+        if (slot.index == EMPTY_SLOT) {
+            // 新字符串 - 字节写入分块，槽位只记录哈希和索引
+            const u32 newIndex = static_cast<u32>(m_strings.size());
+            m_strings.push_back(storeBytes(str));
+            if (m_trackFrequency) {
+                m_frequencies.push_back(1);
+            }
+            slot.hash = folded;
+            slot.index = newIndex;
+            m_dirty = true;
+            return newIndex;
+        }
+        if (slot.hash == folded && m_strings[slot.index] == str) {
+            if (m_trackFrequency) {
+                ++m_frequencies[slot.index];
+            }
+            return slot.index;
+        }
+    }
+}
+
+u32 TXSharedStringsPool::append(std::string_view str) {
+    const std::size_t hashValue = hash(str);
+    u32 existing = 0;
+    if (!find(str, existing)) {
+        return add(str, hashValue);
+    }
+    // 重复项只占索引，不进哈希表
+    const u32 newIndex = static_cast<u32>(m_strings.size());
+    m_strings.push_back(m_strings[existing]);
+    if (m_trackFrequency) {
+        m_frequencies.push_back(1);
+    }
+    m_dirty = true;
+    return newIndex;
+}
+
+bool TXSharedStringsPool::find(std::string_view str, u32& index) const {
+    if (m_slots.empty()) {
+        return false;
+    }
+    const u32 folded = foldHash(hash(str));
+    const std::size_t mask = m_slots.size() - 1;
+    for (std::size_t pos = folded & mask;; pos = (pos + 1) & mask) {
+        const Slot& slot = m_slots[pos];
+        if (slot.index == EMPTY_SLOT) {
+            return false;
+        }
+        if (slot.hash == folded && m_strings[slot.index] == str) {
+            index = slot.index;
+            return true;
+        }
+    }
+}
+
+void TXSharedStringsPool::reserve(std::size_t count) {
+    m_strings.reserve(count);
+    if (m_trackFrequency) {
+        m_frequencies.reserve(count);
+    }
+    std::size_t slotCount = m_slots.empty() ? 64 : m_slots.size();
+    while (count * 4 > slotCount * 3) {
+        slotCount *= 2;
+    }
+    if (slotCount != m_slots.size()) {
+        rehash(slotCount);
+    }
+}
+
+void TXSharedStringsPool::setFrequencyTracking(bool enabled) {
+    m_trackFrequency = enabled;
+    if (enabled) {
+        m_frequencies.resize(m_strings.size(), 1);
+    } else {
+        m_frequencies.clear();
+        m_frequencies.shrink_to_fit();
+    }
+}
+
+std::size_t TXSharedStringsPool::memoryUsage() const {
+    return m_arenaBytes
+         + m_chunks.capacity() * sizeof(std::unique_ptr<char[]>)
+         + m_strings.capacity() * sizeof(std::string_view)
+         + m_slots.capacity() * sizeof(Slot)
+         + m_frequencies.capacity() * sizeof(u32);
+}
+
+void TXSharedStringsPool::reset() {
+    m_chunks.clear();
+    m_chunkCursor = nullptr;
+    m_chunkRemaining = 0;
+    m_arenaBytes = 0;
+    m_strings.clear();
+    m_slots.clear();
+    m_frequencies.clear();
+    m_dirty = false;
+}
+
+std::string_view TXSharedStringsPool::storeBytes(std::string_view str) {
+    if (str.empty()) {
+        return {};
+    }
+    if (str.size() > m_chunkRemaining) {
+        // 超过分块四分之一的长字符串单独分配，不浪费当前分块的剩余空间
+        if (str.size() > ARENA_CHUNK_SIZE / 4) {
+            m_chunks.emplace_back(new char[str.size()]);
+            m_arenaBytes += str.size();
+            std::memcpy(m_chunks.back().get(), str.data(), str.size());
+            return {m_chunks.back().get(), str.size()};
+        }
+        m_chunks.emplace_back(new char[ARENA_CHUNK_SIZE]);
+        m_arenaBytes += ARENA_CHUNK_SIZE;
+        m_chunkCursor = m_chunks.back().get();
+        m_chunkRemaining = ARENA_CHUNK_SIZE;
+    }
+    char* dest = m_chunkCursor;
+    std::memcpy(dest, str.data(), str.size());
+    m_chunkCursor += str.size();
+    m_chunkRemaining -= str.size();
+    return {dest, str.size()};
+}
+
+void TXSharedStringsPool::rehash(std::size_t slotCount) {
+    std::vector<Slot> slots(slotCount);
+    const std::size_t mask = slotCount - 1;
+    for (const Slot& slot : m_slots) {
+        if (slot.index == EMPTY_SLOT) {
+            continue;
+        }
+        std::size_t pos = slot.hash & mask;
+        while (slots[pos].index != EMPTY_SLOT) {
+            pos = (pos + 1) & mask;
+        }
+        slots[pos] = slot;
+    }
+    m_slots.swap(slots);
+}
+
+} // namespace TinaXlsx
@@ -79,6 +79,7 @@ TXSheet::CellValue TXSheet::getCellValue(const std::string& address) const {
 bool TXSheet::setCellValue(row_t row, column_t col, const CellValue& value) {
     bool result = cellManager_.setCellValue(TXCoordinate(row, col), value);
     if (result) {
+        formulaManager_.onCellChanged(TXCoordinate(row, col));
         clearError();
         notifyComponentChange(ExcelComponent::BasicWorkbook);
     } else {
@@ -90,6 +91,7 @@ bool TXSheet::setCellValue(row_t row, column_t col, const CellValue& value) {
 bool TXSheet::setCellValue(const Coordinate& coord, const CellValue& value) {
     bool result = cellManager_.setCellValue(coord, value);
     if (result) {
+        formulaManager_.onCellChanged(coord);
         clearError();
         notifyComponentChange(ExcelComponent::BasicWorkbook);
     } else {
@@ -146,6 +148,7 @@ bool TXSheet::insertRows(row_t row, row_t count) {
     if (result) {
         clearError();
         mergedCells_.adjustForRowInsertion(row, count);
+        formulaManager_.invalidateDependencyIndex();
         notifyComponentChange(ExcelComponent::BasicWorkbook);
     } else {
         setError("Failed to insert rows");
@@ -163,6 +166,7 @@ bool TXSheet::deleteRows(row_t row, row_t count) {
     if (result) {
         clearError();
         mergedCells_.adjustForRowDeletion(row, count);
+        formulaManager_.invalidateDependencyIndex();
         notifyComponentChange(ExcelComponent::BasicWorkbook);
     } else {
         setError("Failed to delete rows");
@@ -180,6 +184,7 @@ bool TXSheet::insertColumns(column_t col, column_t count) {
     if (result) {
         clearError();
         mergedCells_.adjustForColumnInsertion(col, count);
+        formulaManager_.invalidateDependencyIndex();
         notifyComponentChange(ExcelComponent::BasicWorkbook);
     } else {
         setError("Failed to insert columns");
@@ -197,6 +202,7 @@ bool TXSheet::deleteColumns(column_t col, column_t count) {
     if (result) {
         clearError();
         mergedCells_.adjustForColumnDeletion(col, count);
+        formulaManager_.invalidateDependencyIndex();
         notifyComponentChange(ExcelComponent::BasicWorkbook);
     } else {
         setError("Failed to delete columns");
@@ -205,6 +211,7 @@ bool TXSheet::deleteColumns(column_t col, column_t count) {
 }
 
 bool TXSheet::setColumnWidth(column_t col, double width) {
+    markModified();
     if (!protectionManager_.isOperationAllowed(TXSheetProtectionManager::OperationType::FormatColumns)) {
         setError("Operation blocked by sheet protection");
         return false;
@@ -224,6 +231,7 @@ double TXSheet::getColumnWidth(column_t col) const {
 }
 
 bool TXSheet::setRowHeight(row_t row, double height) {
+    markModified();
     if (!protectionManager_.isOperationAllowed(TXSheetProtectionManager::OperationType::FormatRows)) {
         setError("Operation blocked by sheet protection");
         return false;
@@ -243,18 +251,22 @@ double TXSheet::getRowHeight(row_t row) const {
 }
 
 double TXSheet::autoFitColumnWidth(column_t col, double minWidth, double maxWidth) {
+    markModified();
     return rowColumnManager_.autoFitColumnWidth(col, cellManager_, minWidth, maxWidth);
 }
 
 double TXSheet::autoFitRowHeight(row_t row, double minHeight, double maxHeight) {
+    markModified();
     return rowColumnManager_.autoFitRowHeight(row, cellManager_, minHeight, maxHeight);
 }
 
 std::size_t TXSheet::autoFitAllColumnWidths(double minWidth, double maxWidth) {
+    markModified();
     return rowColumnManager_.autoFitAllColumnWidths(cellManager_, minWidth, maxWidth);
 }
 
 std::size_t TXSheet::autoFitAllRowHeights(double minHeight, double maxHeight) {
+    markModified();
     return rowColumnManager_.autoFitAllRowHeights(cellManager_, minHeight, maxHeight);
 }
 
@@ -277,6 +289,9 @@ TXSheet::Range TXSheet::getUsedRange() const {
 std::size_t TXSheet::setCellValues(const std::vector<std::pair<Coordinate, CellValue>>& values) {
     std::size_t count = cellManager_.setCellValues(values);
     if (count > 0) {
+        for (const auto& pair : values) {
+            formulaManager_.onCellChanged(pair.first);
+        }
         notifyComponentChange(ExcelComponent::BasicWorkbook);
     }
     return count;
@@ -320,6 +335,7 @@ const TXSheet::SheetProtection& TXSheet::getSheetProtection() const {
 }
 
 bool TXSheet::setCellLocked(row_t row, column_t col, bool locked) {
+    markModified();
     TXCoordinate coord(row, col);
 
     // 首先通过保护管理器设置锁定状态
@@ -356,16 +372,24 @@ bool TXSheet::isCellLocked(row_t row, column_t col) const {
 }
 
 std::size_t TXSheet::setRangeLocked(const Range& range, bool locked) {
+    markModified();
     return protectionManager_.setRangeLocked(range, locked, cellManager_);
 }
 
 // ==================== 公式操作（委托给FormulaManager�?===================
 
 std::size_t TXSheet::calculateAllFormulas() {
+    markModified();
     return formulaManager_.calculateAllFormulas(cellManager_);
 }
 
+std::size_t TXSheet::recalculateFormulas() {
+    markModified();
+    return formulaManager_.recalculate(cellManager_);
+}
+
 std::size_t TXSheet::calculateFormulasInRange(const Range& range) {
+    markModified();
     return formulaManager_.calculateFormulasInRange(range, cellManager_);
 }
 
@@ -385,6 +409,7 @@ std::string TXSheet::getCellFormula(row_t row, column_t col) const {
 }
 
 std::size_t TXSheet::setCellFormulas(const std::vector<std::pair<Coordinate, std::string>>& formulas) {
+    markModified();
     std::size_t count = 0;
     for (const auto& pair : formulas) {
         if (setCellFormula(pair.first.getRow(), pair.first.getCol(), pair.second)) {
@@ -403,10 +428,12 @@ const TXSheet::FormulaCalculationOptions& TXSheet::getFormulaCalculationOptions(
 }
 
 bool TXSheet::addNamedRange(const std::string& name, const Range& range, const std::string& comment) {
+    markModified();
     return formulaManager_.addNamedRange(name, range, comment);
 }
 
 bool TXSheet::removeNamedRange(const std::string& name) {
+    markModified();
     return formulaManager_.removeNamedRange(name);
 }
 
@@ -440,7 +467,8 @@ bool TXSheet::setCellNumberFormat(row_t row, column_t col, TXNumberFormat::Forma
         return false;
     }
 
-    // 确保样式组件已注�?    notifyComponentChange(ExcelComponent::Styles);
+    // 确保样式组件已注册
+    notifyComponentChange(ExcelComponent::Styles);
 
     // 获取当前有效样式
     TXCellStyle styleToApply = getCellEffectiveStyle(cell);
@@ -474,6 +502,7 @@ bool TXSheet::setCellCustomFormat(row_t row, column_t col, const std::string& fo
 }
 
 std::size_t TXSheet::setRangeNumberFormat(const Range& range, TXNumberFormat::FormatType formatType, int decimalPlaces) {
+    markModified();
     std::size_t count = 0;
     auto start = range.getStart();
     auto end = range.getEnd();
@@ -489,14 +518,15 @@ std::size_t TXSheet::setRangeNumberFormat(const Range& range, TXNumberFormat::Fo
 }
 
 std::string TXSheet::getCellFormattedValue(row_t row, column_t col) const {
-    const TXCell* cell = getCell(row, col);
-    if (!cell) {
+    const TXCellManager::CellView cell = cellManager_.getCellView(Coordinate(row, col));
+    if (!cell.exists()) {
         return "";
     }
-    return cell->getFormattedValue();
+    return cell.getFormattedValue();
 }
 
 std::size_t TXSheet::setCellFormats(const std::vector<std::pair<Coordinate, TXNumberFormat::FormatType>>& formats) {
+    markModified();
     std::size_t count = 0;
     for (const auto& pair : formats) {
         if (setCellNumberFormat(pair.first.getRow(), pair.first.getCol(), pair.second)) {
@@ -525,19 +555,20 @@ bool TXSheet::setCellStyle(row_t row, column_t col, const TXCellStyle& style) {
     auto& styleManager = workbook_->getStyleManager();
     u32 styleId = styleManager.registerCellStyleXF(style);
 
-    TXCell* cell = getCell(row, col);
-    if (!cell) {
+    const Coordinate coord(row, col);
+    // 设置样式索引（普通单元格只写入样式数组，不创建 TXCell）
+    if (!cellManager_.setCellStyleIndex(coord, styleId)) {
         setError("Failed to get cell");
         return false;
     }
 
-    // 设置样式索引
-    cell->setStyleIndex(styleId);
-
-    // 同步数字格式对象到单元格
-    auto numberFormatObject = style.createNumberFormatObject();
-    if (numberFormatObject) {
-        cell->setNumberFormatObject(std::move(numberFormatObject));
+    // 同步数字格式对象到单元格：常规格式与普通单元格的默认格式相同，无需转存
+    const bool defaultFormat = style.getNumberFormatDefinition() == TXCellStyle::NumberFormatDefinition();
+    if (!defaultFormat || cellManager_.getCellView(coord).getCell()) {
+        auto numberFormatObject = style.createNumberFormatObject();
+        if (numberFormatObject) {
+            cellManager_.getCell(coord)->setNumberFormatObject(std::move(numberFormatObject));
+        }
     }
 
     clearError();
@@ -550,6 +581,7 @@ bool TXSheet::setCellStyle(const std::string& address, const TXCellStyle& style)
 }
 
 std::size_t TXSheet::setRangeStyle(const Range& range, const TXCellStyle& style) {
+    markModified();
     std::size_t count = 0;
     auto start = range.getStart();
     auto end = range.getEnd();
@@ -565,6 +597,7 @@ std::size_t TXSheet::setRangeStyle(const Range& range, const TXCellStyle& style)
 }
 
 std::size_t TXSheet::setCellStyles(const std::vector<std::pair<Coordinate, TXCellStyle>>& styles) {
+    markModified();
     std::size_t count = 0;
     for (const auto& pair : styles) {
         if (setCellStyle(pair.first.getRow(), pair.first.getCol(), pair.second)) {
@@ -667,6 +700,7 @@ std::vector<TXSheet::Coordinate> TXSheet::parseFormulaReferences(const std::stri
 // ==================== 清空操作 ====================
 
 void TXSheet::clear() {
+    markModified();
     cellManager_.clear();
     rowColumnManager_.clear();
     protectionManager_.clear();
@@ -677,7 +711,27 @@ void TXSheet::clear() {
     clearError();
 }
 
+bool TXSheet::isModified() const {
+    // 管理器的修订号只增不减，和值变化说明有修改
+    const std::size_t revision = cellManager_.getRevision() + rowColumnManager_.getRevision() +
+                                 protectionManager_.getRevision() + mergedCells_.getRevision();
+    return modified_ || revision != cleanRevision_ || cellManager_.hasHandleChanges();
+}
+
+void TXSheet::markModified() {
+    modified_ = true;
+    cellManager_.trackCellHandles(false);
+}
+
+void TXSheet::clearModified() {
+    modified_ = false;
+    cleanRevision_ = cellManager_.getRevision() + rowColumnManager_.getRevision() +
+                     protectionManager_.getRevision() + mergedCells_.getRevision();
+    cellManager_.trackCellHandles(true);
+}
+
 void TXSheet::notifyComponentChange(ExcelComponent component) const {
+    modified_ = true;
     if (workbook_ && workbook_->getContext()) {
         workbook_->getContext()->registerComponentFast(component);
     }
@@ -686,6 +740,7 @@ void TXSheet::notifyComponentChange(ExcelComponent component) const {
 // ==================== 范围操作方法 ====================
 
 bool TXSheet::setRangeValues(const Range& range, const std::vector<std::vector<CellValue>>& values) {
+    markModified();
     if (values.empty()) {
         setError("Empty values array");
         return false;
@@ -747,14 +802,17 @@ std::vector<std::vector<TXSheet::CellValue>> TXSheet::getRangeValues(const Range
 // ==================== 合并单元格方法 ====================
 
 bool TXSheet::mergeCells(const Range& range) {
+    markModified();
     return mergedCells_.mergeCells(range);
 }
 
 bool TXSheet::mergeCells(row_t startRow, column_t startCol, row_t endRow, column_t endCol) {
+    markModified();
     return mergedCells_.mergeCells(startRow, startCol, endRow, endCol);
 }
 
 bool TXSheet::unmergeCells(row_t row, column_t col) {
+    markModified();
     return mergedCells_.unmergeCells(row, col);
 }
 
@@ -851,11 +909,13 @@ const std::vector<std::pair<TXRange, TXDataValidation>>& TXSheet::getDataValidat
 // ==================== 数据筛选功能实现 ====================
 
 TXAutoFilter* TXSheet::enableAutoFilter(const TXRange& range) {
+    markModified();
     autoFilter_ = std::make_unique<TXAutoFilter>(range);
     return autoFilter_.get();
 }
 
 void TXSheet::disableAutoFilter() {
+    markModified();
     autoFilter_.reset();
 }
 
@@ -949,6 +1009,7 @@ TXScatterChart* TXSheet::addScatterChart(const std::string& title, const TXRange
 }
 
 bool TXSheet::removeChart(const std::string& chartName) {
+    markModified();
     auto it = std::find_if(charts_.begin(), charts_.end(),
                            [&chartName](const std::unique_ptr<TXChart>& chart) {
                                return chart->getName() == chartName;
@@ -34,6 +34,7 @@ bool TXSheetProtectionManager::protectSheet(const std::string& password, const S
         protection_.passwordHash.clear();
         protection_.saltValue.clear();
     }
+    ++revision_;
 
     return true;
 }
@@ -51,6 +52,7 @@ bool TXSheetProtectionManager::unprotectSheet(const std::string& password) {
     
     protection_.isProtected = false;
     protection_.passwordHash.clear();
+    ++revision_;
     
     return true;
 }
@@ -94,8 +96,8 @@ bool TXSheetProtectionManager::setCellLocked(const TXCoordinate& coord, bool loc
 }
 
 bool TXSheetProtectionManager::isCellLocked(const TXCoordinate& coord, const TXCellManager& cellManager) const {
-    const auto* cell = cellManager.getCell(coord);
-    return cell ? cell->isLocked() : true; // 默认锁定
+    // 视图对不存在的单元格和普通单元格都返回默认的锁定状态，不会转存单元格
+    return cellManager.getCellView(coord).isLocked();
 }
 
 std::size_t TXSheetProtectionManager::setRangeLocked(const TXRange& range, bool locked, TXCellManager& cellManager) {
@@ -274,10 +276,12 @@ TXSheetProtectionManager::ProtectionStats TXSheetProtectionManager::getProtectio
 
 void TXSheetProtectionManager::clear() {
     protection_ = SheetProtection{};
+    ++revision_;
 }
 
 void TXSheetProtectionManager::reset() {
     protection_ = SheetProtection{};
+    ++revision_;
 }
 
 // ==================== 私有辅助方法 ====================
@@ -0,0 +1,291 @@
+//
+// @file TXSheetReader.cpp
+// @brief 只进的逐行读取器实现
+//
+
+#include "TinaXlsx/TXSheetReader.hpp"
+#include "TinaXlsx/TXSharedStringTable.hpp"
+#include "TinaXlsx/TXWorksheetSaxHandler.hpp"
+#include "TinaXlsx/TXXmlSaxParser.hpp"
+#include "TinaXlsx/TXZipArchive.hpp"
+#include "TinaXlsx/TXNumberUtils.hpp"
+#include <unordered_map>
+
+namespace TinaXlsx {
+
+namespace {
+
+constexpr std::size_t kReadChunkSize = 64 * 1024;
+
+/**
+ * @brief 按块解压整个条目并交给 SAX 解析器
+ */
+TXResult<void> parseEntry(TXZipArchiveReader& zip, const std::string& entryName, TXXmlSaxHandler& handler) {
+    TXXmlSaxParser parser(handler);
+    bool parseFailed = false;
+    auto streamResult = zip.readStream(entryName, [&](const uint8_t* data, std::size_t size) {
+        auto feedResult = parser.feed(reinterpret_cast<const char*>(data), size);
+        parseFailed = feedResult.isError();
+        return feedResult;
+    }, kReadChunkSize);
+    if (streamResult.isError()) {
+        if (parseFailed) {
+            return Err<void>(streamResult.error().getCode(), entryName + ": " + streamResult.error().getMessage());
+        }
+        return streamResult;
+    }
+
+    auto finishResult = parser.finish();
+    if (finishResult.isError()) {
+        return Err<void>(finishResult.error().getCode(), entryName + ": " + finishResult.error().getMessage());
+    }
+    return Ok();
+}
+
+/**
+ * @brief 收集 workbook.xml 中的工作表名称及关系 ID
+ */
+class WorkbookSheetsHandler : public TXXmlSaxHandler {
+public:
+    void onStartElement(std::string_view qname, const TXXmlSaxAttributes& attributes) override {
+        if (TXXmlSaxParser::localName(qname) != "sheet") {
+            return;
+        }
+        names.emplace_back(attributes.get("name"));
+        relationIds.emplace_back(attributes.get("r:id"));
+    }
+
+    std::vector<std::string> names;
+    std::vector<std::string> relationIds;
+};
+
+/**
+ * @brief 收集 workbook.xml.rels 中的 Id -> Target 映射
+ */
+class RelationshipsHandler : public TXXmlSaxHandler {
+public:
+    void onStartElement(std::string_view qname, const TXXmlSaxAttributes& attributes) override {
+        if (TXXmlSaxParser::localName(qname) == "Relationship") {
+            targets.emplace(std::string(attributes.get("Id")), std::string(attributes.get("Target")));
+        }
+    }
+
+    std::unordered_map<std::string, std::string> targets;
+};
+
+} // namespace
+
+// ==================== Impl ====================
+
+class TXSheetReader::Impl : public TXWorksheetSaxHandler {
+public:
+    Impl() : parser(*this) {}
+
+    TXZipArchiveReader zip;
+    TXXmlSaxParser parser;
+    std::vector<std::string> sheetNames;
+    TXSharedStringTable sharedStrings;
+    std::vector<char> chunk;
+
+    TXRowView row;
+    std::string rowText;                 ///< 本行内联字符串的存储
+    std::vector<std::size_t> textOffsets; ///< 指向 rowText 的单元格 (下标, 偏移, 长度)
+    bool rowReady = false;
+    bool endOfEntry = false;
+    bool done = false;
+
+protected:
+    void onRowStart(u32 rowIndex) override {
+        row.index = rowIndex;
+        row.cells.clear();
+        rowText.clear();
+        textOffsets.clear();
+    }
+
+    void onCell(const CellData& data) override {
+        TXCellView view;
+        view.column = data.column;
+        view.styleIndex = data.styleIndex;
+        view.hasFormula = !data.formula.empty();
+
+        if (data.hasValue()) {
+            if (data.type == "s") {
+                if (sharedStrings.tryGet(parseUnsigned(data.value), view.text)) {
+                    view.type = TXCellView::Type::String;
+                }
+            } else if (data.type == "inlineStr") {
+                view.type = TXCellView::Type::String;
+                appendRowText(data.inlineText);
+            } else if (data.type == "str") {
+                view.type = TXCellView::Type::String;
+                appendRowText(data.value);
+            } else if (data.type == "e") {
+                view.type = TXCellView::Type::Error;
+                appendRowText(data.value);
+            } else if (data.type == "b") {
+                view.type = TXCellView::Type::Boolean;
+                view.boolean = data.value == "1" || data.value == "true";
+            } else if (auto number = TXNumberUtils::parseDouble(data.value)) {
+                view.type = TXCellView::Type::Number;
+                view.number = *number;
+            }
+        }
+        row.cells.push_back(view);
+    }
+
+    void onRowEnd(u32 /*rowIndex*/) override {
+        // rowText 在本行内可能重新分配，行结束后再统一回填视图
+        for (std::size_t i = 0; i < textOffsets.size(); i += 3) {
+            row.cells[textOffsets[i]].text = std::string_view(rowText).substr(textOffsets[i + 1], textOffsets[i + 2]);
+        }
+        rowReady = true;
+        parser.pause();
+    }
+
+private:
+    void appendRowText(std::string_view text) {
+        textOffsets.push_back(row.cells.size());
+        textOffsets.push_back(rowText.size());
+        textOffsets.push_back(text.size());
+        rowText.append(text);
+    }
+};
+
+// ==================== TXSheetReader ====================
+
+TXSheetReader::TXSheetReader() = default;
+TXSheetReader::~TXSheetReader() = default;
+TXSheetReader::TXSheetReader(TXSheetReader&&) noexcept = default;
+TXSheetReader& TXSheetReader::operator=(TXSheetReader&&) noexcept = default;
+
+TXResult<void> TXSheetReader::open(const std::string& filename, const std::string& sheetName) {
+    return openSheet(filename, &sheetName, 0);
+}
+
+TXResult<void> TXSheetReader::open(const std::string& filename, u32 sheetIndex) {
+    return openSheet(filename, nullptr, sheetIndex);
+}
+
+TXResult<void> TXSheetReader::openSheet(const std::string& filename, const std::string* sheetName, u32 sheetIndex) {
+    close();
+    auto impl = std::make_unique<Impl>();
+
+    auto openResult = impl->zip.open(filename);
+    if (openResult.isError()) {
+        return openResult;
+    }
+
+    // 工作表列表
+    WorkbookSheetsHandler sheets;
+    auto workbookResult = parseEntry(impl->zip, "xl/workbook.xml", sheets);
+    if (workbookResult.isError()) {
+        return workbookResult;
+    }
+    impl->sheetNames = sheets.names;
+
+    if (sheetName) {
+        bool found = false;
+        for (std::size_t i = 0; i < sheets.names.size(); ++i) {
+            if (sheets.names[i] == *sheetName) {
+                sheetIndex = static_cast<u32>(i);
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            return Err<void>(TXErrorCode::SheetNotFound, "Sheet not found: " + *sheetName);
+        }
+    } else if (sheetIndex >= sheets.names.size()) {
+        return Err<void>(TXErrorCode::InvalidArgument, "Sheet index out of range: " + std::to_string(sheetIndex));
+    }
+
+    // 通过关系文件解析工作表路径，缺失时退回默认命名
+    std::string sheetPart = "xl/worksheets/sheet" + std::to_string(sheetIndex + 1) + ".xml";
+    RelationshipsHandler rels;
+    if (parseEntry(impl->zip, "xl/_rels/workbook.xml.rels", rels).isOk()) {
+        auto it = rels.targets.find(sheets.relationIds[sheetIndex]);
+        if (it != rels.targets.end() && !it->second.empty()) {
+            sheetPart = it->second[0] == '/' ? it->second.substr(1) : "xl/" + it->second;
+        }
+    }
+
+    // 共享字符串是可选的
+    TXSharedStringsSaxHandler sharedStrings(impl->sharedStrings);
+    auto sstResult = parseEntry(impl->zip, "xl/sharedStrings.xml", sharedStrings);
+    if (sstResult.isError() && sstResult.error().getCode() != TXErrorCode::ZipEntryNotFound) {
+        return sstResult;
+    }
+
+    auto entryResult = impl->zip.openEntry(sheetPart);
+    if (entryResult.isError()) {
+        return entryResult;
+    }
+    impl->chunk.resize(kReadChunkSize);
+    impl_ = std::move(impl);
+    return Ok();
+}
+
+TXResult<bool> TXSheetReader::nextRow() {
+    if (!impl_) {
+        return Err<bool>(TXErrorCode::OperationFailed, "Sheet reader is not open");
+    }
+
+    Impl& impl = *impl_;
+    impl.rowReady = false;
+    while (!impl.rowReady) {
+        if (impl.done) {
+            return Ok(false);
+        }
+
+        TXResult<void> result = Ok();
+        if (impl.endOfEntry) {
+            result = impl.parser.finish();
+            if (result.isOk() && !impl.parser.isPaused()) {
+                impl.done = true;
+            }
+        } else if (impl.parser.isPaused()) {
+            result = impl.parser.resume();
+        } else {
+            auto readResult = impl.zip.readEntry(impl.chunk.data(), impl.chunk.size());
+            if (readResult.isError()) {
+                return Err<bool>(readResult.error());
+            }
+            if (readResult.value() == 0) {
+                impl.endOfEntry = true;
+                impl.zip.closeEntry();
+                continue;
+            }
+            result = impl.parser.feed(impl.chunk.data(), readResult.value());
+        }
+
+        if (result.isError()) {
+            impl.done = true;
+            return Err<bool>(result.error());
+        }
+    }
+    return Ok(true);
+}
+
+const TXRowView& TXSheetReader::row() const {
+    static const TXRowView emptyRow;
+    return impl_ ? impl_->row : emptyRow;
+}
+
+const std::vector<std::string>& TXSheetReader::getSheetNames() const {
+    static const std::vector<std::string> empty;
+    return impl_ ? impl_->sheetNames : empty;
+}
+
+std::size_t TXSheetReader::getSharedStringCount() const {
+    return impl_ ? impl_->sharedStrings.size() : 0;
+}
+
+void TXSheetReader::close() {
+    impl_.reset();
+}
+
+bool TXSheetReader::isOpen() const {
+    return impl_ != nullptr;
+}
+
+} // namespace TinaXlsx
@@ -0,0 +1,283 @@
+//
+// @file TXStreamingWorkbook.cpp
+// @brief 只写流式工作簿实现
+//
+
+#include "TinaXlsx/TXStreamingWorkbook.hpp"
+#include "TinaXlsx/TXSheet.hpp"
+#include "TinaXlsx/TXStyle.hpp"
+#include "TinaXlsx/TXStyleManager.hpp"
+#include "TinaXlsx/TXComponentManager.hpp"
+#include "TinaXlsx/TXSharedStringsPool.hpp"
+#include "TinaXlsx/TXWorkbookProtectionManager.hpp"
+#include "TinaXlsx/TXWorkbookContext.hpp"
+#include "TinaXlsx/TXContentTypesXmlHandler.hpp"
+#include "TinaXlsx/TXMainRelsXmlHandler.hpp"
+#include "TinaXlsx/TXWorkbookXmlHandler.hpp"
+#include "TinaXlsx/TXWorkbookRelsXmlHandler.hpp"
+#include "TinaXlsx/TXStylesXmlHandler.hpp"
+#include <variant>
+
+namespace TinaXlsx {
+
+// ==================== TXStreamingSheet ====================
+
+TXStreamingSheet::TXStreamingSheet(TXZipArchiveWriter& zipWriter, std::string name, u32 index)
+    : zipWriter_(zipWriter)
+    , sink_(zipWriter)
+    , writer_(&sink_)
+    , name_(std::move(name))
+    , index_(index) {
+}
+
+TXStreamingSheet::~TXStreamingSheet() = default;
+
+TXResult<void> TXStreamingSheet::begin() {
+    auto openResult = zipWriter_.openEntry("xl/worksheets/sheet" + std::to_string(index_ + 1) + ".xml");
+    if (openResult.isError()) {
+        return openResult;
+    }
+    writer_.declaration();
+    writer_.startElement("worksheet")
+           .attribute("xmlns", "http://schemas.openxmlformats.org/spreadsheetml/2006/main")
+           .attribute("xmlns:r", "http://schemas.openxmlformats.org/officeDocument/2006/relationships");
+    return writer_.status();
+}
+
+TXResult<void> TXStreamingSheet::beginSheetData() {
+    if (sheetDataStarted_) {
+        return Ok();
+    }
+    if (!columnWidths_.empty()) {
+        writer_.startElement("cols");
+        for (const auto& [col, width] : columnWidths_) {
+            writer_.startElement("col")
+                   .attribute("min", col)
+                   .attribute("max", col)
+                   .attribute("width", width)
+                   .attribute("customWidth", "1")
+                   .endElement("col");
+        }
+        writer_.endElement("cols");
+    }
+    writer_.startElement("sheetData");
+    sheetDataStarted_ = true;
+    return writer_.status();
+}
+
+TXResult<void> TXStreamingSheet::setColumnWidth(column_t col, double width) {
+    if (closed_ || sheetDataStarted_) {
+        return Err<void>(TXErrorCode::OperationFailed, "Column widths must be set before the first row is written");
+    }
+    if (!col.is_valid() || width <= 0.0) {
+        return Err<void>(TXErrorCode::InvalidArgument, "Invalid column or width");
+    }
+    for (auto& entry : columnWidths_) {
+        if (entry.first == col.index()) {
+            entry.second = width;
+            return Ok();
+        }
+    }
+    // <cols> 要求按列号递增
+    auto it = std::lower_bound(columnWidths_.begin(), columnWidths_.end(), col.index(),
+                               [](const std::pair<u32, double>& e, u32 c) { return e.first < c; });
+    columnWidths_.insert(it, {col.index(), width});
+    return Ok();
+}
+
+TXResult<void> TXStreamingSheet::appendRow(const std::vector<cell_value_t>& values, u32 styleIndex) {
+    return appendRow(row_t(lastRow_ + 1), values, styleIndex);
+}
+
+TXResult<void> TXStreamingSheet::appendRow(row_t row, const std::vector<cell_value_t>& values, u32 styleIndex) {
+    if (closed_) {
+        return Err<void>(TXErrorCode::OperationFailed, "Sheet '" + name_ + "' is closed for writing");
+    }
+    if (!row.is_valid() || row.index() <= lastRow_) {
+        return Err<void>(TXErrorCode::InvalidArgument,
+                         "Rows must be appended in increasing order (last row " + std::to_string(lastRow_) + ")");
+    }
+    if (values.size() > column_t::MAX_COLUMNS) {
+        return Err<void>(TXErrorCode::InvalidArgument, "Too many columns in row");
+    }
+
+    auto startResult = beginSheetData();
+    if (startResult.isError()) {
+        return startResult;
+    }
+
+    const u32 rowIndex = row.index();
+    cellRefs_.setRow(rowIndex);
+    writer_.startElement("row").attributeRaw("r", cellRefs_.rowText());
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        const cell_value_t& value = values[i];
+        const bool empty = std::holds_alternative<std::monostate>(value);
+        if (empty && styleIndex == 0) {
+            continue;
+        }
+
+        writer_.startElement("c").attributeRaw("r", cellRefs_.cell(static_cast<u32>(i + 1)));
+        if (styleIndex != 0) {
+            writer_.attribute("s", styleIndex);
+        }
+
+        if (const auto* str = std::get_if<std::string>(&value)) {
+            writer_.attributeRaw("t", "inlineStr").startElement("is").startElement("t");
+            if (TXXmlStreamWriter::needsSpacePreserve(*str)) {
+                writer_.attributeRaw("xml:space", "preserve");
+            }
+            writer_.text(*str).endElement("t").endElement("is");
+        } else if (const auto* number = std::get_if<double>(&value)) {
+            writer_.startElement("v").text(*number).endElement("v");
+        } else if (const auto* integer = std::get_if<int64_t>(&value)) {
+            writer_.startElement("v").text(*integer).endElement("v");
+        } else if (const auto* boolean = std::get_if<bool>(&value)) {
+            writer_.attributeRaw("t", "b").startElement("v").raw(*boolean ? "1" : "0").endElement("v");
+        }
+        writer_.endElement("c");
+    }
+    writer_.endElement("row");
+
+    lastRow_ = rowIndex;
+    ++rowCount_;
+    return writer_.status();
+}
+
+TXResult<void> TXStreamingSheet::finish() {
+    if (closed_) {
+        return Ok();
+    }
+    closed_ = true;
+
+    auto startResult = beginSheetData();
+    if (startResult.isError()) {
+        return startResult;
+    }
+    writer_.endElement("sheetData").endElement("worksheet");
+
+    auto flushResult = writer_.flush();
+    if (flushResult.isError()) {
+        return flushResult;
+    }
+    return zipWriter_.closeEntry();
+}
+
+// ==================== TXStreamingWorkbook ====================
+
+TXStreamingWorkbook::TXStreamingWorkbook()
+    : styleManager_(std::make_unique<TXStyleManager>())
+    , componentManager_(std::make_unique<ComponentManager>())
+    , sharedStringsPool_(std::make_unique<TXSharedStringsPool>())
+    , protectionManager_(std::make_unique<TXWorkbookProtectionManager>())
+    , context_(std::make_unique<TXWorkbookContext>(sheets_, *styleManager_, *componentManager_,
+                                                   *sharedStringsPool_, *protectionManager_)) {
+    componentManager_->registerComponent(ExcelComponent::BasicWorkbook);
+}
+
+TXStreamingWorkbook::~TXStreamingWorkbook() {
+    if (zipWriter_.isOpen()) {
+        (void)close();
+    }
+}
+
+TXResult<void> TXStreamingWorkbook::open(const std::string& filename) {
+    if (zipWriter_.isOpen()) {
+        return Err<void>(TXErrorCode::OperationFailed, "Streaming workbook is already open");
+    }
+    return zipWriter_.open(filename, false);
+}
+
+TXResult<TXStreamingSheet*> TXStreamingWorkbook::addSheet(const std::string& name) {
+    if (!zipWriter_.isOpen()) {
+        return Err<TXStreamingSheet*>(TXErrorCode::OperationFailed, "Streaming workbook is not open");
+    }
+    if (name.empty() || name.size() > 31) {
+        return Err<TXStreamingSheet*>(TXErrorCode::InvalidSheetName, "Invalid sheet name: " + name);
+    }
+    for (const auto& sheet : streamingSheets_) {
+        if (sheet->getName() == name) {
+            return Err<TXStreamingSheet*>(TXErrorCode::SheetNameExists, "Sheet already exists: " + name);
+        }
+    }
+
+    auto finishResult = finishCurrentSheet();
+    if (finishResult.isError()) {
+        return Err<TXStreamingSheet*>(finishResult.error());
+    }
+
+    const auto index = static_cast<u32>(streamingSheets_.size());
+    std::unique_ptr<TXStreamingSheet> sheet(new TXStreamingSheet(zipWriter_, name, index));
+    auto beginResult = sheet->begin();
+    if (beginResult.isError()) {
+        return Err<TXStreamingSheet*>(beginResult.error());
+    }
+
+    sheets_.push_back(std::make_unique<TXSheet>(name, nullptr));
+    streamingSheets_.push_back(std::move(sheet));
+    return Ok(streamingSheets_.back().get());
+}
+
+u32 TXStreamingWorkbook::registerStyle(const TXCellStyle& style) {
+    componentManager_->registerComponent(ExcelComponent::Styles);
+    return styleManager_->registerCellStyleXF(style);
+}
+
+TXResult<void> TXStreamingWorkbook::finishCurrentSheet() {
+    if (streamingSheets_.empty()) {
+        return Ok();
+    }
+    return streamingSheets_.back()->finish();
+}
+
+TXResult<void> TXStreamingWorkbook::close() {
+    if (!zipWriter_.isOpen()) {
+        return Ok();
+    }
+
+    auto finishResult = finishCurrentSheet();
+    if (finishResult.isError()) {
+        zipWriter_.close();
+        return finishResult;
+    }
+
+    // 工作簿至少需要一个工作表
+    if (streamingSheets_.empty()) {
+        auto sheetResult = addSheet("Sheet1");
+        if (sheetResult.isError()) {
+            zipWriter_.close();
+            return Err<void>(sheetResult.error());
+        }
+        auto emptyResult = finishCurrentSheet();
+        if (emptyResult.isError()) {
+            zipWriter_.close();
+            return emptyResult;
+        }
+    }
+
+    TXContentTypesXmlHandler contentTypesHandler;
+    TXMainRelsXmlHandler mainRelsHandler;
+    TXWorkbookXmlHandler workbookHandler;
+    TXWorkbookRelsXmlHandler workbookRelsHandler;
+    std::vector<TXXmlHandler*> handlers = {
+        &contentTypesHandler, &mainRelsHandler, &workbookHandler, &workbookRelsHandler
+    };
+    StylesXmlHandler stylesHandler;
+    if (componentManager_->hasComponent(ExcelComponent::Styles)) {
+        handlers.push_back(&stylesHandler);
+    }
+
+    for (TXXmlHandler* handler : handlers) {
+        auto saveResult = handler->save(zipWriter_, *context_);
+        if (saveResult.isError()) {
+            zipWriter_.close();
+            return Err<void>(saveResult.error().getCode(),
+                             "Failed to save " + handler->partName() + ": " + saveResult.error().getMessage());
+        }
+    }
+
+    zipWriter_.close();
+    return Ok();
+}
+
+} // namespace TinaXlsx
@@ -24,20 +24,28 @@ column_t::index_t column_t::column_index_from_string(const std::string& column_s
 }
 
 std::string column_t::column_string_from_index(index_t column_index) {
+    char letters[MAX_COLUMN_LETTERS];
+    return std::string(letters, column_chars_from_index(column_index, letters));
+}
+
+std::size_t column_t::column_chars_from_index(index_t column_index, char* buffer) {
     if (column_index == 0 || column_index > MAX_COLUMNS) {
-        return "";
+        return 0;
     }
-    
-    std::string result;
+
+    // 从低位到高位生成，写在缓冲区末尾后再移到开头
+    char letters[MAX_COLUMN_LETTERS];
+    std::size_t start = MAX_COLUMN_LETTERS;
     index_t index = column_index;
-    
     while (index > 0) {
         index--; // 转换为 0-based
-        result = char('A' + (index % 26)) + result;
+        letters[--start] = char('A' + (index % 26));
         index /= 26;
     }
-    
-    return result;
+
+    const std::size_t length = MAX_COLUMN_LETTERS - start;
+    std::copy(letters + start, letters + MAX_COLUMN_LETTERS, buffer);
+    return length;
 }
 
 // ==================== 工具函数实现 ====================
@@ -3,6 +3,9 @@
 //
 
 #include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <optional>
 #include <regex>
 
 #include "TinaXlsx/TXWorkbook.hpp"
@@ -19,9 +22,108 @@
 #include "TinaXlsx/TXWorksheetRelsXmlHandler.hpp"
 #include "TinaXlsx/TXSharedStringsXmlHandler.hpp"
 #include "TinaXlsx/TXChartXmlHandler.hpp"
+#include "TinaXlsx/TXDeflate.hpp"
+#include "TinaXlsx/TXParallel.hpp"
+#include "TinaXlsx/TXXmlSaxParser.hpp"
+#include "TinaXlsx/TXZipArchive.hpp"
 
 namespace TinaXlsx
 {
+    namespace
+    {
+        /**
+         * @brief 收集关系部件中的内部目标，外部链接（TargetMode="External"）不是归档中的部件
+         */
+        class RelationshipTargetsHandler : public TXXmlSaxHandler
+        {
+        public:
+            void onStartElement(std::string_view qname, const TXXmlSaxAttributes& attributes) override
+            {
+                if (TXXmlSaxParser::localName(qname) == "Relationship" && attributes.get("TargetMode") != "External") {
+                    targets.emplace_back(attributes.get("Target"));
+                }
+            }
+
+            std::vector<std::string> targets;
+        };
+
+        /**
+         * @brief 收集 [Content_Types].xml 中的 Default（扩展名转为小写）和 Override
+         */
+        class ContentTypesHandler : public TXXmlSaxHandler
+        {
+        public:
+            void onStartElement(std::string_view qname, const TXXmlSaxAttributes& attributes) override
+            {
+                const std::string_view name = TXXmlSaxParser::localName(qname);
+                if (name == "Default") {
+                    std::string extension(attributes.get("Extension"));
+                    std::transform(extension.begin(), extension.end(), extension.begin(),
+                                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                    defaults.emplace(std::move(extension), attributes.get("ContentType"));
+                } else if (name == "Override") {
+                    overrides.emplace(attributes.get("PartName"), attributes.get("ContentType"));
+                }
+            }
+
+            std::unordered_map<std::string, std::string> defaults;
+            std::unordered_map<std::string, std::string> overrides;
+        };
+
+        /**
+         * @brief 把关系目标解析为归档中的部件名：相对路径相对于所属部件所在目录，并消去 . 和 ..
+         */
+        std::string resolveRelationshipTarget(const std::string& ownerPart, std::string_view target)
+        {
+            std::string path;
+            if (!target.empty() && target.front() == '/') {
+                path = std::string(target.substr(1));
+            } else {
+                const std::size_t slash = ownerPart.rfind('/');
+                path = (slash == std::string::npos ? std::string() : ownerPart.substr(0, slash + 1)) + std::string(target);
+            }
+
+            std::vector<std::string> segments;
+            std::size_t start = 0;
+            while (start <= path.size()) {
+                std::size_t end = path.find('/', start);
+                if (end == std::string::npos) {
+                    end = path.size();
+                }
+                const std::string segment = path.substr(start, end - start);
+                if (segment == "..") {
+                    if (!segments.empty()) {
+                        segments.pop_back();
+                    }
+                } else if (!segment.empty() && segment != ".") {
+                    segments.push_back(segment);
+                }
+                start = end + 1;
+            }
+
+            std::string part;
+            for (const auto& segment : segments) {
+                if (!part.empty()) {
+                    part += '/';
+                }
+                part += segment;
+            }
+            return part;
+        }
+
+        /**
+         * @brief 部件对应的关系部件名，如 xl/drawings/drawing1.xml → xl/drawings/_rels/drawing1.xml.rels
+         */
+        std::string relationshipsPartOf(const std::string& part)
+        {
+            const std::size_t slash = part.rfind('/');
+            if (slash == std::string::npos) {
+                return "_rels/" + part + ".rels";
+            }
+            return part.substr(0, slash + 1) + "_rels/" + part.substr(slash + 1) + ".rels";
+        }
+    } // namespace
+
     // ==================== TXWorkbook 实现 ====================
 
     TXWorkbook::TXWorkbook() 
@@ -51,7 +153,12 @@ namespace TinaXlsx
         , style_manager_(std::move(other.style_manager_))
         , shared_strings_pool_(std::move(other.shared_strings_pool_))
         , context_(std::move(other.context_))
-        , workbook_protection_manager_(std::move(other.workbook_protection_manager_)) {
+        , workbook_protection_manager_(std::move(other.workbook_protection_manager_))
+        , source_archive_(std::move(other.source_archive_))
+        , source_filename_(std::move(other.source_filename_))
+        , source_sheets_(std::move(other.source_sheets_))
+        , source_style_revision_(other.source_style_revision_)
+        , pending_sheets_(std::move(other.pending_sheets_)) {
     }
 
     TXWorkbook& TXWorkbook::operator=(TXWorkbook&& other) noexcept {
@@ -65,20 +172,63 @@ namespace TinaXlsx
             shared_strings_pool_ = std::move(other.shared_strings_pool_);
             context_ = std::move(other.context_);
             workbook_protection_manager_ = std::move(other.workbook_protection_manager_);
+            source_archive_ = std::move(other.source_archive_);
+            source_filename_ = std::move(other.source_filename_);
+            source_sheets_ = std::move(other.source_sheets_);
+            source_style_revision_ = other.source_style_revision_;
+            pending_sheets_ = std::move(other.pending_sheets_);
         }
         return *this;
     }
 
     bool TXWorkbook::loadFromFile(const std::string& filename) {
+        return loadFromFile(filename, TXLoadOptions{});
+    }
+
+    bool TXWorkbook::loadFromFile(const std::string& filename, const TXLoadOptions& options) {
         // 清空现有数据
         clear();
 
-        TXZipArchiveReader zipReader;
-        if (!zipReader.open(filename)) {
+        auto zipReader = std::make_unique<TXZipArchiveReader>();
+        if (!zipReader->open(filename)) {
             last_error_ = "Failed to open XLSX file.";
             return false;
         }
+        if (!loadFromArchive(*zipReader, options)) {
+            return false;
+        }
+        if (options.lazySheets) {
+            // 未解析的工作表不参与保存前的组件检测，按归档内容注册样式组件
+            auto hasStyles = zipReader->has("xl/styles.xml");
+            if (hasStyles.isOk() && hasStyles.value()) {
+                component_manager_.registerComponent(ExcelComponent::Styles);
+            }
+        }
+        attachSource(std::move(zipReader), filename);
+        if (options.lazySheets) {
+            for (const auto& sheet : sheets_) {
+                pending_sheets_.insert(sheet.get());
+            }
+        }
+        return true;
+    }
 
+    bool TXWorkbook::loadFromMemory(const void* data, std::size_t size) {
+        clear();
+
+        TXZipArchiveReader zipReader;
+        if (!zipReader.openMemory(data, size)) {
+            last_error_ = "Failed to open XLSX data.";
+            return false;
+        }
+        return loadFromArchive(zipReader, TXLoadOptions{});
+    }
+
+    bool TXWorkbook::loadFromMemory(const std::vector<uint8_t>& data) {
+        return loadFromMemory(data.data(), data.size());
+    }
+
+    bool TXWorkbook::loadFromArchive(TXZipArchiveReader& zipReader, const TXLoadOptions& options) {
         // 加载 workbook.xml（必须首先加载以获取工作表信息）
         TXWorkbookXmlHandler workbookHandler;
         auto workbookLoadResult = workbookHandler.load(zipReader, *context_);
@@ -97,8 +247,11 @@ namespace TinaXlsx
             }
         }
 
-        // 加载 sharedStrings.xml（如果存在）
-        if (component_manager_.hasComponent(ExcelComponent::SharedStrings)) {
+        // 加载 sharedStrings.xml（如果存在）。clear() 之后组件管理器只剩基础组件，
+        // 因此按归档内容判断，并注册组件以便再次保存时写出
+        auto hasSharedStrings = zipReader.has("xl/sharedStrings.xml");
+        if (hasSharedStrings.isOk() && hasSharedStrings.value()) {
+            component_manager_.registerComponent(ExcelComponent::SharedStrings);
             TXSharedStringsXmlHandler sharedStringsHandler;
             auto sharedStringsLoadResult = sharedStringsHandler.load(zipReader, *context_);
             if (sharedStringsLoadResult.isError()) {
@@ -107,14 +260,9 @@ namespace TinaXlsx
             }
         }
 
-        // 加载每个工作表
-        for (size_t i = 0; i < sheets_.size(); ++i) {
-            TXWorksheetXmlHandler worksheetHandler(i);
-            auto worksheetLoadResult = worksheetHandler.load(zipReader, *context_);
-            if (worksheetLoadResult.isError()) {
-                last_error_ = "Worksheet " + std::to_string(i) + " load failed: " + worksheetLoadResult.error().getMessage();
-                return false;
-            }
+        // 加载每个工作表（按需加载时推迟到第一次访问）
+        if (!options.lazySheets && !loadWorksheets(zipReader, options.threadCount)) {
+            return false;
         }
 
         // 加载其他组件（如文档属性）
@@ -127,21 +275,127 @@ namespace TinaXlsx
             }
         }
 
+        // 加载过程中的写入不算修改
+        for (const auto& sheet : sheets_) {
+            sheet->clearModified();
+        }
+        return true;
+    }
+
+    bool TXWorkbook::loadWorksheets(TXZipArchiveReader& zipReader, u32 threadCount) {
+        // 各工作表只写入自己的单元格管理器，归档和共享字符串表只读，可以并发解析
+        std::vector<std::string> errors(sheets_.size());
+        TXParallel::forEach(sheets_.size(), threadCount, [&](std::size_t i) {
+            TXWorksheetXmlHandler worksheetHandler(i);
+            auto worksheetLoadResult = worksheetHandler.load(zipReader, *context_);
+            if (worksheetLoadResult.isError()) {
+                errors[i] = worksheetLoadResult.error().getMessage();
+            }
+        });
+
+        // 按工作表顺序报告第一个错误，与单线程加载一致
+        for (std::size_t i = 0; i < errors.size(); ++i) {
+            if (!errors[i].empty()) {
+                last_error_ = "Worksheet " + std::to_string(i) + " load failed: " + errors[i];
+                return false;
+            }
+        }
         return true;
     }
 
     bool TXWorkbook::saveToFile(const std::string& filename) {
-        // 在保存前准备组件检测
-        prepareForSaving();
+        return saveToFile(filename, TXSaveOptions{});
+    }
+
+    bool TXWorkbook::saveToFile(const std::string& filename, const TXSaveOptions& options) {
+        // 覆盖源文件会使映射中的数据失效，只能全部重新生成
+        std::error_code ec;
+        if (source_archive_ && std::filesystem::equivalent(filename, source_filename_, ec)) {
+            if (!ensureAllSheetsLoaded()) {
+                return false;
+            }
+            releaseSource();
+        }
 
+        const int level = std::clamp(options.compressionLevel, 0, 9);
         TXZipArchiveWriter zipWriter;
-        if (!zipWriter.open(filename, false)) {
+        if (!zipWriter.open(filename, false, static_cast<int16_t>(level))) {
             last_error_ = "无法创建文件: " + filename;
             return false;
         }
+        return saveToArchive(zipWriter, options);
+    }
+
+    bool TXWorkbook::saveToMemory(std::vector<uint8_t>& buffer) {
+        return saveToMemory(buffer, TXSaveOptions{});
+    }
+
+    bool TXWorkbook::saveToMemory(std::vector<uint8_t>& buffer, const TXSaveOptions& options) {
+        buffer.clear();
+        return saveToStream([&buffer](const uint8_t* data, std::size_t size) {
+            buffer.insert(buffer.end(), data, data + size);
+            return true;
+        }, options);
+    }
+
+    bool TXWorkbook::saveToStream(const TXOutputSink& sink) {
+        return saveToStream(sink, TXSaveOptions{});
+    }
+
+    bool TXWorkbook::saveToStream(const TXOutputSink& sink, const TXSaveOptions& options) {
+        const int level = std::clamp(options.compressionLevel, 0, 9);
+        TXZipArchiveWriter zipWriter;
+        if (!zipWriter.openMemory(static_cast<int16_t>(level))) {
+            last_error_ = "无法创建内存归档";
+            return false;
+        }
+        if (!saveToArchive(zipWriter, options)) {
+            return false;
+        }
+
+        // 关闭后中央目录才写入，归档数据直接交给回调
+        zipWriter.close();
+        auto buffer = zipWriter.memoryBuffer();
+        if (buffer.isError()) {
+            last_error_ = "Memory archive failed: " + buffer.error().getMessage();
+            return false;
+        }
+        const std::string_view bytes = buffer.value();
+        if (!sink(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size())) {
+            last_error_ = "Output sink rejected the workbook data";
+            return false;
+        }
+        return true;
+    }
+
+    bool TXWorkbook::saveToArchive(TXZipArchiveWriter& zipWriter, const TXSaveOptions& options) {
+        // 样式表未变时源文件中的样式索引仍然有效，未修改的部件可以原样复制
+        const bool reuseSource = options.reuseUnchangedParts && source_archive_ &&
+                                 style_manager_.getRevision() == source_style_revision_;
+        std::vector<std::string> sourceParts(sheets_.size());
+        std::vector<SourceCopies> sourceCopies(sheets_.size());
+        if (reuseSource) {
+            planSourceReuse(sourceParts, sourceCopies);
+        }
+        bool reusesSheets = false;
+        for (std::size_t i = 0; i < sheets_.size(); ++i) {
+            reusesSheets = reusesSheets || !sourceParts[i].empty();
+            // 需要重新生成的工作表必须先解析
+            if (sourceParts[i].empty() && !ensureSheetLoaded(sheets_[i].get())) {
+                return false;
+            }
+        }
+
+        // 在保存前准备组件检测
+        prepareForSaving();
+        zipWriter.setStoreThreshold(options.storeThreshold);
+        zipWriter.setModifiedTime(options.modifiedTime);
 
         // 保存 [Content_Types].xml
         TXContentTypesXmlHandler contentTypesHandler;
+        if (!addSourceContentTypes(contentTypesHandler, sourceCopies)) {
+            return false;
+        }
         auto contentTypesResult = contentTypesHandler.save(zipWriter, *context_);
         if (contentTypesResult.isError()) {
             last_error_ = "Content types save failed: " + contentTypesResult.error().getMessage();
@@ -173,90 +427,417 @@ namespace TinaXlsx
 
         // 保存 styles.xml（如果启用了样式组件）
         if (component_manager_.hasComponent(ExcelComponent::Styles)) {
-            StylesXmlHandler stylesHandler;
-            auto stylesResult = stylesHandler.save(zipWriter, *context_);
-            if (stylesResult.isError()) {
-                last_error_ = "Styles save failed: " + stylesResult.error().getMessage();
-                return false;
+            if (reuseSource && sourceHas("xl/styles.xml")) {
+                if (!copySourcePart(zipWriter, "xl/styles.xml", "xl/styles.xml")) {
+                    return false;
+                }
+            } else {
+                StylesXmlHandler stylesHandler;
+                auto stylesResult = stylesHandler.save(zipWriter, *context_);
+                if (stylesResult.isError()) {
+                    last_error_ = "Styles save failed: " + stylesResult.error().getMessage();
+                    return false;
+                }
             }
         }
 
-        // 保存每个工作表（必须在sharedStrings之前，因为工作表保存时会填充共享字符串池）
-        for (size_t i = 0; i < sheets_.size(); ++i) {
-            TXWorksheetXmlHandler worksheetHandler(i);
-            auto worksheetResult = worksheetHandler.save(zipWriter, *context_);
-            if (worksheetResult.isError()) {
-                last_error_ = "Worksheet " + std::to_string(i) + " save failed: " + worksheetResult.error().getMessage();
-                return false;
+        // 保存每个工作表（必须在sharedStrings之前，因为工作表保存时会填充共享字符串池）。
+        // 每次保存都从空池开始，保证 sst 与本次写出的索引一致且不含已删除单元格的字符串；
+        // 复用源文件中的工作表时例外，见下方预置
+        shared_strings_pool_.reset();
+        if (reusesSheets) {
+            // 复制的工作表按源 sst 的索引引用字符串，先按原顺序预置，保证这些索引不变
+            const TXSharedStringTable& sourceStrings = shared_strings_pool_.getLoadedStrings();
+            shared_strings_pool_.reserve(sourceStrings.size());
+            for (u32 i = 0; i < sourceStrings.size(); ++i) {
+                shared_strings_pool_.append(sourceStrings[i]);
             }
+        }
+        const std::size_t seededStrings = shared_strings_pool_.size();
 
-            // 保存工作表关系文件（如果有图表）
-            const TXSheet* sheet = sheets_[i].get();
-            if (sheet->getChartCount() > 0) {
-                TXWorksheetRelsXmlHandler worksheetRelsHandler(static_cast<u32>(i));
-                auto worksheetRelsResult = worksheetRelsHandler.save(zipWriter, *context_);
-                if (worksheetRelsResult.isError()) {
-                    last_error_ = "Worksheet rels " + std::to_string(i) + " save failed: " + worksheetRelsResult.error().getMessage();
-                    return false;
-                }
+        const u32 threadCount = TXParallel::resolveThreadCount(options.threadCount);
+        if (!saveWorksheets(zipWriter, threadCount, options, sourceParts, sourceCopies)) {
+            return false;
+        }
 
-                // 保存绘图文件
-                TXDrawingXmlHandler drawingHandler(static_cast<u32>(i));
-                auto drawingResult = drawingHandler.save(zipWriter, *context_);
-                if (drawingResult.isError()) {
-                    last_error_ = "Drawing " + std::to_string(i) + " save failed: " + drawingResult.error().getMessage();
+        // 保存 sharedStrings.xml（如果启用了共享字符串组件）
+        if (component_manager_.hasComponent(ExcelComponent::SharedStrings)) {
+            // 没有新增字符串时池中内容与源 sst 完全相同，直接复制
+            if (reusesSheets && shared_strings_pool_.size() == seededStrings && sourceHas("xl/sharedStrings.xml")) {
+                if (!copySourcePart(zipWriter, "xl/sharedStrings.xml", "xl/sharedStrings.xml")) {
                     return false;
                 }
-
-                // 保存绘图关系文件
-                TXDrawingRelsXmlHandler drawingRelsHandler(static_cast<u32>(i));
-                auto drawingRelsResult = drawingRelsHandler.save(zipWriter, *context_);
-                if (drawingRelsResult.isError()) {
-                    last_error_ = "Drawing rels " + std::to_string(i) + " save failed: " + drawingRelsResult.error().getMessage();
+            } else {
+                TXSharedStringsXmlHandler sharedStringsHandler;
+                auto sharedStringsResult = sharedStringsHandler.save(zipWriter, *context_);
+                if (sharedStringsResult.isError()) {
+                    last_error_ = "Shared strings save failed: " + sharedStringsResult.error().getMessage();
                     return false;
                 }
+            }
+        }
 
-                // 保存每个图表文件
-                auto charts = sheet->getAllCharts();
-                for (size_t j = 0; j < charts.size(); ++j) {
-                    TXChartXmlHandler chartHandler(charts[j], static_cast<u32>(j));
-                    auto chartResult = chartHandler.save(zipWriter, *context_);
-                    if (chartResult.isError()) {
-                        last_error_ = "Chart " + std::to_string(j) + " save failed: " + chartResult.error().getMessage();
-                        return false;
-                    }
+        // 保存文档属性
+        if (component_manager_.hasComponent(ExcelComponent::DocumentProperties)) {
+            TXDocumentPropertiesXmlHandler docPropsHandler;
+            auto docPropsResult = docPropsHandler.save(zipWriter, *context_);
+            if (docPropsResult.isError()) {
+                last_error_ = "Document properties save failed: " + docPropsResult.error().getMessage();
+                return false;
+            }
+        }
+
+        return true;
+    }
 
-                    // 保存图表关系文件
-                    TXChartRelsXmlHandler chartRelsHandler(static_cast<u32>(j));
-                    auto chartRelsResult = chartRelsHandler.save(zipWriter, *context_);
-                    if (chartRelsResult.isError()) {
-                        last_error_ = "Chart rels " + std::to_string(j) + " save failed: " + chartRelsResult.error().getMessage();
+    bool TXWorkbook::saveWorksheets(TXZipArchiveWriter& zipWriter, u32 threadCount, const TXSaveOptions& options,
+                                    const std::vector<std::string>& sourceParts,
+                                    const std::vector<SourceCopies>& sourceCopies) {
+        const std::size_t sheetCount = sheets_.size();
+
+        // 1. 各工作表把要写出的共享字符串收集到自己的暂存池
+        std::vector<TXSharedStringsPool> staging(sheetCount);
+        TXParallel::forEach(sheetCount, threadCount, [&](std::size_t i) {
+            if (sourceParts[i].empty()) {
+                TXWorksheetXmlHandler(i).collectSharedStrings(*context_, staging[i]);
+            }
+        });
+
+        // 2. 按工作表顺序合并，索引与工作表中单元格的写出顺序一致
+        for (const auto& pool : staging) {
+            for (std::string_view str : pool.getStrings()) {
+                shared_strings_pool_.add(str);
+            }
+        }
+        staging.clear();
+
+        // 3. 序列化并压缩，共享字符串池此时只读。单线程和多线程保存共用这一步和下面的写出，
+        //    压缩结果与线程数无关，所以两者写出的归档逐字节相同
+        std::vector<std::optional<TXResult<TXDeflatedData>>> parts(sheetCount);
+        std::vector<std::string> pendingXml(sheetCount);
+        const std::size_t threshold = options.parallelDeflateThreshold;
+        const std::size_t storeThreshold = options.storeThreshold;
+        const int level = std::clamp(options.compressionLevel, 0, 9);
+
+        // 小于存储阈值的表留给写入器直接存储；deferBlocked 为 true 时需要分块压缩的大表只序列化
+        auto encode = [&](std::size_t i, bool deferBlocked) {
+            auto xml = TXWorksheetXmlHandler(i).serialize(*context_);
+            if (xml.isError()) {
+                parts[i].emplace(Err<TXDeflatedData>(xml.error()));
+                return;
+            }
+            std::string data = std::move(xml).value();
+            const bool blocked = threshold != 0 && data.size() >= threshold;
+            if (data.size() < storeThreshold || (blocked && deferBlocked)) {
+                pendingXml[i] = std::move(data);
+                return;
+            }
+            parts[i].emplace(blocked ? TXDeflate::compressParallel(data.data(), data.size(), level, threadCount)
+                                     : TXDeflate::compress(data.data(), data.size(), level));
+        };
+
+        // 4. 按顺序追加条目
+        auto append = [&](std::size_t i) {
+            const std::string partName = TXWorksheetXmlHandler(i).partName();
+            if (!sourceParts[i].empty()) {
+                // 复制的工作表没有图表，它的关系部件和绘图等部件也从源文件复制
+                if (!copySourcePart(zipWriter, partName, sourceParts[i])) {
+                    return false;
+                }
+                for (const auto& [copyName, copySource] : sourceCopies[i]) {
+                    if (!copySourcePart(zipWriter, copyName, copySource)) {
                         return false;
                     }
                 }
+                return true;
+            }
+            TXResult<void> worksheetResult = Ok();
+            if (!parts[i]) {
+                // 小于存储阈值，由写入器按 STORE 方式写出
+                worksheetResult = zipWriter.write(partName, pendingXml[i].data(), pendingXml[i].size());
+                std::string().swap(pendingXml[i]);
+            } else if (parts[i]->isError()) {
+                worksheetResult = Err(parts[i]->error());
+            } else {
+                worksheetResult = zipWriter.writeDeflated(partName, parts[i]->value());
+            }
+            parts[i].reset();
+            if (worksheetResult.isError()) {
+                last_error_ = "Worksheet " + std::to_string(i) + " save failed: " + worksheetResult.error().getMessage();
+                return false;
+            }
+            return saveSheetAttachments(zipWriter, i);
+        };
+
+        if (threadCount <= 1) {
+            // 逐个生成并写出，同一时间只保留一个工作表的数据
+            for (std::size_t i = 0; i < sheetCount; ++i) {
+                if (sourceParts[i].empty()) {
+                    encode(i, false);
+                }
+                if (!append(i)) {
+                    return false;
+                }
             }
+            return true;
         }
 
-        // 保存 sharedStrings.xml（如果启用了共享字符串组件）
-        if (component_manager_.hasComponent(ExcelComponent::SharedStrings)) {
-            TXSharedStringsXmlHandler sharedStringsHandler;
-            auto sharedStringsResult = sharedStringsHandler.save(zipWriter, *context_);
-            if (sharedStringsResult.isError()) {
-                last_error_ = "Shared strings save failed: " + sharedStringsResult.error().getMessage();
+        TXParallel::forEach(sheetCount, threadCount, [&](std::size_t i) {
+            if (sourceParts[i].empty()) {
+                encode(i, true);
+            }
+        });
+
+        // 大表逐个用全部线程按块压缩，避免单个条目拖住整个保存
+        for (std::size_t i = 0; i < sheetCount; ++i) {
+            if (!parts[i] && sourceParts[i].empty() && pendingXml[i].size() >= storeThreshold) {
+                parts[i].emplace(TXDeflate::compressParallel(pendingXml[i].data(), pendingXml[i].size(), level, threadCount));
+                std::string().swap(pendingXml[i]);
+            }
+        }
+
+        for (std::size_t i = 0; i < sheetCount; ++i) {
+            if (!append(i)) {
                 return false;
             }
         }
+        return true;
+    }
 
-        // 保存文档属性
-        if (component_manager_.hasComponent(ExcelComponent::DocumentProperties)) {
-            TXDocumentPropertiesXmlHandler docPropsHandler;
-            auto docPropsResult = docPropsHandler.save(zipWriter, *context_);
-            if (docPropsResult.isError()) {
-                last_error_ = "Document properties save failed: " + docPropsResult.error().getMessage();
+    void TXWorkbook::attachSource(std::unique_ptr<TXZipArchiveReader> archive, const std::string& filename) {
+        source_archive_ = std::move(archive);
+        source_filename_ = filename;
+        source_sheets_.clear();
+        for (std::size_t i = 0; i < sheets_.size(); ++i) {
+            source_sheets_.emplace(sheets_[i].get(), i);
+        }
+        source_style_revision_ = style_manager_.getRevision();
+    }
+
+    void TXWorkbook::releaseSource() {
+        source_archive_.reset();
+        source_filename_.clear();
+        source_sheets_.clear();
+        source_style_revision_ = 0;
+        pending_sheets_.clear();
+    }
+
+    bool TXWorkbook::sourceHas(const std::string& partName) const {
+        if (!source_archive_) {
+            return false;
+        }
+        auto hasResult = source_archive_->has(partName);
+        return hasResult.isOk() && hasResult.value();
+    }
+
+    std::string TXWorkbook::reusableSourcePart(std::size_t index) const {
+        const TXSheet* sheet = sheets_[index].get();
+        if (sheet->isModified() || sheet->getChartCount() != 0) {
+            return {};
+        }
+        auto it = source_sheets_.find(sheet);
+        if (it == source_sheets_.end()) {
+            return {};
+        }
+        std::string sourcePart = TXWorksheetXmlHandler(it->second).partName();
+        return sourceHas(sourcePart) ? sourcePart : std::string();
+    }
+
+    void TXWorkbook::planSourceReuse(std::vector<std::string>& sourceParts, std::vector<SourceCopies>& sourceCopies) {
+        // 本次生成的部件名，复制的部件不能与之重名
+        std::unordered_set<std::string> generated = {
+            TXContentTypesXmlHandler().partName(), TXMainRelsXmlHandler().partName(),
+            TXWorkbookXmlHandler().partName(), TXWorkbookRelsXmlHandler().partName(),
+            StylesXmlHandler().partName(), TXSharedStringsXmlHandler().partName(),
+            "docProps/core.xml", "docProps/app.xml"};
+        for (std::size_t i = 0; i < sheets_.size(); ++i) {
+            const TXSheet* sheet = sheets_[i].get();
+            generated.insert(TXWorksheetXmlHandler(i).partName());
+            generated.insert(TXWorksheetRelsXmlHandler(static_cast<u32>(i)).partName());
+            if (sheet->getChartCount() == 0) {
+                continue;
+            }
+            generated.insert(TXDrawingXmlHandler(static_cast<u32>(i)).partName());
+            generated.insert(TXDrawingRelsXmlHandler(static_cast<u32>(i)).partName());
+            const auto charts = sheet->getAllCharts();
+            for (std::size_t j = 0; j < charts.size(); ++j) {
+                generated.insert(TXChartXmlHandler(charts[j], static_cast<u32>(j)).partName());
+                generated.insert(TXChartRelsXmlHandler(static_cast<u32>(j)).partName());
+            }
+        }
+
+        std::unordered_set<std::string> copied;
+        for (std::size_t i = 0; i < sheets_.size(); ++i) {
+            sourceParts[i] = reusableSourcePart(i);
+            if (sourceParts[i].empty()) {
+                continue;
+            }
+            const std::string sourceRels = relationshipsPartOf(sourceParts[i]);
+            if (!sourceHas(sourceRels)) {
+                continue;
+            }
+
+            std::vector<std::string> parts;
+            const bool reusable = collectSourceRelationships(sourceRels, sourceParts[i], parts) &&
+                std::none_of(parts.begin(), parts.end(),
+                             [&](const std::string& part) { return generated.count(part) != 0; });
+            if (!reusable) {
+                sourceParts[i].clear();
+                continue;
+            }
+            sourceCopies[i].emplace_back(TXWorksheetRelsXmlHandler(static_cast<u32>(i)).partName(), sourceRels);
+            for (auto& part : parts) {
+                if (copied.insert(part).second) {
+                    sourceCopies[i].emplace_back(part, part);
+                }
+            }
+        }
+    }
+
+    bool TXWorkbook::collectSourceRelationships(const std::string& relsPart, const std::string& ownerPart,
+                                                std::vector<std::string>& parts) const {
+        std::vector<std::pair<std::string, std::string>> pending{{relsPart, ownerPart}};
+        std::unordered_set<std::string> seen{ownerPart};
+        while (!pending.empty()) {
+            const auto [rels, owner] = std::move(pending.back());
+            pending.pop_back();
+
+            auto xml = source_archive_->readString(rels);
+            if (xml.isError()) {
+                return false;
+            }
+            RelationshipTargetsHandler handler;
+            TXXmlSaxParser parser(handler);
+            if (parser.parse(xml.value()).isError()) {
                 return false;
             }
+
+            for (const auto& target : handler.targets) {
+                std::string part = resolveRelationshipTarget(owner, target);
+                // 源文件中不存在的目标保持原样的悬空关系
+                if (!seen.insert(part).second || !sourceHas(part)) {
+                    continue;
+                }
+                parts.push_back(part);
+                std::string partRels = relationshipsPartOf(part);
+                if (sourceHas(partRels)) {
+                    parts.push_back(partRels);
+                    pending.emplace_back(std::move(partRels), std::move(part));
+                }
+            }
+        }
+        return true;
+    }
+
+    bool TXWorkbook::addSourceContentTypes(TXContentTypesXmlHandler& handler,
+                                           const std::vector<SourceCopies>& sourceCopies) {
+        const bool copiesParts = std::any_of(sourceCopies.begin(), sourceCopies.end(),
+                                             [](const SourceCopies& copies) { return copies.size() > 1; });
+        if (!copiesParts) {
+            return true;
+        }
+
+        auto xml = source_archive_->readString(TXContentTypesXmlHandler().partName());
+        if (xml.isError()) {
+            last_error_ = "Source content types read failed: " + xml.error().getMessage();
+            return false;
+        }
+        ContentTypesHandler types;
+        TXXmlSaxParser parser(types);
+        auto parseResult = parser.parse(xml.value());
+        if (parseResult.isError()) {
+            last_error_ = "Source content types parse failed: " + parseResult.error().getMessage();
+            return false;
+        }
+
+        for (const auto& copies : sourceCopies) {
+            // 第一项是工作表关系部件，由默认的 rels 类型覆盖
+            for (std::size_t k = 1; k < copies.size(); ++k) {
+                const std::string& part = copies[k].first;
+                auto overrideIt = types.overrides.find("/" + part);
+                if (overrideIt != types.overrides.end()) {
+                    handler.addOverride(overrideIt->first, overrideIt->second);
+                    continue;
+                }
+                const std::size_t dot = part.rfind('.');
+                if (dot == std::string::npos) {
+                    continue;
+                }
+                std::string extension = part.substr(dot + 1);
+                std::transform(extension.begin(), extension.end(), extension.begin(),
+                               [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                auto defaultIt = types.defaults.find(extension);
+                if (defaultIt != types.defaults.end()) {
+                    handler.addDefault(extension, defaultIt->second);
+                }
+            }
+        }
+        return true;
+    }
+
+    bool TXWorkbook::copySourcePart(TXZipArchiveWriter& zipWriter, const std::string& partName,
+                                    const std::string& sourcePart) {
+        auto raw = source_archive_->rawEntry(sourcePart);
+        if (raw.isError()) {
+            last_error_ = "Source part " + sourcePart + " read failed: " + raw.error().getMessage();
+            return false;
+        }
+        auto copyResult = zipWriter.copyRaw(partName, raw.value());
+        if (copyResult.isError()) {
+            last_error_ = "Part " + partName + " copy failed: " + copyResult.error().getMessage();
+            return false;
+        }
+        return true;
+    }
+
+    bool TXWorkbook::saveSheetAttachments(TXZipArchiveWriter& zipWriter, std::size_t i) {
+        // 保存工作表关系文件（如果有图表）
+        const TXSheet* sheet = sheets_[i].get();
+        if (sheet->getChartCount() == 0) {
+            return true;
         }
 
+        TXWorksheetRelsXmlHandler worksheetRelsHandler(static_cast<u32>(i));
+        auto worksheetRelsResult = worksheetRelsHandler.save(zipWriter, *context_);
+        if (worksheetRelsResult.isError()) {
+            last_error_ = "Worksheet rels " + std::to_string(i) + " save failed: " + worksheetRelsResult.error().getMessage();
+            return false;
+        }
+
+        // 保存绘图文件
+        TXDrawingXmlHandler drawingHandler(static_cast<u32>(i));
+        auto drawingResult = drawingHandler.save(zipWriter, *context_);
+        if (drawingResult.isError()) {
+            last_error_ = "Drawing " + std::to_string(i) + " save failed: " + drawingResult.error().getMessage();
+            return false;
+        }
+
+        // 保存绘图关系文件
+        TXDrawingRelsXmlHandler drawingRelsHandler(static_cast<u32>(i));
+        auto drawingRelsResult = drawingRelsHandler.save(zipWriter, *context_);
+        if (drawingRelsResult.isError()) {
+            last_error_ = "Drawing rels " + std::to_string(i) + " save failed: " + drawingRelsResult.error().getMessage();
+            return false;
+        }
+
+        // 保存每个图表文件
+        auto charts = sheet->getAllCharts();
+        for (size_t j = 0; j < charts.size(); ++j) {
+            TXChartXmlHandler chartHandler(charts[j], static_cast<u32>(j));
+            auto chartResult = chartHandler.save(zipWriter, *context_);
+            if (chartResult.isError()) {
+                last_error_ = "Chart " + std::to_string(j) + " save failed: " + chartResult.error().getMessage();
+                return false;
+            }
+
+            // 保存图表关系文件
+            TXChartRelsXmlHandler chartRelsHandler(static_cast<u32>(j));
+            auto chartRelsResult = chartRelsHandler.save(zipWriter, *context_);
+            if (chartRelsResult.isError()) {
+                last_error_ = "Chart rels " + std::to_string(j) + " save failed: " + chartRelsResult.error().getMessage();
+                return false;
+            }
+        }
         return true;
     }
 
@@ -303,6 +884,8 @@ namespace TinaXlsx
             return false;
         }
 
+        source_sheets_.erase(it->get());
+        pending_sheets_.erase(it->get());
         sheets_.erase(it);
 
         // 调整活动工作表索引
@@ -323,7 +906,7 @@ namespace TinaXlsx
     }
 
     bool TXWorkbook::renameSheet(const std::string& oldName, const std::string& newName) {
-        auto sheet = getSheet(oldName);
+        auto sheet = findSheet(oldName);
         if (!sheet) {
             last_error_ = "Sheet not found: " + oldName;
             return false;
@@ -340,13 +923,18 @@ namespace TinaXlsx
     }
 
     TXSheet* TXWorkbook::getSheet(u64 index) const {
-        if (index < sheets_.size()) {
+        if (index < sheets_.size() && ensureSheetLoaded(sheets_[index].get())) {
             return sheets_[index].get();
         }
         return nullptr;
     }
 
     TXSheet* TXWorkbook::getSheet(const std::string& name) {
+        TXSheet* sheet = findSheet(name);
+        return sheet && ensureSheetLoaded(sheet) ? sheet : nullptr;
+    }
+
+    TXSheet* TXWorkbook::findSheet(const std::string& name) const {
         auto it = std::find_if(sheets_.begin(), sheets_.end(),
                                [&name](const std::unique_ptr<TXSheet>& sheet) {
                                    return sheet->getName() == name;
@@ -355,6 +943,69 @@ namespace TinaXlsx
         return (it != sheets_.end()) ? it->get() : nullptr;
     }
 
+    bool TXWorkbook::isSheetLoaded(const std::string& name) const {
+        TXSheet* sheet = findSheet(name);
+        std::lock_guard<std::mutex> lock(sheet_load_mutex_);
+        return sheet && pending_sheets_.count(sheet) == 0;
+    }
+
+    bool TXWorkbook::unloadSheet(const std::string& name) {
+        TXSheet* sheet = findSheet(name);
+        if (!sheet) {
+            last_error_ = "Sheet not found: " + name;
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(sheet_load_mutex_);
+        if (pending_sheets_.count(sheet) != 0) {
+            return true;
+        }
+        if (!source_archive_ || source_sheets_.count(sheet) == 0) {
+            last_error_ = "Sheet is not backed by a source file: " + name;
+            return false;
+        }
+        if (sheet->isModified()) {
+            last_error_ = "Sheet has unsaved changes: " + name;
+            return false;
+        }
+
+        sheet->clear();
+        sheet->clearModified();
+        pending_sheets_.insert(sheet);
+        return true;
+    }
+
+    bool TXWorkbook::ensureSheetLoaded(TXSheet* sheet) const {
+        // const 访问器可能在多个线程中同时调用，解析也在锁内进行，避免同一工作表被解析两次
+        std::lock_guard<std::mutex> lock(sheet_load_mutex_);
+        auto pending = pending_sheets_.find(sheet);
+        if (pending == pending_sheets_.end()) {
+            return true;
+        }
+
+        const std::size_t sourceIndex = source_sheets_.at(sheet);
+        TXWorksheetXmlHandler worksheetHandler(sourceIndex);
+        auto loadResult = worksheetHandler.loadInto(*source_archive_, *context_, *sheet);
+        if (loadResult.isError()) {
+            last_error_ = "Worksheet " + std::to_string(sourceIndex) + " load failed: " + loadResult.error().getMessage();
+            // 丢弃解析了一半的数据，下次访问时重试
+            sheet->clear();
+            sheet->clearModified();
+            return false;
+        }
+        sheet->clearModified();
+        pending_sheets_.erase(pending);
+        return true;
+    }
+
+    bool TXWorkbook::ensureAllSheetsLoaded() const {
+        for (const auto& sheet : sheets_) {
+            if (!ensureSheetLoaded(sheet.get())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     u64 TXWorkbook::getSheetCount() const {
         return sheets_.size();
     }
@@ -414,6 +1065,7 @@ namespace TinaXlsx
         style_manager_ = std::move(TXStyleManager());
         shared_strings_pool_ = TXSharedStringsPool();
         context_ = std::make_unique<TXWorkbookContext>(sheets_, style_manager_, component_manager_, shared_strings_pool_, workbook_protection_manager_);
+        releaseSource();
     }
 
     ComponentManager& TXWorkbook::getComponentManager() {
@@ -433,10 +1085,12 @@ namespace TinaXlsx
     }
 
     std::vector<std::unique_ptr<TXSheet>>& TXWorkbook::getSheets() {
+        ensureAllSheetsLoaded();
         return sheets_;
     }
 
     const std::vector<std::unique_ptr<TXSheet>>& TXWorkbook::getSheets() const {
+        ensureAllSheetsLoaded();
         return sheets_;
     }
 
@@ -466,35 +1120,29 @@ namespace TinaXlsx
         bool hasMergedCells = false;
         bool hasStyledCells = false;
         
-        for (const auto& sheet : sheets_) {
-            if (!sheet) continue;
+        for (const auto& sheetPtr : sheets_) {
+            if (!sheetPtr) continue;
+            // 只读访问，不触发修改标记
+            const TXSheet* sheet = sheetPtr.get();
             
             // 检查是否有合并单元格
             if (sheet->getMergeCount() > 0) {
                 hasMergedCells = true;
             }
             
-            // 获取已使用的范围
-            auto usedRange = sheet->getUsedRange();
-            if (usedRange.isValid()) {
-                auto start = usedRange.getStart();
-                auto end = usedRange.getEnd();
+            // 只遍历已存在的单元格，两类组件都找到后即可停止
+            for (const auto& [coord, cell] : sheet->getCellManager()) {
+                if (hasStringCells && hasStyledCells) break;
+                if (cell.isEmpty()) continue;
                 
-                for (row_t row = start.getRow(); row <= end.getRow(); ++row) {
-                    for (column_t col = start.getCol(); col <= end.getCol(); ++col) {
-                        const TXCell* cell = sheet->getCell(row, col);
-                        if (!cell || cell->isEmpty()) continue;
-                        
-                        // 检查是否有字符串值
-                        if (cell->getType() == TXCell::CellType::String) {
-                            hasStringCells = true;
-                        }
-                        
-                        // 检查是否有样式
-                        if (cell->getStyleIndex() != 0) {
-                            hasStyledCells = true;
-                        }
-                    }
+                // 检查是否有字符串值
+                if (cell.getType() == TXCell::CellType::String) {
+                    hasStringCells = true;
+                }
+                
+                // 检查是否有样式
+                if (cell.getStyleIndex() != 0) {
+                    hasStyledCells = true;
                 }
             }
         }
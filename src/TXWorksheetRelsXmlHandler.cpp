@@ -5,7 +5,6 @@
 #include "TinaXlsx/TXWorksheetRelsXmlHandler.hpp"
 #include "TinaXlsx/TXSheet.hpp"
 #include "TinaXlsx/TXError.hpp"
-#include "TinaXlsx/TXXmlWriter.hpp"
 
 namespace TinaXlsx
 {
@@ -35,36 +34,18 @@ namespace TinaXlsx
             return Ok();
         }
 
-        XmlNodeBuilder relationships("Relationships");
-        relationships.addAttribute("xmlns", "http://schemas.openxmlformats.org/package/2006/relationships");
+        TXXmlStreamWriter xml;
+        xml.declaration();
+        xml.startElement("Relationships")
+           .attribute("xmlns", "http://schemas.openxmlformats.org/package/2006/relationships");
 
         // 添加绘图关系
-        relationships.addChild(XmlNodeBuilder("Relationship")
-                              .addAttribute("Id", "rId1")
-                              .addAttribute("Type", "http://schemas.openxmlformats.org/officeDocument/2006/relationships/drawing")
-                              .addAttribute("Target", "../drawings/drawing" + std::to_string(m_sheetIndex + 1) + ".xml"));
-
-        TXXmlWriter writer;
-        auto setRootResult = writer.setRootNode(relationships);
-        if (setRootResult.isError()) {
-            return Err<void>(setRootResult.error().getCode(), 
-                           "Failed to set root node: " + setRootResult.error().getMessage());
-        }
-
-        auto xmlContentResult = writer.generateXmlString();
-        if (xmlContentResult.isError()) {
-            return Err<void>(xmlContentResult.error().getCode(), 
-                           "Failed to generate XML: " + xmlContentResult.error().getMessage());
-        }
+        writeRelationship(xml, "rId1",
+                          "http://schemas.openxmlformats.org/officeDocument/2006/relationships/drawing",
+                          "../drawings/drawing" + std::to_string(m_sheetIndex + 1) + ".xml");
 
-        std::vector<uint8_t> xmlData(xmlContentResult.value().begin(), xmlContentResult.value().end());
-        auto writeResult = zipWriter.write(partName(), xmlData);
-        if (writeResult.isError()) {
-            return Err<void>(writeResult.error().getCode(), 
-                           "Failed to write " + partName() + ": " + writeResult.error().getMessage());
-        }
-
-        return Ok();
+        xml.endElement("Relationships");
+        return writeXmlPart(zipWriter, xml);
     }
 
     std::string TXWorksheetRelsXmlHandler::partName() const
@@ -99,38 +80,20 @@ namespace TinaXlsx
             return Ok();
         }
 
-        XmlNodeBuilder relationships("Relationships");
-        relationships.addAttribute("xmlns", "http://schemas.openxmlformats.org/package/2006/relationships");
+        TXXmlStreamWriter xml;
+        xml.declaration();
+        xml.startElement("Relationships")
+           .attribute("xmlns", "http://schemas.openxmlformats.org/package/2006/relationships");
 
         // 为每个图表添加关系
         for (size_t i = 0; i < charts.size(); ++i) {
-            relationships.addChild(XmlNodeBuilder("Relationship")
-                                  .addAttribute("Id", "rId" + std::to_string(i + 1))
-                                  .addAttribute("Type", "http://schemas.openxmlformats.org/officeDocument/2006/relationships/chart")
-                                  .addAttribute("Target", "../charts/chart" + std::to_string(i + 1) + ".xml"));
-        }
-
-        TXXmlWriter writer;
-        auto setRootResult = writer.setRootNode(relationships);
-        if (setRootResult.isError()) {
-            return Err<void>(setRootResult.error().getCode(), 
-                           "Failed to set root node: " + setRootResult.error().getMessage());
-        }
-
-        auto xmlContentResult = writer.generateXmlString();
-        if (xmlContentResult.isError()) {
-            return Err<void>(xmlContentResult.error().getCode(), 
-                           "Failed to generate XML: " + xmlContentResult.error().getMessage());
-        }
-
-        std::vector<uint8_t> xmlData(xmlContentResult.value().begin(), xmlContentResult.value().end());
-        auto writeResult = zipWriter.write(partName(), xmlData);
-        if (writeResult.isError()) {
-            return Err<void>(writeResult.error().getCode(), 
-                           "Failed to write " + partName() + ": " + writeResult.error().getMessage());
+            writeRelationship(xml, "rId" + std::to_string(i + 1),
+                              "http://schemas.openxmlformats.org/officeDocument/2006/relationships/chart",
+                              "../charts/chart" + std::to_string(i + 1) + ".xml");
         }
 
-        return Ok();
+        xml.endElement("Relationships");
+        return writeXmlPart(zipWriter, xml);
     }
 
     std::string TXDrawingRelsXmlHandler::partName() const
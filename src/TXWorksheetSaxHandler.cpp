@@ -0,0 +1,157 @@
+//
+// @file TXWorksheetSaxHandler.cpp
+// @brief 工作表 sheetData 的 SAX 事件处理基类实现
+//
+
+#include "TinaXlsx/TXWorksheetSaxHandler.hpp"
+
+#include <limits>
+
+namespace TinaXlsx {
+
+bool TXWorksheetSaxHandler::parseCellReference(std::string_view ref, u32& row, u32& column) {
+    // 行号、列号溢出时取 u32 最大值，超出工作表范围的单元格随后被丢弃
+    constexpr u32 limit = std::numeric_limits<u32>::max();
+    std::size_t i = 0;
+    u32 c = 0;
+    while (i < ref.size() && ref[i] >= 'A' && ref[i] <= 'Z') {
+        c = c > (limit - 26) / 26 ? limit : c * 26 + static_cast<u32>(ref[i] - 'A' + 1);
+        ++i;
+    }
+    const std::size_t digitsStart = i;
+    while (i < ref.size() && ref[i] >= '0' && ref[i] <= '9') {
+        ++i;
+    }
+    const u32 r = parseUnsigned(ref.substr(digitsStart, i - digitsStart));
+    if (i != ref.size() || digitsStart == 0 || digitsStart == i) {
+        return false;
+    }
+    row = r;
+    column = c;
+    return true;
+}
+
+u32 TXWorksheetSaxHandler::parseUnsigned(std::string_view text) {
+    constexpr u32 limit = std::numeric_limits<u32>::max();
+    u32 value = 0;
+    for (char ch : text) {
+        if (ch < '0' || ch > '9') {
+            break;
+        }
+        const u32 digit = static_cast<u32>(ch - '0');
+        if (value > (limit - digit) / 10) {
+            return limit;
+        }
+        value = value * 10 + digit;
+    }
+    return value;
+}
+
+void TXWorksheetSaxHandler::onStartElement(std::string_view qname, const TXXmlSaxAttributes& attributes) {
+    const std::string_view name = TXXmlSaxParser::localName(qname);
+    if (!m_inSheetData) {
+        m_inSheetData = (name == "sheetData");
+        return;
+    }
+
+    if (name == "row") {
+        const std::string_view r = attributes.get("r");
+        m_row = r.empty() ? m_row + 1 : parseUnsigned(r);
+        m_col = 0;
+        onRowStart(m_row);
+    } else if (name == "c") {
+        beginCell(attributes);
+    } else if (m_inCell) {
+        if (name == "v") {
+            m_capture = Capture::Value;
+        } else if (name == "f") {
+            m_capture = Capture::Formula;
+        } else if (name == "is") {
+            m_inInlineString = true;
+            m_hasInlineString = true;
+        } else if (name == "t" && m_inInlineString) {
+            // is/t 或富文本 is/r/t
+            m_capture = Capture::InlineText;
+        } else if (name == "rPh") {
+            // 注音文本不属于单元格值
+            m_inInlineString = false;
+        }
+    }
+}
+
+void TXWorksheetSaxHandler::onEndElement(std::string_view qname) {
+    if (!m_inSheetData) {
+        return;
+    }
+    const std::string_view name = TXXmlSaxParser::localName(qname);
+    if (name == "c") {
+        if (m_inCell) {
+            endCell();
+        }
+    } else if (name == "row") {
+        onRowEnd(m_row);
+    } else if (name == "is") {
+        m_inInlineString = false;
+    } else if (name == "rPh") {
+        m_inInlineString = m_inCell && m_hasInlineString;
+    } else if (name == "v" || name == "f" || name == "t") {
+        m_capture = Capture::None;
+    } else if (name == "sheetData") {
+        m_inSheetData = false;
+    }
+}
+
+void TXWorksheetSaxHandler::onText(std::string_view text) {
+    switch (m_capture) {
+    case Capture::Value: m_value.append(text); break;
+    case Capture::Formula: m_formula.append(text); break;
+    case Capture::InlineText: m_inlineText.append(text); break;
+    case Capture::None: break;
+    }
+}
+
+void TXWorksheetSaxHandler::beginCell(const TXXmlSaxAttributes& attributes) {
+    m_inCell = true;
+    m_inInlineString = false;
+    m_hasInlineString = false;
+    m_capture = Capture::None;
+    m_value.clear();
+    m_formula.clear();
+    m_inlineText.clear();
+
+    u32 row = 0;
+    u32 col = 0;
+    if (parseCellReference(attributes.get("r"), row, col)) {
+        m_row = row;
+        m_col = col;
+    } else {
+        // r 属性可省略，此时按同一行内的顺序推断
+        ++m_col;
+    }
+
+    const std::string_view type = attributes.get("t", "n");
+    m_type.assign(type.data(), type.size());
+    const std::string_view style = attributes.get("s");
+    m_style = style.empty() ? 0 : parseUnsigned(style);
+}
+
+void TXWorksheetSaxHandler::endCell() {
+    m_inCell = false;
+    m_capture = Capture::None;
+    if (m_row == 0 || m_row > row_t::MAX_ROWS || m_col == 0 || m_col > column_t::MAX_COLUMNS) {
+        return;
+    }
+
+    CellData cell;
+    cell.row = m_row;
+    cell.column = m_col;
+    cell.type = m_type;
+    cell.styleIndex = m_style;
+    cell.value = m_value;
+    cell.formula = m_formula;
+    cell.inlineText = m_inlineText;
+    cell.hasInlineString = m_hasInlineString;
+    onCell(cell);
+}
+
+} // namespace TinaXlsx
@@ -5,23 +5,352 @@
 #include "TinaXlsx/TXWorksheetXmlHandler.hpp"
 #include "TinaXlsx/TXCell.hpp"
 #include "TinaXlsx/TXNumberUtils.hpp"
+#include <algorithm>
+#include <cstdio>
 #include <variant>
 
 #include "TinaXlsx/TXSharedStringsPool.hpp"
+#include "TinaXlsx/TXWorksheetSaxHandler.hpp"
+#include "TinaXlsx/TXZipArchive.hpp"
 
 namespace TinaXlsx
 {
+    namespace
+    {
+        /**
+         * @brief 把 SAX 解析出的单元格按 t 属性转换类型后直接写入 TXCellManager
+         */
+        class CellLoadSaxHandler : public TXWorksheetSaxHandler
+        {
+        public:
+            CellLoadSaxHandler(TXCellManager& cells, const TXSharedStringsPool& sharedStrings)
+                : m_cells(cells), m_sharedStrings(sharedStrings.getLoadedStrings())
+            {
+            }
+
+        protected:
+            void onCell(const CellData& data) override
+            {
+                if (!data.hasValue() && data.formula.empty() && data.styleIndex == 0) {
+                    return;
+                }
+
+                const TXCoordinate coord(row_t(data.row), column_t(data.column));
+                if (!data.formula.empty()) {
+                    // 公式单元格需要 TXCell 保存公式对象
+                    TXCell* cell = m_cells.getOrCreateCell(coord);
+                    if (!cell) {
+                        return;
+                    }
+                    if (data.hasValue()) {
+                        cell->setValue(convertValue(data));
+                    }
+                    cell->setFormula("=" + std::string(data.formula));
+                    if (data.styleIndex != 0) {
+                        cell->setStyleIndex(data.styleIndex);
+                    }
+                    return;
+                }
+
+                // 普通单元格直接写入列存储
+                const cell_value_t value = data.hasValue() ? convertValue(data) : cell_value_t{};
+                if (m_cells.setCellValue(coord, value) && data.styleIndex != 0) {
+                    m_cells.setCellStyleIndex(coord, data.styleIndex);
+                }
+            }
+
+        private:
+            cell_value_t convertValue(const CellData& data) const
+            {
+                if (data.type == "s") {
+                    std::string_view text;
+                    if (m_sharedStrings.tryGet(parseUnsigned(data.value), text)) {
+                        return std::string(text);
+                    }
+                    return std::string(data.value);
+                }
+                if (data.type == "inlineStr") {
+                    return std::string(data.inlineText);
+                }
+                if (data.type == "b") {
+                    return data.value == "1" || data.value == "true";
+                }
+                if (data.type == "str" || data.type == "e") {
+                    return std::string(data.value);
+                }
+
+                // 数值：不含小数点和指数的按整数读取，与保存时的格式对称
+                if (data.value.find_first_of(".eE") == std::string_view::npos) {
+                    if (auto integer = TXNumberUtils::parseInt64(data.value)) {
+                        return *integer;
+                    }
+                }
+                if (auto number = TXNumberUtils::parseDouble(data.value)) {
+                    return *number;
+                }
+                return std::string(data.value);
+            }
+
+            TXCellManager& m_cells;
+            const TXSharedStringTable& m_sharedStrings;
+        };
+
+        /**
+         * @brief 列宽最多保留两位小数，并去掉尾随的零
+         */
+        std::string formatColumnWidth(double width)
+        {
+            char buffer[32];
+            int length = std::snprintf(buffer, sizeof(buffer), "%.2f", width);
+            std::string widthStr(buffer, length > 0 ? static_cast<std::size_t>(length) : 0);
+            widthStr.erase(widthStr.find_last_not_of('0') + 1, std::string::npos);
+            if (!widthStr.empty() && widthStr.back() == '.') {
+                widthStr.pop_back();
+            }
+            return widthStr;
+        }
+    }
+
+    TXResult<void> TXWorksheetXmlHandler::load(TXZipArchiveReader& zipReader, TXWorkbookContext& context)
+    {
+        if (m_sheetIndex >= context.sheets.size()) {
+            return Err<void>(TXErrorCode::InvalidArgument, "Invalid sheet index");
+        }
+        return loadInto(zipReader, context, *context.sheets[m_sheetIndex]);
+    }
+
+    TXResult<void> TXWorksheetXmlHandler::loadInto(TXZipArchiveReader& zipReader, TXWorkbookContext& context,
+                                                   TXSheet& sheet)
+    {
+        CellLoadSaxHandler handler(sheet.getCellManager(), context.sharedStringsPool);
+        TXXmlSaxParser parser(handler);
+
+        // 边解压边解析，峰值内存与工作表大小无关
+        bool parseFailed = false;
+        auto streamResult = zipReader.readStream(partName(), [&](const uint8_t* data, std::size_t size) {
+            auto feedResult = parser.feed(reinterpret_cast<const char*>(data), size);
+            parseFailed = feedResult.isError();
+            return feedResult;
+        });
+        if (streamResult.isOk())
+        {
+            streamResult = parser.finish();
+            parseFailed = streamResult.isError();
+        }
+        if (streamResult.isError())
+        {
+            if (parseFailed)
+            {
+                return Err<void>(streamResult.error().getCode(), "Failed to parse " + partName() + ": " + streamResult.error().getMessage());
+            }
+            return Err<void>(streamResult.error().getCode(), "Failed to read " + partName());
+        }
+        return Ok();
+    }
+
+    TXResult<void> TXWorksheetXmlHandler::save(TXZipArchiveWriter& zipWriter, const TXWorkbookContext& context)
+    {
+        if (m_sheetIndex >= context.sheets.size()) {
+            return Err<void>(TXErrorCode::InvalidArgument, "Invalid sheet index");
+        }
+
+        auto openResult = zipWriter.openEntry(partName());
+        if (openResult.isError()) {
+            return Err<void>(openResult.error().getCode(), "Failed to write " + partName() + ": " + openResult.error().getMessage());
+        }
+
+        TXZipEntrySink sink(zipWriter);
+        TXXmlStreamWriter xml(&sink);
+        writeWorksheet(xml, context, false);
+
+        auto flushResult = xml.flush();
+        auto closeResult = zipWriter.closeEntry();
+        if (flushResult.isError()) {
+            return Err<void>(flushResult.error().getCode(), "Failed to write " + partName() + ": " + flushResult.error().getMessage());
+        }
+        if (closeResult.isError()) {
+            return Err<void>(closeResult.error().getCode(), "Failed to write " + partName() + ": " + closeResult.error().getMessage());
+        }
+        return Ok();
+    }
+
+    TXResult<std::string> TXWorksheetXmlHandler::serialize(const TXWorkbookContext& context) const
+    {
+        if (m_sheetIndex >= context.sheets.size()) {
+            return Err<std::string>(TXErrorCode::InvalidArgument, "Invalid sheet index");
+        }
+
+        TXXmlStreamWriter xml;
+        writeWorksheet(xml, context, true);
+        auto status = xml.status();
+        if (status.isError()) {
+            return Err<std::string>(status.error().getCode(), "Failed to write " + partName() + ": " + status.error().getMessage());
+        }
+        return Ok(xml.takeBuffer());
+    }
+
+    void TXWorksheetXmlHandler::collectSharedStrings(const TXWorkbookContext& context, TXSharedStringsPool& staging) const
+    {
+        if (m_sheetIndex >= context.sheets.size()) {
+            return;
+        }
+        // 与 writeWorksheet 相同的行优先顺序；空单元格不会写出共享字符串
+        std::string_view text;
+        const TXSheet* sheet = context.sheets[m_sheetIndex].get();
+        for (const auto& [coord, cell] : sheet->getCellManager()) {
+            if (!cell.isEmpty() && sharedStringOf(cell, text)) {
+                staging.add(text);
+            }
+        }
+    }
+
+    void TXWorksheetXmlHandler::writeWorksheet(TXXmlStreamWriter& xml, const TXWorkbookContext& context, bool lookupOnly) const
+    {
+        const TXSheet* sheet = context.sheets[m_sheetIndex].get();
+
+        xml.declaration();
+        xml.startElement("worksheet")
+           .attribute("xmlns", "http://schemas.openxmlformats.org/spreadsheetml/2006/main")
+           .attribute("xmlns:r", "http://schemas.openxmlformats.org/officeDocument/2006/relationships");
+
+        // 添加维度信息
+        TXRange usedRange = sheet->getUsedRange();
+        xml.startElement("dimension")
+           .attribute("ref", usedRange.isValid() ? usedRange.toAddress() : std::string("A1:A1"))
+           .endElement("dimension");
+
+        // 添加列宽信息（<col> 必须按列号递增）
+        const auto& customColumnWidths = sheet->getRowColumnManager().getCustomColumnWidths();
+        if (!customColumnWidths.empty()) {
+            std::vector<std::pair<column_t::index_t, double>> widths(customColumnWidths.begin(), customColumnWidths.end());
+            std::sort(widths.begin(), widths.end());
+
+            xml.startElement("cols");
+            for (const auto& [colIndex, width] : widths) {
+                xml.startElement("col")
+                   .attribute("min", colIndex)
+                   .attribute("max", colIndex)
+                   .attributeRaw("width", formatColumnWidth(width))
+                   .attributeRaw("customWidth", "1")
+                   .endElement("col");
+            }
+            xml.endElement("cols");
+        }
+
+        // 构建工作表数据
+        xml.startElement("sheetData");
+        if (usedRange.isValid()) {
+            // 按行优先顺序只遍历已存在的单元格，代价与单元格数成正比而不是使用范围的面积；
+            // 通过只读视图访问，保存时不会为普通单元格创建 TXCell 对象。
+            // 单元格引用在定长缓冲区中拼接，列字母按需缓存，写出单元格不分配堆内存
+            TXCellRefFormatter cellRefs;
+            u32 openRow = 0;
+            for (const auto& [coord, cell] : sheet->getCellManager()) {
+                if (cell.isEmpty() && cell.getStyleIndex() == 0) {
+                    continue;
+                }
+                if (!usedRange.contains(coord)) {
+                    continue;
+                }
+
+                // 只输出非空行
+                const u32 row = coord.getRow().index();
+                if (row != openRow) {
+                    if (openRow != 0) {
+                        xml.endElement("row");
+                    }
+                    cellRefs.setRow(row);
+                    xml.startElement("row").attributeRaw("r", cellRefs.rowText());
+                    openRow = row;
+                }
+
+                writeCell(xml, cell, cellRefs.cell(coord.getCol().index()), context, lookupOnly);
+            }
+            if (openRow != 0) {
+                xml.endElement("row");
+            }
+        }
+        xml.endElement("sheetData");
+
+        writeSheetTail(xml, sheet);
+        xml.endElement("worksheet");
+    }
+
+    void TXWorksheetXmlHandler::writeSheetTail(TXXmlStreamWriter& xml, const TXSheet* sheet) const
+    {
+        // 添加工作表保护信息
+        auto& protectionManager = sheet->getProtectionManager();
+        if (protectionManager.isSheetProtected()) {
+            const auto& protection = protectionManager.getSheetProtection();
+            xml.startElement("sheetProtection");
+
+            // 重要：添加sheet="1"属性表示工作表本身被保护
+            xml.attributeRaw("sheet", "1");
+
+            // 添加现代Excel的SHA-512密码保护属性
+            if (!protection.passwordHash.empty()) {
+                // 现代Excel格式：使用algorithmName, hashValue, saltValue, spinCount
+                xml.attribute("algorithmName", protection.algorithmName)
+                   .attribute("hashValue", protection.passwordHash)
+                   .attribute("saltValue", protection.saltValue)
+                   .attribute("spinCount", protection.spinCount);
+            }
+
+            // 添加保护选项属性（只有当值为false时才添加，因为默认值通常是true）
+            const std::pair<const char*, bool> options[] = {
+                {"selectLockedCells", protection.selectLockedCells},
+                {"selectUnlockedCells", protection.selectUnlockedCells},
+                {"formatCells", protection.formatCells},
+                {"formatColumns", protection.formatColumns},
+                {"formatRows", protection.formatRows},
+                {"insertColumns", protection.insertColumns},
+                {"insertRows", protection.insertRows},
+                {"deleteColumns", protection.deleteColumns},
+                {"deleteRows", protection.deleteRows},
+            };
+            for (const auto& [name, allowed] : options) {
+                if (!allowed) {
+                    xml.attributeRaw(name, "0");
+                }
+            }
+
+            xml.endElement("sheetProtection");
+        }
+
+        // 添加合并单元格（如果有）
+        auto mergeRegions = sheet->getAllMergeRegions();
+        if (!mergeRegions.empty()) {
+            xml.startElement("mergeCells").attribute("count", mergeRegions.size());
+            for (const auto& range : mergeRegions) {
+                xml.startElement("mergeCell").attribute("ref", range.toAddress()).endElement("mergeCell");
+            }
+            xml.endElement("mergeCells");
+        }
+
+        // 数据验证和自动筛选条目少、结构深，仍用节点树构建后直接序列化
+        if (sheet->getDataValidationCount() > 0) {
+            TXXmlWriter::writeNode(xml, buildDataValidationsNode(sheet));
+        }
+        if (sheet->hasAutoFilter()) {
+            TXXmlWriter::writeNode(xml, buildAutoFilterNode(sheet));
+        }
+
+        // 添加绘图引用（如果有图表）
+        if (sheet->getChartCount() > 0) {
+            xml.startElement("drawing").attributeRaw("r:id", "rId1").endElement("drawing");
+        }
+    }
 
-    bool TXWorksheetXmlHandler::shouldUseInlineString(const std::string& str) const
+    bool TXWorksheetXmlHandler::shouldUseInlineString(std::string_view str) const
     {
         // 策略1: 极短字符串（1个字符）使用内联，节省共享字符串池空间
         if (str.length() <= 1) return true;
     
         // 策略2: 包含特殊XML字符的字符串使用内联（避免XML转义复杂性）
-        if (str.find_first_of("<>&\"'") != std::string::npos) return true;
+        if (str.find_first_of("<>&\"'") != std::string_view::npos) return true;
     
         // 策略3: 包含控制字符的字符串使用内联（避免XML解析问题）
-        if (str.find_first_of("\n\r\t") != std::string::npos) return true;
+        if (str.find_first_of("\n\r\t") != std::string_view::npos) return true;
         
         // 策略4: 非常长的字符串（>100字符）使用内联（避免共享字符串池膨胀）
         if (str.length() > 100) return true;
@@ -30,116 +359,101 @@ namespace TinaXlsx
         return false;
     }
 
-    XmlNodeBuilder TXWorksheetXmlHandler::buildCellNode(const TXCell* cell, const std::string& cellRef,
-                                                        const TXWorkbookContext& context) const
+    bool TXWorksheetXmlHandler::sharedStringOf(const TXCellManager::CellView& cell, std::string_view& text) const
     {
-        XmlNodeBuilder cellNode("c");
-        cellNode.addAttribute("r", cellRef);
+        const TXCell::CellType cellType = cell.getType();
+        const bool isText = (cellType == TXCell::CellType::String ||
+                             (cellType == TXCell::CellType::Formula && cell.getFormulaObject())) && cell.holdsText();
+        if (!isText) {
+            return false;
+        }
+        text = cell.getText();
+        return !shouldUseInlineString(text);
+    }
 
-        if (!cell) return cellNode;
+    void TXWorksheetXmlHandler::writeCell(TXXmlStreamWriter& xml, const TXCellManager::CellView& cell, std::string_view cellRef,
+                                          const TXWorkbookContext& context, bool lookupOnly) const
+    {
+        xml.startElement("c").attributeRaw("r", cellRef);
 
         // 处理样式
-        if (u32 styleIndex = cell->getStyleIndex(); styleIndex != 0)
+        if (u32 styleIndex = cell.getStyleIndex(); styleIndex != 0)
         {
-            cellNode.addAttribute("s", std::to_string(styleIndex));
+            xml.attribute("s", styleIndex);
         }
         
-        // 获取单元格值和类型
-        const cell_value_t& value = cell->getValue();
-        const TXCell::CellType cellType = cell->getType();
+        // 获取单元格类型
+        const TXCell::CellType cellType = cell.getType();
 
-        // 处理公式单元格
-        if (cellType == TXCell::CellType::Formula)
-        {
-            // 添加公式节点
-            if (cell->isFormula()) {
-                const TXFormula* formula = cell->getFormulaObject();
-                if (formula) {
-                    XmlNodeBuilder fNode("f");
-                    std::string formulaStr = formula->getFormulaString();
-                    // 确保公式不包含等号前缀
-                    if (!formulaStr.empty() && formulaStr[0] == '=') {
-                        formulaStr = formulaStr.substr(1);
-                    }
-                    fNode.setText(formulaStr);
-                    cellNode.addChild(fNode);
-
-                    // 如果有缓存的计算结果，也添加值节点
-                    if (!std::holds_alternative<std::monostate>(value)) {
-                        if (std::holds_alternative<double>(value)) {
-                            XmlNodeBuilder vNode("v");
-                            vNode.setText(TXNumberUtils::formatForExcelXml(std::get<double>(value)));
-                            cellNode.addChild(vNode);
-                        } else if (std::holds_alternative<int64_t>(value)) {
-                            XmlNodeBuilder vNode("v");
-                            vNode.setText(std::to_string(std::get<int64_t>(value)));
-                            cellNode.addChild(vNode);
-                        } else if (std::holds_alternative<std::string>(value)) {
-                            // 公式结果是字符串
-                            const std::string& str = std::get<std::string>(value);
-                            if (shouldUseInlineString(str)) {
-                                cellNode.addAttribute("t", "inlineStr");
-                                XmlNodeBuilder isNode("is");
-                                XmlNodeBuilder tNode("t");
-                                tNode.setText(str);
-                                isNode.addChild(tNode);
-                                cellNode.addChild(isNode);
-                            } else {
-                                u32 index = context.sharedStringsPool.add(str);
-                                cellNode.addAttribute("t", "s");
-                                cellNode.addChild(XmlNodeBuilder("v").setText(std::to_string(index)));
-                            }
-                        }
-                    }
-                }
-            }
+        const TXFormula* formula = nullptr;
+        if (cellType == TXCell::CellType::Formula) {
+            formula = cell.getFormulaObject();
         }
-        else if (cellType == TXCell::CellType::String)
-        {
-            const std::string& str = cell->getStringValue();
-            
+
+        // 字符串值（包括公式的字符串结果）：t 属性必须在子元素之前写出
+        const bool isText = (cellType == TXCell::CellType::String || formula) && cell.holdsText();
+        const std::string_view str = isText ? cell.getText() : std::string_view();
+        bool inlineString = false;
+        u32 sharedIndex = 0;
+        if (isText) {
             // 根据字符串长度和内容决定使用内联还是共享
-            if (shouldUseInlineString(str)) {
-                // 内联字符串 - 直接嵌入XML
-                cellNode.addAttribute("t", "inlineStr");
-                XmlNodeBuilder isNode("is");
-                XmlNodeBuilder tNode("t");
-                tNode.setText(str);
-                isNode.addChild(tNode);
-                cellNode.addChild(isNode);
+            inlineString = shouldUseInlineString(str);
+            if (inlineString) {
+                xml.attributeRaw("t", "inlineStr");
             } else {
-                // 共享字符串 - 添加到池
-                u32 index = context.sharedStringsPool.add(str);
-            
-                cellNode.addAttribute("t", "s");
-                cellNode.addChild(XmlNodeBuilder("v").setText(std::to_string(index)));
+                if (lookupOnly) {
+                    // 并行保存时字符串已预先合并进池中，这里只读查找
+                    (void)context.sharedStringsPool.find(str, sharedIndex);
+                } else {
+                    sharedIndex = context.sharedStringsPool.add(str);
+                }
+                xml.attributeRaw("t", "s");
             }
+        } else if (!formula && cellType == TXCell::CellType::Boolean) {
+            xml.attributeRaw("t", "b");
         }
-        else if (std::holds_alternative<double>(value))
-        {
-            // 浮点数类型
-            XmlNodeBuilder vNode("v");
-            vNode.setText(TXNumberUtils::formatForExcelXml(std::get<double>(value)));
-            cellNode.addChild(vNode);
+
+        if (cellType == TXCell::CellType::Formula && !formula) {
+            xml.endElement("c");
+            return;
         }
-        else if (std::holds_alternative<int64_t>(value))
-        {
-            // 整数类型
-            XmlNodeBuilder vNode("v");
-            vNode.setText(std::to_string(std::get<int64_t>(value)));
-            cellNode.addChild(vNode);
+
+        // 处理公式单元格（公式不包含等号前缀）
+        if (formula) {
+            std::string_view formulaStr = formula->getFormulaString();
+            if (!formulaStr.empty() && formulaStr.front() == '=') {
+                formulaStr.remove_prefix(1);
+            }
+            xml.element("f", formulaStr);
         }
-        else if (std::holds_alternative<bool>(value))
-        {
-            // 布尔类型
-            cellNode.addAttribute("t", "b");
-            XmlNodeBuilder vNode("v");
-            vNode.setText(std::get<bool>(value) ? "1" : "0");
-            cellNode.addChild(vNode);
+
+        if (isText) {
+            if (inlineString) {
+                // 内联字符串 - 直接嵌入XML
+                xml.startElement("is").startElement("t");
+                if (TXXmlStreamWriter::needsSpacePreserve(str)) {
+                    xml.attributeRaw("xml:space", "preserve");
+                }
+                xml.text(str).endElement("t").endElement("is");
+            } else {
+                xml.startElement("v").text(sharedIndex).endElement("v");
+            }
+            xml.endElement("c");
+            return;
         }
 
+        const cell_value_t value = cell.getValue();
+        if (const auto* number = std::get_if<double>(&value)) {
+            xml.startElement("v").text(*number).endElement("v");
+        } else if (const auto* integer = std::get_if<int64_t>(&value)) {
+            xml.startElement("v").text(*integer).endElement("v");
+        } else if (!formula) {
+            if (const auto* boolean = std::get_if<bool>(&value)) {
+                xml.startElement("v").raw(*boolean ? "1" : "0").endElement("v");
+            }
+        }
 
-        return cellNode;
+        xml.endElement("c");
     }
 
     XmlNodeBuilder TXWorksheetXmlHandler::buildDataValidationsNode(const TXSheet* sheet) const {
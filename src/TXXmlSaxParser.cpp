@@ -0,0 +1,398 @@
+//
+// @file TXXmlSaxParser.cpp
+// @brief 流式 SAX XML 解析器实现
+//
+
+#include "TinaXlsx/TXXmlSaxParser.hpp"
+#include <cstring>
+
+namespace TinaXlsx {
+
+namespace {
+
+inline bool isXmlSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool isNameEnd(char c) {
+    return isXmlSpace(c) || c == '/' || c == '>' || c == '=';
+}
+
+// 将码点编码为 UTF-8，返回写入字节数
+std::size_t encodeUtf8(unsigned long cp, char* out) {
+    if (cp < 0x80) {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+// 解析 "&...;" 实体，成功时写入 out 并返回写入字节数，entityLength 为原文长度
+std::size_t decodeEntity(const char* p, const char* end, char* out, std::size_t& entityLength) {
+    const char* semi = static_cast<const char*>(std::memchr(p, ';', static_cast<std::size_t>(end - p)));
+    if (!semi || semi - p > 12) {
+        return 0;
+    }
+    std::string_view entity(p + 1, static_cast<std::size_t>(semi - p - 1));
+    entityLength = static_cast<std::size_t>(semi - p + 1);
+
+    if (entity == "lt") { out[0] = '<'; return 1; }
+    if (entity == "gt") { out[0] = '>'; return 1; }
+    if (entity == "amp") { out[0] = '&'; return 1; }
+    if (entity == "quot") { out[0] = '"'; return 1; }
+    if (entity == "apos") { out[0] = '\''; return 1; }
+
+    if (entity.size() >= 2 && entity[0] == '#') {
+        unsigned long cp = 0;
+        const bool hex = entity[1] == 'x' || entity[1] == 'X';
+        std::size_t i = hex ? 2 : 1;
+        if (i >= entity.size()) {
+            return 0;
+        }
+        for (; i < entity.size(); ++i) {
+            char c = entity[i];
+            unsigned digit;
+            if (c >= '0' && c <= '9') {
+                digit = static_cast<unsigned>(c - '0');
+            } else if (hex && c >= 'a' && c <= 'f') {
+                digit = static_cast<unsigned>(c - 'a' + 10);
+            } else if (hex && c >= 'A' && c <= 'F') {
+                digit = static_cast<unsigned>(c - 'A' + 10);
+            } else {
+                return 0;
+            }
+            cp = cp * (hex ? 16 : 10) + digit;
+            if (cp > 0x10FFFF) {
+                return 0;
+            }
+        }
+        return encodeUtf8(cp, out);
+    }
+    return 0;
+}
+
+} // namespace
+
+TXXmlSaxParser::TXXmlSaxParser(TXXmlSaxHandler& handler) : handler_(handler) {}
+
+std::size_t TXXmlSaxParser::decodeEntities(char* text, std::size_t length) {
+    char* amp = static_cast<char*>(std::memchr(text, '&', length));
+    if (!amp) {
+        return length;
+    }
+
+    const char* end = text + length;
+    const char* read = amp;
+    char* write = amp;
+    while (read < end) {
+        if (*read == '&') {
+            char decoded[4];
+            std::size_t entityLength = 0;
+            std::size_t n = decodeEntity(read, end, decoded, entityLength);
+            if (n > 0) {
+                // 解码结果总是短于实体原文，原地写入是安全的
+                std::memcpy(write, decoded, n);
+                write += n;
+                read += entityLength;
+                continue;
+            }
+        }
+        *write++ = *read++;
+    }
+    return static_cast<std::size_t>(write - text);
+}
+
+TXResult<void> TXXmlSaxParser::feed(const char* data, std::size_t size) {
+    if (finished_) {
+        return Err<void>(TXErrorCode::XmlInvalidState, "SAX parser already finished");
+    }
+    // 丢弃已消费的前缀后再追加，避免缓冲区随文档增长
+    if (head_ > 0) {
+        consumed_ += head_;
+        buffer_.erase(0, head_);
+        head_ = 0;
+    }
+    buffer_.append(data, size);
+    if (paused_) {
+        return Ok();
+    }
+    return process(false);
+}
+
+TXResult<void> TXXmlSaxParser::resume() {
+    paused_ = false;
+    if (finished_) {
+        return Ok();
+    }
+    return process(false);
+}
+
+TXResult<void> TXXmlSaxParser::finish() {
+    if (finished_) {
+        return Ok();
+    }
+    paused_ = false;
+    auto result = process(true);
+    if (result.isError()) {
+        finished_ = true;
+        return result;
+    }
+    if (paused_) {
+        // 回调请求暂停，调用方稍后需再次调用 finish()
+        return Ok();
+    }
+    finished_ = true;
+    if (head_ < buffer_.size()) {
+        return makeError("Unterminated markup at end of document", head_);
+    }
+    if (!openNameStarts_.empty()) {
+        return makeError("Unexpected end of document: " + std::to_string(openNameStarts_.size()) +
+                         " unclosed element(s)", head_);
+    }
+    return Ok();
+}
+
+TXResult<void> TXXmlSaxParser::parse(std::string_view data) {
+    reset();
+    auto result = feed(data);
+    if (result.isError()) {
+        return result;
+    }
+    return finish();
+}
+
+void TXXmlSaxParser::reset() {
+    buffer_.clear();
+    head_ = 0;
+    attributes_.attrs_.clear();
+    openNames_.clear();
+    openNameStarts_.clear();
+    consumed_ = 0;
+    finished_ = false;
+    paused_ = false;
+}
+
+TXResult<void> TXXmlSaxParser::makeError(const std::string& message, std::size_t offset) const {
+    return Err<void>(TXErrorCode::XmlParseError,
+                     "XML parse error: " + message + " at offset " + std::to_string(consumed_ + offset));
+}
+
+TXResult<void> TXXmlSaxParser::process(bool final) {
+    char* const base = buffer_.data();
+    const std::size_t size = buffer_.size();
+    std::size_t pos = head_;
+
+    while (pos < size && !paused_) {
+        char* p = base + pos;
+
+        // 文本节点：一直读到下一个 '<'
+        if (*p != '<') {
+            auto* lt = static_cast<char*>(std::memchr(p, '<', size - pos));
+            if (!lt) {
+                if (!final) {
+                    break;
+                }
+                lt = base + size;
+            }
+            std::size_t length = static_cast<std::size_t>(lt - p);
+            if (!openNameStarts_.empty()) {
+                length = decodeEntities(p, length);
+                handler_.onText(std::string_view(p, length));
+            }
+            pos = static_cast<std::size_t>(lt - base);
+            continue;
+        }
+
+        const std::size_t remain = size - pos;
+        std::string_view rest(p, remain);
+        if (remain < 2) {
+            break;
+        }
+
+        if (p[1] == '?') {
+            // 处理指令 / XML 声明
+            auto close = rest.find("?>", 2);
+            if (close == std::string_view::npos) {
+                break;
+            }
+            pos += close + 2;
+            continue;
+        }
+
+        if (p[1] == '!') {
+            if (remain < 9 && !final) {
+                break;
+            }
+            if (rest.compare(0, 4, "<!--") == 0) {
+                auto close = rest.find("-->", 4);
+                if (close == std::string_view::npos) {
+                    break;
+                }
+                pos += close + 3;
+            } else if (rest.compare(0, 9, "<![CDATA[") == 0) {
+                auto close = rest.find("]]>", 9);
+                if (close == std::string_view::npos) {
+                    break;
+                }
+                if (!openNameStarts_.empty() && close > 9) {
+                    handler_.onText(rest.substr(9, close - 9));
+                }
+                pos += close + 3;
+            } else {
+                // <!DOCTYPE ...> 等声明直接跳过
+                auto close = rest.find('>', 2);
+                if (close == std::string_view::npos) {
+                    break;
+                }
+                pos += close + 1;
+            }
+            continue;
+        }
+
+        if (p[1] == '/') {
+            auto close = rest.find('>', 2);
+            if (close == std::string_view::npos) {
+                break;
+            }
+            std::size_t nameEnd = close;
+            while (nameEnd > 2 && isXmlSpace(p[nameEnd - 1])) {
+                --nameEnd;
+            }
+            if (openNameStarts_.empty()) {
+                return makeError("Unexpected closing tag", pos);
+            }
+            const std::string_view name(p + 2, nameEnd - 2);
+            const std::size_t start = openNameStarts_.back();
+            if (std::string_view(openNames_).substr(start) != name) {
+                return makeError("Closing tag </" + std::string(name) + "> does not match <" +
+                                 openNames_.substr(start) + ">", pos);
+            }
+            openNames_.resize(start);
+            openNameStarts_.pop_back();
+            handler_.onEndElement(name);
+            pos += close + 1;
+            continue;
+        }
+
+        // 开始标签：在引号之外寻找 '>'
+        std::size_t close = std::string_view::npos;
+        char quote = 0;
+        for (std::size_t i = 1; i < remain; ++i) {
+            char c = p[i];
+            if (quote) {
+                if (c == quote) {
+                    quote = 0;
+                }
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '>') {
+                close = i;
+                break;
+            }
+        }
+        if (close == std::string_view::npos) {
+            break;
+        }
+
+        auto result = parseStartTag(p, p + close);
+        if (result.isError()) {
+            return makeError(result.error().getMessage(), pos);
+        }
+        pos += close + 1;
+    }
+
+    head_ = pos;
+    if (final && pos < size) {
+        return makeError("Unterminated markup at end of document", pos);
+    }
+    return Ok();
+}
+
+TXResult<void> TXXmlSaxParser::parseStartTag(char* begin, char* end) {
+    // begin 指向 '<'，end 指向 '>'
+    char* p = begin + 1;
+    char* nameStart = p;
+    while (p < end && !isNameEnd(*p)) {
+        ++p;
+    }
+    if (p == nameStart) {
+        return Err<void>(TXErrorCode::XmlParseError, "Empty element name");
+    }
+    std::string_view name(nameStart, static_cast<std::size_t>(p - nameStart));
+
+    auto& attrs = attributes_.attrs_;
+    attrs.clear();
+    bool selfClosing = false;
+
+    while (p < end) {
+        while (p < end && isXmlSpace(*p)) {
+            ++p;
+        }
+        if (p == end) {
+            break;
+        }
+        if (*p == '/') {
+            selfClosing = true;
+            ++p;
+            continue;
+        }
+
+        char* attrNameStart = p;
+        while (p < end && !isNameEnd(*p)) {
+            ++p;
+        }
+        std::string_view attrName(attrNameStart, static_cast<std::size_t>(p - attrNameStart));
+        while (p < end && isXmlSpace(*p)) {
+            ++p;
+        }
+        if (attrName.empty() || p == end || *p != '=') {
+            return Err<void>(TXErrorCode::XmlParseError, "Malformed attribute in <" + std::string(name) + ">");
+        }
+        ++p;
+        while (p < end && isXmlSpace(*p)) {
+            ++p;
+        }
+        if (p == end || (*p != '"' && *p != '\'')) {
+            return Err<void>(TXErrorCode::XmlParseError, "Unquoted attribute value in <" + std::string(name) + ">");
+        }
+        const char quote = *p++;
+        char* valueStart = p;
+        while (p < end && *p != quote) {
+            ++p;
+        }
+        if (p == end) {
+            return Err<void>(TXErrorCode::XmlParseError, "Unterminated attribute value in <" + std::string(name) + ">");
+        }
+        std::size_t valueLength = decodeEntities(valueStart, static_cast<std::size_t>(p - valueStart));
+        attrs.push_back({attrName, std::string_view(valueStart, valueLength)});
+        ++p;
+    }
+
+    // 回调期间 depth() 包含当前元素；自闭合元素不需要匹配结束标签
+    openNameStarts_.push_back(openNames_.size());
+    openNames_.append(name);
+    handler_.onStartElement(name, attributes_);
+    if (selfClosing) {
+        openNames_.resize(openNameStarts_.back());
+        openNameStarts_.pop_back();
+        handler_.onEndElement(name);
+    }
+    return Ok();
+}
+
+} // namespace TinaXlsx
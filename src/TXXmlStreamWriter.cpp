@@ -0,0 +1,195 @@
+//
+// @file TXXmlStreamWriter.cpp
+// @brief 直接写缓冲区的 XML 输出器实现
+//
+
+#include "TinaXlsx/TXXmlStreamWriter.hpp"
+#include "TinaXlsx/TXZipArchive.hpp"
+#include "TinaXlsx/TXNumberUtils.hpp"
+
+namespace TinaXlsx {
+
+namespace {
+
+// XML 1.0 不允许出现的控制字符（\t \n \r 除外）
+inline bool isInvalidControl(unsigned char c) {
+    return c < 0x20 && c != '\t' && c != '\n' && c != '\r';
+}
+
+template <bool Attribute>
+void appendEscaped(std::string& out, std::string_view value) {
+    const char* data = value.data();
+    const std::size_t size = value.size();
+    std::size_t runStart = 0;
+
+    for (std::size_t i = 0; i < size; ++i) {
+        const unsigned char c = static_cast<unsigned char>(data[i]);
+        const char* replacement = nullptr;
+        switch (c) {
+        case '&': replacement = "&amp;"; break;
+        case '<': replacement = "&lt;"; break;
+        case '>': replacement = "&gt;"; break;
+        case '"': if (Attribute) replacement = "&quot;"; break;
+        case '\n': if (Attribute) replacement = "&#10;"; break;
+        case '\r': replacement = "&#13;"; break;
+        case '\t': if (Attribute) replacement = "&#9;"; break;
+        default:
+            if (isInvalidControl(c)) replacement = "";
+            break;
+        }
+        if (replacement) {
+            out.append(data + runStart, i - runStart);
+            out.append(replacement);
+            runStart = i + 1;
+        }
+    }
+    out.append(data + runStart, size - runStart);
+}
+
+} // namespace
+
+// ==================== TXZipEntrySink ====================
+
+TXResult<void> TXZipEntrySink::write(const char* data, std::size_t size) {
+    return zipWriter_.writeEntry(data, size);
+}
+
+// ==================== TXXmlStreamWriter ====================
+
+TXXmlStreamWriter::TXXmlStreamWriter(TXXmlSink* sink, std::size_t flushThreshold)
+    : sink_(sink), flushThreshold_(flushThreshold) {
+    if (sink_) {
+        buffer_.reserve(flushThreshold_ + flushThreshold_ / 4);
+    }
+}
+
+void TXXmlStreamWriter::appendEscapedText(std::string& out, std::string_view value) {
+    appendEscaped<false>(out, value);
+}
+
+void TXXmlStreamWriter::appendEscapedAttribute(std::string& out, std::string_view value) {
+    appendEscaped<true>(out, value);
+}
+
+TXXmlStreamWriter& TXXmlStreamWriter::declaration() {
+    buffer_.append("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n");
+    return *this;
+}
+
+TXXmlStreamWriter& TXXmlStreamWriter::startElement(std::string_view name) {
+    closeStartTag();
+    maybeFlush();
+    buffer_.push_back('<');
+    buffer_.append(name);
+    tagOpen_ = true;
+    return *this;
+}
+
+TXXmlStreamWriter& TXXmlStreamWriter::attribute(std::string_view name, std::string_view value) {
+    buffer_.push_back(' ');
+    buffer_.append(name);
+    buffer_.append("=\"");
+    appendEscapedAttribute(buffer_, value);
+    buffer_.push_back('"');
+    return *this;
+}
+
+TXXmlStreamWriter& TXXmlStreamWriter::attribute(std::string_view name, double value) {
+    char digits[TXNumberUtils::EXCEL_XML_NUMBER_BUFFER_SIZE];
+    return attributeRaw(name, std::string_view(digits, TXNumberUtils::formatForExcelXml(value, digits)));
+}
+
+TXXmlStreamWriter& TXXmlStreamWriter::attributeRaw(std::string_view name, std::string_view value) {
+    buffer_.push_back(' ');
+    buffer_.append(name);
+    buffer_.append("=\"");
+    buffer_.append(value);
+    buffer_.push_back('"');
+    return *this;
+}
+
+TXXmlStreamWriter& TXXmlStreamWriter::text(std::string_view value) {
+    closeStartTag();
+    appendEscapedText(buffer_, value);
+    return *this;
+}
+
+TXXmlStreamWriter& TXXmlStreamWriter::text(double value) {
+    char digits[TXNumberUtils::EXCEL_XML_NUMBER_BUFFER_SIZE];
+    return raw(std::string_view(digits, TXNumberUtils::formatForExcelXml(value, digits)));
+}
+
+TXXmlStreamWriter& TXXmlStreamWriter::endElement(std::string_view name) {
+    if (tagOpen_) {
+        buffer_.append("/>");
+        tagOpen_ = false;
+    } else {
+        buffer_.append("</");
+        buffer_.append(name);
+        buffer_.push_back('>');
+    }
+    return *this;
+}
+
+TXXmlStreamWriter& TXXmlStreamWriter::element(std::string_view name, std::string_view value) {
+    startElement(name);
+    buffer_.push_back('>');
+    tagOpen_ = false;
+    appendEscapedText(buffer_, value);
+    buffer_.append("</");
+    buffer_.append(name);
+    buffer_.push_back('>');
+    return *this;
+}
+
+TXXmlStreamWriter& TXXmlStreamWriter::raw(std::string_view data) {
+    closeStartTag();
+    buffer_.append(data);
+    return *this;
+}
+
+void TXXmlStreamWriter::flushBuffer() {
+    if (failed_ || buffer_.empty()) {
+        buffer_.clear();
+        return;
+    }
+    auto result = sink_->write(buffer_.data(), buffer_.size());
+    if (result.isError()) {
+        failed_ = true;
+        error_ = result.error();
+    }
+    flushedBytes_ += buffer_.size();
+    buffer_.clear();
+}
+
+TXResult<void> TXXmlStreamWriter::flush() {
+    closeStartTag();
+    if (sink_) {
+        flushBuffer();
+    }
+    return status();
+}
+
+TXResult<void> TXXmlStreamWriter::status() const {
+    if (failed_) {
+        return Err<void>(error_);
+    }
+    return Ok();
+}
+
+std::string TXXmlStreamWriter::takeBuffer() {
+    closeStartTag();
+    std::string out;
+    out.swap(buffer_);
+    return out;
+}
+
+void TXXmlStreamWriter::reset() {
+    buffer_.clear();
+    flushedBytes_ = 0;
+    tagOpen_ = false;
+    failed_ = false;
+    error_ = TXError();
+}
+
+} // namespace TinaXlsx
@@ -4,9 +4,9 @@
 //
 
 #include "TinaXlsx/TXXmlWriter.hpp"
+#include "TinaXlsx/TXXmlStreamWriter.hpp"
 #include "TinaXlsx/TXZipArchive.hpp"
-#include <pugixml.hpp>
-#include <sstream>
+#include <algorithm>
 
 namespace TinaXlsx
 {
@@ -23,7 +23,13 @@ namespace TinaXlsx
 
     XmlNodeBuilder& XmlNodeBuilder::addAttribute(const std::string& name, const std::string& value)
     {
-        attributes_[name] = value;
+        auto it = std::find_if(attributes_.begin(), attributes_.end(),
+                               [&name](const Attribute& attr) { return attr.first == name; });
+        if (it != attributes_.end()) {
+            it->second = value;
+        } else {
+            attributes_.emplace_back(name, value);
+        }
         return *this;
     }
 
@@ -33,24 +39,27 @@ namespace TinaXlsx
         return *this;
     }
 
+    XmlNodeBuilder& XmlNodeBuilder::addChild(XmlNodeBuilder&& child)
+    {
+        children_.push_back(std::move(child));
+        return *this;
+    }
+
     const std::string& XmlNodeBuilder::getName() const { return name_; }
     const std::string& XmlNodeBuilder::getText() const { return text_; }
-    const std::unordered_map<std::string, std::string>& XmlNodeBuilder::getAttributes() const { return attributes_; }
+    const std::vector<XmlNodeBuilder::Attribute>& XmlNodeBuilder::getAttributes() const { return attributes_; }
     const std::vector<XmlNodeBuilder>& XmlNodeBuilder::getChildren() const { return children_; }
 
-    TXXmlWriter::TXXmlWriter() : doc_(std::make_unique<pugi::xml_document>())
-    {
-    }
+    TXXmlWriter::TXXmlWriter() = default;
 
-    TXXmlWriter::TXXmlWriter(const XmlWriteOptions& options)
-        : doc_(std::make_unique<pugi::xml_document>()), options_(options)
+    TXXmlWriter::TXXmlWriter(const XmlWriteOptions& options) : options_(options)
     {
     }
 
     TXXmlWriter::~TXXmlWriter() = default;
 
     TXXmlWriter::TXXmlWriter(TXXmlWriter&& other) noexcept
-        : doc_(std::move(other.doc_)), options_(other.options_), isValid_(other.isValid_)
+        : root_(std::move(other.root_)), options_(other.options_), isValid_(other.isValid_)
     {
         other.isValid_ = false;
     }
@@ -59,7 +68,7 @@ namespace TinaXlsx
     {
         if (this != &other)
         {
-            doc_ = std::move(other.doc_);
+            root_ = std::move(other.root_);
             options_ = other.options_;
             isValid_ = other.isValid_;
             other.isValid_ = false;
@@ -69,19 +78,17 @@ namespace TinaXlsx
 
     TXResult<void> TXXmlWriter::setRootNode(const XmlNodeBuilder& rootNode)
     {
-        doc_->reset();
-        buildNode(*doc_, rootNode);
+        root_ = std::make_unique<XmlNodeBuilder>(rootNode);
         isValid_ = true;
         return Ok();
     }
 
     TXResult<void> TXXmlWriter::createDocument(const std::string& rootNodeName)
     {
-        doc_->reset();
-        auto root = doc_->append_child(rootNodeName.c_str());
-        if (!root) {
+        if (rootNodeName.empty()) {
             return Err<void>(TXErrorCode::XmlCreateError, "Failed to create root node: " + rootNodeName);
         }
+        root_ = std::make_unique<XmlNodeBuilder>(rootNodeName);
         isValid_ = true;
         return Ok();
     }
@@ -93,13 +100,12 @@ namespace TinaXlsx
             return Err<void>(TXErrorCode::XmlInvalidState, "Document not initialized");
         }
 
-        auto root = doc_->document_element();
-        if (!root)
+        if (!root_)
         {
             return Err<void>(TXErrorCode::XmlNoRoot, "No root element found");
         }
 
-        buildNode(root, node);
+        root_->addChild(node);
         return Ok();
     }
 
@@ -124,23 +130,14 @@ namespace TinaXlsx
             return Err<void>(xmlContentResult.error().getCode(), "Failed to generate XML: " + xmlContentResult.error().getMessage());
         }
 
-        std::vector<uint8_t> xmlData(xmlContentResult.value().begin(), xmlContentResult.value().end());
-        auto writeResult = zipWriter.write(xmlPath, xmlData);
-
-        if (writeResult.isError())
-        {
-            return Err<void>(TXErrorCode::ZipWriteError, "Failed to write to ZIP: " + writeResult.error().getMessage());
-        }
-
-        return Ok();
+        return writeStringToZip(zipWriter, xmlPath, xmlContentResult.value());
     }
 
     TXResult<void> TXXmlWriter::writeStringToZip(TXZipArchiveWriter& zipWriter,
                                        const std::string& xmlPath,
                                        const std::string& xmlContent)
     {
-        std::vector<uint8_t> xmlData(xmlContent.begin(), xmlContent.end());
-        auto writeResult = zipWriter.write(xmlPath, xmlData);
+        auto writeResult = zipWriter.write(xmlPath, xmlContent.data(), xmlContent.size());
 
         if (writeResult.isError())
         {
@@ -157,7 +154,7 @@ namespace TinaXlsx
 
     void TXXmlWriter::reset()
     {
-        doc_->reset();
+        root_.reset();
         isValid_ = false;
     }
 
@@ -168,93 +165,89 @@ namespace TinaXlsx
             return Err<DocumentStats>(TXErrorCode::XmlInvalidState, "Document is not valid");
         }
 
-        return Ok(calculateStats(doc_->document_element()));
+        return Ok(calculateStats(*root_));
     }
 
-    void TXXmlWriter::buildNode(pugi::xml_node& parent, const XmlNodeBuilder& builder)
+    namespace
     {
-        pugi::xml_node node = parent.append_child(builder.getName().c_str());
-
-        // 设置属性
-        for (const auto& [name, value] : builder.getAttributes())
+        void writeIndented(TXXmlStreamWriter& out, const XmlNodeBuilder& node,
+                           const std::string& indent, std::size_t depth)
         {
-            node.append_attribute(name.c_str()).set_value(value.c_str());
+            out.startElement(node.getName());
+            for (const auto& [name, value] : node.getAttributes()) {
+                out.attribute(name, value);
+            }
+            if (!node.getText().empty()) {
+                out.text(node.getText());
+            }
+            const auto& children = node.getChildren();
+            if (!children.empty()) {
+                std::string lineStart = "\n";
+                for (std::size_t i = 0; i <= depth; ++i) {
+                    lineStart += indent;
+                }
+                for (const auto& child : children) {
+                    out.raw(lineStart);
+                    writeIndented(out, child, indent, depth + 1);
+                }
+                out.raw(std::string_view(lineStart).substr(0, lineStart.size() - indent.size()));
+            }
+            out.endElement(node.getName());
         }
+    }
 
-        // 设置文本内容
-        if (!builder.getText().empty())
-        {
-            node.text().set(builder.getText().c_str());
+    void TXXmlWriter::writeNode(TXXmlStreamWriter& out, const XmlNodeBuilder& node)
+    {
+        out.startElement(node.getName());
+        for (const auto& [name, value] : node.getAttributes()) {
+            out.attribute(name, value);
         }
-
-        // 递归添加子节点
-        for (const auto& child : builder.getChildren())
-        {
-            buildNode(node, child);
+        if (!node.getText().empty()) {
+            out.text(node.getText());
+        }
+        for (const auto& child : node.getChildren()) {
+            writeNode(out, child);
         }
+        out.endElement(node.getName());
     }
 
     std::string TXXmlWriter::generateString() const
     {
-        if (!isValid_)
+        if (!isValid_ || !root_)
         {
             return "";
         }
 
-        std::ostringstream oss;
-
-        // 根据选项决定如何生成XML
+        TXXmlStreamWriter out;
         if (options_.include_declaration)
         {
-            // 手动添加XML声明以确保包含自定义编码
-            oss << "<?xml version=\"1.0\" encoding=\"" << options_.encoding << "\"?>";
+            out.raw("<?xml version=\"1.0\" encoding=\"" + options_.encoding + "\"?>");
             if (options_.format_output)
             {
-                oss << "\n";
+                out.raw("\n");
             }
+        }
 
-            // 保存文档内容，但不包含声明（因为我们已经手动添加了）
-            if (options_.format_output)
-            {
-                doc_->save(oss, options_.indent.c_str(), pugi::format_default | pugi::format_no_declaration,
-                          pugi::encoding_utf8);
-            }
-            else
-            {
-                doc_->save(oss, "", pugi::format_raw | pugi::format_no_declaration, pugi::encoding_utf8);
-            }
+        if (options_.format_output)
+        {
+            writeIndented(out, *root_, options_.indent, 0);
+            out.raw("\n");
         }
         else
         {
-            // 不包含声明
-            if (options_.format_output)
-            {
-                doc_->save(oss, options_.indent.c_str(), pugi::format_default | pugi::format_no_declaration,
-                          pugi::encoding_utf8);
-            }
-            else
-            {
-                doc_->save(oss, "", pugi::format_raw | pugi::format_no_declaration, pugi::encoding_utf8);
-            }
+            writeNode(out, *root_);
         }
-
-        return oss.str();
+        return out.takeBuffer();
     }
 
-    TXXmlWriter::DocumentStats TXXmlWriter::calculateStats(const pugi::xml_node& node) const
+    TXXmlWriter::DocumentStats TXXmlWriter::calculateStats(const XmlNodeBuilder& node)
     {
         DocumentStats stats;
+        stats.nodeCount = 1;
+        stats.attributeCount = node.getAttributes().size();
+        stats.textLength = node.getText().size();
 
-        // 统计当前节点
-        if (node.type() == pugi::node_element)
-        {
-            stats.nodeCount++;
-            stats.attributeCount += std::distance(node.attributes_begin(), node.attributes_end());
-            stats.textLength += std::strlen(node.text().as_string());
-        }
-
-        // 递归统计子节点
-        for (const auto& child : node.children())
+        for (const auto& child : node.getChildren())
         {
             auto childStats = calculateStats(child);
             stats.nodeCount += childStats.nodeCount;
@@ -0,0 +1,677 @@
+//
+// @file TXZipArchive.cpp
+// @brief 基于内存映射的 ZIP 读取器实现
+//
+
+#include "TinaXlsx/TXZipArchive.hpp"
+
+#include <cctype>
+#include <utility>
+#include <zlib.h>
+
+namespace TinaXlsx
+{
+    namespace
+    {
+        constexpr uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+        constexpr uint32_t CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+        constexpr uint32_t END_OF_CENTRAL_DIR_SIGNATURE = 0x06054b50;
+        constexpr uint32_t ZIP64_END_OF_CENTRAL_DIR_SIGNATURE = 0x06064b50;
+        constexpr uint32_t ZIP64_LOCATOR_SIGNATURE = 0x07064b50;
+
+        constexpr std::size_t LOCAL_HEADER_SIZE = 30;
+        constexpr std::size_t CENTRAL_HEADER_SIZE = 46;
+        constexpr std::size_t END_OF_CENTRAL_DIR_SIZE = 22;
+        constexpr std::size_t ZIP64_LOCATOR_SIZE = 20;
+        constexpr std::size_t ZIP64_END_OF_CENTRAL_DIR_SIZE = 56;
+        constexpr std::size_t MAX_COMMENT_SIZE = 0xFFFF;
+
+        constexpr uint16_t ZIP64_EXTRA_FIELD_ID = 0x0001;
+        constexpr uint16_t FLAG_ENCRYPTED = 0x0001;
+
+        // zlib 单次处理长度为 uInt
+        constexpr std::size_t MAX_ZLIB_CHUNK = 1u << 30;
+
+        uint16_t readU16(const uint8_t* p) {
+            return static_cast<uint16_t>(p[0] | (p[1] << 8));
+        }
+
+        uint32_t readU32(const uint8_t* p) {
+            return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                   (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+        }
+
+        uint64_t readU64(const uint8_t* p) {
+            return static_cast<uint64_t>(readU32(p)) | (static_cast<uint64_t>(readU32(p + 4)) << 32);
+        }
+
+        /// MS-DOS 日期时间 → std::time_t（本地时间）
+        std::time_t fromDosDateTime(uint32_t dosDateTime) {
+            std::tm tm{};
+            tm.tm_year = static_cast<int>((dosDateTime >> 25) & 0x7F) + 80;
+            tm.tm_mon = static_cast<int>((dosDateTime >> 21) & 0x0F) - 1;
+            tm.tm_mday = static_cast<int>((dosDateTime >> 16) & 0x1F);
+            tm.tm_hour = static_cast<int>((dosDateTime >> 11) & 0x1F);
+            tm.tm_min = static_cast<int>((dosDateTime >> 5) & 0x3F);
+            tm.tm_sec = static_cast<int>((dosDateTime & 0x1F) * 2);
+            tm.tm_isdst = -1;
+            return std::mktime(&tm);
+        }
+
+        std::string foldCase(std::string_view name) {
+            std::string folded(name);
+            for (char& c : folded) {
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            return folded;
+        }
+
+        TXError corruptArchive(const std::string& filename, const std::string& detail) {
+            return TX_ERROR_CREATE(TXErrorCode::ZipOpenFailed, "Corrupt ZIP archive '" + filename + "': " + detail);
+        }
+    } // namespace
+
+    // ==================== EntryCursor ====================
+
+    struct TXZipArchiveReader::EntryCursor
+    {
+        std::string name;
+        const uint8_t* data = nullptr;     ///< 条目数据在映射中的起点
+        uint64_t compressedSize = 0;
+        uint64_t uncompressedSize = 0;
+        uint64_t consumed = 0;             ///< 已交给 inflate 的压缩字节数
+        uint64_t produced = 0;             ///< 已输出的解压字节数
+        uint32_t expectedCrc = 0;
+        uLong crc = 0;
+        bool stored = false;
+        bool finished = false;
+        bool inflating = false;
+        z_stream stream{};
+
+        ~EntryCursor() {
+            if (inflating) {
+                inflateEnd(&stream);
+            }
+        }
+
+        TXResult<void> start(const CentralEntry& entry, const uint8_t* entryData) {
+            name = entry.name;
+            data = entryData;
+            compressedSize = entry.compressed_size;
+            uncompressedSize = entry.uncompressed_size;
+            expectedCrc = entry.crc32;
+            crc = crc32(0L, Z_NULL, 0);
+            stored = entry.method == MZ_COMPRESS_METHOD_STORE;
+            if (stored) {
+                return Ok();
+            }
+            if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+                return Err<void>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed,
+                                                 "inflateInit2 failed for ZIP entry '" + name + "'"));
+            }
+            inflating = true;
+            return Ok();
+        }
+
+        /**
+         * @brief 解压下一段数据到 buffer，返回 0 表示条目结束
+         */
+        TXResult<std::size_t> read(void* buffer, std::size_t size) {
+            if (finished || size == 0) {
+                return Ok(std::size_t{0});
+            }
+            auto* out = static_cast<uint8_t*>(buffer);
+            std::size_t written = 0;
+
+            if (stored) {
+                written = static_cast<std::size_t>(std::min<uint64_t>(size, uncompressedSize - produced));
+                std::memcpy(out, data + produced, written);
+            } else {
+                while (written < size) {
+                    if (stream.avail_in == 0 && consumed < compressedSize) {
+                        const auto chunk = static_cast<std::size_t>(
+                            std::min<uint64_t>(MAX_ZLIB_CHUNK, compressedSize - consumed));
+                        stream.next_in = const_cast<Bytef*>(data + consumed);
+                        stream.avail_in = static_cast<uInt>(chunk);
+                        consumed += chunk;
+                    }
+                    const std::size_t space = std::min(MAX_ZLIB_CHUNK, size - written);
+                    stream.next_out = out + written;
+                    stream.avail_out = static_cast<uInt>(space);
+
+                    const int status = inflate(&stream, Z_NO_FLUSH);
+                    written += space - stream.avail_out;
+                    if (status == Z_STREAM_END) {
+                        finished = true;
+                        break;
+                    }
+                    if (status == Z_BUF_ERROR && stream.avail_in == 0 && consumed == compressedSize) {
+                        return Err<std::size_t>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed,
+                                                                "Truncated DEFLATE data in ZIP entry '" + name + "'"));
+                    }
+                    if (status != Z_OK && status != Z_BUF_ERROR) {
+                        return Err<std::size_t>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed,
+                                                                "Invalid DEFLATE data in ZIP entry '" + name +
+                                                                "' (zlib error code: " + std::to_string(status) + ")"));
+                    }
+                }
+            }
+
+            return account(out, written);
+        }
+
+        /**
+         * @brief 取得下一块数据：STORED 条目直接指向映射，压缩条目解压到 scratch
+         */
+        TXResult<std::size_t> next(uint8_t* scratch, std::size_t size, const uint8_t*& chunk) {
+            if (!stored) {
+                chunk = scratch;
+                return read(scratch, size);
+            }
+            chunk = data + produced;
+            if (finished || size == 0) {
+                return Ok(std::size_t{0});
+            }
+            return account(chunk, static_cast<std::size_t>(std::min<uint64_t>(size, uncompressedSize - produced)));
+        }
+
+        /**
+         * @brief 累计已输出的数据，条目结束时校验长度和 CRC
+         */
+        TXResult<std::size_t> account(const uint8_t* out, std::size_t written) {
+            for (std::size_t offset = 0; offset < written; offset += MAX_ZLIB_CHUNK) {
+                crc = crc32(crc, out + offset, static_cast<uInt>(std::min(MAX_ZLIB_CHUNK, written - offset)));
+            }
+            produced += written;
+            if (stored && produced == uncompressedSize) {
+                finished = true;
+            }
+            if (produced > uncompressedSize) {
+                return Err<std::size_t>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed,
+                                                        "ZIP entry '" + name + "' is larger than its recorded size"));
+            }
+            if (finished) {
+                if (produced != uncompressedSize) {
+                    return Err<std::size_t>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed,
+                                                            "Incomplete read from ZIP entry '" + name + "'. Expected " +
+                                                            std::to_string(uncompressedSize) + ", got " +
+                                                            std::to_string(produced)));
+                }
+                if (static_cast<uint32_t>(crc) != expectedCrc) {
+                    return Err<std::size_t>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed,
+                                                            "CRC mismatch in ZIP entry '" + name + "'"));
+                }
+            }
+            return Ok(static_cast<std::size_t>(written));
+        }
+    };
+
+    // ==================== TXZipArchiveReader ====================
+
+    TXZipArchiveReader::TXZipArchiveReader() = default;
+
+    TXZipArchiveReader::~TXZipArchiveReader() {
+        close();
+    }
+
+    TXZipArchiveReader::TXZipArchiveReader(TXZipArchiveReader&& o) noexcept {
+        *this = std::move(o);
+    }
+
+    TXZipArchiveReader& TXZipArchiveReader::operator=(TXZipArchiveReader&& o) noexcept {
+        if (this != &o) {
+            close();
+            // 归档数据的地址不随对象移动，cursor_ 中指向它的指针保持有效
+            mapping_ = std::move(o.mapping_);
+            data_ = std::exchange(o.data_, nullptr);
+            size_ = std::exchange(o.size_, 0);
+            central_ = std::move(o.central_);
+            name_index_ = std::move(o.name_index_);
+            folded_index_ = std::move(o.folded_index_);
+            cursor_ = std::move(o.cursor_);
+            is_open_ = o.is_open_;
+            filename_ = std::move(o.filename_);
+            o.is_open_ = false;
+        }
+        return *this;
+    }
+
+    TXResult<void> TXZipArchiveReader::open(const std::string& file) {
+        close();
+        auto mapResult = mapping_.open(file);
+        if (mapResult.isError()) {
+            return Err<void>(TX_ERROR_CREATE(TXErrorCode::ZipOpenFailed,
+                                             "Cannot open ZIP archive: " + file + " (" +
+                                             mapResult.error().getMessage() + ")"));
+        }
+        filename_ = file;
+        data_ = mapping_.data();
+        size_ = mapping_.size();
+
+        auto parseResult = parseCentralDirectory();
+        if (parseResult.isError()) {
+            close();
+            return parseResult;
+        }
+        is_open_ = true;
+        return Ok();
+    }
+
+    TXResult<void> TXZipArchiveReader::openMemory(const void* data, std::size_t size) {
+        close();
+        if (!data || size == 0) {
+            return Err<void>(TX_ERROR_CREATE(TXErrorCode::ZipOpenFailed, "Cannot open ZIP archive from empty buffer"));
+        }
+        filename_ = "<memory>";
+        data_ = static_cast<const uint8_t*>(data);
+        size_ = size;
+
+        auto parseResult = parseCentralDirectory();
+        if (parseResult.isError()) {
+            close();
+            return parseResult;
+        }
+        is_open_ = true;
+        return Ok();
+    }
+
+    void TXZipArchiveReader::close() {
+        closeEntry();
+        central_.clear();
+        name_index_.clear();
+        folded_index_.clear();
+        mapping_.close();
+        data_ = nullptr;
+        size_ = 0;
+        is_open_ = false;
+        filename_.clear();
+    }
+
+    TXResult<std::vector<ZipEntry>> TXZipArchiveReader::entries() {
+        auto open_check = ensureOpen();
+        if (open_check.isError()) return Err<std::vector<ZipEntry>>(open_check.error());
+
+        std::vector<ZipEntry> out_entries;
+        out_entries.reserve(central_.size());
+        for (const auto& entry : central_) {
+            ZipEntry e;
+            e.filename = entry.name;
+            e.uncompressed_size = static_cast<std::size_t>(entry.uncompressed_size);
+            e.compressed_size = static_cast<std::size_t>(entry.compressed_size);
+            e.modified_date = static_cast<uint64_t>(fromDosDateTime(entry.dos_datetime));
+            e.is_directory = !entry.name.empty() && entry.name.back() == '/';
+            out_entries.emplace_back(std::move(e));
+        }
+        return Ok(std::move(out_entries));
+    }
+
+    TXResult<bool> TXZipArchiveReader::has(const std::string& entry_name) {
+        auto open_check = ensureOpen();
+        if (open_check.isError()) {
+            return Err<bool>(open_check.error());
+        }
+        return Ok(findEntry(entry_name) != nullptr);
+    }
+
+    TXResult<std::vector<uint8_t>> TXZipArchiveReader::read(const std::string& entry_name) {
+        auto open_check = ensureOpen();
+        if (open_check.isError()) {
+            return Err<std::vector<uint8_t>>(open_check.error());
+        }
+        const CentralEntry* entry = findEntry(entry_name);
+        if (!entry) {
+            return Err<std::vector<uint8_t>>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed,
+                                                             "Failed to locate entry '" + entry_name + "' for reading"));
+        }
+
+        std::vector<uint8_t> data_buffer(static_cast<std::size_t>(entry->uncompressed_size));
+        auto readResult = readInto(entry_name, data_buffer.data(), data_buffer.size());
+        if (readResult.isError()) {
+            return Err<std::vector<uint8_t>>(readResult.error());
+        }
+        return Ok(std::move(data_buffer));
+    }
+
+    TXResult<std::string> TXZipArchiveReader::readString(const std::string& entry_name) {
+        auto open_check = ensureOpen();
+        if (open_check.isError()) {
+            return Err<std::string>(open_check.error());
+        }
+        const CentralEntry* entry = findEntry(entry_name);
+        if (!entry) {
+            return Err<std::string>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed,
+                                                    "Failed to locate entry '" + entry_name + "' for reading"));
+        }
+
+        std::string text(static_cast<std::size_t>(entry->uncompressed_size), '\0');
+        auto readResult = readInto(entry_name, text.data(), text.size());
+        if (readResult.isError()) {
+            return Err<std::string>(readResult.error());
+        }
+        return Ok(std::move(text));
+    }
+
+    TXResult<std::string_view> TXZipArchiveReader::view(const std::string& entry_name) {
+        auto open_check = ensureOpen();
+        if (open_check.isError()) {
+            return Err<std::string_view>(open_check.error());
+        }
+        const CentralEntry* entry = findEntry(entry_name);
+        if (!entry) {
+            return Err<std::string_view>(TX_ERROR_CREATE(TXErrorCode::ZipEntryNotFound,
+                                                         "Entry '" + entry_name + "' not found"));
+        }
+        if (entry->method != MZ_COMPRESS_METHOD_STORE) {
+            return Err<std::string_view>(TX_ERROR_CREATE(TXErrorCode::InvalidOperation,
+                                                         "ZIP entry '" + entry_name +
+                                                         "' is compressed and cannot be viewed in place"));
+        }
+        auto dataResult = entryData(*entry);
+        if (dataResult.isError()) {
+            return Err<std::string_view>(dataResult.error());
+        }
+        return Ok(std::string_view(reinterpret_cast<const char*>(dataResult.value()),
+                                   static_cast<std::size_t>(entry->uncompressed_size)));
+    }
+
+    TXResult<ZipRawEntry> TXZipArchiveReader::rawEntry(const std::string& entry_name) {
+        auto open_check = ensureOpen();
+        if (open_check.isError()) {
+            return Err<ZipRawEntry>(open_check.error());
+        }
+        const CentralEntry* entry = findEntry(entry_name);
+        if (!entry) {
+            return Err<ZipRawEntry>(TX_ERROR_CREATE(TXErrorCode::ZipEntryNotFound,
+                                                    "Entry '" + entry_name + "' not found"));
+        }
+        auto dataResult = entryData(*entry);
+        if (dataResult.isError()) {
+            return Err<ZipRawEntry>(dataResult.error());
+        }
+
+        ZipRawEntry raw;
+        raw.data = dataResult.value();
+        raw.compressed_size = static_cast<std::size_t>(entry->compressed_size);
+        raw.uncompressed_size = static_cast<std::size_t>(entry->uncompressed_size);
+        raw.crc32 = entry->crc32;
+        raw.method = entry->method;
+        raw.modified_date = fromDosDateTime(entry->dos_datetime);
+        return Ok(std::move(raw));
+    }
+
+    TXResult<std::size_t> TXZipArchiveReader::readInto(const std::string& entry_name, void* buffer,
+                                                       std::size_t capacity) {
+        auto open_check = ensureOpen();
+        if (open_check.isError()) {
+            return Err<std::size_t>(open_check.error());
+        }
+        const CentralEntry* entry = findEntry(entry_name);
+        if (!entry) {
+            return Err<std::size_t>(TX_ERROR_CREATE(TXErrorCode::ZipEntryNotFound,
+                                                    "Entry '" + entry_name + "' not found"));
+        }
+        if (capacity < entry->uncompressed_size) {
+            return Err<std::size_t>(TX_ERROR_CREATE(TXErrorCode::InvalidArgument,
+                                                    "Buffer too small for ZIP entry '" + entry_name + "'. Need " +
+                                                    std::to_string(entry->uncompressed_size) + ", got " +
+                                                    std::to_string(capacity)));
+        }
+        auto dataResult = entryData(*entry);
+        if (dataResult.isError()) {
+            return Err<std::size_t>(dataResult.error());
+        }
+
+        // 独立的解压状态，不影响 openEntry() 打开的条目
+        EntryCursor cursor;
+        auto startResult = cursor.start(*entry, dataResult.value());
+        if (startResult.isError()) {
+            return Err<std::size_t>(startResult.error());
+        }
+        auto* out = static_cast<uint8_t*>(buffer);
+        std::size_t total = 0;
+        while (!cursor.finished) {
+            // 缓冲区写满后再探测一个字节，让游标完成流结束、长度和 CRC 校验
+            uint8_t probe = 0;
+            const bool full = total == capacity;
+            auto readResult = full ? cursor.read(&probe, 1) : cursor.read(out + total, capacity - total);
+            if (readResult.isError()) {
+                return readResult;
+            }
+            total += full ? 0 : readResult.value();
+        }
+        return Ok(static_cast<std::size_t>(total));
+    }
+
+    TXResult<void> TXZipArchiveReader::readStream(const std::string& entry_name, const ChunkSink& sink,
+                                                  std::size_t chunkSize) {
+        auto open_check = ensureOpen();
+        if (open_check.isError()) {
+            return open_check;
+        }
+        const CentralEntry* entry = findEntry(entry_name);
+        if (!entry) {
+            return Err<void>(TX_ERROR_CREATE(TXErrorCode::ZipEntryNotFound,
+                                             "Failed to locate entry '" + entry_name + "' for reading"));
+        }
+        auto dataResult = entryData(*entry);
+        if (dataResult.isError()) {
+            return Err<void>(dataResult.error());
+        }
+
+        EntryCursor cursor;
+        auto startResult = cursor.start(*entry, dataResult.value());
+        if (startResult.isError()) {
+            return startResult;
+        }
+        chunkSize = std::max<std::size_t>(chunkSize, 1);
+        // STORED 条目直接交付映射中的数据，不需要缓冲区
+        std::vector<uint8_t> scratch(cursor.stored ? 0 : chunkSize);
+        while (!cursor.finished) {
+            const uint8_t* chunk = nullptr;
+            auto readResult = cursor.next(scratch.data(), chunkSize, chunk);
+            if (readResult.isError()) {
+                return Err<void>(readResult.error());
+            }
+            if (readResult.value() > 0) {
+                auto sinkResult = sink(chunk, readResult.value());
+                if (sinkResult.isError()) {
+                    return sinkResult;
+                }
+            }
+        }
+        return Ok();
+    }
+
+    TXResult<void> TXZipArchiveReader::openEntry(const std::string& entry_name) {
+        auto open_check = ensureOpen();
+        if (open_check.isError()) {
+            return open_check;
+        }
+        closeEntry();
+
+        const CentralEntry* entry = findEntry(entry_name);
+        if (!entry) {
+            return Err<void>(TX_ERROR_CREATE(TXErrorCode::ZipEntryNotFound,
+                                             "Failed to locate entry '" + entry_name + "' for reading"));
+        }
+        auto dataResult = entryData(*entry);
+        if (dataResult.isError()) {
+            return Err<void>(dataResult.error());
+        }
+        auto cursor = std::make_unique<EntryCursor>();
+        auto startResult = cursor->start(*entry, dataResult.value());
+        if (startResult.isError()) {
+            return startResult;
+        }
+        cursor_ = std::move(cursor);
+        return Ok();
+    }
+
+    TXResult<std::size_t> TXZipArchiveReader::readEntry(void* buffer, std::size_t size) {
+        if (!cursor_) {
+            return Err<std::size_t>(TXErrorCode::ZipInvalidState, "No entry is open. Call openEntry() first.");
+        }
+        auto readResult = cursor_->read(buffer, size);
+        if (readResult.isError()) {
+            closeEntry();
+        }
+        return readResult;
+    }
+
+    void TXZipArchiveReader::closeEntry() {
+        cursor_.reset();
+    }
+
+    TXResult<void> TXZipArchiveReader::parseCentralDirectory() {
+        const uint8_t* base = data_;
+        const std::size_t size = size_;
+        if (size < END_OF_CENTRAL_DIR_SIZE) {
+            return Err<void>(corruptArchive(filename_, "file is too small"));
+        }
+
+        // 目录结束记录位于文件末尾，之后最多跟一段 64KB 的注释
+        const std::size_t lowest = size > END_OF_CENTRAL_DIR_SIZE + MAX_COMMENT_SIZE
+                                       ? size - END_OF_CENTRAL_DIR_SIZE - MAX_COMMENT_SIZE
+                                       : 0;
+        std::size_t eocd = size - END_OF_CENTRAL_DIR_SIZE;
+        while (readU32(base + eocd) != END_OF_CENTRAL_DIR_SIGNATURE) {
+            if (eocd == lowest) {
+                return Err<void>(corruptArchive(filename_, "end of central directory not found"));
+            }
+            --eocd;
+        }
+
+        uint64_t count = readU16(base + eocd + 10);
+        uint64_t directorySize = readU32(base + eocd + 12);
+        uint64_t directoryOffset = readU32(base + eocd + 16);
+
+        if ((count == 0xFFFF || directorySize == 0xFFFFFFFF || directoryOffset == 0xFFFFFFFF) &&
+            eocd >= ZIP64_LOCATOR_SIZE &&
+            readU32(base + eocd - ZIP64_LOCATOR_SIZE) == ZIP64_LOCATOR_SIGNATURE) {
+            const uint64_t zip64Offset = readU64(base + eocd - ZIP64_LOCATOR_SIZE + 8);
+            // 文件可能比 zip64 目录结束记录还短，先比较大小再做减法，避免回绕
+            if (size < ZIP64_END_OF_CENTRAL_DIR_SIZE || zip64Offset > size - ZIP64_END_OF_CENTRAL_DIR_SIZE ||
+                readU32(base + zip64Offset) != ZIP64_END_OF_CENTRAL_DIR_SIGNATURE) {
+                return Err<void>(corruptArchive(filename_, "invalid zip64 end of central directory"));
+            }
+            const uint8_t* zip64 = base + zip64Offset;
+            count = readU64(zip64 + 32);
+            directorySize = readU64(zip64 + 40);
+            directoryOffset = readU64(zip64 + 48);
+        }
+
+        if (directoryOffset > size || directorySize > size - directoryOffset) {
+            return Err<void>(corruptArchive(filename_, "central directory is out of range"));
+        }
+
+        const uint8_t* p = base + directoryOffset;
+        const uint8_t* end = p + directorySize;
+        central_.clear();
+        name_index_.clear();
+        folded_index_.clear();
+        central_.reserve(static_cast<std::size_t>(std::min<uint64_t>(count, directorySize / CENTRAL_HEADER_SIZE)));
+
+        for (uint64_t i = 0; i < count; ++i) {
+            if (static_cast<std::size_t>(end - p) < CENTRAL_HEADER_SIZE || readU32(p) != CENTRAL_HEADER_SIGNATURE) {
+                return Err<void>(corruptArchive(filename_, "invalid central directory header"));
+            }
+            const uint16_t nameLength = readU16(p + 28);
+            const uint16_t extraLength = readU16(p + 30);
+            const uint16_t commentLength = readU16(p + 32);
+            const std::size_t recordSize = CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
+            if (static_cast<std::size_t>(end - p) < recordSize) {
+                return Err<void>(corruptArchive(filename_, "truncated central directory header"));
+            }
+
+            CentralEntry entry;
+            entry.flags = readU16(p + 8);
+            entry.method = readU16(p + 10);
+            entry.dos_datetime = (static_cast<uint32_t>(readU16(p + 14)) << 16) | readU16(p + 12);
+            entry.crc32 = readU32(p + 16);
+            entry.compressed_size = readU32(p + 20);
+            entry.uncompressed_size = readU32(p + 24);
+            entry.local_header_offset = readU32(p + 42);
+            entry.name.assign(reinterpret_cast<const char*>(p + CENTRAL_HEADER_SIZE), nameLength);
+
+            // zip64 扩展字段只包含在 32 位字段中被标记为 0xFFFFFFFF 的值，顺序固定
+            const uint8_t* extra = p + CENTRAL_HEADER_SIZE + nameLength;
+            const uint8_t* extraEnd = extra + extraLength;
+            while (extraEnd - extra >= 4) {
+                const uint16_t id = readU16(extra);
+                const uint16_t length = readU16(extra + 2);
+                const uint8_t* field = extra + 4;
+                if (extraEnd - field < length) {
+                    break;
+                }
+                if (id == ZIP64_EXTRA_FIELD_ID) {
+                    const uint8_t* fieldEnd = field + length;
+                    if (entry.uncompressed_size == 0xFFFFFFFF && fieldEnd - field >= 8) {
+                        entry.uncompressed_size = readU64(field);
+                        field += 8;
+                    }
+                    if (entry.compressed_size == 0xFFFFFFFF && fieldEnd - field >= 8) {
+                        entry.compressed_size = readU64(field);
+                        field += 8;
+                    }
+                    if (entry.local_header_offset == 0xFFFFFFFF && fieldEnd - field >= 8) {
+                        entry.local_header_offset = readU64(field);
+                    }
+                    break;
+                }
+                extra = field + length;
+            }
+
+            central_.push_back(std::move(entry));
+            p += recordSize;
+        }
+
+        // 同名条目以中央目录中靠前的为准
+        name_index_.reserve(central_.size());
+        folded_index_.reserve(central_.size());
+        for (std::size_t i = 0; i < central_.size(); ++i) {
+            name_index_.emplace(central_[i].name, i);
+            folded_index_.emplace(foldCase(central_[i].name), i);
+        }
+        return Ok();
+    }
+
+    const TXZipArchiveReader::CentralEntry* TXZipArchiveReader::findEntry(const std::string& entry_name) const {
+        auto it = name_index_.find(entry_name);
+        if (it != name_index_.end()) {
+            return &central_[it->second];
+        }
+        // 与 minizip-ng 的 locate_entry(ignore_case) 行为一致
+        it = folded_index_.find(foldCase(entry_name));
+        return it != folded_index_.end() ? &central_[it->second] : nullptr;
+    }
+
+    TXResult<const uint8_t*> TXZipArchiveReader::entryData(const CentralEntry& entry) const {
+        if (entry.flags & FLAG_ENCRYPTED) {
+            return Err<const uint8_t*>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed,
+                                                       "Encrypted ZIP entry '" + entry.name + "' is not supported"));
+        }
+        if (entry.method != MZ_COMPRESS_METHOD_STORE && entry.method != MZ_COMPRESS_METHOD_DEFLATE) {
+            return Err<const uint8_t*>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed,
+                                                       "Unsupported compression method " +
+                                                       std::to_string(entry.method) + " in ZIP entry '" +
+                                                       entry.name + "'"));
+        }
+
+        const uint8_t* base = data_;
+        const std::size_t size = size_;
+        const uint64_t offset = entry.local_header_offset;
+        if (offset > size || size - offset < LOCAL_HEADER_SIZE || readU32(base + offset) != LOCAL_HEADER_SIGNATURE) {
+            return Err<const uint8_t*>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed,
+                                                       "Invalid local header for ZIP entry '" + entry.name + "'"));
+        }
+        // 本地头的扩展字段长度可能与中央目录不同，必须以本地头为准
+        const uint64_t dataOffset = offset + LOCAL_HEADER_SIZE + readU16(base + offset + 26) +
+                                    readU16(base + offset + 28);
+        if (dataOffset > size || size - dataOffset < entry.compressed_size ||
+            (entry.method == MZ_COMPRESS_METHOD_STORE && entry.compressed_size != entry.uncompressed_size)) {
+            return Err<const uint8_t*>(TX_ERROR_CREATE(TXErrorCode::ZipReadEntryFailed,
+                                                       "ZIP entry '" + entry.name + "' is out of range"));
+        }
+        return Ok(base + dataOffset);
+    }
+} // namespace TinaXlsx
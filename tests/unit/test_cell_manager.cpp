@@ -306,3 +306,138 @@ TEST_F(TXCellManagerTest, Iterators) {
     }
     EXPECT_EQ(count, 3);
 }
+
+// ==================== 列存储测试 ====================
+
+TEST_F(TXCellManagerTest, RowMajorIteration) {
+    // 乱序写入，跨越多个数据块
+    cellManager->setCellValue(TXCoordinate(row_t(300), column_t(1)), 3.0);
+    cellManager->setCellValue(TXCoordinate(row_t(1), column_t(3)), 2.0);
+    cellManager->setCellValue(TXCoordinate(row_t(1), column_t(1)), 1.0);
+    cellManager->setCellValue(TXCoordinate(row_t(2), column_t(2)), std::string("B2"));
+
+    std::vector<std::string> order;
+    for (const auto& [coord, view] : *cellManager) {
+        order.push_back(coord.toAddress());
+    }
+    EXPECT_EQ(order, (std::vector<std::string>{"A1", "C1", "B2", "A300"}));
+}
+
+TEST_F(TXCellManagerTest, PlainCellsStayOutOfSideTable) {
+    TXCoordinate coord(row_t(5), column_t(2));
+    cellManager->setCellValue(coord, 1.5);
+    EXPECT_TRUE(cellManager->setCellStyleIndex(coord, 7));
+    EXPECT_EQ(cellManager->getRichCellCount(), 0);
+
+    auto view = cellManager->getCellView(coord);
+    ASSERT_TRUE(view.exists());
+    EXPECT_EQ(view.getType(), TXCell::CellType::Number);
+    EXPECT_EQ(view.getStyleIndex(), 7u);
+    EXPECT_EQ(view.getCell(), nullptr);
+
+    // 取出指针后转存到侧表，值和样式保持不变
+    TXCell* cell = cellManager->getCell(coord);
+    ASSERT_NE(cell, nullptr);
+    EXPECT_EQ(cellManager->getRichCellCount(), 1);
+    EXPECT_DOUBLE_EQ(std::get<double>(cell->getValue()), 1.5);
+    EXPECT_EQ(cell->getStyleIndex(), 7u);
+    EXPECT_EQ(cellManager->getCellCount(), 1);
+}
+
+TEST_F(TXCellManagerTest, NumericMemoryFootprint) {
+    constexpr u32 rows = 10000;
+    constexpr u32 cols = 10;
+    for (u32 r = 1; r <= rows; ++r) {
+        for (u32 c = 1; c <= cols; ++c) {
+            cellManager->setCellValue(TXCoordinate(row_t(r), column_t(c)), static_cast<double>(r * c));
+        }
+    }
+    EXPECT_EQ(cellManager->getCellCount(), rows * cols);
+    // 每个数值单元格约 9 字节，远小于 TXCell 本身的大小
+    EXPECT_LT(cellManager->getMemoryUsage(), rows * cols * sizeof(TXCell) / 5);
+}
+
+TEST_F(TXCellManagerTest, ConstReadsDoNotPromote) {
+    TXCoordinate coord(row_t(3), column_t(3));
+    TXCoordinate text(row_t(4), column_t(3));
+    cellManager->setCellValue(coord, 2.5);
+    cellManager->setCellValue(text, std::string("abc"));
+    cellManager->setCellStyleIndex(text, 3);
+
+    // 普通单元格返回只读副本，不转存到侧表，重复访问得到同一个对象
+    const TXCellManager& readOnly = *cellManager;
+    const TXCell* number = readOnly.getCell(coord);
+    const TXCell* str = readOnly.getCell(text);
+    ASSERT_NE(number, nullptr);
+    ASSERT_NE(str, nullptr);
+    EXPECT_DOUBLE_EQ(std::get<double>(number->getValue()), 2.5);
+    EXPECT_EQ(std::get<std::string>(str->getValue()), "abc");
+    EXPECT_EQ(str->getStyleIndex(), 3u);
+    EXPECT_EQ(readOnly.getCell(coord), number);
+    EXPECT_EQ(readOnly.getCell(TXCoordinate(row_t(5), column_t(3))), nullptr);
+    EXPECT_EQ(cellManager->getRichCellCount(), 0);
+
+    // 之后的修改写到同一个对象上，指针保持有效
+    cellManager->setCellValue(coord, 4.0);
+    EXPECT_DOUBLE_EQ(std::get<double>(number->getValue()), 4.0);
+    EXPECT_EQ(cellManager->getCell(text), str);
+    EXPECT_EQ(cellManager->getCellValue(text), TXCell::CellValue(std::string("abc")));
+
+    // 已在侧表中的单元格仍然可以只读访问
+    cellManager->getCell(coord)->setLocked(false);
+    ASSERT_EQ(readOnly.getCell(coord), number);
+    EXPECT_FALSE(number->isLocked());
+}
+
+TEST_F(TXCellManagerTest, ConstSheetGetCellReturnsPlainCells) {
+    sheet->setCellValue(row_t(1), column_t(1), 12.5);
+    sheet->setCellValue(row_t(1), column_t(2), std::string("plain"));
+
+    const TXSheet& readOnly = *sheet;
+    const TXCell* number = readOnly.getCell(row_t(1), column_t(1));
+    const TXCell* str = readOnly.getCell("B1");
+    ASSERT_NE(number, nullptr);
+    ASSERT_NE(str, nullptr);
+    EXPECT_EQ(number->getType(), TXCell::CellType::Number);
+    EXPECT_DOUBLE_EQ(std::get<double>(number->getValue()), 12.5);
+    EXPECT_EQ(str->getType(), TXCell::CellType::String);
+    EXPECT_EQ(std::get<std::string>(str->getValue()), "plain");
+    EXPECT_EQ(readOnly.getCell("C1"), nullptr);
+}
+
+TEST_F(TXCellManagerTest, CompactStringsDropsUnreferencedValues) {
+    TXCoordinate a(row_t(1), column_t(1));
+    TXCoordinate b(row_t(300), column_t(2));
+    for (int i = 0; i < 1000; ++i) {
+        cellManager->setCellValue(a, "value " + std::to_string(i));
+    }
+    cellManager->setCellValue(b, std::string("kept"));
+    const std::size_t before = cellManager->getMemoryUsage();
+
+    EXPECT_EQ(cellManager->compactStrings(), 999u);
+    EXPECT_LT(cellManager->getMemoryUsage(), before);
+    EXPECT_EQ(cellManager->getCellValue(a), TXCell::CellValue(std::string("value 999")));
+    EXPECT_EQ(cellManager->getCellValue(b), TXCell::CellValue(std::string("kept")));
+    EXPECT_EQ(cellManager->compactStrings(), 0u);
+}
+
+TEST_F(TXCellManagerTest, SparseCornerCellsSave) {
+    auto* corners = workbook->addSheet("稀疏");
+    ASSERT_NE(corners, nullptr);
+
+    // 使用范围覆盖整张表，保存只应遍历这两个单元格
+    EXPECT_TRUE(corners->setCellValue("A1", std::string("first")));
+    EXPECT_TRUE(corners->setCellValue("XFD1048576", 42.0));
+    EXPECT_EQ(corners->getUsedRange().toAddress(), "A1:XFD1048576");
+
+    ASSERT_TRUE(saveWorkbook(workbook, "SparseCorners"));
+
+    TXWorkbook loaded;
+    ASSERT_TRUE(loaded.loadFromFile(getFilePath("SparseCorners")));
+    auto* loadedSheet = loaded.getSheet("稀疏");
+    ASSERT_NE(loadedSheet, nullptr);
+    EXPECT_EQ(loadedSheet->getCellValue(row_t(1), column_t(1)), TXCell::CellValue(std::string("first")));
+    // 整数值的 double 以 <v>42</v> 保存，重新加载为整数
+    EXPECT_EQ(loadedSheet->getCellValue(row_t(1048576), column_t(16384)), TXCell::CellValue(int64_t(42)));
+    EXPECT_EQ(loadedSheet->getCellManager().getCellCount(), 2);
+}
@@ -0,0 +1,337 @@
+//
+// @file test_formula_engine.cpp
+// @brief 公式编译、求值和增量重算测试
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXFormula.hpp"
+#include "TinaXlsx/TXCellManager.hpp"
+#include "TinaXlsx/TXFormulaManager.hpp"
+#include "TinaXlsx/TXWorkbook.hpp"
+#include "TinaXlsx/TXSheet.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TinaXlsx;
+
+class TXFormulaEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // A1:A3 = 1, 2, 3；B1 = "abc"；B2 = "4"
+        for (u32 r = 1; r <= 3; ++r) {
+            cells_.setCellValue(TXCoordinate(row_t(r), column_t(1)), static_cast<int64_t>(r));
+        }
+        cells_.setCellValue(TXCoordinate(row_t(1), column_t(2)), std::string("abc"));
+        cells_.setCellValue(TXCoordinate(row_t(2), column_t(2)), std::string("4"));
+    }
+
+    TXFormula::FormulaValue eval(TXFormula& formula) {
+        return formula.evaluate(cells_, row_t(10), column_t(10));
+    }
+
+    double number(const std::string& text) {
+        TXFormula formula(text);
+        auto value = eval(formula);
+        EXPECT_EQ(formula.getLastError(), TXFormula::FormulaError::None) << text;
+        EXPECT_TRUE(std::holds_alternative<double>(value)) << text;
+        return std::holds_alternative<double>(value) ? std::get<double>(value) : 0.0;
+    }
+
+    std::string errorValue(const std::string& text) {
+        TXFormula formula(text);
+        eval(formula);
+        return std::string(formula.getErrorValue());
+    }
+
+    TXCellManager cells_;
+};
+
+TEST_F(TXFormulaEngineTest, OperatorPrecedence) {
+    EXPECT_DOUBLE_EQ(number("=1+2*3"), 7.0);
+    EXPECT_DOUBLE_EQ(number("=(1+2)*3"), 9.0);
+    EXPECT_DOUBLE_EQ(number("=2^3^2"), 64.0);   // 左结合
+    EXPECT_DOUBLE_EQ(number("=-2^2"), 4.0);     // 一元负号优先
+    EXPECT_DOUBLE_EQ(number("=10-4-3"), 3.0);
+    EXPECT_DOUBLE_EQ(number("=50%*4"), 2.0);
+    EXPECT_DOUBLE_EQ(number("=1.5e2/3"), 50.0);
+}
+
+TEST_F(TXFormulaEngineTest, ReferencesAndFunctions) {
+    EXPECT_DOUBLE_EQ(number("=A1+A2*A3"), 7.0);
+    EXPECT_DOUBLE_EQ(number("=$A$3-a1"), 2.0);
+    EXPECT_DOUBLE_EQ(number("=B2*2"), 8.0);         // 数字文本参与运算
+    EXPECT_DOUBLE_EQ(number("=C5+1"), 1.0);         // 空单元格为 0
+    EXPECT_DOUBLE_EQ(number("=SUM(A1:A3)"), 6.0);
+    EXPECT_DOUBLE_EQ(number("=SUM(A3:A1, 4)"), 10.0);
+    EXPECT_DOUBLE_EQ(number("=MAX(A1:A3)*ROUND(average(A1:A3), 0)"), 6.0);
+    EXPECT_DOUBLE_EQ(number("=SUM(MIN(A1:A3), MAX(A1, SUM(A2:A3)))"), 6.0);
+
+    TXFormula concat("=B1&\"-\"&A2&\"\"\"\"");
+    EXPECT_EQ(eval(concat), TXFormula::FormulaValue(std::string("abc-2\"")));
+
+    TXFormula compare("=IF(A1<A2, \"yes\", \"no\")");
+    EXPECT_EQ(eval(compare), TXFormula::FormulaValue(std::string("yes")));
+    TXFormula text("=B1=\"ABC\"");
+    EXPECT_EQ(eval(text), TXFormula::FormulaValue(true));
+}
+
+TEST_F(TXFormulaEngineTest, IfOnlyEvaluatesTakenBranch) {
+    TXFormula formula("=IF(A1>0, A1, 1/0)");
+    EXPECT_EQ(eval(formula), TXFormula::FormulaValue(int64_t(1)));
+    EXPECT_EQ(formula.getLastError(), TXFormula::FormulaError::None);
+
+    TXFormula noElse("=IF(A1>5, 1)");
+    EXPECT_EQ(eval(noElse), TXFormula::FormulaValue(false));
+}
+
+TEST_F(TXFormulaEngineTest, ReportsErrors) {
+    EXPECT_EQ(errorValue("=1/(A1-1)"), "#DIV/0!");
+    EXPECT_EQ(errorValue("=B1+1"), "#VALUE!");
+    EXPECT_EQ(errorValue("=NOSUCHFUNC(1)"), "#NAME?");
+    EXPECT_EQ(errorValue("=Other!A1"), "#REF!");
+    EXPECT_EQ(errorValue("=1+"), "#ERROR!");
+    EXPECT_EQ(errorValue("=SUM(1,2"), "#ERROR!");
+    EXPECT_EQ(errorValue("=1+2"), "");
+
+    EXPECT_TRUE(TXFormula::isValidFormula("=SUM(A1:B2)*2"));
+    EXPECT_FALSE(TXFormula::isValidFormula("=SUM(A1:B2"));
+    EXPECT_FALSE(TXFormula::isValidFormula("=A0"));
+}
+
+TEST_F(TXFormulaEngineTest, CompilesOnceAndTracksDependencies) {
+    TXFormula formula("=A1+SUM(B1:C2)+Sheet2!D4");
+    const auto deps = formula.getDependencies();
+    ASSERT_EQ(deps.size(), 2u);
+    EXPECT_EQ(deps[0].toString(), "A1");
+    EXPECT_EQ(deps[1].sheetName, "Sheet2");
+    ASSERT_EQ(formula.getRangeDependencies().size(), 1u);
+    EXPECT_EQ(formula.getRangeDependencies()[0].toString(), "B1:C2");
+
+    // 同一个编译结果可以重复求值，单元格变化后结果随之变化
+    TXFormula sum("=SUM(A1:A3)");
+    EXPECT_EQ(eval(sum), TXFormula::FormulaValue(6.0));
+    cells_.setCellValue(TXCoordinate(row_t(2), column_t(1)), 10.0);
+    EXPECT_EQ(eval(sum), TXFormula::FormulaValue(14.0));
+
+    // 自定义函数覆盖同名内置函数
+    sum.registerFunction("SUM", [](const std::vector<TXFormula::FormulaValue>&) {
+        return TXFormula::FormulaValue(42.0);
+    });
+    EXPECT_EQ(eval(sum), TXFormula::FormulaValue(42.0));
+    sum.clearCustomFunctions();
+    EXPECT_EQ(eval(sum), TXFormula::FormulaValue(14.0));
+}
+
+TEST_F(TXFormulaEngineTest, SheetCalculationWritesResults) {
+    TXWorkbook workbook;
+    TXSheet* sheet = workbook.addSheet("Calc");
+    ASSERT_NE(sheet, nullptr);
+    sheet->setCellValue(row_t(1), column_t(1), 2.0);
+    sheet->setCellValue(row_t(2), column_t(1), 3.0);
+    ASSERT_TRUE(sheet->setCellFormula(row_t(1), column_t(2), "=A1*A2+1"));
+    ASSERT_TRUE(sheet->setCellFormula(row_t(2), column_t(2), "=B1/0"));
+
+    sheet->calculateAllFormulas();
+    EXPECT_EQ(sheet->getCellValue(row_t(1), column_t(2)), TXCell::CellValue(7.0));
+    EXPECT_EQ(sheet->getCellValue(row_t(2), column_t(2)), TXCell::CellValue(std::string("#DIV/0!")));
+}
+
+class TXFormulaRecalcTest : public ::testing::Test {
+protected:
+    static TXCoordinate at(const std::string& address) {
+        return TXCoordinate::fromAddress(address);
+    }
+
+    void setValue(const std::string& address, double value) {
+        cells_.setCellValue(at(address), value);
+        formulas_.onCellChanged(at(address));
+    }
+
+    void setFormula(const std::string& address, const std::string& formula) {
+        ASSERT_TRUE(formulas_.setCellFormula(at(address), formula, cells_)) << address;
+    }
+
+    TXCell::CellValue value(const std::string& address) const {
+        return cells_.getCellValue(at(address));
+    }
+
+    TXCellManager cells_;
+    TXFormulaManager formulas_;
+};
+
+TEST_F(TXFormulaRecalcTest, RecalculatesOnlyDirtyCone) {
+    setValue("A1", 1.0);
+    setValue("A2", 2.0);
+    setFormula("B1", "=A1*2");
+    setFormula("B2", "=B1+1");
+    setFormula("C1", "=A2*10");
+    setFormula("D1", "=SUM(B1:B2)+B1");
+    EXPECT_EQ(formulas_.calculateAllFormulas(cells_), 4u);
+    EXPECT_EQ(value("D1"), TXCell::CellValue(7.0));
+    EXPECT_EQ(formulas_.getDirtyFormulaCount(), 0u);
+
+    // 只有 A1 的下游变脏，D1 通过两条路径依赖 B1 但只计算一次
+    setValue("A1", 5.0);
+    EXPECT_EQ(formulas_.getDirtyFormulaCount(), 3u);
+    EXPECT_EQ(formulas_.recalculate(cells_), 3u);
+    EXPECT_EQ(value("B2"), TXCell::CellValue(11.0));
+    EXPECT_EQ(value("D1"), TXCell::CellValue(31.0));
+    EXPECT_EQ(value("C1"), TXCell::CellValue(20.0));
+    EXPECT_EQ(formulas_.recalculate(cells_), 0u);
+
+    EXPECT_EQ(formulas_.getDependents(at("B1"), cells_).size(), 2u);
+    // 单元格引用和范围引用分开记录
+    EXPECT_EQ(formulas_.getDirectDependencies(at("D1"), cells_).size(), 1u);
+    EXPECT_EQ(formulas_.getDirectRangeDependencies(at("D1"), cells_).size(), 1u);
+}
+
+TEST_F(TXFormulaRecalcTest, ReplacingFormulaRewiresDependencies) {
+    setValue("A1", 1.0);
+    setValue("A3", 3.0);
+    setFormula("B1", "=A1*2");
+    formulas_.calculateAllFormulas(cells_);
+
+    setFormula("B1", "=A3*2");
+    EXPECT_EQ(formulas_.recalculate(cells_), 1u);
+    EXPECT_EQ(value("B1"), TXCell::CellValue(6.0));
+
+    setValue("A1", 100.0);
+    EXPECT_EQ(formulas_.getDirtyFormulaCount(), 0u);
+    setValue("A3", 4.0);
+    EXPECT_EQ(formulas_.recalculate(cells_), 1u);
+    EXPECT_EQ(value("B1"), TXCell::CellValue(8.0));
+}
+
+TEST_F(TXFormulaRecalcTest, CalculateAllSeesFormulasSetOnCells) {
+    setValue("A1", 2.0);
+    setFormula("B1", "=A1*2");
+    EXPECT_EQ(formulas_.calculateAllFormulas(cells_), 1u);
+
+    // 索引建立之后直接在单元格上设置和修改公式，不经过 TXFormulaManager
+    TXCell* b1 = cells_.getCell(at("B1"));
+    TXCell* c1 = cells_.getOrCreateCell(at("C1"));
+    ASSERT_NE(b1, nullptr);
+    ASSERT_NE(c1, nullptr);
+    c1->setFormula("=B1+1");
+    b1->setFormula("=A1*3");
+    EXPECT_EQ(formulas_.calculateAllFormulas(cells_), 2u);
+    EXPECT_EQ(value("B1"), TXCell::CellValue(6.0));
+    EXPECT_EQ(value("C1"), TXCell::CellValue(7.0));
+
+    // 重建后的索引包含新公式，增量计算照常工作
+    setValue("A1", 1.0);
+    EXPECT_EQ(formulas_.recalculate(cells_), 2u);
+    EXPECT_EQ(value("C1"), TXCell::CellValue(4.0));
+}
+
+TEST_F(TXFormulaRecalcTest, LongChainEvaluatesInDependencyOrder) {
+    constexpr u32 kLength = 2000;
+    setValue("A1", 0.0);
+    // 自下而上设置，保证计算顺序来自依赖关系而不是插入顺序
+    for (u32 r = kLength; r >= 2; --r) {
+        setFormula("A" + std::to_string(r), "=A" + std::to_string(r - 1) + "+1");
+    }
+    EXPECT_EQ(formulas_.calculateAllFormulas(cells_), kLength - 1);
+    EXPECT_EQ(value("A" + std::to_string(kLength)), TXCell::CellValue(double(kLength - 1)));
+
+    setValue("A1", 10.0);
+    EXPECT_EQ(formulas_.recalculateDependents(at("A1"), cells_), kLength - 1);
+    EXPECT_EQ(value("A" + std::to_string(kLength)), TXCell::CellValue(double(kLength + 9)));
+    EXPECT_FALSE(formulas_.detectCircularReferences(cells_));
+}
+
+TEST_F(TXFormulaRecalcTest, CircularReferencesTerminate) {
+    setFormula("A1", "=B1+1");
+    setFormula("B1", "=A1+1");
+    setFormula("C1", "=5");
+    EXPECT_TRUE(formulas_.detectCircularReferences(cells_));
+    EXPECT_EQ(formulas_.getCircularReferences(cells_).size(), 1u);
+    EXPECT_EQ(formulas_.calculateAllFormulas(cells_), 3u);
+    EXPECT_EQ(value("C1"), TXCell::CellValue(5.0));
+}
+
+TEST_F(TXFormulaRecalcTest, ConcurrentConstQueriesShareTheIndex) {
+    constexpr u32 kRows = 200;
+    setValue("A1", 1.0);
+    for (u32 r = 1; r <= kRows; ++r) {
+        setFormula("B" + std::to_string(r), "=A1+" + std::to_string(r));
+    }
+    setFormula("C1", "=SUM(B1:B200)");
+
+    // 索引尚未建立，多个线程同时通过 const 接口查询时第一次查询负责建立
+    const TXFormulaManager& formulas = formulas_;
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int k = 0; k < 20; ++k) {
+                if (formulas.getDependents(at("A1"), cells_).size() != kRows ||
+                    formulas.getDependents(at("B7"), cells_).size() != 1 ||
+                    formulas.detectCircularReferences(cells_)) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+}
+
+TEST_F(TXFormulaRecalcTest, ParallelRecalculationMatchesSerial) {
+    // 三层宽模型：B 列引用 A 列，C 列引用 B 列和 B 列的总和，D1 汇总 C 列
+    constexpr u32 kRows = 3000;
+    auto build = [](TXCellManager& cells, TXFormulaManager& formulas) {
+        for (u32 r = 1; r <= kRows; ++r) {
+            const std::string row = std::to_string(r);
+            cells.setCellValue(TXCoordinate(row_t(r), column_t(1)), static_cast<double>(r));
+            formulas.setCellFormula(TXCoordinate(row_t(r), column_t(2)), "=A" + row + "*2", cells);
+            formulas.setCellFormula(TXCoordinate(row_t(r), column_t(3)), "=IF(B" + row + ">100,B" + row + "-SUM(B1:B10),1/0)", cells);
+        }
+        formulas.setCellFormula(TXCoordinate(row_t(1), column_t(4)), "=SUM(C100:C" + std::to_string(kRows) + ")", cells);
+    };
+
+    TXCellManager parallelCells;
+    TXFormulaManager parallel;
+    auto options = TXFormulaManager::FormulaCalculationOptions::createDefault();
+    options.threadCount = 4;
+    parallel.setCalculationOptions(options);
+    build(parallelCells, parallel);
+    build(cells_, formulas_);
+
+    EXPECT_EQ(parallel.calculateAllFormulas(parallelCells), 2 * kRows + 1);
+    EXPECT_EQ(formulas_.calculateAllFormulas(cells_), 2 * kRows + 1);
+    for (u32 r = 1; r <= kRows; ++r) {
+        for (u32 c = 2; c <= 4; ++c) {
+            const TXCoordinate coord{row_t(r), column_t(c)};
+            ASSERT_EQ(parallelCells.getCellValue(coord), cells_.getCellValue(coord)) << coord.toAddress();
+        }
+    }
+    EXPECT_EQ(parallelCells.getCellValue(TXCoordinate(row_t(1), column_t(3))), TXCell::CellValue(std::string("#DIV/0!")));
+
+    // 增量重算同样走并行路径
+    parallelCells.setCellValue(TXCoordinate(row_t(5), column_t(1)), 1000.0);
+    parallel.onCellChanged(TXCoordinate(row_t(5), column_t(1)));
+    EXPECT_EQ(parallel.recalculate(parallelCells), kRows + 2);  // B5、所有 C 列公式（都引用 B1:B10）和 D1
+    EXPECT_EQ(parallelCells.getCellValue(TXCoordinate(row_t(5), column_t(2))), TXCell::CellValue(2000.0));
+}
+
+TEST_F(TXFormulaRecalcTest, SheetTracksEditsAndStructuralChanges) {
+    TXWorkbook workbook;
+    TXSheet* sheet = workbook.addSheet("Recalc");
+    ASSERT_NE(sheet, nullptr);
+    sheet->setCellValue(row_t(1), column_t(1), 2.0);
+    ASSERT_TRUE(sheet->setCellFormula(row_t(1), column_t(2), "=A1*3"));
+    EXPECT_EQ(sheet->calculateAllFormulas(), 1u);
+
+    sheet->setCellValue(row_t(1), column_t(1), 4.0);
+    EXPECT_EQ(sheet->recalculateFormulas(), 1u);
+    EXPECT_EQ(sheet->getCellValue(row_t(1), column_t(2)), TXCell::CellValue(12.0));
+
+    // 插入行后索引重建，公式移动到新位置后仍可重算
+    ASSERT_TRUE(sheet->insertRows(row_t(1), row_t(1)));
+    EXPECT_EQ(sheet->recalculateFormulas(), 1u);
+}
@@ -0,0 +1,207 @@
+//
+// @file test_incremental_save.cpp
+// @brief 增量保存测试：未修改的部件从源文件原样复制
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXWorkbook.hpp"
+#include "TinaXlsx/TXSheet.hpp"
+#include "TinaXlsx/TXZipArchive.hpp"
+#include <cstdio>
+#include <string>
+
+using namespace TinaXlsx;
+
+class TXIncrementalSaveTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        TXWorkbook workbook;
+        for (int s = 1; s <= 3; ++s) {
+            TXSheet* sheet = workbook.addSheet("Data" + std::to_string(s));
+            ASSERT_NE(sheet, nullptr);
+            for (u32 r = 1; r <= 300; ++r) {
+                sheet->setCellValue(row_t(r), column_t(1), "sheet" + std::to_string(s) + "_" + std::to_string(r % 17));
+                sheet->setCellValue(row_t(r), column_t(2), static_cast<int64_t>(r * s));
+            }
+        }
+        // 源文件用最高压缩级别，重新生成的部件（级别 1）与之不同，便于区分是否原样复制
+        ASSERT_TRUE(workbook.saveToFile(template_, TXSaveOptions::maxRatio())) << workbook.getLastError();
+    }
+
+    void TearDown() override {
+        std::remove(template_.c_str());
+        std::remove(output_.c_str());
+    }
+
+    static std::string rawBytes(TXZipArchiveReader& reader, const std::string& part) {
+        auto raw = reader.rawEntry(part);
+        EXPECT_TRUE(raw.isOk()) << part;
+        if (raw.isError()) {
+            return {};
+        }
+        return std::string(reinterpret_cast<const char*>(raw.value().data), raw.value().compressed_size);
+    }
+
+    const std::string template_ = "incremental_template.xlsx";
+    const std::string output_ = "incremental_output.xlsx";
+};
+
+TEST_F(TXIncrementalSaveTest, CopiesUntouchedSheetsVerbatim) {
+    for (u32 threads : {1u, 4u}) {
+        TXWorkbook workbook;
+        ASSERT_TRUE(workbook.loadFromFile(template_)) << workbook.getLastError();
+        for (const auto& sheet : workbook.getSheets()) {
+            EXPECT_FALSE(sheet->isModified());
+        }
+
+        TXSheet* edited = workbook.getSheet("Data2");
+        ASSERT_NE(edited, nullptr);
+        edited->setCellValue(row_t(5), column_t(1), std::string("a brand new string"));
+        EXPECT_TRUE(edited->isModified());
+        EXPECT_FALSE(workbook.getSheet("Data1")->isModified());
+
+        TXSaveOptions options = TXSaveOptions::fast();
+        options.threadCount = threads;
+        ASSERT_TRUE(workbook.saveToFile(output_, options)) << workbook.getLastError();
+
+        TXZipArchiveReader source;
+        TXZipArchiveReader output;
+        ASSERT_TRUE(source.open(template_).isOk());
+        ASSERT_TRUE(output.open(output_).isOk());
+        EXPECT_EQ(rawBytes(output, "xl/worksheets/sheet1.xml"), rawBytes(source, "xl/worksheets/sheet1.xml"));
+        EXPECT_EQ(rawBytes(output, "xl/worksheets/sheet3.xml"), rawBytes(source, "xl/worksheets/sheet3.xml"));
+        EXPECT_NE(rawBytes(output, "xl/worksheets/sheet2.xml"), rawBytes(source, "xl/worksheets/sheet2.xml"));
+        output.close();
+
+        // 新增的字符串追加在源 sst 之后，复制的工作表中的索引仍然有效
+        TXWorkbook reloaded;
+        ASSERT_TRUE(reloaded.loadFromFile(output_)) << reloaded.getLastError();
+        EXPECT_EQ(reloaded.getSheet("Data1")->getCellValue(row_t(20), column_t(1)),
+                  TXCell::CellValue(std::string("sheet1_3")));
+        EXPECT_EQ(reloaded.getSheet("Data3")->getCellValue(row_t(20), column_t(2)),
+                  TXCell::CellValue(static_cast<int64_t>(60)));
+        EXPECT_EQ(reloaded.getSheet("Data2")->getCellValue(row_t(5), column_t(1)),
+                  TXCell::CellValue(std::string("a brand new string")));
+        EXPECT_EQ(reloaded.getSheet("Data2")->getCellValue(row_t(6), column_t(1)),
+                  TXCell::CellValue(std::string("sheet2_6")));
+    }
+}
+
+TEST_F(TXIncrementalSaveTest, UnchangedWorkbookReusesSharedStrings) {
+    TXWorkbook workbook;
+    ASSERT_TRUE(workbook.loadFromFile(template_)) << workbook.getLastError();
+    ASSERT_TRUE(workbook.saveToFile(output_, TXSaveOptions::fast())) << workbook.getLastError();
+
+    TXZipArchiveReader source;
+    TXZipArchiveReader output;
+    ASSERT_TRUE(source.open(template_).isOk());
+    ASSERT_TRUE(output.open(output_).isOk());
+    EXPECT_EQ(rawBytes(output, "xl/sharedStrings.xml"), rawBytes(source, "xl/sharedStrings.xml"));
+    EXPECT_EQ(rawBytes(output, "xl/worksheets/sheet2.xml"), rawBytes(source, "xl/worksheets/sheet2.xml"));
+}
+
+TEST_F(TXIncrementalSaveTest, CanBeDisabled) {
+    TXWorkbook workbook;
+    ASSERT_TRUE(workbook.loadFromFile(template_)) << workbook.getLastError();
+
+    TXSaveOptions options = TXSaveOptions::fast();
+    options.reuseUnchangedParts = false;
+    ASSERT_TRUE(workbook.saveToFile(output_, options)) << workbook.getLastError();
+
+    TXZipArchiveReader source;
+    TXZipArchiveReader output;
+    ASSERT_TRUE(source.open(template_).isOk());
+    ASSERT_TRUE(output.open(output_).isOk());
+    EXPECT_NE(rawBytes(output, "xl/worksheets/sheet1.xml"), rawBytes(source, "xl/worksheets/sheet1.xml"));
+}
+
+TEST_F(TXIncrementalSaveTest, OverwritingSourceRegeneratesEverything) {
+    TXWorkbook workbook;
+    ASSERT_TRUE(workbook.loadFromFile(template_)) << workbook.getLastError();
+    workbook.getSheet("Data1")->setCellValue(row_t(1), column_t(3), static_cast<int64_t>(42));
+    ASSERT_TRUE(workbook.saveToFile(template_)) << workbook.getLastError();
+
+    TXWorkbook reloaded;
+    ASSERT_TRUE(reloaded.loadFromFile(template_)) << reloaded.getLastError();
+    EXPECT_EQ(reloaded.getSheet("Data1")->getCellValue(row_t(1), column_t(3)),
+              TXCell::CellValue(static_cast<int64_t>(42)));
+    EXPECT_EQ(reloaded.getSheet("Data3")->getCellValue(row_t(17), column_t(1)),
+              TXCell::CellValue(std::string("sheet3_0")));
+}
+
+TEST_F(TXIncrementalSaveTest, ReadsDoNotMarkSheetsModified) {
+    TXWorkbook workbook;
+    ASSERT_TRUE(workbook.loadFromFile(template_)) << workbook.getLastError();
+
+    TXSheet* sheet = workbook.getSheet("Data1");
+    ASSERT_NE(sheet, nullptr);
+    TXCell* cell = sheet->getCell(row_t(3), column_t(2));
+    ASSERT_NE(cell, nullptr);
+    EXPECT_EQ(cell->getValue(), TXCell::CellValue(static_cast<int64_t>(3)));
+    EXPECT_NE(sheet->getCellManager().getCell(TXCoordinate(row_t(4), column_t(1))), nullptr);
+    EXPECT_EQ(sheet->getRowColumnManager().getRowHeight(row_t(1)), sheet->getRowHeight(row_t(1)));
+    EXPECT_TRUE(sheet->getAllCharts().empty());
+    EXPECT_FALSE(sheet->isModified());
+
+    // 通过之前取得的指针写入才算修改
+    cell->setValue(static_cast<int64_t>(99));
+    EXPECT_TRUE(sheet->isModified());
+
+    TXSheet* other = workbook.getSheet("Data3");
+    other->getRowColumnManager().setColumnWidth(column_t(1), 20.0);
+    EXPECT_TRUE(other->isModified());
+    EXPECT_FALSE(workbook.getSheet("Data2")->isModified());
+
+    ASSERT_TRUE(workbook.saveToFile(output_, TXSaveOptions::fast())) << workbook.getLastError();
+    TXZipArchiveReader source;
+    TXZipArchiveReader output;
+    ASSERT_TRUE(source.open(template_).isOk());
+    ASSERT_TRUE(output.open(output_).isOk());
+    EXPECT_EQ(rawBytes(output, "xl/worksheets/sheet2.xml"), rawBytes(source, "xl/worksheets/sheet2.xml"));
+    output.close();
+
+    TXWorkbook reloaded;
+    ASSERT_TRUE(reloaded.loadFromFile(output_)) << reloaded.getLastError();
+    EXPECT_EQ(reloaded.getSheet("Data1")->getCellValue(row_t(3), column_t(2)),
+              TXCell::CellValue(static_cast<int64_t>(99)));
+}
+
+TEST_F(TXIncrementalSaveTest, CopiesDrawingsOfUntouchedSheets) {
+    {
+        TXWorkbook workbook;
+        TXSheet* charted = workbook.addSheet("Charted");
+        for (u32 r = 1; r <= 5; ++r) {
+            charted->setCellValue(row_t(r), column_t(1), "item" + std::to_string(r));
+            charted->setCellValue(row_t(r), column_t(2), static_cast<int64_t>(r * 10));
+        }
+        ASSERT_NE(charted->addColumnChart("Totals", TXRange::fromAddress("A1:B5"), {row_t(8), column_t(1)}), nullptr);
+        TXSheet* plain = workbook.addSheet("Plain");
+        plain->setCellValue(row_t(1), column_t(1), std::string("plain"));
+        ASSERT_TRUE(workbook.saveToFile(template_, TXSaveOptions::maxRatio())) << workbook.getLastError();
+    }
+
+    TXWorkbook workbook;
+    ASSERT_TRUE(workbook.loadFromFile(template_)) << workbook.getLastError();
+    workbook.getSheet("Plain")->setCellValue(row_t(2), column_t(1), std::string("edited"));
+    ASSERT_TRUE(workbook.saveToFile(output_, TXSaveOptions::fast())) << workbook.getLastError();
+
+    TXZipArchiveReader source;
+    TXZipArchiveReader output;
+    ASSERT_TRUE(source.open(template_).isOk());
+    ASSERT_TRUE(output.open(output_).isOk());
+    for (const char* part : {"xl/worksheets/sheet1.xml", "xl/worksheets/_rels/sheet1.xml.rels",
+                             "xl/drawings/drawing1.xml", "xl/drawings/_rels/drawing1.xml.rels",
+                             "xl/charts/chart1.xml"}) {
+        EXPECT_EQ(rawBytes(output, part), rawBytes(source, part)) << part;
+    }
+    auto contentTypes = output.readString("[Content_Types].xml");
+    ASSERT_TRUE(contentTypes.isOk());
+    EXPECT_NE(contentTypes.value().find("/xl/drawings/drawing1.xml"), std::string::npos);
+    EXPECT_NE(contentTypes.value().find("/xl/charts/chart1.xml"), std::string::npos);
+    output.close();
+
+    TXWorkbook reloaded;
+    ASSERT_TRUE(reloaded.loadFromFile(output_)) << reloaded.getLastError();
+    EXPECT_EQ(reloaded.getSheet("Plain")->getCellValue(row_t(2), column_t(1)),
+              TXCell::CellValue(std::string("edited")));
+}
@@ -0,0 +1,151 @@
+//
+// @file test_lazy_loading.cpp
+// @brief 按需加载工作表测试
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXWorkbook.hpp"
+#include "TinaXlsx/TXSheet.hpp"
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace TinaXlsx;
+
+class TXLazyLoadingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        TXWorkbook workbook;
+        for (int s = 1; s <= kSheets; ++s) {
+            TXSheet* sheet = workbook.addSheet(sheetName(s));
+            ASSERT_NE(sheet, nullptr);
+            for (u32 r = 1; r <= 100; ++r) {
+                sheet->setCellValue(row_t(r), column_t(1), "s" + std::to_string(s) + "_r" + std::to_string(r));
+                sheet->setCellValue(row_t(r), column_t(2), static_cast<int64_t>(r + s * 1000));
+            }
+        }
+        ASSERT_TRUE(workbook.saveToFile(filename_)) << workbook.getLastError();
+    }
+
+    void TearDown() override {
+        std::remove(filename_.c_str());
+        std::remove(output_.c_str());
+    }
+
+    static std::string sheetName(int s) {
+        return "Sheet" + std::to_string(s);
+    }
+
+    static void expectSheetContents(TXWorkbook& workbook, int s) {
+        TXSheet* sheet = workbook.getSheet(sheetName(s));
+        ASSERT_NE(sheet, nullptr) << workbook.getLastError();
+        EXPECT_EQ(sheet->getCellValue(row_t(42), column_t(1)),
+                  TXCell::CellValue("s" + std::to_string(s) + "_r42"));
+        EXPECT_EQ(sheet->getCellValue(row_t(42), column_t(2)),
+                  TXCell::CellValue(static_cast<int64_t>(42 + s * 1000)));
+    }
+
+    static constexpr int kSheets = 6;
+    const std::string filename_ = "lazy_loading.xlsx";
+    const std::string output_ = "lazy_loading_out.xlsx";
+};
+
+TEST_F(TXLazyLoadingTest, ParsesSheetsOnFirstAccess) {
+    TXLoadOptions options;
+    options.lazySheets = true;
+    TXWorkbook workbook;
+    ASSERT_TRUE(workbook.loadFromFile(filename_, options)) << workbook.getLastError();
+
+    // 名称和数量来自 workbook.xml，不需要解析工作表
+    EXPECT_EQ(workbook.getSheetCount(), static_cast<u64>(kSheets));
+    EXPECT_EQ(workbook.getSheetNames()[3], sheetName(4));
+    for (int s = 1; s <= kSheets; ++s) {
+        EXPECT_FALSE(workbook.isSheetLoaded(sheetName(s)));
+    }
+
+    expectSheetContents(workbook, 4);
+    EXPECT_TRUE(workbook.isSheetLoaded(sheetName(4)));
+    EXPECT_FALSE(workbook.isSheetLoaded(sheetName(3)));
+
+    ASSERT_NE(workbook.getSheet(u64(0)), nullptr);
+    EXPECT_TRUE(workbook.isSheetLoaded(sheetName(1)));
+}
+
+TEST_F(TXLazyLoadingTest, UnloadsAndReloadsSheets) {
+    TXLoadOptions options;
+    options.lazySheets = true;
+    TXWorkbook workbook;
+    ASSERT_TRUE(workbook.loadFromFile(filename_, options)) << workbook.getLastError();
+
+    expectSheetContents(workbook, 2);
+    ASSERT_TRUE(workbook.unloadSheet(sheetName(2))) << workbook.getLastError();
+    EXPECT_FALSE(workbook.isSheetLoaded(sheetName(2)));
+    expectSheetContents(workbook, 2);
+
+    // 有未保存修改的工作表不能卸载
+    workbook.getSheet(sheetName(3))->setCellValue(row_t(1), column_t(5), 1.0);
+    EXPECT_FALSE(workbook.unloadSheet(sheetName(3)));
+    EXPECT_TRUE(workbook.isSheetLoaded(sheetName(3)));
+
+    // 急切加载的工作表同样可以卸载
+    TXWorkbook eager;
+    ASSERT_TRUE(eager.loadFromFile(filename_)) << eager.getLastError();
+    ASSERT_TRUE(eager.unloadSheet(sheetName(5))) << eager.getLastError();
+    expectSheetContents(eager, 5);
+}
+
+TEST_F(TXLazyLoadingTest, SavesSheetsThatWereNeverParsed) {
+    for (bool reuse : {true, false}) {
+        TXLoadOptions loadOptions;
+        loadOptions.lazySheets = true;
+        TXWorkbook workbook;
+        ASSERT_TRUE(workbook.loadFromFile(filename_, loadOptions)) << workbook.getLastError();
+        workbook.getSheet(sheetName(2))->setCellValue(row_t(42), column_t(3), std::string("edited"));
+
+        TXSaveOptions saveOptions;
+        saveOptions.reuseUnchangedParts = reuse;
+        ASSERT_TRUE(workbook.saveToFile(output_, saveOptions)) << workbook.getLastError();
+        EXPECT_EQ(workbook.isSheetLoaded(sheetName(5)), !reuse);
+
+        TXWorkbook reloaded;
+        ASSERT_TRUE(reloaded.loadFromFile(output_)) << reloaded.getLastError();
+        for (int s = 1; s <= kSheets; ++s) {
+            expectSheetContents(reloaded, s);
+        }
+        EXPECT_EQ(reloaded.getSheet(sheetName(2))->getCellValue(row_t(42), column_t(3)),
+                  TXCell::CellValue(std::string("edited")));
+    }
+}
+
+TEST_F(TXLazyLoadingTest, ConcurrentAccessParsesEachSheetOnce) {
+    TXLoadOptions options;
+    options.lazySheets = true;
+    TXWorkbook workbook;
+    ASSERT_TRUE(workbook.loadFromFile(filename_, options)) << workbook.getLastError();
+
+    // 所有线程同时访问全部工作表，每个线程看到的内容都完整
+    const TXWorkbook& shared = workbook;
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int k = 0; k < kSheets; ++k) {
+                const int s = (k + t) % kSheets + 1;
+                const TXSheet* sheet = shared.getSheet(static_cast<u64>(s - 1));
+                if (!sheet || sheet->getCellValue(row_t(42), column_t(2)) !=
+                                  TXCell::CellValue(static_cast<int64_t>(42 + s * 1000))) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+    for (int s = 1; s <= kSheets; ++s) {
+        EXPECT_TRUE(workbook.isSheetLoaded(sheetName(s)));
+    }
+}
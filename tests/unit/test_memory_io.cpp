@@ -0,0 +1,92 @@
+//
+// @file test_memory_io.cpp
+// @brief 内存中加载和保存工作簿测试
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXWorkbook.hpp"
+#include "TinaXlsx/TXSheet.hpp"
+#include "TinaXlsx/TXZipArchive.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace TinaXlsx;
+
+namespace {
+
+void fillWorkbook(TXWorkbook& workbook) {
+    TXSheet* sheet = workbook.addSheet("Upload");
+    ASSERT_NE(sheet, nullptr);
+    for (u32 r = 1; r <= 200; ++r) {
+        sheet->setCellValue(row_t(r), column_t(1), std::string("item_") + std::to_string(r % 13));
+        sheet->setCellValue(row_t(r), column_t(2), static_cast<double>(r) * 1.25);
+    }
+}
+
+} // namespace
+
+TEST(TXMemoryIOTest, SaveToMemoryLoadsBack) {
+    TXWorkbook workbook;
+    fillWorkbook(workbook);
+
+    std::vector<uint8_t> bytes;
+    ASSERT_TRUE(workbook.saveToMemory(bytes)) << workbook.getLastError();
+    ASSERT_GT(bytes.size(), 4u);
+    EXPECT_EQ(bytes[0], 'P');
+    EXPECT_EQ(bytes[1], 'K');
+
+    TXWorkbook loaded;
+    ASSERT_TRUE(loaded.loadFromMemory(bytes)) << loaded.getLastError();
+    TXSheet* sheet = loaded.getSheet("Upload");
+    ASSERT_NE(sheet, nullptr);
+    EXPECT_EQ(sheet->getCellValue(row_t(20), column_t(1)), TXCell::CellValue(std::string("item_7")));
+    EXPECT_EQ(sheet->getCellValue(row_t(21), column_t(2)), TXCell::CellValue(26.25));
+}
+
+TEST(TXMemoryIOTest, MemoryOutputMatchesFileOutput) {
+    const std::string filename = "memory_io_file.xlsx";
+    TXWorkbook workbook;
+    fillWorkbook(workbook);
+
+    TXSaveOptions options = TXSaveOptions::fast();
+    ASSERT_TRUE(workbook.saveToFile(filename, options)) << workbook.getLastError();
+    std::vector<uint8_t> streamed;
+    std::size_t calls = 0;
+    ASSERT_TRUE(workbook.saveToStream([&](const uint8_t* data, std::size_t size) {
+        streamed.insert(streamed.end(), data, data + size);
+        ++calls;
+        return true;
+    }, options)) << workbook.getLastError();
+    EXPECT_GE(calls, 1u);
+
+    // 时间戳可能不同，逐条目比较解压内容
+    TXZipArchiveReader fromFile;
+    TXZipArchiveReader fromMemory;
+    ASSERT_TRUE(fromFile.open(filename).isOk());
+    ASSERT_TRUE(fromMemory.openMemory(streamed.data(), streamed.size()).isOk());
+    auto fileEntries = fromFile.entries();
+    auto memoryEntries = fromMemory.entries();
+    ASSERT_TRUE(fileEntries.isOk());
+    ASSERT_TRUE(memoryEntries.isOk());
+    ASSERT_EQ(fileEntries.value().size(), memoryEntries.value().size());
+    for (std::size_t i = 0; i < fileEntries.value().size(); ++i) {
+        const std::string& name = fileEntries.value()[i].filename;
+        EXPECT_EQ(name, memoryEntries.value()[i].filename);
+        EXPECT_EQ(fromFile.readString(name).value(), fromMemory.readString(name).value()) << name;
+    }
+
+    fromFile.close();
+    std::remove(filename.c_str());
+}
+
+TEST(TXMemoryIOTest, RejectsInvalidData) {
+    const std::string garbage = "definitely not an xlsx file";
+    TXWorkbook workbook;
+    EXPECT_FALSE(workbook.loadFromMemory(garbage.data(), garbage.size()));
+    EXPECT_FALSE(workbook.getLastError().empty());
+
+    TXWorkbook source;
+    fillWorkbook(source);
+    EXPECT_FALSE(source.saveToStream([](const uint8_t*, std::size_t) { return false; }));
+}
@@ -6,6 +6,7 @@
 #include <gtest/gtest.h>
 #include "TinaXlsx/TXNumberUtils.hpp"
 #include <chrono>
+#include <limits>
 #include <vector>
 #include <random>
 
@@ -78,8 +79,25 @@ TEST_F(NumberUtilsTest, FormatForExcelXml) {
     EXPECT_EQ(TXNumberUtils::formatForExcelXml(123.40), "123.4");
     EXPECT_EQ(TXNumberUtils::formatForExcelXml(123.00), "123");
     
-    // 测试精度
-    EXPECT_EQ(TXNumberUtils::formatForExcelXml(123.456789), "123.46");
+    // 测试精度：不截断，输出能还原原值的最短表示
+    EXPECT_EQ(TXNumberUtils::formatForExcelXml(123.456789), "123.456789");
+    EXPECT_EQ(TXNumberUtils::formatForExcelXml(3.14159), "3.14159");
+    EXPECT_EQ(TXNumberUtils::formatForExcelXml(0.1), "0.1");
+    EXPECT_EQ(TXNumberUtils::formatForExcelXml(1.0 / 3.0), "0.3333333333333333");
+}
+
+TEST_F(NumberUtilsTest, FormatForExcelXmlRoundTrips) {
+    const double values[] = {0.1 + 0.2, 1.0 / 7.0, -2.5e-12, 6.02214076e23, 1e20, -0.0,
+                             std::numeric_limits<double>::max(), std::numeric_limits<double>::min(),
+                             std::numeric_limits<double>::denorm_min()};
+    for (double value : values) {
+        char buffer[TXNumberUtils::EXCEL_XML_NUMBER_BUFFER_SIZE];
+        const std::size_t length = TXNumberUtils::formatForExcelXml(value, buffer);
+        const std::string text(buffer, length);
+        EXPECT_EQ(text, TXNumberUtils::formatForExcelXml(value));
+        EXPECT_EQ(TXNumberUtils::parseDouble(text), value) << text;
+    }
+    EXPECT_EQ(TXNumberUtils::formatForExcelXml(-0.0), "0");
 }
 
 TEST_F(NumberUtilsTest, FormatDoubleWithOptions) {
@@ -216,7 +234,7 @@ TEST_F(NumberUtilsTest, ExcelCompatibility) {
         {123.40, "123.4"},
         {0.0, "0"},
         {-1000.0, "-1000"},
-        {1234.567890, "1234.57"}
+        {1234.567890, "1234.56789"}
     };
     
     for (const auto& testCase : testCases) {
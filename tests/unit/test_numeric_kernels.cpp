@@ -0,0 +1,132 @@
+//
+// @file test_numeric_kernels.cpp
+// @brief 聚合内核和聚合函数快速路径测试
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXNumericKernels.hpp"
+#include "TinaXlsx/TXFormula.hpp"
+#include "TinaXlsx/TXCellManager.hpp"
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace TinaXlsx;
+
+TEST(TXNumericKernelsTest, AllLevelsMatchScalar) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> value(-1000.0, 1000.0);
+    std::uniform_int_distribution<int> tag(0, 3);
+
+    // 各种长度覆盖向量主循环和尾部
+    for (std::size_t count : {0u, 1u, 3u, 7u, 8u, 9u, 255u, 256u, 1001u}) {
+        std::vector<double> values(count);
+        std::vector<u8> tags(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            // 未选中的位置放入无穷大，验证它们被掩码排除
+            tags[i] = static_cast<u8>(tag(rng));
+            values[i] = tags[i] == 3 ? value(rng) : std::numeric_limits<double>::infinity();
+        }
+
+        TXNumericAccumulator expected;
+        TXNumericKernels::accumulate(TXNumericKernels::Level::Scalar, values.data(), tags.data(), 3, count, expected);
+        for (auto level : {TXNumericKernels::Level::SSE2, TXNumericKernels::Level::AVX2}) {
+            TXNumericAccumulator acc;
+            TXNumericKernels::accumulate(level, values.data(), tags.data(), 3, count, acc);
+            EXPECT_EQ(acc.count, expected.count) << count;
+            EXPECT_NEAR(acc.sum, expected.sum, 1e-9 * (1.0 + count)) << count;
+            EXPECT_EQ(acc.min, expected.min) << count;
+            EXPECT_EQ(acc.max, expected.max) << count;
+        }
+    }
+}
+
+TEST(TXNumericKernelsTest, NaNPropagatesToMinAndMaxAtEveryLevel) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    // NaN 放在向量主循环、跨块位置和尾部的每个位置
+    for (std::size_t count : {1u, 3u, 8u, 9u, 37u}) {
+        for (std::size_t pos = 0; pos < count; ++pos) {
+            std::vector<double> values(count);
+            std::vector<u8> tags(count, 3);
+            for (std::size_t i = 0; i < count; ++i) {
+                values[i] = static_cast<double>(i) - 4.0;
+            }
+            values[pos] = nan;
+
+            for (auto level : {TXNumericKernels::Level::Scalar, TXNumericKernels::Level::SSE2,
+                               TXNumericKernels::Level::AVX2}) {
+                TXNumericAccumulator acc;
+                TXNumericKernels::accumulate(level, values.data(), tags.data(), 3, count, acc);
+                EXPECT_EQ(acc.count, count);
+                EXPECT_TRUE(std::isnan(acc.sum)) << count << " " << pos;
+                EXPECT_TRUE(std::isnan(acc.min)) << count << " " << pos << " level " << static_cast<int>(level);
+                EXPECT_TRUE(std::isnan(acc.max)) << count << " " << pos << " level " << static_cast<int>(level);
+            }
+
+            // 未选中位置上的 NaN 不参与计算
+            tags[pos] = 0;
+            for (auto level : {TXNumericKernels::Level::Scalar, TXNumericKernels::Level::SSE2,
+                               TXNumericKernels::Level::AVX2}) {
+                TXNumericAccumulator acc;
+                TXNumericKernels::accumulate(level, values.data(), tags.data(), 3, count, acc);
+                EXPECT_EQ(acc.count, count - 1);
+                EXPECT_FALSE(std::isnan(acc.min)) << count << " " << pos;
+                EXPECT_FALSE(std::isnan(acc.max)) << count << " " << pos;
+            }
+        }
+    }
+
+    // 先累加的段已经是 NaN 时，之后的段不会把它覆盖
+    const double finite[] = {1.0, 2.0, 3.0, 4.0, 5.0};
+    const u8 finiteTags[] = {3, 3, 3, 3, 3};
+    for (auto level : {TXNumericKernels::Level::Scalar, TXNumericKernels::Level::SSE2,
+                       TXNumericKernels::Level::AVX2}) {
+        TXNumericAccumulator acc;
+        acc.add(nan);
+        TXNumericKernels::accumulate(level, finite, finiteTags, 3, 5, acc);
+        EXPECT_TRUE(std::isnan(acc.min));
+        EXPECT_TRUE(std::isnan(acc.max));
+    }
+}
+
+TEST(TXNumericKernelsTest, AggregatesOverLargeMixedColumn) {
+    TXCellManager cells;
+    constexpr u32 kRows = 100000;
+    double sum = 0.0;
+    double low = 0.0;
+    double high = 0.0;
+    u32 count = 0;
+    for (u32 r = 1; r <= kRows; r += 2) {
+        // 奇数行为 double，每 1000 行放一个整数和一个可转换的字符串
+        const double v = static_cast<double>(r % 977) - 400.0;
+        cells.setCellValue(TXCoordinate(row_t(r), column_t(1)), v);
+        sum += v;
+        low = count == 0 ? v : std::min(low, v);
+        high = count == 0 ? v : std::max(high, v);
+        ++count;
+    }
+    for (u32 r = 1000; r <= kRows; r += 1000) {
+        cells.setCellValue(TXCoordinate(row_t(r), column_t(1)), static_cast<int64_t>(5000));
+        cells.setCellValue(TXCoordinate(row_t(r - 1), column_t(2)), std::string("2.5"));
+        sum += 5000.0;
+        high = 5000.0;
+        ++count;
+    }
+
+    auto eval = [&cells](const std::string& text) {
+        TXFormula formula(text);
+        auto result = formula.evaluate(cells, row_t(1), column_t(10));
+        EXPECT_EQ(formula.getLastError(), TXFormula::FormulaError::None) << text;
+        return std::holds_alternative<double>(result) ? std::get<double>(result) : 0.0;
+    };
+    EXPECT_DOUBLE_EQ(eval("=SUM(A:A)"), sum);
+    EXPECT_DOUBLE_EQ(eval("=SUM(A1:B100000)"), sum + 2.5 * 100);
+    EXPECT_DOUBLE_EQ(eval("=AVERAGE(A:A)"), sum / count);
+    EXPECT_DOUBLE_EQ(eval("=COUNT(A:A,Z1)"), count);
+    EXPECT_DOUBLE_EQ(eval("=MAX(A:A)"), high);
+    EXPECT_DOUBLE_EQ(eval("=MIN(A1:A100000,-1000)"), -1000.0);
+    EXPECT_DOUBLE_EQ(eval("=MIN(A:A)"), low);
+    EXPECT_DOUBLE_EQ(eval("=MAX(C:C)"), 0.0);
+    EXPECT_DOUBLE_EQ(eval("=SUM(A2:A2)"), 0.0);
+}
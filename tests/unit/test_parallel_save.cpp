@@ -0,0 +1,195 @@
+//
+// @file test_parallel_save.cpp
+// @brief 多线程保存和加载测试
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXWorkbook.hpp"
+#include "TinaXlsx/TXSheet.hpp"
+#include "TinaXlsx/TXZipArchive.hpp"
+#include "TinaXlsx/TXDeflate.hpp"
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace TinaXlsx;
+
+class TXParallelSaveTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        std::remove(serialFile_.c_str());
+        std::remove(parallelFile_.c_str());
+    }
+
+    static void fillWorkbook(TXWorkbook& workbook) {
+        for (int s = 0; s < 6; ++s) {
+            TXSheet* sheet = workbook.addSheet("Sheet" + std::to_string(s + 1));
+            ASSERT_NE(sheet, nullptr);
+            for (u32 r = 1; r <= 500; ++r) {
+                // 各表之间有重复字符串，验证共享字符串索引的合并顺序
+                sheet->setCellValue(row_t(r), column_t(1), std::string("name_") + std::to_string((r + s) % 37));
+                sheet->setCellValue(row_t(r), column_t(2), static_cast<double>(r) * 0.5 + s);
+                sheet->setCellValue(row_t(r), column_t(3), static_cast<int64_t>(r * (s + 1)));
+                sheet->setCellValue(row_t(r), column_t(4), std::string("x"));
+            }
+        }
+    }
+
+    static std::vector<uint8_t> readFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    const std::string serialFile_ = "parallel_save_serial.xlsx";
+    const std::string parallelFile_ = "parallel_save_parallel.xlsx";
+};
+
+TEST_F(TXParallelSaveTest, MatchesSingleThreadedOutput) {
+    TXWorkbook workbook;
+    fillWorkbook(workbook);
+
+    // 固定时间戳，输出只取决于工作簿内容
+    TXSaveOptions serial;
+    serial.threadCount = 1;
+    serial.modifiedTime = 1700000000;
+    TXSaveOptions parallel = serial;
+    parallel.threadCount = 4;
+
+    std::vector<uint8_t> serialBytes;
+    std::vector<uint8_t> parallelBytes;
+    ASSERT_TRUE(workbook.saveToMemory(serialBytes, serial)) << workbook.getLastError();
+    ASSERT_TRUE(workbook.saveToMemory(parallelBytes, parallel)) << workbook.getLastError();
+    EXPECT_EQ(serialBytes, parallelBytes);
+
+    // 按块压缩的大表同样与线程数无关
+    serial.parallelDeflateThreshold = 1;
+    parallel.parallelDeflateThreshold = 1;
+    ASSERT_TRUE(workbook.saveToMemory(serialBytes, serial)) << workbook.getLastError();
+    ASSERT_TRUE(workbook.saveToMemory(parallelBytes, parallel)) << workbook.getLastError();
+    EXPECT_EQ(serialBytes, parallelBytes);
+
+    // 写入文件的结果也逐字节相同
+    serial.storeThreshold = 4 * 1024;
+    parallel.storeThreshold = 4 * 1024;
+    ASSERT_TRUE(workbook.saveToFile(serialFile_, serial)) << workbook.getLastError();
+    ASSERT_TRUE(workbook.saveToFile(parallelFile_, parallel)) << workbook.getLastError();
+    EXPECT_EQ(readFile(serialFile_), readFile(parallelFile_));
+}
+
+TEST_F(TXParallelSaveTest, ParallelOutputLoadsBack) {
+    TXWorkbook workbook;
+    fillWorkbook(workbook);
+
+    TXSaveOptions options;
+    options.threadCount = 0;  // 硬件并发数
+    ASSERT_TRUE(workbook.saveToFile(parallelFile_, options)) << workbook.getLastError();
+
+    TXWorkbook loaded;
+    ASSERT_TRUE(loaded.loadFromFile(parallelFile_)) << loaded.getLastError();
+    ASSERT_EQ(loaded.getSheetCount(), 6u);
+    TXSheet* sheet = loaded.getSheet("Sheet6");
+    ASSERT_NE(sheet, nullptr);
+    EXPECT_EQ(sheet->getCellValue(row_t(11), column_t(1)), TXCell::CellValue(std::string("name_16")));
+    EXPECT_EQ(sheet->getCellValue(row_t(11), column_t(2)), TXCell::CellValue(10.5));
+    EXPECT_EQ(sheet->getCellValue(row_t(11), column_t(3)), TXCell::CellValue(static_cast<int64_t>(66)));
+    EXPECT_EQ(sheet->getCellValue(row_t(11), column_t(4)), TXCell::CellValue(std::string("x")));
+}
+
+TEST_F(TXParallelSaveTest, BlockParallelDeflateRoundTrips) {
+    // 可压缩但不完全重复的数据，跨越多个块
+    std::string data;
+    for (int i = 0; i < 200000; ++i) {
+        data += "<c r=\"A" + std::to_string(i) + "\"><v>" + std::to_string(i * 7 % 1000) + "</v></c>";
+    }
+
+    auto single = TXDeflate::compress(data.data(), data.size());
+    auto blocks = TXDeflate::compressParallel(data.data(), data.size(), 6, 4, 64 * 1024);
+    ASSERT_TRUE(single.isOk());
+    ASSERT_TRUE(blocks.isOk());
+    EXPECT_EQ(blocks.value().crc32, single.value().crc32);
+    EXPECT_EQ(blocks.value().uncompressedSize, data.size());
+
+    {
+        TXZipArchiveWriter writer;
+        ASSERT_TRUE(writer.open(parallelFile_).isOk());
+        ASSERT_TRUE(writer.writeDeflated("big.xml", blocks.value()).isOk());
+    }
+
+    TXZipArchiveReader reader;
+    ASSERT_TRUE(reader.open(parallelFile_).isOk());
+    auto content = reader.readString("big.xml");
+    ASSERT_TRUE(content.isOk()) << content.error().getMessage();
+    EXPECT_EQ(content.value(), data);
+}
+
+TEST_F(TXParallelSaveTest, LargeSheetUsesBlockCompression) {
+    TXWorkbook workbook;
+    fillWorkbook(workbook);
+
+    TXSaveOptions options;
+    options.threadCount = 4;
+    options.parallelDeflateThreshold = 1;  // 所有工作表都按块压缩
+    ASSERT_TRUE(workbook.saveToFile(parallelFile_, options)) << workbook.getLastError();
+
+    TXWorkbook loaded;
+    ASSERT_TRUE(loaded.loadFromFile(parallelFile_)) << loaded.getLastError();
+    TXSheet* sheet = loaded.getSheet("Sheet3");
+    ASSERT_NE(sheet, nullptr);
+    EXPECT_EQ(sheet->getCellValue(row_t(500), column_t(1)), TXCell::CellValue(std::string("name_21")));
+    EXPECT_EQ(sheet->getCellValue(row_t(500), column_t(3)), TXCell::CellValue(static_cast<int64_t>(1500)));
+}
+
+TEST_F(TXParallelSaveTest, StoresPartsBelowThreshold) {
+    TXWorkbook workbook;
+    fillWorkbook(workbook);
+
+    TXSaveOptions options = TXSaveOptions::fast();
+    ASSERT_TRUE(workbook.saveToFile(serialFile_, options)) << workbook.getLastError();
+
+    TXZipArchiveReader reader;
+    ASSERT_TRUE(reader.open(serialFile_).isOk());
+    auto entries = reader.entries();
+    ASSERT_TRUE(entries.isOk());
+    for (const ZipEntry& entry : entries.value()) {
+        if (entry.uncompressed_size < options.storeThreshold) {
+            EXPECT_EQ(entry.compressed_size, entry.uncompressed_size) << entry.filename;
+        } else {
+            EXPECT_LT(entry.compressed_size, entry.uncompressed_size) << entry.filename;
+        }
+    }
+
+    TXWorkbook loaded;
+    ASSERT_TRUE(loaded.loadFromFile(serialFile_)) << loaded.getLastError();
+    EXPECT_EQ(loaded.getSheetCount(), 6u);
+}
+
+TEST_F(TXParallelSaveTest, ParallelLoadMatchesSerialLoad) {
+    TXWorkbook workbook;
+    fillWorkbook(workbook);
+    ASSERT_TRUE(workbook.saveToFile(serialFile_)) << workbook.getLastError();
+
+    TXWorkbook serial;
+    ASSERT_TRUE(serial.loadFromFile(serialFile_)) << serial.getLastError();
+
+    TXLoadOptions options;
+    options.threadCount = 4;
+    TXWorkbook parallel;
+    ASSERT_TRUE(parallel.loadFromFile(serialFile_, options)) << parallel.getLastError();
+
+    ASSERT_EQ(parallel.getSheetCount(), serial.getSheetCount());
+    for (u64 s = 0; s < serial.getSheetCount(); ++s) {
+        TXSheet* expected = serial.getSheet(s);
+        TXSheet* actual = parallel.getSheet(s);
+        ASSERT_NE(actual, nullptr);
+        EXPECT_FALSE(actual->isModified());
+        for (u32 r = 1; r <= 500; r += 7) {
+            for (u32 c = 1; c <= 4; ++c) {
+                EXPECT_EQ(actual->getCellValue(row_t(r), column_t(c)), expected->getCellValue(row_t(r), column_t(c)))
+                    << "sheet " << s << " row " << r << " column " << c;
+            }
+        }
+    }
+}
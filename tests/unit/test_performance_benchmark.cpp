@@ -1,13 +1,57 @@
 #include <gtest/gtest.h>
 #include "TinaXlsx/TinaXlsx.hpp"
+#include "TinaXlsx/TXNumberUtils.hpp"
+#include "TinaXlsx/TXXmlStreamWriter.hpp"
+#include "TinaXlsx/TXSharedStringsPool.hpp"
 #include <chrono>
 #include <cstdio>
 #include <filesystem>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <random>
+#include <sstream>
+#include <unordered_map>
 
 using namespace TinaXlsx;
 
+namespace {
+
+// 原共享字符串池的实现（每个字符串存三份、命中时两次哈希查找），作为对照组
+class LegacySharedStringsPool {
+public:
+    u32 add(const std::string& str) {
+        if (auto it = m_uniqueIndexMap.find(str); it != m_uniqueIndexMap.end()) {
+            m_frequencyMap[str]++;
+            return it->second;
+        }
+        const u32 newIndex = static_cast<u32>(m_strings.size());
+        m_strings.push_back(str);
+        m_uniqueIndexMap[str] = newIndex;
+        m_frequencyMap[str] = 1;
+        return newIndex;
+    }
+
+    std::size_t size() const { return m_strings.size(); }
+
+private:
+    std::vector<std::string> m_strings;
+    std::unordered_map<std::string, u32> m_uniqueIndexMap;
+    std::unordered_map<std::string, int> m_frequencyMap;
+};
+
+// 原 formatForExcelXml 的小数路径（每次构造 ostringstream、固定两位小数），作为对照组
+std::string legacyFormatForExcelXml(double value) {
+    if (TXNumberUtils::isInteger(value)) {
+        return std::to_string(static_cast<long long>(value));
+    }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << value;
+    return TXNumberUtils::removeTrailingZeros(oss.str());
+}
+
+} // namespace
+
 class PerformanceBenchmarkTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -320,3 +364,214 @@ TEST_F(PerformanceBenchmarkTest, FileSavePerformance) {
     double avg_time_per_save = time_ms / SAVE_COUNT;
     EXPECT_LT(avg_time_per_save, 200.0); // 每次保存应少于200ms
 }
+
+// 测试大工作表保存性能（工作表直接流式写入 ZIP 条目）
+TEST_F(PerformanceBenchmarkTest, LargeSheetSavePerformance) {
+    const int ROWS = 20000;
+    const int COLS = 8;
+    std::string output_file = benchmark_dir + "/large_sheet_save.xlsx";
+
+    auto workbook = std::make_unique<TXWorkbook>();
+    auto* sheet = workbook->addSheet("大表");
+    for (int row = 1; row <= ROWS; ++row) {
+        sheet->setCellValue(row_t(row), column_t(1), "项目_" + std::to_string(row % 100));
+        for (int col = 2; col <= COLS; ++col) {
+            sheet->setCellValue(row_t(row), column_t(col), row * col * 0.25);
+        }
+    }
+
+    bool saved = false;
+    double time_ms = measureExecutionTime([&]() {
+        saved = workbook->saveToFile(output_file);
+    });
+
+    printPerformanceReport("大工作表保存", time_ms, ROWS * COLS,
+                           "文件大小: " + std::to_string(std::filesystem::file_size(output_file)) + " bytes");
+
+    EXPECT_TRUE(saved) << workbook->getLastError();
+    EXPECT_LT(time_ms, 5000.0); // 16 万个单元格应在5秒内保存完成
+}
+
+// 不同压缩级别下的保存耗时与文件大小
+TEST_F(PerformanceBenchmarkTest, CompressionLevelTradeoff) {
+    const int ROWS = 20000;
+    const int COLS = 8;
+
+    auto workbook = std::make_unique<TXWorkbook>();
+    auto* sheet = workbook->addSheet("压缩级别");
+    for (int row = 1; row <= ROWS; ++row) {
+        sheet->setCellValue(row_t(row), column_t(1), "项目_" + std::to_string(row % 100));
+        for (int col = 2; col <= COLS; ++col) {
+            sheet->setCellValue(row_t(row), column_t(col), row * col * 0.25);
+        }
+    }
+
+    struct Mode {
+        std::string name;
+        TXSaveOptions options;
+    };
+    std::vector<Mode> modes = {{"fast (level 1, store < 4KB)", TXSaveOptions::fast()}};
+    for (int level : {1, 6, 9}) {
+        TXSaveOptions options;
+        options.compressionLevel = level;
+        modes.push_back({"level " + std::to_string(level), options});
+    }
+    modes.push_back({"maxRatio (level 9)", TXSaveOptions::maxRatio()});
+
+    std::vector<std::uintmax_t> sizes;
+    for (std::size_t i = 0; i < modes.size(); ++i) {
+        std::string output_file = benchmark_dir + "/compression_level_" + std::to_string(i) + ".xlsx";
+        bool saved = false;
+        double time_ms = measureExecutionTime([&]() {
+            saved = workbook->saveToFile(output_file, modes[i].options);
+        });
+        ASSERT_TRUE(saved) << workbook->getLastError();
+        sizes.push_back(std::filesystem::file_size(output_file));
+        printPerformanceReport("保存 " + modes[i].name, time_ms, ROWS * COLS,
+                               "文件大小: " + std::to_string(sizes.back()) + " bytes");
+    }
+
+    // 级别 1 的文件不会比级别 9 的小
+    EXPECT_GE(sizes[1], sizes[3]);
+}
+
+// 对比节点树序列化与直接输出的速度（相同的工作表内容）
+TEST_F(PerformanceBenchmarkTest, XmlEmitterVsNodeBuilder) {
+    const int ROWS = 20000;
+    const int COLS = 8;
+
+    std::vector<std::string> columnNames;
+    for (int col = 1; col <= COLS; ++col) {
+        columnNames.push_back(column_t::column_string_from_index(col));
+    }
+
+    std::string treeXml;
+    double tree_ms = measureExecutionTime([&]() {
+        XmlNodeBuilder sheetData("sheetData");
+        for (int row = 1; row <= ROWS; ++row) {
+            XmlNodeBuilder rowNode("row");
+            rowNode.addAttribute("r", std::to_string(row));
+            for (int col = 1; col <= COLS; ++col) {
+                XmlNodeBuilder cell("c");
+                cell.addAttribute("r", columnNames[col - 1] + std::to_string(row));
+                cell.addChild(XmlNodeBuilder("v").setText(std::to_string(row * col)));
+                rowNode.addChild(cell);
+            }
+            sheetData.addChild(rowNode);
+        }
+        XmlWriteOptions options;
+        options.include_declaration = false;
+        TXXmlWriter writer(options);
+        ASSERT_TRUE(writer.setRootNode(sheetData).isOk());
+        treeXml = writer.generateXmlString().value();
+    });
+
+    std::string streamXml;
+    double stream_ms = measureExecutionTime([&]() {
+        TXXmlStreamWriter xml;
+        xml.startElement("sheetData");
+        for (int row = 1; row <= ROWS; ++row) {
+            const std::string rowText = std::to_string(row);
+            xml.startElement("row").attributeRaw("r", rowText);
+            for (int col = 1; col <= COLS; ++col) {
+                xml.startElement("c").attributeRaw("r", columnNames[col - 1] + rowText);
+                xml.startElement("v").text(row * col).endElement("v");
+                xml.endElement("c");
+            }
+            xml.endElement("row");
+        }
+        xml.endElement("sheetData");
+        streamXml = xml.takeBuffer();
+    });
+
+    printPerformanceReport("XmlNodeBuilder 序列化", tree_ms, ROWS * COLS);
+    printPerformanceReport("TXXmlStreamWriter 直接输出", stream_ms, ROWS * COLS,
+                           "加速比: " + std::to_string(tree_ms / (stream_ms > 0 ? stream_ms : 1e-3)) + "x");
+
+    EXPECT_EQ(treeXml, streamXml);
+    EXPECT_LT(stream_ms, tree_ms);
+}
+
+// 测试共享字符串池：分块存储 + 开放寻址 vs 原 vector + 两个 unordered_map
+TEST_F(PerformanceBenchmarkTest, SharedStringsPoolVsLegacy) {
+    const int CELLS = 1000000;
+    const int UNIQUE = 100000;
+
+    std::vector<std::string> values;
+    values.reserve(CELLS);
+    for (int i = 0; i < CELLS; ++i) {
+        values.push_back("customer_name_" + std::to_string(static_cast<u64>(i) * 7919 % UNIQUE));
+    }
+
+    u64 legacyChecksum = 0;
+    std::size_t legacyUnique = 0;
+    double legacy_ms = measureExecutionTime([&]() {
+        LegacySharedStringsPool pool;
+        for (const auto& value : values) {
+            legacyChecksum += pool.add(value);
+        }
+        legacyUnique = pool.size();
+    });
+
+    u64 poolChecksum = 0;
+    std::size_t poolUnique = 0;
+    std::size_t poolMemory = 0;
+    double pool_ms = measureExecutionTime([&]() {
+        TXSharedStringsPool pool;
+        for (const auto& value : values) {
+            poolChecksum += pool.add(value);
+        }
+        poolUnique = pool.size();
+        poolMemory = pool.memoryUsage();
+    });
+
+    printPerformanceReport("原共享字符串池", legacy_ms, CELLS);
+    printPerformanceReport("TXSharedStringsPool", pool_ms, CELLS,
+                           "加速比: " + std::to_string(legacy_ms / (pool_ms > 0 ? pool_ms : 1e-3)) +
+                           "x, 内存: " + std::to_string(poolMemory / 1024) + " KB");
+
+    EXPECT_EQ(poolUnique, static_cast<std::size_t>(UNIQUE));
+    EXPECT_EQ(poolUnique, legacyUnique);
+    EXPECT_EQ(poolChecksum, legacyChecksum);
+    EXPECT_LT(pool_ms, legacy_ms);
+}
+
+TEST_F(PerformanceBenchmarkTest, NumberToXmlVsLegacy) {
+    const int VALUES = 1000000;
+
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<double> dis(-1e6, 1e6);
+    std::vector<double> values(VALUES);
+    for (auto& value : values) {
+        value = dis(gen);
+    }
+
+    std::size_t legacyBytes = 0;
+    double legacy_ms = measureExecutionTime([&]() {
+        for (double value : values) {
+            legacyBytes += legacyFormatForExcelXml(value).size();
+        }
+    });
+
+    std::size_t fastBytes = 0;
+    std::size_t roundTrips = 0;
+    double fast_ms = measureExecutionTime([&]() {
+        char buffer[TXNumberUtils::EXCEL_XML_NUMBER_BUFFER_SIZE];
+        for (double value : values) {
+            fastBytes += TXNumberUtils::formatForExcelXml(value, buffer);
+        }
+    });
+    for (double value : values) {
+        roundTrips += TXNumberUtils::parseDouble(TXNumberUtils::formatForExcelXml(value)) == value;
+    }
+
+    printPerformanceReport("ostringstream 两位小数（原实现）", legacy_ms, VALUES,
+                           "输出: " + std::to_string(legacyBytes / 1024) + " KB");
+    printPerformanceReport("formatForExcelXml 最短往返", fast_ms, VALUES,
+                           "加速比: " + std::to_string(legacy_ms / (fast_ms > 0 ? fast_ms : 1e-3)) +
+                           "x, 输出: " + std::to_string(fastBytes / 1024) + " KB");
+
+    // 新实现更快，并且每个值都能精确还原
+    EXPECT_EQ(roundTrips, static_cast<std::size_t>(VALUES));
+    EXPECT_LT(fast_ms, legacy_ms);
+}
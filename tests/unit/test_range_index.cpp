@@ -0,0 +1,172 @@
+//
+// @file test_range_index.cpp
+// @brief 范围空间索引和基于范围的公式依赖测试
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXRangeIndex.hpp"
+#include "TinaXlsx/TXCellManager.hpp"
+#include "TinaXlsx/TXFormulaManager.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+
+using namespace TinaXlsx;
+
+namespace {
+
+TXRange makeRange(u32 top, u32 left, u32 bottom, u32 right) {
+    return TXRange(TXCoordinate(row_t(top), column_t(left)), TXCoordinate(row_t(bottom), column_t(right)));
+}
+
+std::vector<u32> query(const TXRangeIndex& index, u32 row, u32 col) {
+    std::vector<u32> ids;
+    index.forEachContaining(TXCoordinate(row_t(row), column_t(col)), [&ids](u32 id) { ids.push_back(id); });
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+} // namespace
+
+TEST(TXRangeIndexTest, FindsContainingRanges) {
+    TXRangeIndex index;
+    EXPECT_TRUE(query(index, 1, 1).empty());
+
+    index.insert(0, makeRange(1, 1, 100000, 1));    // A1:A100000
+    index.insert(1, makeRange(5, 1, 5, 3));         // A5:C5
+    index.insert(2, makeRange(10, 2, 20, 4));       // B10:D20
+    EXPECT_EQ(index.size(), 3u);
+
+    EXPECT_EQ(query(index, 5, 1), (std::vector<u32>{0, 1}));
+    EXPECT_EQ(query(index, 99999, 1), (std::vector<u32>{0}));
+    EXPECT_EQ(query(index, 15, 3), (std::vector<u32>{2}));
+    EXPECT_TRUE(query(index, 100001, 1).empty());
+
+    // 同一编号再次插入时替换原范围
+    index.insert(0, makeRange(1, 2, 1, 2));
+    EXPECT_EQ(index.size(), 3u);
+    EXPECT_EQ(query(index, 5, 1), (std::vector<u32>{1}));
+    EXPECT_EQ(query(index, 1, 2), (std::vector<u32>{0}));
+
+    index.erase(1);
+    index.erase(1);
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_TRUE(query(index, 5, 1).empty());
+
+    index.clear();
+    EXPECT_TRUE(index.empty());
+    EXPECT_TRUE(query(index, 1, 2).empty());
+}
+
+TEST(TXRangeIndexTest, MatchesBruteForceAcrossRebuilds) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<u32> coord(1, 200);
+    std::uniform_int_distribution<u32> extent(0, 30);
+
+    TXRangeIndex index;
+    std::map<u32, TXRange> expected;
+    auto check = [&]() {
+        for (int probe = 0; probe < 200; ++probe) {
+            const u32 row = coord(rng);
+            const u32 col = coord(rng);
+            std::vector<u32> brute;
+            for (const auto& entry : expected) {
+                if (entry.second.contains(TXCoordinate(row_t(row), column_t(col)))) {
+                    brute.push_back(entry.first);
+                }
+            }
+            ASSERT_EQ(query(index, row, col), brute) << row << "," << col;
+        }
+    };
+
+    // 交替进行批量插入、删除和查询，覆盖尾部扫描、墓碑和重新打包
+    u32 nextId = 0;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 150; ++i) {
+            const u32 top = coord(rng);
+            const u32 left = coord(rng);
+            const TXRange range = makeRange(top, left, top + extent(rng), left + extent(rng));
+            index.insert(nextId, range);
+            expected[nextId] = range;
+            ++nextId;
+        }
+        check();
+        for (int i = 0; i < 100 && !expected.empty(); ++i) {
+            auto it = expected.begin();
+            std::advance(it, rng() % expected.size());
+            index.erase(it->first);
+            expected.erase(it);
+        }
+        EXPECT_EQ(index.size(), expected.size());
+        check();
+    }
+}
+
+class TXRangeDependencyTest : public ::testing::Test {
+protected:
+    static TXCoordinate at(u32 row, u32 col) {
+        return TXCoordinate(row_t(row), column_t(col));
+    }
+
+    void setFormula(u32 row, u32 col, const std::string& formula) {
+        ASSERT_TRUE(formulas_.setCellFormula(at(row, col), formula, cells_)) << formula;
+    }
+
+    TXCellManager cells_;
+    TXFormulaManager formulas_;
+};
+
+TEST_F(TXRangeDependencyTest, LargeRangesAreNotExpanded) {
+    // 1000 个公式都汇总 A1:A100000，依赖关系只占 1000 条范围记录
+    for (u32 r = 1; r <= 1000; ++r) {
+        setFormula(r, 2, "=SUM(A1:A100000)+" + std::to_string(r));
+    }
+    cells_.setCellValue(at(50000, 1), 7.0);
+    EXPECT_EQ(formulas_.calculateAllFormulas(cells_), 1000u);
+    EXPECT_EQ(cells_.getCellValue(at(1000, 2)), TXCell::CellValue(1007.0));
+
+    EXPECT_TRUE(formulas_.getDirectDependencies(at(1, 2), cells_).empty());
+    ASSERT_EQ(formulas_.getDirectRangeDependencies(at(1, 2), cells_).size(), 1u);
+    EXPECT_EQ(formulas_.getDirectRangeDependencies(at(1, 2), cells_)[0], TXRange::fromAddress("A1:A100000"));
+    EXPECT_EQ(formulas_.getDependents(at(99999, 1), cells_).size(), 1000u);
+    EXPECT_TRUE(formulas_.getDependents(at(100001, 1), cells_).empty());
+
+    cells_.setCellValue(at(100000, 1), 3.0);
+    formulas_.onCellChanged(at(100000, 1));
+    EXPECT_EQ(formulas_.getDirtyFormulaCount(), 1000u);
+    EXPECT_EQ(formulas_.recalculate(cells_), 1000u);
+    EXPECT_EQ(cells_.getCellValue(at(1, 2)), TXCell::CellValue(11.0));
+
+    cells_.setCellValue(at(100001, 1), 3.0);
+    formulas_.onCellChanged(at(100001, 1));
+    EXPECT_EQ(formulas_.getDirtyFormulaCount(), 0u);
+}
+
+TEST_F(TXRangeDependencyTest, RangeChainsAndRemovals) {
+    cells_.setCellValue(at(1, 1), 1.0);
+    cells_.setCellValue(at(2, 1), 2.0);
+    setFormula(1, 2, "=SUM(A:A)");          // B1
+    setFormula(1, 3, "=SUM(B1:B10)*2");     // C1
+    setFormula(2, 3, "=SUM(1:1)");          // C2 依赖第一行（包括 C1 和 B1）
+    EXPECT_FALSE(formulas_.detectCircularReferences(cells_));
+    EXPECT_EQ(formulas_.calculateAllFormulas(cells_), 3u);
+    EXPECT_EQ(cells_.getCellValue(at(1, 3)), TXCell::CellValue(6.0));
+    EXPECT_EQ(cells_.getCellValue(at(2, 3)), TXCell::CellValue(10.0));
+
+    cells_.setCellValue(at(2, 1), 5.0);
+    formulas_.onCellChanged(at(2, 1));
+    EXPECT_EQ(formulas_.recalculate(cells_), 3u);
+    EXPECT_EQ(cells_.getCellValue(at(2, 3)), TXCell::CellValue(19.0));
+
+    // 替换公式后，不再有公式引用的范围也从索引中移除
+    setFormula(1, 3, "=1");
+    EXPECT_TRUE(formulas_.getDependents(at(5, 2), cells_).empty());
+
+    // 范围引用形成的循环
+    setFormula(5, 1, "=SUM(A1:A4)+C2");
+    EXPECT_TRUE(formulas_.detectCircularReferences(cells_));
+    auto cycles = formulas_.getCircularReferences(cells_);
+    ASSERT_EQ(cycles.size(), 1u);
+    EXPECT_EQ(cycles[0].size(), 3u);
+}
@@ -0,0 +1,109 @@
+//
+// @file test_shared_string_table.cpp
+// @brief 紧凑共享字符串表及其流式加载测试
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXSharedStringTable.hpp"
+#include "TinaXlsx/TXWorkbook.hpp"
+#include "TinaXlsx/TXSheet.hpp"
+#include "TinaXlsx/TXZipArchive.hpp"
+#include <string>
+#include <vector>
+
+using namespace TinaXlsx;
+
+TEST(TXSharedStringTableTest, AppendAndGet) {
+    TXSharedStringTable table;
+    EXPECT_TRUE(table.empty());
+
+    EXPECT_EQ(table.append("alpha"), 0u);
+    EXPECT_EQ(table.append(""), 1u);
+    table.appendPart("be");
+    table.appendPart("ta");
+    EXPECT_EQ(table.commit(), 2u);
+
+    ASSERT_EQ(table.size(), 3u);
+    EXPECT_EQ(table.get(0), "alpha");
+    EXPECT_EQ(table[1], "");
+    EXPECT_EQ(table[2], "beta");
+
+    std::string_view out;
+    EXPECT_TRUE(table.tryGet(2, out));
+    EXPECT_EQ(out, "beta");
+    EXPECT_FALSE(table.tryGet(3, out));
+
+    table.clear();
+    EXPECT_TRUE(table.empty());
+    EXPECT_FALSE(table.tryGet(0, out));
+}
+
+TEST(TXSharedStringTableTest, LoadsPlainRichAndPhoneticItems) {
+    const std::string xml =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<sst xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" count=\"5\" uniqueCount=\"4\">"
+        "<si><t>plain</t></si>"
+        "<si><r><rPr><b/></rPr><t>bold </t></r><r><t xml:space=\"preserve\">and normal</t></r></si>"
+        "<si><t>漢字</t><rPh sb=\"0\" eb=\"2\"><t>かんじ</t></rPh><phoneticPr fontId=\"1\"/></si>"
+        "<si><t>a &amp; b &lt;c&gt;</t></si>"
+        "</sst>";
+
+    TXSharedStringTable table;
+    auto result = table.load(xml);
+    ASSERT_TRUE(result.isOk()) << result.error().getMessage();
+
+    ASSERT_EQ(table.size(), 4u);
+    EXPECT_EQ(table[0], "plain");
+    EXPECT_EQ(table[1], "bold and normal");
+    EXPECT_EQ(table[2], "漢字");
+    EXPECT_EQ(table[3], "a & b <c>");
+}
+
+TEST(TXSharedStringTableTest, EmptyItemsKeepIndicesAligned) {
+    const std::string xml =
+        "<sst xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" count=\"3\" uniqueCount=\"3\">"
+        "<si><t/></si><si><t>x</t></si><si/></sst>";
+
+    TXSharedStringTable table;
+    ASSERT_TRUE(table.load(xml).isOk());
+    ASSERT_EQ(table.size(), 3u);
+    EXPECT_EQ(table[0], "");
+    EXPECT_EQ(table[1], "x");
+    EXPECT_EQ(table[2], "");
+}
+
+TEST(TXSharedStringTableTest, ReportsMalformedXml) {
+    TXSharedStringTable table;
+    auto result = table.load("<sst><si><t>broken</si>");
+    EXPECT_TRUE(result.isError());
+}
+
+TEST(TXSharedStringTableTest, IgnoresOversizedUniqueCount) {
+    // uniqueCount 不可信，不能按它预留数 GB 的空间
+    TXSharedStringTable table;
+    ASSERT_TRUE(table.load("<sst uniqueCount=\"4294967295\"><si><t>a</t></si></sst>").isOk());
+    ASSERT_EQ(table.size(), 1u);
+    EXPECT_EQ(table[0], "a");
+}
+
+TEST(TXSharedStringTableTest, SavedTableWritesOnlyUniqueCount) {
+    TXWorkbook workbook;
+    TXSheet* sheet = workbook.addSheet("Data");
+    for (u32 r = 1; r <= 6; ++r) {
+        sheet->setCellValue(row_t(r), column_t(1), std::string(r % 2 ? "odd" : "even"));
+    }
+    std::vector<uint8_t> buffer;
+    ASSERT_TRUE(workbook.saveToMemory(buffer)) << workbook.getLastError();
+
+    TXZipArchiveReader reader;
+    ASSERT_TRUE(reader.openMemory(buffer.data(), buffer.size()).isOk());
+    auto xml = reader.readString("xl/sharedStrings.xml");
+    ASSERT_TRUE(xml.isOk());
+    // 6 次引用、2 个不同字符串：count 若写出必须是引用总数，这里不写
+    EXPECT_NE(xml.value().find("uniqueCount=\"2\""), std::string::npos);
+    EXPECT_EQ(xml.value().find(" count="), std::string::npos);
+
+    TXSharedStringTable table;
+    ASSERT_TRUE(table.load(xml.value()).isOk());
+    EXPECT_EQ(table.size(), 2u);
+}
@@ -0,0 +1,95 @@
+//
+// @file test_shared_strings_pool.cpp
+// @brief 共享字符串池测试
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXSharedStringsPool.hpp"
+#include <string>
+
+using namespace TinaXlsx;
+
+TEST(TXSharedStringsPoolTest, DeduplicatesInInsertionOrder) {
+    TXSharedStringsPool pool;
+    EXPECT_FALSE(pool.isDirty());
+
+    EXPECT_EQ(pool.add("apple"), 0u);
+    EXPECT_EQ(pool.add("banana"), 1u);
+    EXPECT_EQ(pool.add(std::string("apple")), 0u);
+    EXPECT_EQ(pool.add(""), 2u);
+    EXPECT_EQ(pool.add(""), 2u);
+
+    ASSERT_EQ(pool.size(), 3u);
+    EXPECT_TRUE(pool.isDirty());
+    EXPECT_EQ(pool.getStrings()[0], "apple");
+    EXPECT_EQ(pool.get(1), "banana");
+    EXPECT_EQ(pool.get(2), "");
+
+    u32 index = 99;
+    EXPECT_TRUE(pool.find("banana", index));
+    EXPECT_EQ(index, 1u);
+    EXPECT_FALSE(pool.find("cherry", index));
+}
+
+TEST(TXSharedStringsPoolTest, KeepsIndicesAndViewsAcrossGrowth) {
+    TXSharedStringsPool pool;
+    const u32 count = 50000;
+    for (u32 i = 0; i < count; ++i) {
+        ASSERT_EQ(pool.add("value_" + std::to_string(i)), i);
+    }
+    // 超过分块大小的长字符串单独存放
+    const std::string longText(200 * 1024, 'x');
+    EXPECT_EQ(pool.add(longText), count);
+
+    for (u32 i = 0; i < count; i += 997) {
+        EXPECT_EQ(pool.add("value_" + std::to_string(i)), i);
+        EXPECT_EQ(pool.get(i), "value_" + std::to_string(i));
+    }
+    EXPECT_EQ(pool.add(longText), count);
+    EXPECT_EQ(pool.get(count), longText);
+    EXPECT_GT(pool.memoryUsage(), longText.size());
+
+    // 移动后视图仍然有效，原对象为空且可继续使用
+    std::string_view first = pool.get(0);
+    TXSharedStringsPool moved(std::move(pool));
+    EXPECT_EQ(moved.get(0).data(), first.data());
+    EXPECT_EQ(moved.add("value_1"), 1u);
+    EXPECT_EQ(pool.size(), 0u);
+    EXPECT_EQ(pool.add("fresh"), 0u);
+}
+
+TEST(TXSharedStringsPoolTest, FrequencyTrackingIsOptIn) {
+    TXSharedStringsPool pool;
+    pool.add("a");
+    pool.add("a");
+    EXPECT_FALSE(pool.isFrequencyTrackingEnabled());
+    EXPECT_EQ(pool.getFrequency(0), 0u);
+
+    pool.setFrequencyTracking(true);
+    EXPECT_EQ(pool.getFrequency(0), 1u);
+    pool.add("a");
+    pool.add("b");
+    pool.add("b");
+    pool.add("b");
+    EXPECT_EQ(pool.getFrequency(0), 2u);
+    EXPECT_EQ(pool.getFrequency(1), 3u);
+
+    pool.reset();
+    EXPECT_TRUE(pool.isFrequencyTrackingEnabled());
+    EXPECT_EQ(pool.add("b"), 0u);
+    EXPECT_EQ(pool.getFrequency(0), 1u);
+}
+
+TEST(TXSharedStringsPoolTest, ResetClearsStringsAndReserveKeepsLookups) {
+    TXSharedStringsPool pool;
+    pool.add("x");
+    pool.reset();
+    EXPECT_EQ(pool.size(), 0u);
+    EXPECT_FALSE(pool.isDirty());
+
+    pool.add("y");
+    pool.reserve(10000);
+    EXPECT_EQ(pool.add("y"), 0u);
+    EXPECT_EQ(pool.add("z", TXSharedStringsPool::hash("z")), 1u);
+    EXPECT_EQ(pool.add("z"), 1u);
+}
@@ -0,0 +1,111 @@
+//
+// @file test_sheet_reader.cpp
+// @brief 只进逐行读取器测试
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXSheetReader.hpp"
+#include "TinaXlsx/TXWorkbook.hpp"
+#include "TinaXlsx/TXSheet.hpp"
+#include <cstdio>
+#include <string>
+
+using namespace TinaXlsx;
+
+class TXSheetReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        TXWorkbook workbook;
+        TXSheet* summary = workbook.addSheet("Summary");
+        summary->setCellValue("A1", std::string("only one row"));
+
+        TXSheet* data = workbook.addSheet("Data");
+        for (u32 r = 1; r <= kRows; ++r) {
+            data->setCellValue(row_t(r), column_t(1), static_cast<double>(r) + 0.5);
+            data->setCellValue(row_t(r), column_t(2), std::string("name_") + std::to_string(r % 10));
+            data->setCellValue(row_t(r), column_t(4), r % 2 == 0);
+        }
+        // 内联字符串（含特殊字符）
+        data->setCellValue(row_t(1), column_t(3), std::string("a&b"));
+        ASSERT_TRUE(workbook.saveToFile(filename_)) << workbook.getLastError();
+    }
+
+    void TearDown() override {
+        std::remove(filename_.c_str());
+    }
+
+    static constexpr u32 kRows = 5000;
+    const std::string filename_ = "sheet_reader_test.xlsx";
+};
+
+TEST_F(TXSheetReaderTest, ReadsRowsInOrderWithTypedViews) {
+    TXSheetReader reader;
+    auto openResult = reader.open(filename_, "Data");
+    ASSERT_TRUE(openResult.isOk()) << openResult.error().getMessage();
+
+    ASSERT_EQ(reader.getSheetNames().size(), 2u);
+    EXPECT_EQ(reader.getSheetNames()[1], "Data");
+
+    u32 expectedRow = 1;
+    while (true) {
+        auto hasRow = reader.nextRow();
+        ASSERT_TRUE(hasRow.isOk()) << hasRow.error().getMessage();
+        if (!hasRow.value()) {
+            break;
+        }
+
+        const TXRowView& row = reader.row();
+        ASSERT_EQ(row.index, expectedRow);
+
+        const TXCellView* number = row.find(1);
+        ASSERT_NE(number, nullptr);
+        ASSERT_TRUE(number->isNumber());
+        EXPECT_DOUBLE_EQ(number->number, static_cast<double>(expectedRow) + 0.5);
+
+        const TXCellView* name = row.find(2);
+        ASSERT_NE(name, nullptr);
+        ASSERT_TRUE(name->isString());
+        EXPECT_EQ(name->text, "name_" + std::to_string(expectedRow % 10));
+
+        const TXCellView* flag = row.find(4);
+        ASSERT_NE(flag, nullptr);
+        ASSERT_TRUE(flag->isBoolean());
+        EXPECT_EQ(flag->boolean, expectedRow % 2 == 0);
+
+        if (expectedRow == 1) {
+            const TXCellView* inlineText = row.find(3);
+            ASSERT_NE(inlineText, nullptr);
+            EXPECT_EQ(inlineText->text, "a&b");
+        }
+        ++expectedRow;
+    }
+    EXPECT_EQ(expectedRow, kRows + 1);
+
+    // 读到末尾后继续调用保持返回 false
+    auto again = reader.nextRow();
+    ASSERT_TRUE(again.isOk());
+    EXPECT_FALSE(again.value());
+}
+
+TEST_F(TXSheetReaderTest, OpensSheetByIndex) {
+    TXSheetReader reader;
+    ASSERT_TRUE(reader.open(filename_, 0u).isOk());
+
+    auto hasRow = reader.nextRow();
+    ASSERT_TRUE(hasRow.isOk());
+    ASSERT_TRUE(hasRow.value());
+    ASSERT_EQ(reader.row().cells.size(), 1u);
+    EXPECT_EQ(reader.row().cells[0].text, "only one row");
+
+    hasRow = reader.nextRow();
+    ASSERT_TRUE(hasRow.isOk());
+    EXPECT_FALSE(hasRow.value());
+}
+
+TEST_F(TXSheetReaderTest, ReportsMissingSheet) {
+    TXSheetReader reader;
+    auto result = reader.open(filename_, "NoSuchSheet");
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.error().getCode(), TXErrorCode::SheetNotFound);
+    EXPECT_FALSE(reader.isOpen());
+}
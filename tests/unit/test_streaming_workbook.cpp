@@ -0,0 +1,116 @@
+//
+// @file test_streaming_workbook.cpp
+// @brief 只写流式工作簿测试
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXStreamingWorkbook.hpp"
+#include "TinaXlsx/TXSheetReader.hpp"
+#include "TinaXlsx/TXWorkbook.hpp"
+#include "TinaXlsx/TXSheet.hpp"
+#include "TinaXlsx/TXStyle.hpp"
+#include <cstdio>
+#include <string>
+
+using namespace TinaXlsx;
+
+class TXStreamingWorkbookTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        std::remove(filename_.c_str());
+    }
+
+    const std::string filename_ = "streaming_workbook_test.xlsx";
+};
+
+TEST_F(TXStreamingWorkbookTest, WritesRowsReadableBySheetReader) {
+    constexpr u32 kRows = 20000;
+    {
+        TXStreamingWorkbook book;
+        ASSERT_TRUE(book.open(filename_).isOk());
+        auto sheetResult = book.addSheet("Data");
+        ASSERT_TRUE(sheetResult.isOk()) << sheetResult.error().getMessage();
+        TXStreamingSheet* sheet = sheetResult.value();
+        ASSERT_TRUE(sheet->setColumnWidth(column_t(2), 18.0).isOk());
+
+        for (u32 r = 1; r <= kRows; ++r) {
+            auto result = sheet->appendRow({
+                static_cast<double>(r) + 0.25,
+                std::string(r == 1 ? " a<b> & \"c\" " : "name_" + std::to_string(r % 10)),
+                std::monostate{},
+                r % 2 == 0,
+                static_cast<int64_t>(r) * 1000
+            });
+            ASSERT_TRUE(result.isOk()) << result.error().getMessage();
+        }
+        EXPECT_EQ(sheet->getRowCount(), kRows);
+        ASSERT_TRUE(book.close().isOk());
+        EXPECT_TRUE(sheet->isClosed());
+    }
+
+    TXSheetReader reader;
+    auto openResult = reader.open(filename_, "Data");
+    ASSERT_TRUE(openResult.isOk()) << openResult.error().getMessage();
+    EXPECT_EQ(reader.getSharedStringCount(), 0u);
+
+    u32 expectedRow = 1;
+    while (true) {
+        auto hasRow = reader.nextRow();
+        ASSERT_TRUE(hasRow.isOk()) << hasRow.error().getMessage();
+        if (!hasRow.value()) {
+            break;
+        }
+        const TXRowView& row = reader.row();
+        ASSERT_EQ(row.index, expectedRow);
+        ASSERT_EQ(row.cells.size(), 4u);  // 空单元格不写出
+
+        EXPECT_DOUBLE_EQ(row.find(1)->number, static_cast<double>(expectedRow) + 0.25);
+        EXPECT_EQ(row.find(2)->text, expectedRow == 1 ? " a<b> & \"c\" " : "name_" + std::to_string(expectedRow % 10));
+        EXPECT_EQ(row.find(3), nullptr);
+        ASSERT_TRUE(row.find(4)->isBoolean());
+        EXPECT_EQ(row.find(4)->boolean, expectedRow % 2 == 0);
+        EXPECT_DOUBLE_EQ(row.find(5)->number, static_cast<double>(expectedRow) * 1000);
+        ++expectedRow;
+    }
+    EXPECT_EQ(expectedRow, kRows + 1);
+}
+
+TEST_F(TXStreamingWorkbookTest, MultipleSheetsAndStylesLoadInWorkbook) {
+    {
+        TXStreamingWorkbook book;
+        ASSERT_TRUE(book.open(filename_).isOk());
+
+        TXCellStyle bold;
+        bold.setFontBold(true);
+        const u32 boldIndex = book.registerStyle(bold);
+        EXPECT_GT(boldIndex, 0u);
+
+        auto first = book.addSheet("First");
+        ASSERT_TRUE(first.isOk());
+        ASSERT_TRUE(first.value()->appendRow({std::string("header")}, boldIndex).isOk());
+
+        auto second = book.addSheet("Second");
+        ASSERT_TRUE(second.isOk());
+        EXPECT_TRUE(first.value()->isClosed());
+        ASSERT_TRUE(second.value()->appendRow(row_t(3), {1.5, 2.5}).isOk());
+
+        // 行号必须递增，已结束的工作表不可再写
+        EXPECT_TRUE(second.value()->appendRow(row_t(2), {1.0}).isError());
+        EXPECT_TRUE(first.value()->appendRow({1.0}).isError());
+        EXPECT_TRUE(book.addSheet("First").isError());
+
+        ASSERT_TRUE(book.close().isOk());
+    }
+
+    TXWorkbook workbook;
+    ASSERT_TRUE(workbook.loadFromFile(filename_)) << workbook.getLastError();
+    ASSERT_EQ(workbook.getSheetCount(), 2u);
+
+    TXSheet* first = workbook.getSheet("First");
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(std::get<std::string>(first->getCellValue(row_t(1), column_t(1))), "header");
+
+    TXSheet* second = workbook.getSheet("Second");
+    ASSERT_NE(second, nullptr);
+    EXPECT_DOUBLE_EQ(std::get<double>(second->getCellValue(row_t(3), column_t(2))), 2.5);
+}
@@ -0,0 +1,167 @@
+//
+// @file test_xml_sax_parser.cpp
+// @brief 流式 SAX 解析器及工作表 SAX 加载测试
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXXmlSaxParser.hpp"
+#include "TinaXlsx/TXWorksheetSaxHandler.hpp"
+#include "TinaXlsx/TXWorkbook.hpp"
+#include "TinaXlsx/TXSheet.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace TinaXlsx;
+
+namespace {
+
+/**
+ * @brief 把事件记录为字符串，便于断言
+ */
+class RecordingHandler : public TXXmlSaxHandler {
+public:
+    void onStartElement(std::string_view name, const TXXmlSaxAttributes& attributes) override {
+        std::string event = "<" + std::string(name);
+        for (const auto& attr : attributes) {
+            event += " " + std::string(attr.name) + "=" + std::string(attr.value);
+        }
+        events.push_back(event + ">");
+    }
+
+    void onEndElement(std::string_view name) override {
+        events.push_back("</" + std::string(name) + ">");
+    }
+
+    void onText(std::string_view text) override {
+        events.push_back("'" + std::string(text) + "'");
+    }
+
+    std::vector<std::string> events;
+};
+
+} // namespace
+
+TEST(XmlSaxParserTest, ParsesElementsAttributesAndText) {
+    RecordingHandler handler;
+    TXXmlSaxParser parser(handler);
+
+    auto result = parser.parse(R"(<?xml version="1.0"?><root a="1" b='x y'><c r="A1"/>text</root>)");
+    ASSERT_TRUE(result.isOk()) << result.error().getMessage();
+
+    std::vector<std::string> expected = {
+        "<root a=1 b=x y>", "<c r=A1>", "</c>", "'text'", "</root>"
+    };
+    EXPECT_EQ(handler.events, expected);
+}
+
+TEST(XmlSaxParserTest, DecodesEntitiesAndCData) {
+    RecordingHandler handler;
+    TXXmlSaxParser parser(handler);
+
+    auto result = parser.parse(
+        "<t v=\"&lt;&amp;&gt;\">a&quot;b&apos;&#65;&#x4E2D;<![CDATA[<raw>&amp;]]><!-- skip --></t>");
+    ASSERT_TRUE(result.isOk()) << result.error().getMessage();
+
+    ASSERT_EQ(handler.events.size(), 4u);
+    EXPECT_EQ(handler.events[0], "<t v=<&>>");
+    EXPECT_EQ(handler.events[1], "'a\"b'A\xE4\xB8\xAD'");
+    EXPECT_EQ(handler.events[2], "'<raw>&amp;'");
+    EXPECT_EQ(handler.events[3], "</t>");
+}
+
+TEST(XmlSaxParserTest, ChunkedInputMatchesSinglePass) {
+    const std::string xml =
+        R"(<?xml version="1.0" encoding="UTF-8"?>)"
+        R"(<worksheet><sheetData><row r="1"><c r="A1" t="s"><v>0</v></c>)"
+        R"(<c r="B1" t="inlineStr"><is><t>x &amp; y</t></is></c></row></sheetData></worksheet>)";
+
+    RecordingHandler whole;
+    TXXmlSaxParser wholeParser(whole);
+    ASSERT_TRUE(wholeParser.parse(xml).isOk());
+
+    // 每次只输入一个字节，模拟最坏情况的解压分块
+    RecordingHandler chunked;
+    TXXmlSaxParser chunkedParser(chunked);
+    for (char ch : xml) {
+        ASSERT_TRUE(chunkedParser.feed(&ch, 1).isOk());
+    }
+    ASSERT_TRUE(chunkedParser.finish().isOk());
+
+    EXPECT_EQ(whole.events, chunked.events);
+}
+
+TEST(XmlSaxParserTest, ReportsMalformedDocuments) {
+    RecordingHandler handler;
+    TXXmlSaxParser parser(handler);
+    EXPECT_TRUE(parser.parse("<a><b></b>").isError());
+    EXPECT_TRUE(parser.parse("<a b=1></a>").isError());
+    EXPECT_TRUE(parser.parse("</a>").isError());
+    EXPECT_TRUE(parser.parse("<a><b attr=\"x\"").isError());
+    EXPECT_TRUE(parser.parse("<a></b>").isError());
+    EXPECT_TRUE(parser.parse("<a><b></a></b>").isError());
+    EXPECT_TRUE(parser.parse("<x:a></a>").isError());
+    EXPECT_TRUE(parser.parse("<a><b/></a>").isOk());
+}
+
+TEST(XmlSaxParserTest, NumbersSaturateInsteadOfWrapping) {
+    EXPECT_EQ(TXWorksheetSaxHandler::parseUnsigned("4294967295"), 4294967295u);
+    EXPECT_EQ(TXWorksheetSaxHandler::parseUnsigned("4294967296"), 4294967295u);
+    EXPECT_EQ(TXWorksheetSaxHandler::parseUnsigned("99999999999999999999"), 4294967295u);
+    EXPECT_EQ(TXWorksheetSaxHandler::parseUnsigned("12x"), 12u);
+
+    u32 row = 0;
+    u32 column = 0;
+    ASSERT_TRUE(TXWorksheetSaxHandler::parseCellReference("AB12", row, column));
+    EXPECT_EQ(row, 12u);
+    EXPECT_EQ(column, 28u);
+    // 4294967297 回绕后是 1，饱和后超出工作表范围
+    ASSERT_TRUE(TXWorksheetSaxHandler::parseCellReference("A4294967297", row, column));
+    EXPECT_EQ(row, 4294967295u);
+    ASSERT_TRUE(TXWorksheetSaxHandler::parseCellReference("ZZZZZZZZZ1", row, column));
+    EXPECT_EQ(column, 4294967295u);
+}
+
+TEST(XmlSaxParserTest, WorksheetLoadKeepsCellTypes) {
+    const std::string filename = "sax_worksheet_roundtrip.xlsx";
+    {
+        TXWorkbook workbook;
+        TXSheet* sheet = workbook.addSheet("Data");
+        ASSERT_NE(sheet, nullptr);
+        sheet->setCellValue("A1", 3.25);
+        sheet->setCellValue("B1", static_cast<int64_t>(42));
+        sheet->setCellValue("C1", true);
+        sheet->setCellValue("D1", std::string("a<b"));
+        sheet->setCellValue("A2", 1.0);
+        sheet->setCellValue("A3", 2.0);
+        sheet->setCellFormula(row_t(4), column_t(1), "=A2+A3");
+        ASSERT_TRUE(workbook.saveToFile(filename)) << workbook.getLastError();
+    }
+
+    TXWorkbook loaded;
+    ASSERT_TRUE(loaded.loadFromFile(filename)) << loaded.getLastError();
+    TXSheet* sheet = loaded.getSheet("Data");
+    ASSERT_NE(sheet, nullptr);
+
+    auto a1 = sheet->getCellValue("A1");
+    ASSERT_TRUE(std::holds_alternative<double>(a1));
+    EXPECT_DOUBLE_EQ(std::get<double>(a1), 3.25);
+
+    auto b1 = sheet->getCellValue("B1");
+    ASSERT_TRUE(std::holds_alternative<int64_t>(b1));
+    EXPECT_EQ(std::get<int64_t>(b1), 42);
+
+    auto c1 = sheet->getCellValue("C1");
+    ASSERT_TRUE(std::holds_alternative<bool>(c1));
+    EXPECT_TRUE(std::get<bool>(c1));
+
+    auto d1 = sheet->getCellValue("D1");
+    ASSERT_TRUE(std::holds_alternative<std::string>(d1));
+    EXPECT_EQ(std::get<std::string>(d1), "a<b");
+
+    const TXCell* a4 = sheet->getCellManager().getCell(TXCoordinate(row_t(4), column_t(1)));
+    ASSERT_NE(a4, nullptr);
+    EXPECT_TRUE(a4->isFormula());
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,108 @@
+//
+// @file test_xml_stream_writer.cpp
+// @brief 流式 XML 输出器测试
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXXmlStreamWriter.hpp"
+#include "TinaXlsx/TXCoordinate.hpp"
+#include "TinaXlsx/TXXmlWriter.hpp"
+#include <string>
+
+using namespace TinaXlsx;
+
+namespace {
+
+class StringSink : public TXXmlSink {
+public:
+    TXResult<void> write(const char* data, std::size_t size) override {
+        output.append(data, size);
+        ++writes;
+        return Ok();
+    }
+
+    std::string output;
+    int writes = 0;
+};
+
+} // namespace
+
+TEST(TXXmlStreamWriterTest, KeepsAttributeOrderAndSelfCloses) {
+    TXXmlStreamWriter xml;
+    xml.startElement("c").attribute("r", "B2").attribute("s", 3).attribute("t", "b");
+    xml.startElement("v").raw("1").endElement("v");
+    xml.endElement("c");
+    xml.startElement("empty").attribute("w", 12.5).endElement("empty");
+
+    EXPECT_EQ(xml.buffer(), "<c r=\"B2\" s=\"3\" t=\"b\"><v>1</v></c><empty w=\"12.5\"/>");
+}
+
+TEST(TXXmlStreamWriterTest, EscapesTextAndAttributes) {
+    TXXmlStreamWriter xml;
+    xml.startElement("t").attribute("a", "x\"<&>\n").text("1 < 2 & \"ok\"\x01").endElement("t");
+
+    EXPECT_EQ(xml.buffer(), "<t a=\"x&quot;&lt;&amp;&gt;&#10;\">1 &lt; 2 &amp; \"ok\"</t>");
+    EXPECT_TRUE(TXXmlStreamWriter::needsSpacePreserve(" padded"));
+    EXPECT_FALSE(TXXmlStreamWriter::needsSpacePreserve("plain"));
+}
+
+TEST(TXXmlStreamWriterTest, FlushesToSinkPastThreshold) {
+    StringSink sink;
+    TXXmlStreamWriter xml(&sink, 256);
+    std::string expected;
+    for (int i = 0; i < 1000; ++i) {
+        xml.startElement("v").text(i).endElement("v");
+        expected += "<v>" + std::to_string(i) + "</v>";
+    }
+    ASSERT_TRUE(xml.flush().isOk());
+
+    EXPECT_GT(sink.writes, 1);
+    EXPECT_EQ(sink.output, expected);
+    EXPECT_EQ(xml.bytesWritten(), expected.size());
+    EXPECT_TRUE(xml.buffer().empty());
+}
+
+TEST(TXXmlStreamWriterTest, WriteNodeMatchesNodeBuilderSerialization) {
+    XmlNodeBuilder root("worksheet");
+    root.addAttribute("xmlns", "urn:test").addAttribute("b", "2").addAttribute("a", "1");
+    root.addAttribute("b", "3");  // 覆盖保持原位置
+    XmlNodeBuilder row("row");
+    row.addAttribute("r", "1");
+    row.addChild(XmlNodeBuilder("c").addAttribute("r", "A1").setText("a&b"));
+    root.addChild(std::move(row));
+
+    TXXmlStreamWriter xml;
+    TXXmlWriter::writeNode(xml, root);
+    const std::string expected =
+        "<worksheet xmlns=\"urn:test\" b=\"3\" a=\"1\"><row r=\"1\"><c r=\"A1\">a&amp;b</c></row></worksheet>";
+    EXPECT_EQ(xml.buffer(), expected);
+
+    XmlWriteOptions options;
+    options.include_declaration = false;
+    TXXmlWriter writer(options);
+    ASSERT_TRUE(writer.setRootNode(root).isOk());
+    auto generated = writer.generateXmlString();
+    ASSERT_TRUE(generated.isOk());
+    EXPECT_EQ(generated.value(), expected);
+}
+
+TEST(TXCellRefFormatterTest, BuildsReferencesWithoutAllocating) {
+    TXCellRefFormatter refs;
+    refs.setRow(7);
+    EXPECT_EQ(refs.rowText(), "7");
+    EXPECT_EQ(refs.cell(1), "A7");
+    EXPECT_EQ(refs.cell(28), "AB7");
+
+    refs.setRow(1048576);
+    EXPECT_EQ(refs.cell(column_t::MAX_COLUMNS), "XFD1048576");
+    EXPECT_EQ(refs.cell(28), "AB1048576");
+
+    char buffer[TXCoordinate::MAX_ADDRESS_LENGTH];
+    const TXCoordinate coord(row_t(12), column_t(703));
+    EXPECT_EQ(std::string(buffer, coord.toChars(buffer)), "AAA12");
+    EXPECT_EQ(coord.toAddress(), "AAA12");
+
+    char letters[column_t::MAX_COLUMN_LETTERS];
+    EXPECT_EQ(std::string(letters, column_t::column_chars_from_index(26, letters)), "Z");
+    EXPECT_EQ(column_t::column_chars_from_index(0, letters), 0u);
+}
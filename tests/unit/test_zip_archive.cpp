@@ -0,0 +1,201 @@
+//
+// @file test_zip_archive.cpp
+// @brief 内存映射 ZIP 读取器测试
+//
+
+#include <gtest/gtest.h>
+#include "TinaXlsx/TXZipArchive.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace TinaXlsx;
+
+class TXZipArchiveReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // 可压缩的大条目，解压时需要多次分块
+        for (int i = 0; i < 200000; ++i) {
+            bigText_ += "<c r=\"A" + std::to_string(i) + "\"><v>" + std::to_string(i * 7) + "</v></c>";
+        }
+
+        TXZipArchiveWriter writer;
+        ASSERT_TRUE(writer.open(filename_).isOk());
+        writer.setStoreThreshold(64);
+        ASSERT_TRUE(writer.write("docProps/tiny.txt", storedText_.data(), storedText_.size()).isOk());
+        ASSERT_TRUE(writer.write("xl/worksheets/sheet1.xml", bigText_.data(), bigText_.size()).isOk());
+        writer.close();
+    }
+
+    void TearDown() override {
+        std::remove(filename_.c_str());
+    }
+
+    const std::string filename_ = "zip_archive_reader.zip";
+    const std::string storedText_ = "stored entry";
+    std::string bigText_;
+};
+
+TEST_F(TXZipArchiveReaderTest, ListsEntriesFromCentralDirectory) {
+    TXZipArchiveReader reader;
+    ASSERT_TRUE(reader.open(filename_).isOk());
+
+    auto entries = reader.entries();
+    ASSERT_TRUE(entries.isOk());
+    ASSERT_EQ(entries.value().size(), 2u);
+    EXPECT_EQ(entries.value()[0].filename, "docProps/tiny.txt");
+    EXPECT_EQ(entries.value()[0].uncompressed_size, storedText_.size());
+    EXPECT_EQ(entries.value()[1].uncompressed_size, bigText_.size());
+    EXPECT_LT(entries.value()[1].compressed_size, bigText_.size());
+
+    EXPECT_TRUE(reader.has("XL/Worksheets/Sheet1.xml").value());
+    EXPECT_FALSE(reader.has("xl/missing.xml").value());
+}
+
+TEST_F(TXZipArchiveReaderTest, StoredEntryIsZeroCopyView) {
+    TXZipArchiveReader reader;
+    ASSERT_TRUE(reader.open(filename_).isOk());
+
+    auto view = reader.view("docProps/tiny.txt");
+    ASSERT_TRUE(view.isOk()) << view.error().getMessage();
+    EXPECT_EQ(view.value(), storedText_);
+
+    // 压缩条目不能原地查看
+    EXPECT_TRUE(reader.view("xl/worksheets/sheet1.xml").isError());
+}
+
+TEST_F(TXZipArchiveReaderTest, InflatesIntoCallerBuffers) {
+    TXZipArchiveReader reader;
+    ASSERT_TRUE(reader.open(filename_).isOk());
+
+    std::string whole(bigText_.size(), '\0');
+    auto readResult = reader.readInto("xl/worksheets/sheet1.xml", whole.data(), whole.size());
+    ASSERT_TRUE(readResult.isOk()) << readResult.error().getMessage();
+    EXPECT_EQ(readResult.value(), bigText_.size());
+    EXPECT_EQ(whole, bigText_);
+
+    std::vector<char> tooSmall(bigText_.size() - 1);
+    EXPECT_TRUE(reader.readInto("xl/worksheets/sheet1.xml", tooSmall.data(), tooSmall.size()).isError());
+
+    ASSERT_TRUE(reader.openEntry("xl/worksheets/sheet1.xml").isOk());
+    std::string streamed;
+    std::vector<char> chunk(4096);
+    while (true) {
+        auto chunkResult = reader.readEntry(chunk.data(), chunk.size());
+        ASSERT_TRUE(chunkResult.isOk()) << chunkResult.error().getMessage();
+        if (chunkResult.value() == 0) {
+            break;
+        }
+        streamed.append(chunk.data(), chunkResult.value());
+    }
+    reader.closeEntry();
+    EXPECT_EQ(streamed, bigText_);
+}
+
+TEST_F(TXZipArchiveReaderTest, RejectsNonZipFile) {
+    const std::string bogus = "zip_archive_reader_bogus.zip";
+    {
+        std::FILE* file = std::fopen(bogus.c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        std::fputs("this is not a zip archive", file);
+        std::fclose(file);
+    }
+
+    TXZipArchiveReader reader;
+    auto openResult = reader.open(bogus);
+    EXPECT_TRUE(openResult.isError());
+    EXPECT_EQ(openResult.error().getCode(), TXErrorCode::ZipOpenFailed);
+    EXPECT_FALSE(reader.isOpen());
+    std::remove(bogus.c_str());
+}
+
+TEST_F(TXZipArchiveReaderTest, RejectsTruncatedZip64Locator) {
+    // 只有 zip64 定位记录和目录结束记录的 42 字节归档，比 zip64 目录结束记录（56 字节）还短；
+    // 定位记录指向的偏移落在缓冲区末尾附近
+    std::vector<uint8_t> data;
+    data.reserve(42);
+    auto put = [&data](uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    };
+    put(0x07064b50, 4);    // zip64 定位记录
+    put(0, 4);
+    put(40, 8);            // zip64 目录结束记录的偏移
+    put(1, 4);
+    put(0x06054b50, 4);    // 目录结束记录，计数、大小和偏移都标记为 zip64
+    put(0, 2);
+    put(0, 2);
+    put(0xFFFF, 2);
+    put(0xFFFF, 2);
+    put(0xFFFFFFFF, 4);
+    put(0xFFFFFFFF, 4);
+    put(0, 2);
+    ASSERT_EQ(data.size(), 42u);
+
+    TXZipArchiveReader reader;
+    auto openResult = reader.openMemory(data.data(), data.size());
+    EXPECT_TRUE(openResult.isError());
+    EXPECT_EQ(openResult.error().getCode(), TXErrorCode::ZipOpenFailed);
+    EXPECT_FALSE(reader.isOpen());
+}
+
+TEST_F(TXZipArchiveReaderTest, StreamsEntryInFixedSizeChunks) {
+    TXZipArchiveReader reader;
+    ASSERT_TRUE(reader.open(filename_).isOk());
+
+    std::string streamed;
+    std::size_t largestChunk = 0;
+    auto result = reader.readStream("xl/worksheets/sheet1.xml", [&](const uint8_t* data, std::size_t size) {
+        streamed.append(reinterpret_cast<const char*>(data), size);
+        largestChunk = std::max(largestChunk, size);
+        return Ok();
+    }, 16 * 1024);
+    ASSERT_TRUE(result.isOk()) << result.error().getMessage();
+    EXPECT_EQ(streamed, bigText_);
+    EXPECT_LE(largestChunk, 16u * 1024);
+
+    // sink 返回错误时立即停止并原样返回
+    std::size_t calls = 0;
+    result = reader.readStream("xl/worksheets/sheet1.xml", [&](const uint8_t*, std::size_t) {
+        ++calls;
+        return Err<void>(TXErrorCode::OperationFailed, "stop");
+    });
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.error().getCode(), TXErrorCode::OperationFailed);
+    EXPECT_EQ(calls, 1u);
+
+    EXPECT_EQ(reader.readStream("xl/missing.xml", [](const uint8_t*, std::size_t) { return Ok(); })
+                  .error().getCode(), TXErrorCode::ZipEntryNotFound);
+}
+
+TEST(TXZipArchiveIndexTest, LooksUpThousandsOfParts) {
+    const std::string filename = "zip_archive_many_parts.zip";
+    constexpr int kParts = 3000;
+    {
+        TXZipArchiveWriter writer;
+        ASSERT_TRUE(writer.open(filename).isOk());
+        for (int i = 0; i < kParts; ++i) {
+            const std::string body = "part " + std::to_string(i);
+            ASSERT_TRUE(writer.write("xl/drawings/drawing" + std::to_string(i) + ".xml",
+                                     body.data(), body.size()).isOk());
+        }
+        writer.close();
+    }
+
+    TXZipArchiveReader reader;
+    ASSERT_TRUE(reader.open(filename).isOk());
+    EXPECT_EQ(reader.entries().value().size(), static_cast<std::size_t>(kParts));
+    for (int i = kParts - 1; i >= 0; --i) {
+        auto text = reader.readString("xl/drawings/drawing" + std::to_string(i) + ".xml");
+        ASSERT_TRUE(text.isOk());
+        EXPECT_EQ(text.value(), "part " + std::to_string(i));
+    }
+    EXPECT_TRUE(reader.has("XL/DRAWINGS/DRAWING42.XML").value());
+    EXPECT_FALSE(reader.has("xl/drawings/drawing3000.xml").value());
+
+    reader.close();
+    std::remove(filename.c_str());
+}